@@ -42,6 +42,18 @@
 // ~~~~~~~~~~~~~~~>
 #define FilIndUSARTDMAHD    "milibrary/drv/UARTPeriph/UARTDMAPeriph.h"
     // File fur the USART driver with additional support for DMA interfaces
+#define FilInd_SPIDMAHD     "milibrary/drv/SPIPeriph/SPIDMAPeriph.h"
+    // File for the SPI driver with additional support for DMA interfaces
+
+// Benchmarks
+// ~~~~~~~~~~>
+#define FilInd_SPIBchHD     "milibrary/drv/SPIPeriph/SPIBench.h"
+    // File for the SPI driver throughput and latency benchmark (Linux)
+
+// Bus managers
+// ~~~~~~~~~~~~>
+#define FilInd_I2CMngHD     "milibrary/drv/I2CPeriph/I2CBusMngr.h"
+    // File for the manager of multiple I2C buses, each with its own worker thread (Linux)
 
 /**************************************************************************************************
  * All of the defines below are for "Common" code - examples: Buffers, Math, etc.
@@ -52,6 +64,9 @@
 
 #define FilInd_DATMngrHD    "milibrary/com/DataManip/DataManip.h"   // File for Data Manipulator
 
+#define FilInd_FrmEvtHD     "milibrary/com/FormEvent/FormEvent.h"   // File for Request Form
+                                                                    // completion event
+
 /**************************************************************************************************
  * All of the defines below are for "Devices" - examples: external hardware, shift registers, etc.
  * These would be contained within a "dev" folder
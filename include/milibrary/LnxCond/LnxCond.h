@@ -31,6 +31,37 @@
  *                        "CurLoad" however each contain 10 additional entries for each CPU count.
  *                        CurCPU[0][0] = CPU (Total) - Time in user mode
  *                        CurCPU[1][0] = CPU (  1  ) - Time in user mode
+ *          ".Thread[]" = Array of the threads within this process (size "ThreadCnt"), containing
+ *                        the user/system time, context switches, last CPU run on, and the load of
+ *                        each thread (as a fraction of a single core) - see "_LnxThrd" below.
+ *                        The thread directory and the thread file descriptors are kept open
+ *                        between calls, so only new threads require files to be opened.
+ *                        Maximum number of threads captured is "LNX_MAX_THREADS".
+ *          ".Pressure[]"   = Pressure stall information for the CPU, memory and io (index with
+ *                            "LNX_PSI_CPU", "LNX_PSI_MEMORY", "LNX_PSI_IO") - see "_LnxPSI".
+ *                            If the kernel does not support pressure stall information, the first
+ *                            "UpdateStatus" will return 'PressureOpen', and it will then no longer
+ *                            be checked.
+ *          ".Memory"       = Selected entries from the memory information - see "_LnxMem".
+ *          ".IRQ[]"        = Array of the interrupt lines (size "IRQCnt"), containing the count
+ *                            (total of all cores) and the rate of interrupts between the last 2
+ *                            calls - see "_LnxIRQ". Maximum number of lines captured is
+ *                            "LNX_MAX_IRQS", and the file is read into a buffer of size
+ *                            "LNX_PROC_BUFF" - if either is exceeded then the lines which fit
+ *                            are captured, and 'IRQOverflow' is returned (as per threads).
+ *
+ *      A scheduling latency probe can be started with "StartLatency" (stopped with "StopLatency").
+ *      This runs a real-time (SCHED_FIFO) thread, which wakes at a fixed period, and captures how
+ *      late each wake-up was. Each "UpdateStatus" will then update the statistics for the wake-ups
+ *      since the previous call:
+ *          ".Latency"      = Min/Avg/Max/99.9th percentile of wake-up latency (us) - see "_LnxLat"
+ *          ".LatencyHist[]"= Histogram of the wake-up latency (1us per entry, with final entry
+ *                            being all wake-ups beyond "LNX_LAT_BUCKETS")
+ *      To run with real-time priority, the process requires CAP_SYS_NICE (or root), a priority of
+ *      0 will run the probe as a normal thread.
+ *
+ *      Class can also be provided with a root directory for the files, or a directory of recorded
+ *      snapshots to replay - see the calling conditions of "LnxCond" below.
  *
  *      There is no other functionality within this class
  *************************************************************************************************/
@@ -41,6 +72,16 @@
 #include <sstream>      // std::stringstream
 #include <string>       // std::string
 
+#include <dirent.h>     // opendir, readdir, rewinddir, closedir
+#include <fcntl.h>      // open
+#include <unistd.h>     // pread, read, lseek, close
+#include <time.h>       // clock_gettime, clock_nanosleep
+#include <pthread.h>    // pthread_create, pthread_join
+#include <sched.h>      // SCHED_FIFO
+#include <cstdio>       // snprintf
+#include <cstdlib>      // strtoul, strtoull, strtof
+#include <cstring>      // strchr, strrchr, strstr
+
 #if defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
 //=================================================================================================
 // As currently have only 1 Embedded Linux Device, this class will only work if the project has
@@ -63,6 +104,29 @@ typedef enum {
     LnxCond_CPULoadRead     = 4,    // Fault with CPU Load file read
     LnxCond_CPULoadConvert  = 5,    // Fault with CPU Load file conversion
 
+    LnxCond_ThreadOpen      = 6,    // Fault with Thread directory open
+    LnxCond_ThreadRead      = 7,    // Fault with Thread file read (thread has exited)
+    LnxCond_ThreadConvert   = 8,    // Fault with Thread file conversion
+    LnxCond_ThreadOverflow  = 9,    // More threads within process than "LNX_MAX_THREADS"
+
+    LnxCond_PressureOpen    = 10,   // Fault with Pressure Stall file open
+    LnxCond_PressureRead    = 11,   // Fault with Pressure Stall file read
+    LnxCond_PressureConvert = 12,   // Fault with Pressure Stall file conversion
+
+    LnxCond_MemoryOpen      = 13,   // Fault with Memory Information file open
+    LnxCond_MemoryRead      = 14,   // Fault with Memory Information file read
+    LnxCond_MemoryConvert   = 15,   // Fault with Memory Information file conversion
+
+    LnxCond_IRQOpen         = 16,   // Fault with Interrupts file open
+    LnxCond_IRQRead         = 17,   // Fault with Interrupts file read
+    LnxCond_IRQConvert      = 18,   // Fault with Interrupts file conversion
+
+    LnxCond_ReplayEnd       = 19,   // All recorded snapshots have been replayed
+
+    LnxCond_LatencyStart    = 20,   // Fault with starting latency probe thread
+
+    LnxCond_IRQOverflow     = 21,   // More interrupt lines than "LNX_MAX_IRQS", or Interrupts
+                                    // file larger than "LNX_PROC_BUFF"
 
     LnxCond_Initialised = -1        // If initailised, this flag is set
 } _LnxFlt;
@@ -75,9 +139,111 @@ typedef enum {
 #ifndef LNX_NUM_CORES                 // If the number of CPU cores is not defined
 #define LNX_NUM_CORES       4         // Define the number as 4 (excluding the total)
 #endif
+#define LNX_CORE_IGNORE     0xFF      // Core number for lines beyond "LNX_NUM_CORES"
+#define LNX_COUNTER_HALF    0x80000000// Half range of the CPU counters (see "CalculateCPULoad")
+
+//  > Thread Status defines
+#ifndef LNX_MAX_THREADS               // If the maximum number of threads is not defined
+#define LNX_MAX_THREADS     64        // Define the number as 64
+#endif
+#define LNX_THREAD_NAME     16        // Size of thread name (kernel limit, including '\0')
+#define LNX_THREAD_BUFF     2048      // Size of buffer used to read thread files
+#define LNX_THREAD_UTIME    14        // Field number within thread "stat" file for user time
+#define LNX_THREAD_STIME    15        // Field number within thread "stat" file for system time
+#define LNX_THREAD_CPU      39        // Field number within thread "stat" file for last CPU
+
+typedef struct {
+    int         TID;                    // Thread ID (0 if entry is not used)
+    char        Name[LNX_THREAD_NAME];  // Name of thread (as per "pthread_setname_np")
+    uint32_t    UTime;                  // Time in User Mode (clock ticks)
+    uint32_t    STime;                  // Time in System Mode (clock ticks)
+    uint32_t    VolCtxt;                // Number of voluntary context switches
+    uint32_t    NonVolCtxt;             // Number of involuntary context switches
+    uint32_t    VolCtxtDiff;            // Voluntary context switches since previous read
+    uint32_t    NonVolCtxtDiff;         // Involuntary context switches since previous read
+    int         LastCPU;                // CPU core thread was last executed on
+    float       Load;                   // Calculated load of thread (fraction of a single core)
+
+    uint32_t    PrevTime;               // UTime + STime from previous read
+    int         StatFd;                 // File descriptor for thread "stat" file
+    int         StatusFd;               // File descriptor for thread "status" file
+    uint8_t     Pass;                   // Pass the thread was last seen within directory
+    int8_t      threadmode;             // Variable for storing parameters on the thread
+                                        // i.e. FirstPass state
+} _LnxThrd;
+
+//  > Pressure Stall defines
+#define LNX_NUM_PSI         3         // Number of Pressure Stall files
+#define LNX_PSI_CPU         0         // Entry within "Pressure" for CPU
+#define LNX_PSI_MEMORY      1         // Entry within "Pressure" for memory
+#define LNX_PSI_IO          2         // Entry within "Pressure" for io
+
+typedef struct {
+    float       SomeAvg10;              // % of time some tasks stalled (10s average)
+    float       SomeAvg60;              // % of time some tasks stalled (60s average)
+    float       SomeAvg300;             // % of time some tasks stalled (300s average)
+    uint64_t    SomeTotal;              // Total time some tasks stalled (us)
+    uint64_t    SomeDiff;               // Time some tasks stalled since previous read (us)
+
+    float       FullAvg10;              // % of time all tasks stalled (10s average)
+    float       FullAvg60;              // % of time all tasks stalled (60s average)
+    float       FullAvg300;             // % of time all tasks stalled (300s average)
+    uint64_t    FullTotal;              // Total time all tasks stalled (us)
+    uint64_t    FullDiff;               // Time all tasks stalled since previous read (us)
+} _LnxPSI;
+
+//  > Memory Information defines
+typedef struct {
+    uint32_t    MemTotal;               // Total usable memory (kB)
+    uint32_t    MemFree;                // Unused memory (kB)
+    uint32_t    MemAvailable;           // Estimate of memory available without swapping (kB)
+    uint32_t    Buffers;                // Memory used for raw disk blocks (kB)
+    uint32_t    Cached;                 // Memory used for file cache (kB)
+    uint32_t    Dirty;                  // Memory waiting to be written to disk (kB)
+    uint32_t    SwapTotal;              // Total swap space (kB)
+    uint32_t    SwapFree;               // Unused swap space (kB)
+} _LnxMem;
+
+//  > Interrupt defines
+#ifndef LNX_MAX_IRQS                  // If the maximum number of interrupt lines is not defined
+#define LNX_MAX_IRQS        64        // Define the number as 64
+#endif
+#ifndef LNX_PROC_BUFF                 // If the size of the file buffer is not defined
+#define LNX_PROC_BUFF       8192      // Define the size as 8kB (interrupts file is the largest)
+#endif
+#define LNX_IRQ_NAME        8         // Size of interrupt line label (i.e. "23", "IPI0")
+#define LNX_IRQ_DESC        24        // Size of interrupt line device name (i.e. "spi0")
+
+typedef struct {
+    char        Name[LNX_IRQ_NAME];     // Label of interrupt line
+    char        Desc[LNX_IRQ_DESC];     // Device name of interrupt line (last entry of line)
+    uint32_t    Count;                  // Number of interrupts (total of all cores)
+    uint32_t    Diff;                   // Number of interrupts since previous read
+    float       Rate;                   // Rate of interrupts since previous read (per second)
+} _LnxIRQ;
+
+//  > Latency Probe defines
+#ifndef LNX_LAT_BUCKETS               // If the number of histogram entries is not defined
+#define LNX_LAT_BUCKETS     1000      // Define the number as 1000 (1us per entry)
+#endif
+#define LNX_LAT_STOPPED     0         // Latency probe is not running
+#define LNX_LAT_RUNNING     1         // Latency probe is running
+
+typedef struct {
+    uint32_t    Min;                    // Minimum wake-up latency since previous read (us)
+    uint32_t    Max;                    // Maximum wake-up latency since previous read (us)
+    float       Avg;                    // Average wake-up latency since previous read (us)
+    uint32_t    P999;                   // 99.9th percentile wake-up latency since previous read
+                                        // (us) - limited to resolution of histogram
+    uint32_t    Samples;                // Number of wake-ups since previous read
+    uint32_t    Overflow;               // Number of wake-ups beyond histogram since previous read
+    uint32_t    MaxTotal;               // Maximum wake-up latency since probe started (us)
+} _LnxLat;
 
 //  > Class Mode defines
 #define LNX_FIRST_PASS          0x01  // Flag indicating that first pass has been done (classmode)
+#define LNX_NO_PRESSURE         0x02  // Flag indicating Pressure Stall is not supported
+#define LNX_PRESSURE_PASS       0x04  // Flag indicating that first Pressure Stall read is done
 
 //  > Short-cuts for calculating ActiveTime and IdleTime
 #define LNX_ActiveTime(array, core)     array[core][0] + \
@@ -109,21 +275,73 @@ typedef enum {
 
 class LnxCond {
     private:
+        std::string ReplayDir;              // Location for where replay snapshots are located
+        uint16_t    ReplayCnt;              // Number of replay snapshots (0 if not replaying)
+        uint16_t    ReplayPos;              // Next replay snapshot
         std::string TemperatureFile;        // Location for where CPU temperature file is located
         std::string CPUFile;                // Location for where CPU load file is located
         uint32_t    PrevCPU[LNX_NUM_CORES + 1][LNX_NUM_CPU_STATES];
                     // CPU entries from previous read
+        std::string ThreadDir;              // Location for where process threads are located
+        DIR        *ThreadDirHandle;        // Cached directory handle for "ThreadDir"
+        uint8_t     ThreadPass;             // Counter for number of thread directory scans
+        pthread_t   LatencyHandle;          // Handle of latency probe thread
+        uint32_t    LatencyPeriod;          // Period of latency probe (us)
+        uint8_t     LatencyState;           // State of latency probe (shared with probe thread)
+        uint32_t    LatencyCount[LNX_LAT_BUCKETS + 1];  // Histogram since probe started
+                                                        // (written by probe thread)
+        uint32_t    LatencyPrev[LNX_LAT_BUCKETS + 1];   // Histogram at previous read
+        uint64_t    LatencySum;             // Total latency since probe started (us)
+        uint64_t    LatencyPrevSum;         // Total latency at previous read (us)
+        uint32_t    LatencyIntMin;          // Minimum latency since previous read (us)
+        uint32_t    LatencyIntMax;          // Maximum latency since previous read (us)
+        uint32_t    LatencySeq;             // Sequence count of probe updates (odd whilst the
+                                            // probe thread is updating the statistics)
+        uint32_t    TotalDiff;              // Total CPU time (all cores) between last 2 reads
+        uint16_t    OnlineCnt;              // Number of cores listed at current read (including
+                                            // those beyond "LNX_NUM_CORES")
+        std::string PressureFile[LNX_NUM_PSI];  // Location for where Pressure files are located
+        std::string MemoryFile;             // Location for where Memory Information is located
+        std::string IRQFile;                // Location for where Interrupts file is located
+        int         PressureFd[LNX_NUM_PSI];// Cached file descriptors for "PressureFile"
+        int         MemoryFd;               // Cached file descriptor for "MemoryFile"
+        int         IRQFd;                  // Cached file descriptor for "IRQFile"
+        struct timespec IRQTime;            // Time of previous Interrupts read
+        char        ProcBuff[LNX_PROC_BUFF];// Buffer used to read Pressure/Memory/Interrupts
         float       CheckFreq;              // Frequency of checking
         int8_t      classmode;              // Variable for storing parameters on the class
                                             // i.e. FirstPass state
 
 
         void        InitialSetup(void);     // Hidden function, which defaults all parameters
-        _LnxFlt     ConvertCPUText(uint32_t CPUData[], std::string CPUString);
+        void        SetRoot(std::string Root);  // Update location of all files to be within "Root"
+        void        CloseFiles(void);       // Close all files kept open between calls
+        void        ReleaseFiles(void);     // Close all files, keeping the list of threads
+        _LnxFlt     ConvertCPUText(uint32_t CPUData[][LNX_NUM_CPU_STATES], const char *CPUString,
+                                   uint8_t *Core);
                     // Convert the read CPU status string into array entries
         void        CalculateCPULoad(void); // Calculate the CPU load
         void        UpdateCPUHistory(void); // Update the CPU historic array
 
+        _LnxFlt     ScanThreads(void);      // Update list of threads within process
+        uint8_t     OpenThread(_LnxThrd *Thrd, const char *Name);
+                    // Open the files of thread (returns 0 if thread has exited)
+        void        RemoveThread(uint16_t entry);   // Close and remove thread from list
+        _LnxFlt     ReadThread(_LnxThrd *Thrd, char Buff[]);
+                    // Read the latest status of thread
+
+        _LnxFlt     ReadProcFile(int *Fd, std::string &Loc, _LnxFlt OpenFlt, _LnxFlt ReadFlt,
+                                 _LnxFlt OverflowFlt);
+                    // Read complete file into "ProcBuff" (file descriptor cached)
+        char       *FindField(char Buff[], const char *Field);
+                    // Find line starting with "Field:" within buffer
+        _LnxFlt     ReadPressure(void);     // Read the Pressure Stall files
+        _LnxFlt     ReadMemory(void);       // Read the Memory Information file
+        _LnxFlt     ReadInterrupts(void);   // Read the Interrupts file
+
+        static void *LatencyThread(void *Cond);     // Latency probe thread
+        void        UpdateLatency(void);    // Update the latency statistics since previous read
+
     public:
         float       Temp;                   // Calculated temperature (celsius) from last
                                             // "UpdateStatus"
@@ -132,6 +350,17 @@ class LnxCond {
         _LnxFlt     FaultCode;              // Store the FaultCode from previous "UpdateStatus"
         uint32_t    CurCPU[LNX_NUM_CORES+1][LNX_NUM_CPU_STATES];
                     // CPU entries at current read
+        uint8_t     CoreOnline[LNX_NUM_CORES+1];
+                    // Indication of whether core was listed at current read (1 = online)
+        uint16_t    ThreadCnt;              // Number of threads captured within "Thread"
+        _LnxThrd    Thread[LNX_MAX_THREADS];// Status of each thread within process
+        _LnxPSI     Pressure[LNX_NUM_PSI];  // Pressure Stall information (CPU, memory, io)
+        _LnxMem     Memory;                 // Memory Information
+        uint16_t    IRQCnt;                 // Number of interrupt lines captured within "IRQ"
+        _LnxIRQ     IRQ[LNX_MAX_IRQS];      // Status of each interrupt line
+        _LnxLat     Latency;                // Wake-up latency statistics of probe
+        uint32_t    LatencyHist[LNX_LAT_BUCKETS + 1];   // Histogram of wake-up latency since
+                                                        // previous read
 
 /**************************************************************************************************
  * LnxCond is an overloaded function, so therefore has multiple calling conditions
@@ -139,12 +368,26 @@ class LnxCond {
  *              parameters
  *  The second  is when the frequency is provided to the class. It will again setup default
  *              parameters, however will set the frequency to value provided
+ *  The third   is when a root directory is provided, all files will then be read relative to this
+ *              directory (i.e. for a chroot, or a copy of the filesystem)
+ *  The fourth  is for replaying recorded snapshots of the files, each call of "UpdateStatus" will
+ *              move onto the next snapshot (so can be run faster then recorded). The frequency
+ *              the snapshots were recorded at is used in place of the actual time between calls.
+ *              The list of threads is kept between snapshots, so the load of each thread is
+ *              determined from the second snapshot onwards (as per the CPU load)
  *************************************************************************************************/
         LnxCond();                          // Default class initialise
         LnxCond(float Frequency);           // Default class + set Check Frequency
+        LnxCond(std::string Root);          // Default class + set root directory of files
+        LnxCond(std::string Replay, uint16_t Snapshots, float Frequency);
+                                            // Replay class from recorded snapshots
 
         _LnxFlt UpdateStatus(void);         // Update class parameters to latest conditions
 
+        _LnxFlt StartLatency(uint32_t Period, int Priority, int Core);
+                                            // Start latency probe (Core = -1 for any core)
+        void    StopLatency(void);          // Stop latency probe
+
         virtual ~LnxCond();
 };
 
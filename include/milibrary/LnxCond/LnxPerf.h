@@ -0,0 +1,128 @@
+/**************************************************************************************************
+ * @file        LnxPerf.h
+ * @author      thomas
+ * @brief       Header file for the Linux Embedded Device Performance Counters
+ **************************************************************************************************
+ @ attention
+
+ << To be Introduced >>
+
+ *************************************************************************************************/
+/**************************************************************************************************
+ * How to use
+ * ----------
+ * Linux class, which will capture the performance counters of the calling thread, around specific
+ * regions of code (i.e. an interrupt handler, or a search loop).
+ * The counters are opened as a single group (via "perf_event_open"), so all counters are captured
+ * at the same time, with a single read.
+ * Use of class
+ *      Initial call, doesn't require any additional parameters - however the counters are only
+ *      for the thread which creates the class, so needs to be created within the thread to be
+ *      measured.
+ *          The hardware counters are captured:
+ *              ".Count[LNX_PERF_CYCLES]"       = Number of CPU cycles
+ *              ".Count[LNX_PERF_INSTRUCTIONS]" = Number of instructions executed
+ *              ".Count[LNX_PERF_CACHE_MISSES]" = Number of cache misses
+ *              ".Count[LNX_PERF_BRANCH_MISSES]"= Number of mispredicted branches
+ *          If the hardware counters are not available (i.e. within a container, or virtual
+ *          machine), then the software counters are captured instead, and ".Software" is set:
+ *              ".Count[LNX_PERF_TASK_CLOCK]"   = Time thread was running (ns)
+ *              ".Count[LNX_PERF_CTX_SWITCHES]" = Number of context switches
+ *
+ *      Call "Begin" at the start of the region, and "End" at the end of the region. "End" will
+ *      then update:
+ *          ".Count[]"  = Counts for the last region
+ *          ".Total[]"  = Total counts of all regions (since class created, or "Reset")
+ *          ".Scopes"   = Number of regions captured within "Total"
+ *      Both will return the status of the read - if no failures will return 'NoFault' -> see
+ *      "_LnxPerfFlt" below.
+ *
+ *      If there are more counters then the CPU supports, the kernel will share the counters over
+ *      time, if this has occurred within the last region ".Multiplexed" will be set.
+ *************************************************************************************************/
+#ifndef LNXCOND_LNXPERF_H_
+#define LNXCOND_LNXPERF_H_
+
+#include <stdint.h>             // uint64_t
+#include <unistd.h>             // read, close, syscall
+#include <sys/syscall.h>        // __NR_perf_event_open
+#include <linux/perf_event.h>   // perf_event_attr
+#include <cstring>              // memset
+
+#if defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
+//=================================================================================================
+// As currently have only 1 Embedded Linux Device, this class will only work if the project has
+// been configured for RaspberryPi
+#else
+//=================================================================================================
+// Otherwise it is an unrecognised device
+#error "Unrecognised target device"
+
+#endif
+
+// Defines specific within this class
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+typedef enum {
+    LnxPerf_NoFault = 0,            // No fault with performance counters
+    LnxPerf_Open    = 1,            // Fault with opening counters (neither hardware or software
+                                    // counters are available)
+    LnxPerf_Read    = 2,            // Fault with reading counters
+    LnxPerf_Scope   = 3,            // "End" called without "Begin"
+
+    LnxPerf_Initialised = -1        // If initailised, this flag is set
+} _LnxPerfFlt;
+
+// Types used within this class
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+#define LNX_PERF_NUM_EVENTS     4     // Maximum number of counters within group
+
+//  > Hardware counter entries
+#define LNX_PERF_CYCLES         0     // Entry for CPU cycles
+#define LNX_PERF_INSTRUCTIONS   1     // Entry for instructions executed
+#define LNX_PERF_CACHE_MISSES   2     // Entry for cache misses
+#define LNX_PERF_BRANCH_MISSES  3     // Entry for mispredicted branches
+
+//  > Software counter entries (if hardware counters not available)
+#define LNX_PERF_TASK_CLOCK     0     // Entry for time thread was running (ns)
+#define LNX_PERF_CTX_SWITCHES   1     // Entry for context switches
+
+//  > Class Mode defines
+#define LNX_PERF_IN_SCOPE       0x01  // Flag indicating that "Begin" has been called (perfmode)
+
+class LnxPerf {
+    private:
+        int         EventFd[LNX_PERF_NUM_EVENTS];   // File descriptors of counters (first entry
+                                                    // is the group leader)
+        uint8_t     EventCnt;               // Number of counters opened
+        uint64_t    Start[LNX_PERF_NUM_EVENTS];     // Counts at "Begin"
+        uint64_t    StartEnabled;           // Time counters enabled at "Begin"
+        uint64_t    StartRunning;           // Time counters running at "Begin"
+        int8_t      perfmode;               // Variable for storing parameters on the class
+                                            // i.e. InScope state
+
+        void        InitialSetup(void);     // Hidden function, which defaults all parameters
+        _LnxPerfFlt OpenGroup(const uint32_t Type[], const uint64_t Config[], uint8_t Num);
+                    // Open group of counters for calling thread
+        void        CloseGroup(void);       // Close all counters
+        _LnxPerfFlt ReadGroup(uint64_t Values[], uint64_t *Enabled, uint64_t *Running);
+                    // Read all counters within group
+
+    public:
+        uint8_t     Software;               // Set to 1 if software counters are being used
+        uint8_t     Multiplexed;            // Set to 1 if counters were shared within last region
+        uint64_t    Count[LNX_PERF_NUM_EVENTS];     // Counts for the last region
+        uint64_t    Total[LNX_PERF_NUM_EVENTS];     // Total counts of all regions
+        uint32_t    Scopes;                 // Number of regions captured within "Total"
+        _LnxPerfFlt FaultCode;              // Store the FaultCode from previous "Begin"/"End"
+
+        LnxPerf();                          // Default class initialise (for calling thread)
+
+        _LnxPerfFlt Begin(void);            // Capture counters at start of region
+        _LnxPerfFlt End(void);              // Capture counters at end of region, and update
+                                            // "Count" and "Total"
+        void        Reset(void);            // Clear "Total" and "Scopes"
+
+        virtual ~LnxPerf();
+};
+
+#endif /* LNXCOND_LNXPERF_H_ */
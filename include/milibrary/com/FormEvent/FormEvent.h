@@ -0,0 +1,123 @@
+/**************************************************************************************************
+ * @file        FormEvent.h
+ * @author      Thomas
+ * @brief       Header file for the Request Form completion event
+ **************************************************************************************************
+  @ attention
+
+  << To be Introduced >>
+
+ *************************************************************************************************/
+/**************************************************************************************************
+ * How to use
+ * ----------
+ * Class provides a waitable event, which can be linked to the completion callback of the
+ * interrupt based Request Forms (SPIPeriph, I2CPeriph, UARTPeriph). So rather than polling the
+ * "Complete"/"Fault" flags, the source function can wait for the form(s) to complete.
+ *
+ * Use of class
+ *      Initial call generates the event (no parameters needed)
+ *
+ *      Provide the static function ".formCallback" as the Request Form callback, and the address
+ *      of this class as the callback context. Each time a form completes (or faults) the event
+ *      is signalled.
+ *      ".wait"     - Will wait until the event has been signalled the requested number of times
+ *                    (since ".clear"), or until the timeout (milliseconds, 0 = no timeout)
+ *      ".count"    - Number of times signalled (since ".clear")
+ *      ".clear"    - Clear the number of signals, to be called prior to requesting the forms
+ *
+ *      For RaspberryPi, the wait is blocking (thread sleeps until signalled), the callbacks will
+ *      be from the interrupt emulation thread (or the requesting thread).
+ *      For STM32, the wait is a poll of the signal count (callbacks are from the interrupt), with
+ *      timeout based upon "HAL_GetTick".
+ *
+ *      There is no other functionality within this class
+ *************************************************************************************************/
+#ifndef FORMEVENT_H_
+#define FORMEVENT_H_
+
+#include <stdint.h>                     // Include library for standard data types
+
+#if   defined(zz__MiSTM32Fx__zz)        // If the target device is an STM32Fxx from cubeMX then
+//=================================================================================================
+#include "stm32f1xx_hal.h"              // Include the HAL library
+
+#elif defined(zz__MiSTM32Lx__zz)        // If the target device is an STM32Lxx from cubeMX then
+//=================================================================================================
+#include "stm32l4xx_hal.h"              // Include the HAL library
+
+#elif defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
+//=================================================================================================
+#include <pthread.h>                    // Include threads (mutex and condition)
+#include <time.h>                       // Include clock (for timeout)
+
+#else
+//=================================================================================================
+#error "Unrecognised target device"
+
+#endif
+
+// Defines specific within this class
+// None
+
+// Types used within this class
+// Defined within the class, to ensure are contained within the correct scope
+
+class FormEvent {
+/**************************************************************************************************
+ * ==   TYPES   == >>>       TYPES GENERATED WITHIN CLASS        <<<
+ *   -----------
+ *  Following types are generated within this class. If needed outside of the class, need to
+ *  state "FormEvent::" followed by the type.
+ *************************************************************************************************/
+public:
+    enum class EvntState : uint8_t {    // State of the event (return of ".wait")
+        kSignalled      = 0x00,         // Event has been signalled (requested number of times)
+        kTimeout        = 0x01          // Timeout before event was signalled
+    };
+
+/**************************************************************************************************
+ * == GEN PARAM == >>>       GENERIC PARAMETERS FOR CLASS        <<<
+ *   -----------
+ *  Parameters required for the class to function.
+ *************************************************************************************************/
+    private:
+        volatile uint16_t   _count_;        // Number of times event has been signalled
+
+/**************************************************************************************************
+ * == SPC PARAM == >>>        SPECIFIC ENTRIES FOR CLASS         <<<
+ *   -----------
+ *  Following are functions and parameters which are specific for the embedded device selected.
+ *************************************************************************************************/
+#if defined(zz__MiRaspbPi__zz)          // If the target device is an Raspberry Pi then
+//=================================================================================================
+    private:
+        pthread_mutex_t     _lock_;         // Lock for the signal count
+        pthread_cond_t      _cond_;         // Condition to wake waiting thread
+
+#endif
+
+/**************************************************************************************************
+ * == GEN FUNCT == >>>      GENERIC FUNCTIONS WITHIN CLASS       <<<
+ *   -----------
+ *  The following are functions scoped within the "FormEvent" class, which are generic; this means
+ *  are used by ANY of the embedded devices supported by this class.
+ *************************************************************************************************/
+public:
+    FormEvent();
+
+    void clear(void);                   // Clear the number of signals
+    void signal(void);                  // Signal the event
+    uint16_t count(void);               // Number of signals (since ".clear")
+
+    EvntState wait(uint16_t count, uint32_t timeout);
+    // Wait until event has been signalled "count" times, or "timeout" (milliseconds) has passed
+    // (0 = no timeout)
+
+    static void formCallback(void *context);
+    // Request Form completion callback, "context" is to be the address of the FormEvent
+
+    virtual ~FormEvent();
+};
+
+#endif /* FORMEVENT_H_ */
@@ -53,6 +53,10 @@
  *           Additionally, if the same is done for the read pointer, then instead it will just put
  *           the buffer into the EMPTY state.
  *
+ *      ".promoteEntry(<offset>)" Moves the unread entry "offset" entries after the output
+ *      pointer to the front of the buffer (next to be read), the entries in between are moved
+ *      back by 1. Order of all other entries is unchanged.
+ *
  *  This class has been defined within a template format (which is why the include at the end for
  *  the source file has been added - template call needs to include declaration and definition)
  *  So to use this class, it needs to be called like this:
@@ -148,6 +152,9 @@ public:
         //  input_pointer will be set to bring the buffer to "FULL"
         //  output_pointer will be set to bring the buffer to "EMPTY"
 
+        void promoteEntry(uint16_t offset);     // Move unread entry "offset" from the output
+                                                // pointer to be the next read
+
         virtual ~GenBuffer();               // Destructor of class
 
 // Device specific entries
@@ -447,6 +454,30 @@ void GenBuffer<Typ>::readErase(uint16_t size) {
     // Otherwise, bring the input_pointer such that it is at the FULL threshold of the buffer
 }
 
+template <typename Typ>
+void GenBuffer<Typ>::promoteEntry(uint16_t offset) {
+/**************************************************************************************************
+ * Move the unread entry "offset" entries after the output_pointer, to be the next entry read (at
+ * the output_pointer). Entries between are each moved back by 1 (keeping their order).
+ * If "offset" is not within the unread entries, then nothing is changed.
+ *************************************************************************************************/
+    Typ      promoted;                      // Entry to be moved to the front
+    uint16_t position   = 0;                // Position within buffer
+
+    if (offset >= unreadCount())            // If not an unread entry, then exit
+        return;
+
+    promoted = readBuffer(output_pointer + offset);
+
+    while (offset != 0) {                   // Move each entry in between back by 1
+        position = (output_pointer + offset) % length;
+        pa[position] = readBuffer(output_pointer + offset - 1);
+        offset--;
+    }
+
+    pa[output_pointer] = promoted;          // Put entry to the front
+}
+
 template <typename Typ>
 GenBuffer<Typ>::~GenBuffer() {
 /**************************************************************************************************
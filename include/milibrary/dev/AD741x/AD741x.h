@@ -19,6 +19,10 @@
  *          Currently both devices are supported, however the additional functionality introduced
  *          within AD7414 has not been captured as of yet.
  *
+ *          If the device is behind an I2C multiplexer (i.e. more devices than address options),
+ *          then ".configMuxChannel" is to be called with the channel - all I2C transfers then
+ *          select the channel first (see "I2CPeriph").
+ *
  *      Depending upon how the programmer has setup the I2C Device, will change which of the
  *      functions listed below can be used:
  *      For function to wait for new data, or data to be transmitted utilise "poling mode":
@@ -71,6 +75,11 @@
  *      decoding occurs (as no data is read back); but Address Pointer update is retained. If
  *      request was a READ, then the data is decoded.
  *
+ *      Register reads which need the Address Pointer to be updated, are a single I2C write then
+ *      read request ("I2CPeriph" - kStart_WriteRead), repeated START between the Address Pointer
+ *      write and the read. The Address Pointer is written from within the class, so the write
+ *      buffer ("wBuff") is not used, and the write complete flag/target are not updated by reads.
+ *
  *      There is no other functionality within this class
  *************************************************************************************************/
 #ifndef AD741X_H_
@@ -216,6 +225,8 @@ public:
 
         uint16_t    _i2c_address;       // I2C Address of the device
         uint8_t     _address_pointer_;  // Stores the current state of the Address Pointer
+        uint8_t     _pointer_reg_[AD741x_RegSelMASK + 1];
+            // Address Pointer value for each register, written as part of register reads
 
     public:
         DevFlt      flt;            // Fault status of the device
@@ -252,6 +263,9 @@ public:
     public:
         AD741x(DevPart DeviceNum, AddrBit ASPin, Form *FormArray, uint16_t FormSize);
 
+        void configMuxChannel(uint8_t channel);
+        // Device is behind I2C multiplexer "channel" (see "I2CPeriph" - I2C Multiplexer)
+
 /**************************************************************************************************
  * == GEN FUNCT == >>>      GENERIC FUNCTIONS WITHIN CLASS       <<<
  *   -----------
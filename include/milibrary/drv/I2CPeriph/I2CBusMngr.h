@@ -0,0 +1,167 @@
+/**************************************************************************************************
+ * @file        I2CBusMngr.h
+ * @author      Thomas
+ * @brief       Header file for the manager of multiple I2C buses (each with its own worker)
+ **************************************************************************************************
+ @ attention
+
+ << To be Introduced >>
+
+ *************************************************************************************************/
+/**************************************************************************************************
+ * How to use
+ * ----------
+ * Linux class, which owns a number of 'I2CPeriph' instances - one per i2c-dev bus (i.e.
+ * "/dev/i2c-1", "/dev/i2c-3", etc.). Each bus has its own I2C Request Form queue, and its own
+ * interrupt emulation thread (see 'I2CPeriph' - ".startWorker"), so the buses are driven in
+ * parallel - i.e. polling a large number of sensors spread across the buses scales with the
+ * number of buses.
+ *
+ *      Call Class I2CBusMngr to initialise the class (no buses), then:
+ *          ".addBus"               - Opens the i2c-dev device, returning the handle of the bus
+ *                                    ("I2CMn_NoBus" if limit of "I2CMn_MaxBus" buses reached, or
+ *                                    the device cannot be opened).
+ *                                    Each bus has a queue of "I2CMn_Forms" I2C Request Forms
+ *          ".bus"                  - Returns the 'I2CPeriph' of the bus handle, which is then
+ *                                    provided to the device drivers (i.e. 'AD741x') - so each
+ *                                    device is routed to its bus (__null if not a valid handle)
+ *
+ *          ".startWorkers"         - Starts the interrupt emulation thread of each bus (any bus
+ *                                    added afterwards is also started). If "core" is not -1, then
+ *                                    each bus is limited to a different core (starting at "core")
+ *          ".stopWorkers"          - Stops the interrupt emulation thread of each bus
+ *
+ *      Bus utilisation and throughput is from the statistics of each 'I2CPeriph' (".readStats"),
+ *      over the time since the last reset:
+ *          ".resetStats"           - Clears the statistics of each bus, and restarts the time
+ *          ".busReport"            - Statistics of a single bus (forms, bytes, driver calls, busy
+ *                                    time), utilisation (busy time / elapsed time) and throughput
+ *          ".throughput"           - Aggregate throughput of all buses (bytes per second)
+ *          ".report"               - Writes a CSV line for each bus, and a "total" line, into the
+ *                                    provided file (i.e. stdout):
+ *              bus,device,forms,bytes,calls,busy_ns,elapsed_ns,utilisation,bytes_per_sec
+ *
+ *      There is no other functionality within this class.
+ *************************************************************************************************/
+#ifndef I2CBUSMNGR_H_
+#define I2CBUSMNGR_H_
+
+#include "FileIndex.h"
+#include <stdint.h>
+
+#include FilInd_I2CPe__HD
+
+#if defined(zz__MiRaspbPi__zz)          // If the target device is an Raspberry Pi then
+//=================================================================================================
+#include <stdio.h>                      // Include file output (CSV)
+#include <time.h>                       // Include clock
+#include <unistd.h>                     // Include sysconf (number of cores)
+
+#else
+//=================================================================================================
+#error "Unsupported target device"
+
+#endif
+
+// Defines specific within this class
+#define I2CMn_MaxBus            8       // Largest number of buses managed
+#define I2CMn_Forms             128     // Size of the I2C Request Form queue of each bus
+#define I2CMn_NoBus             0xFF    // Handle returned if bus could not be added
+
+// Types used within this class
+// Defined within the class, to ensure are contained within the correct scope
+
+class I2CBusMngr {
+/**************************************************************************************************
+ * ==   TYPES   == >>>       TYPES GENERATED WITHIN CLASS        <<<
+ *   -----------
+ *  Following types are generated within this class. If needed outside of the class, need to
+ *  state "I2CBusMngr::" followed by the type.
+ *************************************************************************************************/
+public:
+    enum class DevFlt : uint8_t {   // Fault Type of the class (internal enumerate)
+        kNone           = 0x00,     // Normal Operation
+        kBus_Limit      = 0x01,     // No space for more buses
+        kWorker_Error   = 0x02,     // Unable to start interrupt emulation thread of a bus
+        kOutput_Error   = 0x03,     // Unable to write to output file
+        kInvalid_Bus    = 0x04,     // Handle is not a bus
+        kOpen_Error     = 0x05,     // Unable to open the i2c-dev device of a bus
+
+        kInitialised    = 0xFF      // Just initialised
+    };
+
+    typedef struct {
+        I2CPeriph::BusStats Stats;          // Statistics of the bus
+        uint64_t            Elapsed;        // Time since statistics were reset (ns)
+        float               Utilisation;    // Busy time / elapsed time (0 to 1)
+        float               Throughput;     // Bytes per second
+    } BusReport;
+
+/**************************************************************************************************
+* == GEN PARAM == >>>       GENERIC PARAMETERS FOR CLASS        <<<
+*   -----------
+*  Parameters required for the class to function.
+*************************************************************************************************/
+    protected:
+        I2CPeriph::Form     _form_array_[I2CMn_MaxBus][I2CMn_Forms];
+                                            // I2C Request Form queue of each bus
+        I2CPeriph           *_bus_[I2CMn_MaxBus];   // Buses managed
+        const char          *_bus_loc_[I2CMn_MaxBus];   // Location of i2c-dev device of each bus
+
+        uint8_t             _worker_run_;   // Indicate interrupt emulation threads are running
+        int                 _worker_priority_;  // Priority of interrupt emulation threads
+        int                 _worker_core_;  // Core of first bus (-1 for any)
+
+        uint64_t            _stats_start_;  // Time statistics were reset (ns)
+
+    public:
+        uint8_t             BusCount;       // Number of buses managed
+        DevFlt              Flt;            // Fault state of the manager
+
+/**************************************************************************************************
+ * == SPC PARAM == >>>        SPECIFIC ENTRIES FOR CLASS         <<<
+ *   -----------
+ *  Following are functions and parameters which are specific for the embedded device selected.
+ *  The initialisation function for the class is also within this section, which again will be
+ *  different depending upon the embedded device selected.
+ *************************************************************************************************/
+    public:
+        I2CBusMngr(void);                   // Setup the manager (no buses)
+
+/**************************************************************************************************
+ * == GEN FUNCT == >>>      GENERIC FUNCTIONS WITHIN CLASS       <<<
+ *   -----------
+ *  The following are functions scoped within the "I2CBusMngr" class, which are generic; this
+ *  means are used by ANY of the embedded devices supported by this class.
+ *  The internals of the class, will then determine how it will be managed between the multiple
+ *  embedded devices.
+ *************************************************************************************************/
+protected:  /**************************************************************************************
+             * == PROTECTED == >>>          BUS HELPER FUNCTIONS          <<<
+             *   -----------
+             *  Functions used to start and time the buses.
+             *************************************************************************************/
+    static uint64_t timeNow(void);          // Current time (ns)
+    DevFlt startBus(uint8_t handle);        // Start interrupt emulation thread of bus
+
+public:     /**************************************************************************************
+             * ==  PUBLIC   == >>>         BUS MANAGER FUNCTIONS         <<<
+             *
+             *  Visible functions used to add, run and report upon the buses.
+             *************************************************************************************/
+    uint8_t addBus(const char *deviceloc);  // Add bus for i2c-dev device (returns handle)
+    I2CPeriph *bus(uint8_t handle);         // 'I2CPeriph' of bus (__null if not valid)
+
+    DevFlt startWorkers(int priority, int core);
+    // Start interrupt emulation thread of each bus (priority = 0 for normal, core = -1 for any)
+    void stopWorkers(void);                 // Stop interrupt emulation thread of each bus
+
+    void resetStats(void);                  // Clear statistics of each bus
+    DevFlt busReport(uint8_t handle, BusReport *Report);    // Statistics of bus
+    float throughput(void);                 // Aggregate throughput of all buses (bytes/s)
+    DevFlt report(FILE *out);               // Write CSV line for each bus, and total
+
+    virtual ~I2CBusMngr();
+};
+
+#endif /* I2CBUSMNGR_H_ */
@@ -17,6 +17,7 @@
  * The basic use of the class is the same for all target devices
  *      Call Class I2CPeriph to initialise the class
  *          For STM32L devices, providing the address of the I2C handler - from cubeMX
+ *          For RaspberryPi, providing the location of the i2c-dev device (i.e. "/dev/i2c-1")
  *
  *      Depending upon how the programmer wants to use the I2C device, will change which functions
  *      are utilised.
@@ -24,8 +25,11 @@
  *          ".poleMasterTransmit"   - Transmit data (in MASTER mode), waiting for states to be
  *                                    ready
  *          ".poleMasterReceive"    - Receive data (in MASTER mode), waiting for states to be ready
+ *          ".poleMasterWriteRead"  - Transmit then Receive data (in MASTER mode), with a repeated
+ *                                    START between (no STOP), i.e. register read
  *          ".poleDeviceRdy"        - Determine if the target I2C device is available to
  *                                    communicate
+ *          ".poleBusScan"          - Determine which addresses have a device (see below)
  *
  *      If interrupts are to be used, then will first need to be configured within the NVIC (which
  *      is not part of this class), then the following can be used:
@@ -39,6 +43,8 @@
  *          ".intMasterReq"         - Put a request for an interrupt based communication on the
  *                                    selected I2C device (utilises the I2C form system, see below)
  *                                    expects to receive an array data location
+ *          ".intMasterWriteRead"   - Put a request for a write then read (repeated START, no STOP
+ *                                    between) as a single I2C Request Form - see below
  *
  *          ".startInterrupt"       - Check to see if the I2C bus is free, and a new request form
  *                                    is available. Then trigger a communication run (enables
@@ -58,9 +64,16 @@
  *          ".writeDR"              - Will put data straight onto the hardware
  *          ".requestTransfer"      - Configures the hardware for a I2C transfer (sets up Address,
  *                                    R/~W, START/STOP, etc.)
+ *          ".reloadTransfer"       - Configures the hardware for the next chunk of a transfer
+ *                                    larger than "I2CPe_MaxNBYTES" (see below)
+ *          ".startTransfer"        - STM32 only, locks the bus and starts the transfer of the
+ *                                    current Request Form (enables the interrupts needed)
+ *          ".poleMuxSelect"        - Selects the I2C multiplexer channel of the address, if not
+ *                                    already selected (see below)
  *
  *          ".transmitEmptyChk"     - Check to see if the Transmit Empty buffer is empty
  *          ".transmitComptChk"     - Check to see if Transmission is complete
+ *          ".transferReloadChk"    - Check to see if the next chunk of the transfer is needed
  *          ".receiveToReadChk"     - Check to see if the Receive buffer is full (data to read)
  *          ".busNACKChk"           - Check to see if there has been a NACK on the BUS
  *          ".busBusyChk"           - Check to see if the BUS is busy
@@ -99,15 +112,107 @@
  *                                                   transmitted successfully)
  *          I2C communication fault return flag
  *
+ *      Forms (and polling functions) can be larger than the hardware limit of a single request
+ *      ("I2CPe_MaxNBYTES"), for STM32L the transfer is split into chunks - the hardware is put
+ *      into RELOAD mode, and at the end of each chunk (Transfer Complete Reload) the next chunk is
+ *      requested, until the last chunk which uses the mode of the form. This is done within the
+ *      interrupt (Transmit Complete interrupt is enabled for these forms), so the form is still a
+ *      single transfer on the bus.
+ *
+ *      A write then read form ("kStart_WriteRead") also contains the location and number of
+ *      packets to read. The write part is done in "kSoftEnd" mode, once complete (Transmit
+ *      Complete) the read part is started with a repeated START - STOP is only generated at the
+ *      end of the read. Communication complete return flag is updated with the amount of packets
+ *      read.
+ *
  *      Function list (all are protected):
  *          ".genericForm"          - Populate generic entries of the I2C Form (outputs structure)
  *          ".formW8bitArray"       - Link form to a 8bit array location
+ *          ".groupForm"            - Bring form for the selected multiplexer channel to the front
+ *                                    of the queue (see below)
  *          ".specificRequest"      - OVERLOADED function, for putting a request onto the target
  *                                    I2C's form queue
  *
  *          ".getFormWriteData"     - Retrieve data from I2C Form's requested location
  *          ".putFormReadData"      - Write data to location specified by current I2C Form
  *
+ *  [#] I2C Multiplexer
+ *      ~~~~~~~~~~~~~~~
+ *      Devices with the same address (i.e. multiple AD741x) can be put behind an I2C multiplexer
+ *      (TCA9548A style - single control register, bit "n" enables channel "n", channel becomes
+ *      active at the next STOP). The address of the multiplexer is provided via ".configMux".
+ *      The channel then becomes part of the device address, via "I2CPe_MuxAddr(channel, address)"
+ *      - this address is used the same as any other (Request Forms and polling functions).
+ *      Before a transfer to a device behind the multiplexer, if its channel is not the one
+ *      selected, the channel is selected (".poleMuxSelect", counted within "MuxSwitchCnt"):
+ *          STM32       - Within the interrupt, the channel select write is done first (with a
+ *                        STOP), then the form is started
+ *          RaspberryPi - Channel select is a separate driver call (for the STOP), so a change of
+ *                        channel ends the batch of forms
+ *      To reduce the number of channel changes, if the next form is for a different channel, the
+ *      next "I2CPe_GroupDepth" forms are checked for one on the selected channel - which is then
+ *      taken first (".groupForm", counted within "GroupCnt"). Order of forms to the same device is
+ *      kept, and forms are not taken from in front of a multi-form communication ("kSoftEnd"/
+ *      "kReload"/"kStop"). Upto "I2CPe_GroupLimit" forms are taken this way, before the next form
+ *      is taken in order (so cannot be starved).
+ *      Devices not behind the multiplexer are visible on every channel, so need to have a
+ *      different address to the devices behind it.
+ *
+ *  [#] Bus Scan
+ *      ~~~~~~~~
+ *      ".poleBusScan" probes each 7bit address ("I2CPe_ScanFirst" to "I2CPe_ScanLast", reserved
+ *      addresses are skipped), and returns a bitmap of the addresses which acknowledged (bit
+ *      "address & 7" of byte "address >> 3"). Optionally on an I2C multiplexer channel.
+ *      Rather than a ".poleDeviceRdy" for each address, each probe is an I2C Request Form
+ *      ("kProbe" - write with no data), queued as many as the queue has space for - so are run
+ *      back to back by the interrupts/worker. Function waits for all of the probes to complete.
+ *          STM32       - NACK and STOP interrupts are to be enabled (".configBusNACKIT",
+ *                        ".configBusSTOPIT"), a NACK faults the probe - the STOP which follows
+ *                        completes it, then the next starts
+ *          RaspberryPi - Each probe is its own driver call (the driver only indicates that a
+ *                        message within the call was not acknowledged, not which one). If the
+ *                        adapter does not support messages with no data, the probes return
+ *                        "kDriver_Error"
+ *      A fault other than a NACK is returned (bitmap still populated for the other addresses).
+ *      If a set of probes does not complete within "I2CPe_ScanTimeout" (i.e. bus is stuck), then
+ *      "kTimeout" is returned. Probes not yet started are removed (not transferred). For STM32
+ *      the probe in progress is also released, for RaspberryPi the driver call in progress is
+ *      waited for (driver has its own timeout).
+ *
+ *  [#] RaspberryPi (i2c-dev)
+ *      ~~~~~~~~~~~~~~~~~~~~~
+ *      There are no interrupts, so ".startInterrupt" will submit the queue to the i2c-dev driver
+ *      before returning (blocking). Up to "I2CPe_MaxBatch" forms are submitted within a single
+ *      "I2C_RDWR" driver call, each form being a message ("kStart_Write" or "kStart_Read"), or
+ *      a pair of messages ("kStart_WriteRead") - the driver puts a repeated START between each
+ *      message, and a STOP at the end of the call.
+ *      A form with any other request ("kStop"/"kNothing") ends the call (so the STOP is generated
+ *      at that point), and is completed with no data transferred.
+ *      The polling functions (".poleMasterTransmit", ".poleMasterReceive", ".poleDeviceRdy") are
+ *      a single message, submitted the same way.
+ *      If the driver rejects the call, each form within it has its fault flag set - "kNACK" if
+ *      a device did not acknowledge, otherwise "kDriver_Error" (driver does not indicate which
+ *      message failed).
+ *      Addresses are provided the same as STM32 (7bit address shifted up by 1).
+ *      The driver limits each message to 8192 bytes (larger is rejected - "kDriver_Error").
+ *      All calls to the driver go through "ioctl", this can be replaced with a different function
+ *      via ".linkIoctl" - so the class can be run without the hardware (i.e. simulated device).
+ *      If the i2c-dev device cannot be opened, "flt" is set to "kDriver_Error". When a function is
+ *      linked, "flt" is returned to "kInitialised" - the linked function then stands in for the
+ *      device (no device needed).
+ *
+ *      By default, ".startInterrupt" will submit the queue before returning (blocking). To have
+ *      the same non-blocking use as the STM32 devices, a worker thread can be started via
+ *      ".startWorker" (stopped via ".stopWorker") - same as 'SPIPeriph'. Each new form then wakes
+ *      the worker (via an eventfd), which submits the queue to the driver.
+ *      Each submission of the queue (worker or blocking), and each polling transfer (including
+ *      its multiplexer channel select), is a single holder of the bus (lock held for the driver
+ *      calls), so polling transfers can be called whilst the worker is running. Polling
+ *      transfers are not to be called from a completion callback (the bus is already held).
+ *      Each driver call submitting forms is counted within the bus statistics (".readStats", reset
+ *      via ".resetStats") - number of forms, bytes transferred, driver calls and time within the
+ *      driver (busy time). Used by 'I2CBusMngr' to report bus utilisation.
+ *
  *      There is no other functionality within this class.
  *************************************************************************************************/
 #ifndef I2CPeriph_H_
@@ -128,7 +233,15 @@
 
 #elif defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
 //=================================================================================================
-// Add includes specific to the Raspberry Pi
+#include <linux/i2c.h>                  // Include the Linux I2C message interface
+#include <linux/i2c-dev.h>              // Include the Linux i2c-dev interface
+#include <sys/ioctl.h>                  // Include the ioctl interface (for i2c-dev)
+#include <fcntl.h>                      // Include file open
+#include <unistd.h>                     // Include file close
+#include <errno.h>                      // Include errno (for driver faults)
+#include <pthread.h>                    // Include threads (for interrupt emulation)
+#include <sys/eventfd.h>                // Include eventfd (for waking interrupt emulation)
+#include <time.h>                       // Include clock (for bus statistics)
 
 #else
 //=================================================================================================
@@ -137,7 +250,31 @@
 #endif
 
 // Defines specific within this class
-// None
+#define I2CPe_MaxBatch          42      // Maximum number of I2C Request Forms to submit to the
+                                        // Linux i2c-dev driver within a single call
+                                        // (I2C_RDWR_IOCTL_MAX_MSGS)
+#define I2CPe_MaxNBYTES         255     // Maximum number of packets within a single hardware
+                                        // request (NBYTES), for STM32L
+
+#define I2CPe_AddrMASK          0x03FF  // Device address (without multiplexer channel)
+#define I2CPe_MuxFlag           0x8000  // Device is behind the I2C multiplexer, on channel
+#define I2CPe_MuxChanPos        12      // within bits 12 to 14 of the address
+#define I2CPe_MuxChanMASK       0x07
+#define I2CPe_MuxAddr(channel, devAddress)  ((uint16_t) (I2CPe_MuxFlag |                      \
+                                        (((channel) & I2CPe_MuxChanMASK) << I2CPe_MuxChanPos) | \
+                                        ((devAddress) & I2CPe_AddrMASK)))
+                                        // Address of device behind I2C multiplexer "channel"
+#define I2CPe_NoMux             0xFF    // Address is not behind the I2C multiplexer
+#define I2CPe_MuxUnknown        0xFE    // Selected multiplexer channel is not known
+#define I2CPe_ScanFirst         0x08    // First 7bit address probed by bus scan
+#define I2CPe_ScanLast          0x77    // Last 7bit address probed by bus scan
+#define I2CPe_ScanBytes         16      // Size of bus scan bitmap (bit per 7bit address)
+#define I2CPe_ScanTimeout       1000    // Time to wait for each set of bus scan probes (ms)
+#define I2CPe_GroupDepth        8       // Number of queued forms checked for the selected
+                                        // multiplexer channel
+#define I2CPe_GroupLimit        16      // Number of forms taken out of order (for the selected
+                                        // multiplexer channel), before the next form is taken
+                                        // in order
 
 // Types used within this class
 // Defined within the class, to ensure are contained within the correct scope
@@ -154,6 +291,8 @@ public:
         kNone            = 0x00,    // Normal Operation
         kNACK            = 0x01,    // I2C No Acknowledge
         kBus_Error       = 0x02,    // I2C Bus error
+        kDriver_Error    = 0x03,    // Linux device driver rejected the transfer
+        kTimeout         = 0x04,    // Bus scan probes did not complete in time
 
         kInitialised     = 0xFF     // Just initialised
     };
@@ -172,7 +311,11 @@ public:
                                     // request
         kStart_Write    = 1,        // Start new communication, in WRITE MODE
         kStart_Read     = 2,        // Start new communication, in READ MODE
-        kStop           = 3         // STOP current communication
+        kStop           = 3,        // STOP current communication
+        kStart_WriteRead= 4,        // Start new communication, in WRITE MODE then READ MODE
+                                    // (repeated START, no STOP between)
+        kProbe          = 5         // Start new communication, in WRITE MODE with no data - to
+                                    // check if device is present (NACK if not)
     };
 
     enum InterState : uint8_t {kIT_Enable, kIT_Disable};   // Enumerate state for enabling/
@@ -180,12 +323,18 @@ public:
     enum CommLock : uint8_t {kCommunicating, kFree};       // Enumerate state for indicating if
                                                            // device iscommunicating
 
+    typedef void (*CmpltCallback)(void *context);
+        // Function type for I2C Request Form completion callback
+
     typedef struct {            // I2C Form structure, used to manage I2C Communication interrupts
         uint16_t                devAddress; // State the I2C Address to be used
         uint16_t                size;       // State the amount of data to be transfered
 
         uint8_t                 *Buff;      // Pointer to array to contain data
 
+        uint16_t                readSize;   // State the amount of data to be read, and pointer
+        uint8_t                 *ReadBuff;  // to array to contain it ("kStart_WriteRead" only)
+
         Request                 Reqst;      // State the Request type
         CommMode                Mode;       // State the Mode
 
@@ -194,6 +343,8 @@ public:
         volatile DevFlt         *Flt;       // Provide a pointer to a I2CPeriph::DevFlt for the
                                             // I2C fault status to be provided to source
                                             // function
+        CmpltCallback           Callback;   // Function called once form is complete/faulted
+        void                    *Context;   // Context provided to "Callback"
     }   Form;
 
 /**************************************************************************************************
@@ -208,13 +359,28 @@ public:
                                             // and interrupt then goes through them sequentially.
         //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
         uint16_t        _cur_count_;        // Current communication packet count
+        uint16_t        _reload_count_;     // Packets of current communication not yet requested
+                                            // from hardware (transfers > "I2CPe_MaxNBYTES")
+        CommMode        _cur_mode_;         // Mode of current communication, once all packets
+                                            // have been requested
         Request         _cur_reqst_;        // Current request for communication (ignores "Nothing")
         Form            _cur_form_;         // Current I2C request form
 
+        uint16_t        _mux_address_;      // Address of the I2C multiplexer (0 if none)
+        uint8_t         _mux_channel_;      // Multiplexer channel selected
+        uint8_t         _mux_select_;       // Multiplexer control register data (written)
+        uint8_t         _group_count_;      // Number of forms taken out of order (grouping)
+
+        volatile DevFlt     _scan_flt_;     // Fault/complete flags of bus scan probes which
+        volatile uint16_t   _scan_cmp_;     // were cancelled (timeout)
+
     public:
         DevFlt      flt;                // Fault state of the I2C Device
         CommLock    comm_state;         // Status of the Communication
 
+        uint32_t    MuxSwitchCnt;       // Number of multiplexer channel selects
+        uint32_t    GroupCnt;           // Number of forms taken out of order (grouping)
+
 /**************************************************************************************************
  * == SPC PARAM == >>>        SPECIFIC ENTRIES FOR CLASS         <<<
  *   -----------
@@ -231,6 +397,13 @@ public:
     protected:
         I2C_HandleTypeDef  *_i2c_handle_;     // Store the I2C handle
 
+        Form                _mux_form_;     // Form waiting on the multiplexer channel select
+        uint8_t             _mux_pend_;     // Indicate multiplexer channel select is in progress
+        volatile DevFlt     _mux_flt_;      // Fault/complete flags of the multiplexer channel
+        volatile uint16_t   _mux_cmp_;      // select
+
+        void startTransfer(void);       // Start transfer of current Request Form
+
     public:
         I2CPeriph(I2C_HandleTypeDef *I2C_Handle, Form *FormArray, uint16_t FormSize);
         // Setup the I2C class, for STM32 by providing the I2C Request Form array pointer, as well
@@ -240,7 +413,57 @@ public:
 #elif defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
 //=================================================================================================
     public:
-        I2CPeriph();
+        typedef int (*IoctlFunc)(int fd, unsigned long request, void *arg);
+        // Function type for the driver calls (matches "ioctl")
+
+        typedef struct {
+            uint64_t            Forms;      // Number of I2C Request Forms completed
+            uint64_t            Bytes;      // Number of bytes transferred (write and read)
+            uint64_t            Calls;      // Number of driver calls
+            uint64_t            BusyTime;   // Time within driver calls (ns)
+        } BusStats;
+
+    private:
+        int                 _i2c_handle_;   // Stores the device to communicate too
+        const char          *_device_loc_;  // Store location file for I2C device
+        IoctlFunc           _ioctl_;        // Function used for driver calls
+
+        static int sysIoctl(int fd, unsigned long request, void *arg);
+        // Default driver call, linked to system "ioctl"
+
+        uint8_t formMessages(Form *RequestForm, struct i2c_msg *msgs);
+        // Populate the driver message(s) for the form (returns number used)
+
+        pthread_mutex_t     _queue_lock_;   // Lock for I2C Request Form queue
+        pthread_mutex_t     _bus_lock_;     // Lock for the bus, held for each submission of the
+                                            // queue, and each polling transfer
+        pthread_t           _worker_handle_;// Handle of interrupt emulation thread
+        int                 _event_fd_;     // eventfd used to wake interrupt emulation thread
+        volatile uint8_t    _worker_run_;   // Indicate interrupt emulation thread is running
+
+        static void *workerThread(void *arg);   // Interrupt emulation thread
+
+        BusStats            _stats_;        // Bus statistics (updated by driver calls)
+
+    protected:
+        DevFlt transferMessages(struct i2c_msg *msgs, uint8_t count);
+        // Submit "count" messages to driver within a single call (returns fault)
+        uint8_t transferBatch(void);    // Submit queued I2C Request Forms to driver (returns
+                                        // number of forms submitted)
+
+    public:
+        I2CPeriph(const char *deviceloc, Form *FormArray, uint16_t FormSize);
+        // Setup the I2C class, by providing the folder location of i2c-dev device, as well as
+        // the I2C Request Form array pointer, and size.
+
+        void linkIoctl(IoctlFunc func);     // Replace the function used for driver calls
+
+        DevFlt startWorker(int priority, int core); // Start interrupt emulation thread
+                                                    // (priority = 0 for normal, core = -1 for any)
+        void stopWorker(void);                      // Stop interrupt emulation thread
+
+        BusStats readStats(void);                   // Read the bus statistics
+        void resetStats(void);                      // Clear the bus statistics
 
 #else
 //=================================================================================================
@@ -273,6 +496,8 @@ protected:  /*******************************************************************
     // ~~~~~~~~~~~~~~~~~~~~~~~
     uint8_t transmitEmptyChk(void);         // Check state of transmission register (1 = empty)
     uint8_t transmitComptChk(void);         // Check state of transmission complete (1 = cmplt)
+    uint8_t transferReloadChk(void);        // Check if next chunk of transfer is needed
+                                            //                                      (1 = reload)
     uint8_t receiveToReadChk(void);         // Check state of receive data register (1 =  read)
     uint8_t busNACKChk(void);               // Check if No Acknowledge is received  (1 = NACK)
     void clearNACK(void);                   // Clear the NACK bit
@@ -298,19 +523,39 @@ protected:  /*******************************************************************
 
     // I2C Communication Request Form handling
     // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-    void requestTransfer(uint16_t devAddress, uint8_t size, CommMode mode, Request reqst);
+    void requestTransfer(uint16_t devAddress, uint16_t size, CommMode mode, Request reqst);
         // Request a new communicate via I2C device, function handles the START/STOP, R/~W setup
         // devAddress needs to be full, i.e. 7bit address needs to be provided as 8bits. The
         // R/~W will be ignored and populated as required
+    void reloadTransfer(void);
+        // Request the next chunk of the current communication (size > "I2CPe_MaxNBYTES")
 
     Form genericForm(uint16_t devAddress, uint16_t size, CommMode mode, Request reqst,
                      volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag);
 
     void formW8bitArray(Form *RequestForm, uint8_t *pData);
+    void formR8bitArray(Form *RequestForm, uint8_t *pData, uint16_t size);
 
     void specificRequest(uint16_t devAddress, uint16_t size, uint8_t *pData,
                             CommMode mode, Request reqst,
-                            volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag);
+                            volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag,
+                            CmpltCallback callback = __null, void *context = __null);
+
+    void cmpltCallback(Form *RequestForm);  // Call the form's completion callback (if linked)
+    static void scanCallback(void *context);    // Count completed bus scan probes
+    uint8_t releaseProbe(Form *RequestForm, uint16_t *done);    // Release bus scan probe
+    uint16_t cancelProbes(uint16_t *done);      // Cancel bus scan probes not complete (returns
+                                                // number cancelled)
+    static uint32_t tickNow(void);              // Current time (ms), for timeouts
+
+    // I2C Multiplexer
+    // ~~~~~~~~~~~~~~~
+    static uint8_t muxChannel(uint16_t devAddress); // Multiplexer channel of address
+                                                    // ("I2CPe_NoMux" if not behind multiplexer)
+    uint8_t muxSwitchChk(uint16_t devAddress);      // Check if channel select needed (1 = needed)
+    DevFlt poleMuxSelect(uint16_t devAddress);      // Select multiplexer channel of address
+                                                    // (bus to be held by caller)
+    void groupForm(void);   // Bring form for the selected multiplexer channel to front of queue
 
     uint8_t getFormWriteData(Form *RequestForm);
     // Function will retrieve the next data entry from the source data specified within the
@@ -326,9 +571,16 @@ public:     /*******************************************************************
              *  Visible functions used to transfer data via I2C - will wait for any registers to
              *  be in correct state before progressing.
              *************************************************************************************/
-    DevFlt poleMasterTransmit(uint16_t devAddress, uint8_t *pdata, uint8_t size);
-    DevFlt poleMasterReceive(uint16_t devAddress, uint8_t *pdata, uint8_t size);
+    DevFlt poleMasterTransmit(uint16_t devAddress, uint8_t *pdata, uint16_t size);
+    DevFlt poleMasterReceive(uint16_t devAddress, uint8_t *pdata, uint16_t size);
+    DevFlt poleMasterWriteRead(uint16_t devAddress, uint8_t *wdata, uint16_t wsize,
+                               uint8_t *rdata, uint16_t rsize);
     DevFlt poleDeviceRdy(uint16_t devAddress);
+    DevFlt poleBusScan(uint8_t *Bitmap, uint8_t channel = I2CPe_NoMux);
+    // Probe each address (on multiplexer "channel"), "Bitmap" ("I2CPe_ScanBytes") has the bit
+    // set for each address which acknowledged
+
+    void configMux(uint16_t muxAddress);    // Provide address of I2C multiplexer (0 for none)
 
 public:     /**************************************************************************************
              * ==  PUBLIC   == >>>   INTERRUPT FUNCTIONS FOR DATA TRANSFER   <<<
@@ -345,7 +597,16 @@ public:     /*******************************************************************
 
     void intMasterReq(uint16_t devAddress, uint16_t size, uint8_t *Buff,
                       CommMode mode, Request reqst,
-                      volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag);
+                      volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag,
+                      CmpltCallback callback = __null, void *context = __null);
+    // "callback" (with "context") is called once the form is complete (or NACK), from within the
+    // interrupt - see "FormEvent" (FilInd_FrmEvtHD) for a waitable callback
+
+    void intMasterWriteRead(uint16_t devAddress, uint16_t wSize, uint8_t *wBuff,
+                            uint16_t rSize, uint8_t *rBuff,
+                            volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag,
+                            CmpltCallback callback = __null, void *context = __null);
+    // Write "wSize" of "wBuff", then read "rSize" into "rBuff" as a single form (repeated START)
 
     void startInterrupt(void);              // Enable communication if bus is free, otherwise
                                             // wait (doesn't actually wait)
@@ -0,0 +1,178 @@
+/**************************************************************************************************
+ * @file        SPIBench.h
+ * @author      Thomas
+ * @brief       Header file for the SPIPeriph throughput and latency benchmark
+ **************************************************************************************************
+ @ attention
+
+ << To be Introduced >>
+
+ *************************************************************************************************/
+/**************************************************************************************************
+ * How to use
+ * ----------
+ * Linux class, which will measure the throughput and per transfer latency of 'SPIPeriph', for
+ * each of the ways of transferring data:
+ *          "polled"    - ".poleMasterTransfer", single transfer per call
+ *          "form"      - ".intMasterTransfer", single SPI Request Form, submitted by the interrupt
+ *                        emulation thread (".startWorker"). Latency includes waking the thread
+ *          "batched"   - ".intMasterTransfer", "SPIPe_MaxBatch" SPI Request Forms queued whilst
+ *                        the bus is held (".holdBus"), then submitted together (".releaseBus").
+ *                        Latency is the time of the batch divided by the number of forms
+ *      Transfer sizes are from 1 byte to 64KB (65535 bytes, largest size of a single transfer).
+ *      For spidev, all of the bytes within a single driver call are limited to the spidev buffer
+ *      ("bufsiz" module parameter, default 4096 bytes) - read at construction into "MaxSize".
+ *      Sizes are limited to "MaxSize", and a batch has fewer forms if needed to be within it.
+ *
+ *      Call Class SPIBench to initialise the class, with the spidev device location (i.e.
+ *      "/dev/spidev0.0"), speed and mode - same as 'SPIPeriph'.
+ *          If the device doesn't exist (or __null is provided), then the driver calls are
+ *          replaced with a loop back (".loopback" - read back data is a copy of the transmit
+ *          data). So can be run on any Linux host, measuring the overhead of the class itself.
+ *
+ *          ".run"                  - Runs each mode for each size, "iterations" times, writing a
+ *                                    CSV line for each into the provided file (i.e. stdout),
+ *                                    after a header line (".header")
+ *          ".runMode"              - Runs a single mode and size, writing a single CSV line
+ *
+ *      Each CSV line contains:
+ *          backend                 - "loopback" or "spidev"
+ *          mode                    - "polled", "form" or "batched"
+ *          size                    - Bytes per transfer
+ *          transfers               - Number of transfers
+ *          faults                  - Number of transfers which returned a fault
+ *          mismatches              - Number of transfers where read back data differs from the
+ *                                    transmit data (for spidev, needs MOSI linked to MISO)
+ *          total_ns                - Total time of all transfers
+ *          bytes_per_sec           - Throughput
+ *          lat_min_ns, lat_p50_ns, lat_p99_ns, lat_max_ns
+ *                                  - Per transfer latency (CLOCK_MONOTONIC_RAW)
+ *
+ *      There is no other functionality within this class.
+ *************************************************************************************************/
+#ifndef SPIBENCH_H_
+#define SPIBENCH_H_
+
+#include "FileIndex.h"
+#include <stdint.h>
+
+#include FilInd_SPIPe__HD
+
+#if defined(zz__MiRaspbPi__zz)          // If the target device is an Raspberry Pi then
+//=================================================================================================
+#include <stdio.h>                      // Include file output (CSV)
+#include <stdlib.h>                     // Include qsort
+#include <string.h>                     // Include memset, memcpy, memcmp
+#include <time.h>                       // Include clock
+#include <unistd.h>                     // Include access
+
+#else
+//=================================================================================================
+#error "Unsupported target device"
+
+#endif
+
+// Defines specific within this class
+#define SPIBch_Forms            64      // Size of the SPI Request Form queue
+#define SPIBch_MaxSize          65535   // Largest transfer (bytes)
+#define SPIBch_MaxIter          1000    // Largest number of iterations (latency samples)
+#define SPIBch_BufsizLoc        "/sys/module/spidev/parameters/bufsiz"
+                                        // spidev buffer size (largest bytes in a driver call)
+#define SPIBch_BufsizDef        4096    // spidev buffer size, if unable to be read
+
+// Types used within this class
+// Defined within the class, to ensure are contained within the correct scope
+
+class SPIBench {
+/**************************************************************************************************
+ * ==   TYPES   == >>>       TYPES GENERATED WITHIN CLASS        <<<
+ *   -----------
+ *  Following types are generated within this class. If needed outside of the class, need to
+ *  state "SPIBench::" followed by the type.
+ *************************************************************************************************/
+public:
+    enum class DevFlt : uint8_t {   // Fault Type of the class (internal enumerate)
+        kNone           = 0x00,     // Normal Operation
+        kOutput_Error   = 0x01,     // Unable to write to output file
+        kWorker_Error   = 0x02,     // Unable to start interrupt emulation thread ("form" mode)
+
+        kInitialised    = 0xFF      // Just initialised
+    };
+
+    enum BenchMode : uint8_t { kPolled = 0, kForm = 1, kBatched = 2 };
+        // Enumerate type used to indicate the way of transferring data
+
+    enum Backend : uint8_t { kLoopback = 0, kSpidev = 1 };
+        // Enumerate type used to indicate where the driver calls go
+
+/**************************************************************************************************
+* == GEN PARAM == >>>       GENERIC PARAMETERS FOR CLASS        <<<
+*   -----------
+*  Parameters required for the class to function.
+*************************************************************************************************/
+    protected:
+        SPIPeriph::Form     _form_array_[SPIBch_Forms]; // SPI Request Form queue
+        SPIPeriph           _spi_;          // SPI device being measured
+
+        uint8_t             _tx_buff_[SPIBch_MaxSize];  // Transmit data
+        uint8_t             _rx_buff_[SPIBch_MaxSize];  // Read back data
+        uint32_t            _latency_[SPIBch_MaxIter];  // Latency of each transfer (ns)
+
+    public:
+        Backend             Back;           // Where the driver calls go
+        uint32_t            MaxSize;        // Largest bytes within a single driver call
+        DevFlt              Flt;            // Fault state of the benchmark
+
+/**************************************************************************************************
+ * == SPC PARAM == >>>        SPECIFIC ENTRIES FOR CLASS         <<<
+ *   -----------
+ *  Following are functions and parameters which are specific for the embedded device selected.
+ *  The initialisation function for the class is also within this section, which again will be
+ *  different depending upon the embedded device selected.
+ *************************************************************************************************/
+    public:
+        SPIBench(const char *deviceloc, int speed, SPIPeriph::SPIMode Mode);
+        // Setup the benchmark, for the spidev device (loop back if device doesn't exist, or is
+        // __null)
+
+/**************************************************************************************************
+ * == GEN FUNCT == >>>      GENERIC FUNCTIONS WITHIN CLASS       <<<
+ *   -----------
+ *  The following are functions scoped within the "SPIBench" class, which are generic; this means
+ *  are used by ANY of the embedded devices supported by this class.
+ *  The internals of the class, will then determine how it will be managed between the multiple
+ *  embedded devices.
+ *************************************************************************************************/
+protected:  /**************************************************************************************
+             * == PROTECTED == >>>        BENCHMARK HELPER FUNCTIONS         <<<
+             *   -----------
+             *  Functions used to time and summarise the transfers.
+             *************************************************************************************/
+    static uint32_t driverLimit(void);      // spidev buffer size (bytes)
+    static uint64_t timeNow(void);          // Current time (ns)
+    static int compareLatency(const void *first, const void *second);   // Sort order (qsort)
+
+    uint32_t transferPolled(uint16_t size, uint32_t *faults);
+    uint32_t transferForm(uint16_t size, uint32_t *faults);
+    uint32_t transferBatched(uint16_t size, uint8_t batch, uint32_t *faults);
+    // Single iteration of each mode, returns the latency (ns). Number of faulted transfers is
+    // added to "faults"
+
+public:     /**************************************************************************************
+             * ==  PUBLIC   == >>>        BENCHMARK FUNCTIONS        <<<
+             *
+             *  Visible functions used to run the benchmark.
+             *************************************************************************************/
+    static int loopback(int fd, unsigned long request, void *arg);
+    // Driver call loop back, for "SPIPeriph.linkIoctl" (read back data is copy of transmit)
+
+    DevFlt header(FILE *out);               // Write CSV header line
+    DevFlt runMode(FILE *out, BenchMode mode, uint16_t size, uint16_t iterations);
+    // Run "mode" at "size", "iterations" times - writing a CSV line
+    DevFlt run(FILE *out, uint16_t iterations);
+    // Run all modes and sizes, "iterations" times each - writing the header and CSV lines
+
+    virtual ~SPIBench();
+};
+
+#endif /* SPIBENCH_H_ */
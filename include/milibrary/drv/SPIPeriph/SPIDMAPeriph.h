@@ -0,0 +1,197 @@
+/**************************************************************************************************
+ * @file        SPIDMAPeriph.h
+ * @author      Thomas
+ * @brief       Header file for the Generic SPI with DMA Class handle
+ **************************************************************************************************
+ @ attention
+
+ << To be Introduced >>
+
+ *************************************************************************************************/
+/**************************************************************************************************
+ * How to use
+ * ----------
+ * This class combines together 'SPIPeriph' and the 'DMAPeriph' classes, granting the capability
+ * to utilise DMAs for SPI communication within the embedded device - reducing the CPU load.
+ * This class only supports embedded devices which have a DMA connected to the SPI, supported
+ * devices:
+ *  STM32
+ *
+ * As SPI is full duplex, both a Transmit and Receive DMA are required (the Transmit DMA drives
+ * the clock, the Receive DMA captures the data). If either handle is not provided (__null), then
+ * the class will behave the same as 'SPIPeriph' (interrupt driven).
+ * The DMAs are expected to be configured via STM32CubeMX (Normal mode, not circular), the data
+ * size and memory increment are updated by this class for each SPI Request Form.
+ *
+ * The CPU is then only involved at the start and completion of each SPI Request Form. The next
+ * form within the queue is started from the Receive DMA complete interrupt (so back to back
+ * forms are chained, including coalescing of forms to the same device - see ".configCoalesce").
+ *
+ *      The following 'SPIPeriph' functions will be redefined for use with DMA:
+ *          ".startTransfer"        - If DMA is enabled, and the current form is able to be
+ *                                    transferred by DMA, then both DMAs are configured to manage
+ *                                    the communication. Otherwise logic is the same as
+ *                                    'SPIPeriph' (interrupts enabled)
+ *            #####################################################################################
+ *            ## NOTE-> Scatter-gather forms (".formSegments") are not transferred by DMA, and
+ *            ##        will use the 'SPIPeriph' interrupts
+ *            #####################################################################################
+ *          ".intReqFormCmplt"      - Will tidy up the current request, with DMA enabled it will
+ *                                    retrieve number of data points transferred from the Receive
+ *                                    DMA registers, and then disable the DMAs
+ *
+ *      The following functions will be added, so as to manage the DMA interrupts
+ *          ".handleDMATxIRQ"       - Functions to be placed within the relevant Interrupt Vector
+ *                                    call, for DMA linked to Transmit, so as to handle interrupts
+ *          ".handleDMARxIRQ"       - Functions to be placed within the relevant Interrupt Vector
+ *                                    call, for DMA linked to Receive, so as to handle interrupts
+ *
+ *      ".handleIRQ" is still to be placed within the SPI Interrupt Vector, so as to capture bus
+ *      faults (and progress any forms not transferred by DMA).
+ *
+ *      The following functions will be added, so as to stream a command into a 'GenBuffer' (see
+ *      "SPIPeriph" - SPI Stream), with no CPU use per sample:
+ *          ".startStream"          - Starts the stream, a timer (configured via STM32CubeMX for
+ *                                    the period) requests a DMA (linked to the timer update
+ *                                    event) to write the command to the SPI a frame at a time.
+ *                                    The Receive DMA is put into circular mode, so the replies
+ *                                    are put straight into the 'GenBuffer'
+ *            #####################################################################################
+ *            ## NOTE-> The timer is a frame at a time, so for a command of "size" frames the
+ *            ##        period of each sample is "size" timer periods. Timer and its DMA are
+ *            ##        dedicated to the stream (enabled/disabled by this class). Timer period
+ *            ##        needs to be longer than a frame.
+ *            ##        Hardware managed Chip Select is used, for devices which require the Chip
+ *            ##        Select to be released between each frame, the NSS pulse mode (STM32L)
+ *            ##        is to be enabled via STM32CubeMX
+ *            #####################################################################################
+ *          ".updateStream"         - Update the "input_pointer" of the 'GenBuffer' to the last
+ *                                    complete sample (from the Receive DMA count register), to be
+ *                                    called prior to reading the 'GenBuffer'
+ *          ".stopStream"           - Stops the stream, any forms requested whilst the stream was
+ *                                    running are then started (waits for the last frame, so not
+ *                                    to be called from an interrupt). If the Receive DMA faults,
+ *                                    the stream is stopped within ".handleDMARxIRQ" without
+ *                                    waiting, and the class fault is set to "kDMA_Rx_Error"
+ *
+ *      There is no other functionality within this class.
+ *************************************************************************************************/
+#ifndef SPIDMAPeriph_H_
+#define SPIDMAPeriph_H_
+
+#include "FileIndex.h"
+#include <stdint.h>
+
+#include FilInd_SPIPe__HD
+#include FilInd_DMAPe__HD
+
+#if   defined(zz__MiSTM32Fx__zz)        // If the target device is an STM32Fxx from cubeMX then
+//=================================================================================================
+#include "stm32f1xx_hal.h"              // Include the HAL library
+
+#elif defined(zz__MiSTM32Lx__zz)        // If the target device is an STM32Lxx from cubeMX then
+//=================================================================================================
+#include "stm32l4xx_hal.h"              // Include the HAL library
+
+#elif defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
+//=================================================================================================
+#error "Unsupported target device"
+
+#else
+//=================================================================================================
+#error "Unrecognised target device"
+
+#endif
+
+// Defines specific within this class
+// None
+
+// Types used within this class
+// Defined within the class, to ensure are contained within the correct scope
+
+class SPIDMAPeriph : public SPIPeriph, public DMAPeriph {
+/**************************************************************************************************
+ * ==   TYPES   == >>>       TYPES GENERATED WITHIN CLASS        <<<
+ *   -----------
+ *  Following types are generated within this class. If needed outside of the class, need to
+ *  state "SPIDMAPeriph::" followed by the type.
+ *************************************************************************************************/
+// None (inherited from both SPIPeriph and DMAPeriph)
+
+/**************************************************************************************************
+* == GEN PARAM == >>>       GENERIC PARAMETERS FOR CLASS        <<<
+*   -----------
+*  Parameters required for the class to function.
+*************************************************************************************************/
+    protected:
+        DMA_HandleTypeDef   *_dma_rx_;      // Store the SPI DMA handle (Receive)
+        DMA_HandleTypeDef   *_dma_tx_;      // Store the SPI DMA handle (Transmit)
+
+        DMAMode             _dma_mode_;     // DMA Communication Mode (both Transmit/Receive)
+        DMAMode             _dma_active_;   // Indicate if current form is transferred by DMA
+
+        uint16_t            _dummy_tx_;     // Data transmitted for forms with no write data
+        uint16_t            _dummy_rx_;     // Location for data read for forms with no read data
+
+        TIM_HandleTypeDef   *_cadence_tim_; // Timer setting period of stream
+        DMA_HandleTypeDef   *_cadence_dma_; // DMA writing stream command (timer update request)
+
+/**************************************************************************************************
+ * == SPC PARAM == >>>        SPECIFIC ENTRIES FOR CLASS         <<<
+ *   -----------
+ *  Following are functions and parameters which are specific for the embedded device selected.
+ *  The initialisation function for the class is also within this section, which again will be
+ *  different depending upon the embedded device selected.
+ *************************************************************************************************/
+
+public:
+    SPIDMAPeriph(SPI_HandleTypeDef *SPIHandle, Form *FormArray, uint16_t FormSize,
+                 DMA_HandleTypeDef *DMA_Rx_Handle, DMA_HandleTypeDef *DMA_Tx_Handle);
+
+/**************************************************************************************************
+ * == GEN FUNCT == >>>      GENERIC FUNCTIONS WITHIN CLASS       <<<
+ *   -----------
+ *  The following are functions scoped within the "SPIDMAPeriph" class, which are generic; this
+ *  means are used by ANY of the embedded devices supported by this class.
+ *  The internals of the class, will then determine how it will be managed between the multiple
+ *  embedded devices.
+ *************************************************************************************************/
+protected:  /**************************************************************************************
+             * == PROTECTED == >>>     DIRECT HARDWARE READING FUNCTIONS     <<<
+             *   -----------
+             *  Functions allow direct access to the hardware/base functions of this class. Are
+             *  not visible unless "friend" or "child"/inherited
+             *************************************************************************************/
+    uint32_t configDMA(DMA_HandleTypeDef *hdma, DataWidth width, uint8_t *Buff, uint16_t *Dummy);
+    // Configure the DMA data size (as per "width"), and memory increment (disabled if using the
+    // dummy location). Returns the memory address for the DMA
+    void stopDMA(void);                 // Disable both DMAs, and link from SPI
+    void stopCadence(void);             // Stop the stream timer, and its DMA
+    void closeStream(void);             // Stop the stream Receive DMA, and free the bus (no wait)
+
+public:     /**************************************************************************************
+             * ==  PUBLIC   == >>>      DMA FUNCTIONS FOR DATA TRANSFER      <<<
+             *
+             *  Following functions are redefinitions of 'SPIPeriph', functions such as to allow
+             *  interfacing with DMAs
+             *************************************************************************************/
+    void startTransfer(void);           // Start transfer of current Request Form (DMA if
+                                        // possible)
+    void intReqFormCmplt(void);         // Closes out the input Request Form
+
+// SPI/DMA specific functions
+    void handleDMATxIRQ(void);          // Interrupt handler for DMA Transmit
+    void handleDMARxIRQ(void);          // Interrupt handler for DMA Receive
+
+    DevFlt startStream(const uint8_t *Command, uint16_t size, DataWidth width,
+                       GenBuffer<uint8_t> *ReadArray,
+                       TIM_HandleTypeDef *Cadence, DMA_HandleTypeDef *CadenceDMA);
+    // Start stream of "Command" ("size" frames), a frame written each "Cadence" timer update
+    // (via "CadenceDMA"), with each reply put into "ReadArray"
+    void updateStream(void);            // Update "ReadArray" to last complete sample
+    void stopStream(void);              // Stop stream
+
+    virtual ~SPIDMAPeriph();
+};
+
+#endif /* SPIDMAPERIPH_H_ */
@@ -17,7 +17,8 @@
  *      Call Class SPIPeriph to initialise the class
  *          For STM32F devices, provide the address of the SPI handler - from cubeMX
  *          For STM32L devices, provide the address of the SPI handler - from cubeMX
- *          For RaspberryPi, provide the channel, speed and mode
+ *          For RaspberryPi, provide the spidev device location (i.e. "/dev/spidev0.0"), speed,
+ *          mode, and the SPI Request Form array (as per STM32)
  *
  *      Depending upon how the programmer wants to use the SPI device, will change which functions
  *      are utilised.
@@ -25,6 +26,8 @@
  *          ".poleMasterTransfer"   - OVERLOADED function for SPI communication
  *                                    (input varies the GPIO or DEMUX devices to select SPI, or
  *                                    hardware managed)
+ *                                    If no read location is provided (__null), then will only
+ *                                    transmit
  *
  *      If interrupts are to be used, then will first need to be configured within the NVIC (which
  *      is not part of this class), then the following can be used:
@@ -35,15 +38,32 @@
  *          ".intMasterTransfer"    - OVERLOADED function for SPI communication in interrupt mode
  *                                    (utilises the SPI form system, see below), expects to
  *                                    receive an array data location.
- *                                    (input varies for GPIO or hardware managed Chip Select)
+ *                                    (input varies for GPIO or hardware managed Chip Select, and
+ *                                    8bit/16bit/32bit array - which sets the frame size)
  *
  *          ".startInterrupt"       - Check to see if the SPI bus is free, and a new request form
  *                                    is available. Then trigger a communication run (enables
  *                                    Transmit Empty/Receive interrupts)
+ *                                    For RaspberryPi, there are no interrupts, so the queue is
+ *                                    drained through the spidev driver - with up to
+ *                                    "SPIPe_MaxBatch" forms submitted within a single
+ *                                    "SPI_IOC_MESSAGE" (Chip Select is released between each)
+ *          ".startTransfer"        - Start the transfer of the current Request Form (enables
+ *                                    Transmit Empty/Receive interrupts), overridden by
+ *                                    "SPIDMAPeriph" to use DMA
  *          ".intReqFormCmplt"      - Function will go through tidy up procedure for the current
  *                                    Request Form
+ *          ".configCoalesce"       - Enable/Disable coalescing of consecutive Request Forms to
+ *                                    the same Chip Select (device is kept selected between them,
+ *                                    so saves the Chip Select toggle, and the restart of the
+ *                                    interrupts). Number of forms coalesced is in "CoalesceCnt"
  *          ".handleIRQ"            - Functions to be placed within the relevant Interrupt Vector
  *                                    call, so as to handle the SPI interrupt
+ *          ".configDevice"         - Set the speed, mode and bit order for a device (Chip
+ *                                    Select), see below
+ *          ".startStream"          - Repeat a command at a fixed period, with each reply put into
+ *          ".stopStream"             a 'GenBuffer' (RaspberryPi, STM32 within "SPIDMAPeriph"),
+ *                                    see below
  *
  *      Following functions are protected so will only work for classes which inherit from this
  *      one, and are not visible external to this class. They contain the lower level handling
@@ -53,14 +73,23 @@
  *
  *          ".readDR"               - Will take data straight from hardware
  *          ".writeDR"              - Will put data straight onto the hardware
+ *          ".readDRPacked"         - Will take 2x 8bit frames straight from hardware (STM32L)
+ *          ".writeDRPacked"        - Will put 2x 8bit frames straight onto the hardware (STM32L)
+ *          ".configDataWidth"      - Configure the hardware data width (frame size)
+ *          ".configBus"            - Configure the hardware speed, mode and bit order
+ *          ".fillTransmitFIFO"     - Fill the hardware TXFIFO from the current form (STM32L)
+ *          ".drainReceiveFIFO"     - Empty the hardware RXFIFO into the current form (STM32L)
  *
  *          ".hardwareCS"           - Generate the struct as a Hardware Chip Select
  *          ".softwareGPIO"         - Generate the struct as a Software GPIO Chip Select
  *          ".chipSelectHandle"     - Will handle selecting/deselecting the SPI device (using the
  *                                    above structs)
+ *          ".deviceConfig"         - Bus configuration of the device (as per ".configDevice")
  *
  *          ".transmitEmptyChk"     - Check to see if the Transmit Empty buffer is empty
  *          ".receiveToReadChk"     - Check to see if the Receive buffer is full (data to read)
+ *          ".transmitFIFOLvl"      - Level of the Transmit FIFO (STM32L)
+ *          ".receiveFIFOLvl"       - Level of the Receive FIFO (STM32L)
  *          ".busBusyChk"           - Check to see if the BUS is busy
  *          ".busOverRunChk"        - Check to see if a BUS overrun has occurred
  *          ".busModeFltChk"        - Check to see if a BUS mode fault has occurred
@@ -84,19 +113,165 @@
  *      the target SPI device Form queue, such that the SPI device can go through each of these
  *      forms in sequence; each form will contain the following:
  *          Target device's Chip Select management (hardware/software)
- *          Number of packets to transmit/receive (8bits x N)
+ *          Number of packets to transmit/receive (8bits, 16bits or 32bits x N)
  *          Location for where the data is to be taken/stored
  *          Communication complete return flag      (will be updated with the amount of packets
  *                                                   transmitted successfully)
  *          SPI communication fault return flag
+ *          Completion callback (optional), function and context - called once the form is
+ *                                                   complete, or a fault has been detected
  *
  *      Function list (all are protected):
  *          ".genericForm"          - Populate generic entries of the SPI Form (outputs structure)
  *          ".formW8bitArray"       - Link form to a 8bit array location
+ *          ".formW16bitArray"      - Link form to a 16bit array location (16bit frames)
+ *          ".formW32bitArray"      - Link form to a 32bit array location (32bit frames)
+ *          ".formSegments"         - Link form to scatter-gather segment lists
+ *          ".formCallback"         - Link form to a completion callback
+ *          ".cmpltCallback"        - Call the completion callback of the form (if linked)
+ *          ".queueForm"            - Add form to the queue of the requested priority
+ *          ".selectQueue"          - Determine which priority queue is to be served next
+ *          ".takeForm"             - Remove form from the selected priority queue
+ *          ".groupForm"            - Bring form with the same bus configuration to the front of
+ *                                    the selected priority queue
  *
  *          ".getFormWriteData"     - Retrieve data from SPI Form's requested location
  *          ".putFormReadData"      - Write data to location specified by current SPI Form
  *
+ *  [#] SPI Request Form Completion Callback
+ *      ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *      The interrupt based functions can be provided a callback function (and context), which is
+ *      called once the form has been completed (after the complete flag is updated), or faulted.
+ *      So dependent work can be started straight away, rather than polling the flags.
+ *      For STM32 the callback is called from within the interrupt, and for RaspberryPi from the
+ *      interrupt emulation thread (or the requesting thread) - so needs to be short, and can
+ *      request new forms (but not wait upon them).
+ *      "FormEvent" (FilInd_FrmEvtHD) provides a waitable event, which can be used as the callback.
+ *
+ *  [#] SPI Request Form Scatter-Gather
+ *      ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *      Instead of single arrays, a form can be provided a list of segments ("Segment" - pointer
+ *      and number of 8bit packets) for transmit, and for receive. The segments are walked through
+ *      in order, within a single Chip Select - i.e. a command header and payload, or a reply split
+ *      into different locations - without having to copy into a single array first.
+ *      A segment with a __null pointer transmits 0s, or discards the read back data.
+ *      Both lists need to have the same total number of packets. The lists (and data) need to
+ *      remain valid until the form is complete.
+ *      For RaspberryPi, each change of segment is a separate transfer within the driver call (so
+ *      counts towards "SPIPe_MaxBatch").
+ *
+ *  [#] SPI Request Form Data Width
+ *      ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *      Each form states the data width (frame size) of its data, so that a 16bit device can be
+ *      communicated with in whole 16bit frames (half the number of interrupts/FIFO accesses of
+ *      8bit). The hardware is configured to the form's width (".configDataWidth") prior to its
+ *      transfer:
+ *          STM32       - DFF bit (STM32F) or DS bits (STM32L), 8bit or 16bit only. 32bit forms
+ *                        are rejected ("kData_Size")
+ *          RaspberryPi - "bits_per_word" of the transfer (the spidev controller needs to support
+ *                        the width, otherwise the driver will reject - "kDriver_Error").
+ *                        Data is in the native format of the array (i.e. not byte swapped)
+ *      Polling functions are 8bit only.
+ *
+ *  [#] SPI Device Configuration
+ *      ~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *      Each device (Chip Select) can be given its own speed, mode and bit order via
+ *      ".configDevice" (upto "SPIPe_MaxDevices" devices, hardware managed Chip Select is
+ *      __null). Devices not configured use the settings provided to the constructor (STM32 - as
+ *      configured by cubeMX). To be called prior to requesting forms for the device, as the
+ *      configuration is captured within the Chip Select of each form ("CSHandle.Config").
+ *      The speed is rounded down to the fastest speed the hardware can achieve:
+ *          STM32       - Peripheral clock / 2, 4, ... 256 (SPI1 on PCLK2, others on PCLK1)
+ *          RaspberryPi - Left to the spidev driver
+ *
+ *      The hardware is only reconfigured when the configuration of the next form is different
+ *      (".configBus", counted within "ReconfigCnt"). To reduce this, if the next form is for a
+ *      different configuration, the next "SPIPe_GroupDepth" forms of the same priority are
+ *      checked for one with the current configuration - which is then taken first (counted
+ *      within "GroupCnt"). Order of forms to the same device is kept. Upto "SPIPe_GroupLimit"
+ *      forms are taken this way, before the next form is taken in order (so cannot be starved).
+ *      For RaspberryPi, speed is stated per transfer - so only a change of mode or bit order
+ *      requires a reconfiguration (and ends the driver call, see ".transferBatch").
+ *      Polling functions use the configuration of the device, or the hardware managed Chip
+ *      Select configuration if using DeMux.
+ *
+ *  [#] SPI Request Form Priority
+ *      ~~~~~~~~~~~~~~~~~~~~~~~~~
+ *      Forms can be requested at one of 3 priorities ("kHigh", "kNormal", "kLow") - via the last
+ *      input to ".intMasterTransfer" (defaults to "kNormal"). The form array provided to the
+ *      constructor is the "kNormal" queue, separate arrays for the other priorities are linked
+ *      via ".linkPriorityQueue" (if not linked, forms of that priority are put into the "kNormal"
+ *      queue).
+ *      The highest priority form is always taken next, unless a lower priority form has been
+ *      waiting whilst "SPIPe_AgeLimit" forms have been taken from higher priority queues - in
+ *      which case it is taken next (so lower priority forms cannot be starved).
+ *
+ *      The time each form waits within its queue is captured within "QueueWait" (one entry per
+ *      priority) - count, maximum, total and a log2 histogram (so the tail latency can be
+ *      determined). Cleared via ".resetQueueWait". Forms put into the "kNormal" queue (as their
+ *      queue is not linked) are captured as "kNormal".
+ *      Time is in ticks of ".timeStamp":
+ *          STM32       - Core clock cycles (DWT->CYCCNT, the DWT cycle counter needs to be
+ *                        enabled outside of this class)
+ *          RaspberryPi - Nanoseconds (CLOCK_MONOTONIC_RAW)
+ *
+ *  [#] SPI Request Form Tracing
+ *      ~~~~~~~~~~~~~~~~~~~~~~~~~
+ *      If "SPI_TRACE_ENABLE" is defined (build flag), each form is also timestamped when it
+ *      starts (device selected) and completes. Which are captured within (same format as
+ *      "QueueWait", ticks of ".timeStamp"):
+ *          "WireTime"              - Time from start to completion
+ *          "FormTime"              - Time from being queued to completion
+ *          "TraceBytes"            - Total bytes transferred
+ *          ".traceThroughput"      - Bytes per second since the previous call
+ *          ".resetTrace"           - Clear all of the above
+ *      For RaspberryPi, all forms within a single driver call share the same start/completion
+ *      time.
+ *      If not defined, none of the above (or the timestamping) is included.
+ *
+ *  [#] SPI Stream
+ *      ~~~~~~~~~~
+ *      For high rate sampling (i.e. encoders), a fixed command ("size" frames) can be repeated
+ *      at a fixed period, with each reply put straight into a 'GenBuffer' - no SPI Request Form
+ *      per sample. The 'GenBuffer' is used as a ring (same as "UARTDMAPeriph.readGenBufferLock"),
+ *      so needs to be a whole number of samples (otherwise "kData_Size"), the "input_pointer" is
+ *      moved forward a sample at a time. If not read in time, samples are overwritten.
+ *      Stream uses the hardware managed Chip Select (and its bus configuration).
+ *          RaspberryPi - Run by the interrupt emulation thread (".startWorker"), "SPIPe_StreamBatch"
+ *                        samples are submitted within each driver call (straight into the
+ *                        'GenBuffer'), with "input_pointer" updated once the call is complete.
+ *                        Period is the time from the start of each sample, with the remainder
+ *                        after the sample being a delay ("delay_usecs") - timing within the call
+ *                        is by the driver, with a small gap between calls. Any forms requested
+ *                        are submitted between calls.
+ *          STM32       - See "SPIDMAPeriph", no CPU use per sample
+ *
+ *  [#] RaspberryPi (spidev)
+ *      ~~~~~~~~~~~~~~~~~~~~
+ *      Hardware managed Chip Select, is the Chip Select of the spidev device opened. Forms which
+ *      use a software GPIO Chip Select are submitted on their own (GPIO is selected either side
+ *      of the driver call).
+ *      All calls to the driver go through "ioctl", this can be replaced with a different function
+ *      via ".linkIoctl" - so the class can be run without the hardware (i.e. loop back of data).
+ *      If the spidev device cannot be opened/configured, "Flt" is set to "kDriver_Error". When a
+ *      function is linked, the configuration (mode, speed, data size) is sent through it, and
+ *      "Flt" updated - the linked function then stands in for the device (no device needed).
+ *
+ *      By default, ".startInterrupt" will submit the queue before returning (blocking). To have
+ *      the same non-blocking use as the STM32 devices, a worker thread can be started via
+ *      ".startWorker" (stopped via ".stopWorker") - which emulates the interrupt vector. Each new
+ *      form then wakes the worker (via an eventfd), which submits the queue to the driver, and
+ *      updates the complete/fault flags of each form (release ordering, so the read back data is
+ *      visible once the complete flag has been updated).
+ *      The worker can be run at real-time priority (SCHED_FIFO), and limited to a single core.
+ *      Each submission of the queue (worker or blocking), and each polling transfer, is a single
+ *      holder of the bus (lock held for the driver calls), so polling transfers can be called
+ *      whilst the worker is running. Polling transfers are not to be called from a completion
+ *      callback (the bus is already held).
+ *      The bus can be held (".holdBus"), so forms are queued rather than submitted - then on
+ *      release (".releaseBus") the queue is submitted together (fewest driver calls). No polling
+ *      transfers whilst held, and to be released by the same thread.
+ *
  *      There is no other functionality within this class
  *************************************************************************************************/
 #ifndef SPIPeriph_H_
@@ -119,7 +294,15 @@
 
 #elif defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
 //=================================================================================================
-#include <wiringPiSPI.h>                // Include the wiringPi SPI library
+#include <linux/spi/spidev.h>           // Include the Linux SPI device interface
+#include <sys/ioctl.h>                  // Include the ioctl interface (for spidev)
+#include <fcntl.h>                      // Include file open
+#include <unistd.h>                     // Include file close
+#include <string.h>                     // Include memset
+#include <pthread.h>                    // Include threads (for interrupt emulation)
+#include <sys/eventfd.h>                // Include eventfd (for waking interrupt emulation)
+#include <errno.h>                      // Include errno (for interrupted eventfd wake)
+#include <time.h>                       // Include clock (for queue wait timing)
 
 #else
 //=================================================================================================
@@ -128,7 +311,24 @@
 #endif
 
 // Defines specific within this class
-// None
+#define SPIPe_MaxBatch          32      // Maximum number of SPI Request Forms to submit to the
+                                        // Linux spidev driver within a single call
+#define SPIPe_NumPriority       3       // Number of SPI Request Form priorities (queues)
+#define SPIPe_AgeLimit          8       // Number of forms taken from higher priority queues,
+                                        // whilst a lower priority form waits, before the lower
+                                        // priority form is taken next
+#define SPIPe_WaitBins          33      // Number of bins within queue wait histogram (log2)
+#define SPIPe_FIFODepth         4       // Size of the hardware TX/RX FIFOs (bytes), for STM32L
+#define SPIPe_FIFOHalf          2       // FIFO level (quarters) - half full
+#define SPIPe_FIFOFull          3       // FIFO level (quarters) - full
+#define SPIPe_MaxDevices        8       // Number of devices which can be given their own
+                                        // speed/mode/bit order (".configDevice")
+#define SPIPe_GroupDepth        4       // Number of queued forms checked for the same bus
+                                        // configuration as the current
+#define SPIPe_GroupLimit        8       // Number of forms taken out of order (for the same bus
+                                        // configuration), before the next form is taken in order
+#define SPIPe_StreamBatch       64      // Number of stream samples to submit to the Linux spidev
+                                        // driver within a single call
 
 // Types used within this class
 // Defined within the class, to ensure are contained within the correct scope
@@ -148,6 +348,11 @@ public:
         kFrame_Format   = 0x03,     // Frame format error
         kCRC_Error      = 0x04,     // CRC Error detected
         kData_Size      = 0x05,     // Error with the size request of data
+        kDriver_Error   = 0x06,     // Linux device driver rejected the transfer
+        kDMA_Tx_Error   = 0x07,     // DMA Transmit fault has occurred (SPIDMAPeriph)
+        kDMA_Rx_Error   = 0x08,     // DMA Receive fault has occurred  (SPIDMAPeriph)
+        kDevice_Limit   = 0x09,     // No space for device configuration ("SPIPe_MaxDevices")
+        kStream_Error   = 0x0A,     // Stream cannot be started (already running, or bus in use)
 
         kInitialised    = 0xFF      // Just initialised
     };
@@ -159,6 +364,15 @@ public:
         kMode3 = 3      // Clock Idles at 1, and captures on the rising edge
     };
 
+    enum BitOrder : uint8_t { kMSBFirst = 0, kLSBFirst = 1 };
+        // Enumerate type used to indicate the order of bits within each frame
+
+    typedef struct {            // Structure for the bus configuration of a device
+        uint32_t    Speed;                  // Clock speed (Hz)
+        SPIMode     Mode;                   // Mode (clock polarity/phase)
+        BitOrder    Order;                  // Bit order
+    }   DevConfig;
+
     enum InterState : uint8_t {kIT_Enable, kIT_Disable};   // Enumerate state for enabling/
                                                            // disabling interrupts
     enum CommLock : uint8_t {kCommunicating, kFree};       // Enumerate state for indicating if
@@ -167,6 +381,26 @@ public:
     enum CSSelection : uint8_t  { kSelect, kDeselect };
         // Enumerate type used to indicate whether device needs to be selected or deselected
 
+    typedef void (*CmpltCallback)(void *context);
+        // Function type for SPI Request Form completion callback
+
+    enum DataWidth : uint8_t { k8bit = 8, k16bit = 16, k32bit = 32 };
+        // Enumerate type used to indicate the data width (frame size) of SPI Request Form
+
+    enum Coalesce : uint8_t { kCoalesce_Off, kCoalesce_On };
+        // Enumerate type used to enable/disable the coalescing of SPI Request Forms
+
+    enum FormPriority : uint8_t { kHigh = 0, kNormal = 1, kLow = 2 };
+        // Enumerate type used to indicate the priority of the SPI Request Form (queue)
+
+    typedef struct {            // Structure for the time SPI Request Forms wait within queue
+        uint32_t    Count;                  // Number of forms taken from queue
+        uint32_t    Max;                    // Maximum wait (ticks)
+        uint64_t    Total;                  // Total wait (ticks), for average
+        uint32_t    Hist[SPIPe_WaitBins];   // Histogram of wait, bin 0 is 0 ticks, bin "n" is
+                                            // 2^(n-1) to (2^n) - 1 ticks
+    }   WaitStats;
+
     typedef struct {                // Structure to manage the multiple types of Chip Selection
                                     // options available
         GPIO    *GPIO_CS;           // Software managed GPIO CS
@@ -175,14 +409,30 @@ public:
             kHardware_Managed,      // Indicate that Hardware is manages the CS
             kSoftware_GPIO          // Indicate that the Chip Select is software managed
         } Type;
+
+        DevConfig   Config;         // Bus configuration of the device (".configDevice")
     }   CSHandle;
 
+    typedef struct {            // Segment of data, for scatter-gather SPI Request Forms
+        uint8_t                 *Buff;      // Pointer to data (__null, transmit 0s or discard)
+        uint16_t                size;       // Number of packets within segment
+    }   Segment;
+
     typedef struct {            // SPI Form structure, used to manage SPI Communication interrupts
         CSHandle                devLoc;     // Location to trigger the Chip Select
         uint16_t                size;       // State the amount of data to be transfered
+        DataWidth               Width;      // Data width of each packet (frame size)
 
         uint8_t                 *TxBuff;    // Pointer to data to transmit
         uint8_t                 *RxBuff;    // Pointer to data to be read back
+                                            // (8bit/16bit/32bit array, as per "Width")
+
+        const Segment           *TxSeg;     // Scatter-gather segment lists (__null if single
+        const Segment           *RxSeg;     // array "TxBuff"/"RxBuff")
+        uint8_t                 TxSegCnt;   // Number of segments remaining within lists
+        uint8_t                 RxSegCnt;   //
+        uint16_t                TxSegRem;   // Packets remaining within current segment
+        uint16_t                RxSegRem;   //
 
 
         volatile uint16_t        *Cmplt;    // Provide a pointer to a "Complete" flag (will be
@@ -190,6 +440,14 @@ public:
         volatile DevFlt          *Flt;      // Provide a pointer to a SPIPeriph::DevFlt for the
                                             // SPI fault status to be provided to source
                                             // function
+        CmpltCallback           Callback;   // Function called once form is complete/faulted
+        void                    *Context;   // Context provided to "Callback"
+
+        uint32_t                Queued;     // Time form was added to queue (".timeStamp")
+#if defined(SPI_TRACE_ENABLE)           // If tracing of SPI Request Forms is enabled then
+//=================================================================================================
+        uint32_t                Started;    // Time form was started (".timeStamp")
+#endif
     }   Form;
 
 /**************************************************************************************************
@@ -202,17 +460,57 @@ public:
                                         // is used to manage interrupt based communication.
                                         // Functions will add request forms to this buffer,
                                         // and interrupt then goes through them sequentially.
-    //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+                                        // This is the "kNormal" priority queue
+    GenBuffer<Form>     _high_queue_;   // "kHigh" priority queue   (linked via
+    GenBuffer<Form>     _low_queue_;    // "kLow" priority queue     ".linkPriorityQueue")
+    uint8_t             _age_count_[SPIPe_NumPriority];
+        // Number of forms taken from higher priority queues, whilst queue has been waiting
+    //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
         SPIMode     _mode_;             // Selected mode of SPI Device
 
         uint16_t    _cur_count_;        // Current communication packet count
+        uint16_t    _tx_count_;         // Current communication packets still to be transmitted
         Form        _cur_form_;         // Current SPI request form
 
+        Coalesce    _coalesce_;         // Indicate if forms to same device are to be coalesced
+        DataWidth   _data_width_;       // Data width hardware is configured for
+
+        GPIO        *_dev_gpio_[SPIPe_MaxDevices];      // Chip Select of each configured device
+                                                        // (__null = hardware managed)
+        DevConfig   _dev_config_[SPIPe_MaxDevices];     // Bus configuration of each device
+        uint8_t     _dev_count_;        // Number of configured devices
+        DevConfig   _default_config_;   // Bus configuration of any other device
+        DevConfig   _bus_config_;       // Bus configuration hardware is configured for
+        uint8_t     _group_count_;      // Number of forms taken out of order (grouping)
+
+        GenBuffer<uint8_t>  *_stream_buff_; // Buffer which stream samples are put into
+        const uint8_t       *_stream_cmd_;  // Command frame(s) repeated for each stream sample
+        uint16_t            _stream_size_;  // Number of frames within each stream sample
+        DataWidth           _stream_width_; // Data width of the stream frames
+        volatile uint8_t    _stream_run_;   // Indicate stream is running (1 = running)
+
     public:
         DevFlt      Flt;                // Fault state of the SPI Device
         CommLock    CommState;          // Status of the Communication
 
+        WaitStats   QueueWait[SPIPe_NumPriority];   // Time forms wait within each priority queue
+        uint32_t    CoalesceCnt;        // Number of forms coalesced with previous form
+        uint32_t    ReconfigCnt;        // Number of times the bus configuration has changed
+        uint32_t    GroupCnt;           // Number of forms taken out of order (grouping)
+
+#if defined(SPI_TRACE_ENABLE)           // If tracing of SPI Request Forms is enabled then
+//=================================================================================================
+    protected:
+        uint32_t    _trace_time_;       // Time of previous throughput calculation
+        uint64_t    _trace_bytes_;      // Bytes at previous throughput calculation
+
+    public:
+        WaitStats   WireTime;           // Time from form start (device selected) to completion
+        WaitStats   FormTime;           // Time from form queued to completion
+        uint64_t    TraceBytes;         // Total bytes transferred
+#endif
+
 /**************************************************************************************************
  * == SPC PARAM == >>>        SPECIFIC ENTRIES FOR CLASS         <<<
  *   -----------
@@ -226,7 +524,7 @@ public:
 #if ( defined(zz__MiSTM32Fx__zz) || defined(zz__MiSTM32Lx__zz)  )
 // If the target device is either STM32Fxx or STM32Lxx from cubeMX then ...
 //=================================================================================================
-    private:
+    protected:
         SPI_HandleTypeDef   *_spi_handle_;  // Store the Handle for the SPI Device, from cubeMX
 
     public:
@@ -237,11 +535,61 @@ public:
 
 #elif defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
 //=================================================================================================
+    public:
+        typedef int (*IoctlFunc)(int fd, unsigned long request, void *arg);
+        // Function type for the driver calls (matches "ioctl")
+
     private:
-        int _spi_channel_;              // Store the channel used for SPI
+        int                 _spi_handle_;   // Stores the device to communicate too
+        const char          *_device_loc_;  // Store location file for SPI device
+        uint32_t            _speed_;        // Store entered speed (Hz)
+        IoctlFunc           _ioctl_;        // Function used for driver calls
+
+        static int sysIoctl(int fd, unsigned long request, void *arg);
+        // Default driver call, linked to system "ioctl"
+        DevFlt configDriver(void);      // Configure the mode, speed and data size of device
+
+        pthread_mutex_t     _queue_lock_;   // Lock for SPI Request Form queue
+        pthread_t           _worker_handle_;// Handle of interrupt emulation thread
+        int                 _event_fd_;     // eventfd used to wake interrupt emulation thread
+        volatile uint8_t    _worker_run_;   // Indicate interrupt emulation thread is running
+
+        static void *workerThread(void *arg);   // Interrupt emulation thread
+
+        pthread_mutex_t     _stream_lock_;  // Lock for stream, held whilst with the driver
+        pthread_mutex_t     _bus_lock_;     // Lock for the bus, held for each submission of the
+                                            // queue, and each polling transfer
+        uint16_t            _stream_delay_; // Delay between stream samples (us)
+
+        uint8_t formTransfers(Form *RequestForm, struct spi_ioc_transfer *xfer, uint8_t space);
+        // Populate the driver transfers for the form (returns number used, 0 if doesn't fit)
+
+    protected:
+        uint8_t transferBatch(void);    // Submit queued SPI Request Forms to driver (returns
+                                        // number of forms submitted)
+        uint16_t streamBatch(void);     // Submit stream samples to driver (returns number of
+                                        // samples submitted)
 
     public:
-        SPIPeriph(int channel, int speed, _SPIMode Mode);
+        SPIPeriph(const char *deviceloc, int speed, SPIMode Mode,
+                  Form *FormArray, uint16_t FormSize);
+        // Setup the SPI class, by providing the folder location of spidev device, speed and mode
+        // as well the SPI Request Form array pointer, and size.
+
+        void linkIoctl(IoctlFunc func);     // Replace the function used for driver calls
+
+        DevFlt startWorker(int priority, int core); // Start interrupt emulation thread
+                                                    // (priority = 0 for normal, core = -1 for any)
+        void stopWorker(void);                      // Stop interrupt emulation thread
+
+        void holdBus(void);                         // Hold the bus, forms are queued until
+        void releaseBus(void);                      // released (then submitted together)
+
+        DevFlt startStream(const uint8_t *Command, uint16_t size, DataWidth width,
+                           GenBuffer<uint8_t> *ReadArray, uint32_t period);
+        // Start stream of "Command" ("size" frames) repeated every "period" (us), with each
+        // reply put into "ReadArray" (requires interrupt emulation thread)
+        void stopStream(void);                      // Stop stream
 
 #else
 //=================================================================================================
@@ -267,13 +615,24 @@ protected:  /*******************************************************************
     void enable(void);                      // Enable the SPI device
     void disable(void);                     // Disable the SPI device
 
-    uint8_t readDR(void);                   // Function to read direct from the hardware
-    void writeDR(uint8_t data);             // Function to write direct to the hardware
+    uint16_t readDR(void);                  // Function to read direct from the hardware
+    void writeDR(uint16_t data);            // Function to write direct to the hardware
+    uint16_t readDRPacked(void);            // Read 2x 8bit frames direct from the hardware
+    void writeDRPacked(uint16_t data);      // Write 2x 8bit frames direct to the hardware
+    void configDataWidth(DataWidth width);  // Configure the hardware data width (frame size)
+    void configBus(DevConfig config);       // Configure the hardware speed/mode/bit order
+    uint32_t busClock(void);                // Clock feeding the SPI peripheral (Hz), for STM32
+    uint32_t clockSpeed(uint32_t speed);    // Fastest speed achievable, upto "speed" (Hz)
+
+    void fillTransmitFIFO(void);            // Fill TXFIFO from current form (upto RXFIFO space)
+    void drainReceiveFIFO(void);            // Empty RXFIFO into current form
 
     // SPI Event status checks
     // ~~~~~~~~~~~~~~~~~~~~~~~
     uint8_t transmitEmptyChk(void);         // Check state of transmission register (1 = empty)
     uint8_t receiveToReadChk(void);         // Check state of receive data register (1 =  read)
+    uint8_t transmitFIFOLvl(void);          // Level of transmit FIFO (0 = empty, 3 = full)
+    uint8_t receiveFIFOLvl(void);           // Level of receive FIFO  (0 = empty, 3 = full)
 
     uint8_t busBusyChk(void);               // Check if SPI bus is busy             (1 = BUSY)
 
@@ -297,6 +656,10 @@ protected:  /*******************************************************************
     CSHandle softwareGPIO(GPIO *CS);
 
     void chipSelectHandle(CSHandle selection, CSSelection Mode);
+    uint8_t chipSelectMatch(CSHandle first, CSHandle second);   // Check if same device (1 = same)
+    DevConfig deviceConfig(GPIO *CS);       // Bus configuration of device (__null = hardware)
+    uint8_t configMatch(DevConfig first, DevConfig second);     // Check if the bus configuration
+                                                                // is the same (1 = same)
 
     // SPI Communication Request Form handling
     // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -304,12 +667,58 @@ protected:  /*******************************************************************
                      volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag);
 
     void formW8bitArray(Form *RequestForm, uint8_t *TxData, uint8_t *RxData);
+    void formW16bitArray(Form *RequestForm, uint16_t *TxData, uint16_t *RxData);
+    void formW32bitArray(Form *RequestForm, uint32_t *TxData, uint32_t *RxData);
+    uint8_t formSegments(Form *RequestForm, const Segment *TxSeg, uint8_t TxCnt,
+                         const Segment *RxSeg, uint8_t RxCnt);  // (1 = lists valid)
+    void formCallback(Form *RequestForm, CmpltCallback callback, void *context);
+    void cmpltCallback(Form *RequestForm);  // Call the form's completion callback (if linked)
+
+    uint32_t timeStamp(void);           // Current time (ticks), for queue wait timing
 
-    uint8_t getFormWriteData(Form *RequestForm);
+    GenBuffer<Form> *formQueue(FormPriority priority);
+    // Function will return the queue used for "priority"
+    uint8_t queueLinked(uint8_t priority);  // Check if "priority" has its own queue (1 = linked)
+
+    void queueForm(Form *RequestForm, FormPriority priority);
+    // Function will add the "RequestForm" into the queue of "priority" (protected from the
+    // interrupt emulation thread for RaspberryPi)
+
+    uint8_t selectQueue(void);
+    // Function will return the priority of the queue to take the next form from (includes aging),
+    // returns "SPIPe_NumPriority" if all queues are empty. Only linked queues are returned
+
+    void takeForm(uint8_t priority, Form *RequestForm);
+    // Function will take the next "RequestForm" from queue of "priority", and update the aging
+    // and queue wait
+
+    void groupForm(uint8_t priority, DevConfig config);
+    // Function will bring a form with the same bus configuration as "config", forward to the
+    // front of the queue of "priority" (if the front form does not have the same)
+
+    DevFlt streamLink(const uint8_t *Command, uint16_t size, DataWidth width,
+                      GenBuffer<uint8_t> *ReadArray);
+    // Check and link the stream parameters (returns "kData_Size" if the buffer is not a whole
+    // number of samples, "kStream_Error" if stream already running)
+    uint16_t streamBytes(void);         // Number of bytes within each stream sample
+
+    void addWaitStat(WaitStats *stat, uint32_t wait);   // Add time into the wait statistics
+    void clearWaitStat(WaitStats *stat);                // Clear the wait statistics
+
+#if defined(SPI_TRACE_ENABLE)           // If tracing of SPI Request Forms is enabled then
+//=================================================================================================
+    void traceFormStart(Form *RequestForm);                 // Capture start of form
+    void traceFormCmplt(Form *RequestForm, uint16_t count); // Capture completion of form
+#endif
+
+    DevFlt poleTransfer(DevConfig config, const uint8_t *wData, uint8_t *rData, uint16_t size);
+    // Poling transfer, with the bus configured as per "config" (used by ".poleMasterTransfer")
+
+    uint16_t getFormWriteData(Form *RequestForm);
     // Function will retrieve the next data entry from the source data specified within the
     // SPI "RequestForm"
 
-    void putFormReadData(Form *RequestForm, uint8_t readdata);
+    void putFormReadData(Form *RequestForm, uint16_t readdata);
     // Function will take the data read from the SPI Hardware, and put into the requested data
     // location specified within the "RequestForm" input
 
@@ -319,10 +728,12 @@ public:     /*******************************************************************
              *  Visible functions used to transfer data via SPI - will wait for any registers to
              *  be in correct state before progressing.
              *************************************************************************************/
-    DevFlt poleMasterTransfer(uint8_t *wData, uint8_t *rData, uint16_t size);
-    DevFlt poleMasterTransfer(GPIO *ChipSelect, uint8_t *wData, uint8_t *rData, uint16_t size);
+    DevFlt poleMasterTransfer(const uint8_t *wData, uint8_t *rData, uint16_t size);
+    DevFlt poleMasterTransfer(GPIO *ChipSelect, const uint8_t *wData, uint8_t *rData,
+                              uint16_t size);
     DevFlt poleMasterTransfer(DeMux *DeMuxCS, uint8_t CSNum,
-                              uint8_t *wData, uint8_t *rData, uint16_t size);
+                              const uint8_t *wData, uint8_t *rData, uint16_t size);
+    // If "rData" is __null, then data is only transmitted (read back data is discarded)
 
 public:     /**************************************************************************************
              * ==  PUBLIC   == >>>   INTERRUPT FUNCTIONS FOR DATA TRANSFER   <<<
@@ -335,16 +746,70 @@ public:     /*******************************************************************
     void configBusErroIT(InterState intr);      // Configure the BUS Error interrupt
 
     void intMasterTransfer(uint16_t size, uint8_t *TxBuff, uint8_t *RxBuff,
-                           volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag);
+                           volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag,
+                           FormPriority priority = FormPriority::kNormal,
+                           CmpltCallback callback = __null, void *context = __null);
 
     void intMasterTransfer(GPIO *CS, uint16_t size, uint8_t *TxBuff, uint8_t *RxBuff,
-                           volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag);
+                           volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag,
+                           FormPriority priority = FormPriority::kNormal,
+                           CmpltCallback callback = __null, void *context = __null);
+
+    void intMasterTransfer(uint16_t size, uint16_t *TxBuff, uint16_t *RxBuff,
+                           volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag,
+                           FormPriority priority = FormPriority::kNormal,
+                           CmpltCallback callback = __null, void *context = __null);
+
+    void intMasterTransfer(GPIO *CS, uint16_t size, uint16_t *TxBuff, uint16_t *RxBuff,
+                           volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag,
+                           FormPriority priority = FormPriority::kNormal,
+                           CmpltCallback callback = __null, void *context = __null);
+
+    void intMasterTransfer(uint16_t size, uint32_t *TxBuff, uint32_t *RxBuff,
+                           volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag,
+                           FormPriority priority = FormPriority::kNormal,
+                           CmpltCallback callback = __null, void *context = __null);
+
+    void intMasterTransfer(GPIO *CS, uint16_t size, uint32_t *TxBuff, uint32_t *RxBuff,
+                           volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag,
+                           FormPriority priority = FormPriority::kNormal,
+                           CmpltCallback callback = __null, void *context = __null);
+
+    void intMasterTransfer(const Segment *TxSeg, uint8_t TxCnt, const Segment *RxSeg,
+                           uint8_t RxCnt, volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag,
+                           FormPriority priority = FormPriority::kNormal,
+                           CmpltCallback callback = __null, void *context = __null);
+
+    void intMasterTransfer(GPIO *CS, const Segment *TxSeg, uint8_t TxCnt, const Segment *RxSeg,
+                           uint8_t RxCnt, volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag,
+                           FormPriority priority = FormPriority::kNormal,
+                           CmpltCallback callback = __null, void *context = __null);
     // Above OVERLOADED function "intMasterTransfer" takes the input parameters and uses this to
-    // populate a SPI Request Form, and then add this to the Device Queue.
+    // populate a SPI Request Form, and then add this to the Device Queue of "priority".
+    // "size" is the number of entries within the array (8bit, 16bit or 32bit frames), or for
+    // scatter-gather the number of entries is within the segment lists
+
+    DevFlt configDevice(GPIO *CS, uint32_t speed, SPIMode mode, BitOrder order);
+    // Set the bus configuration for device selected by "CS" (__null for hardware managed Chip
+    // Select). "speed" of 0 uses the default speed
+
+    void linkPriorityQueue(FormPriority priority, Form *FormArray, uint16_t FormSize);
+    // Link SPI Request Form array for the "kHigh"/"kLow" priority queue
+    void resetQueueWait(void);                  // Clear the queue wait times
+
+#if defined(SPI_TRACE_ENABLE)           // If tracing of SPI Request Forms is enabled then
+//=================================================================================================
+    uint32_t traceThroughput(void);             // Bytes per second since previous call
+    void resetTrace(void);                      // Clear the trace histograms, and byte count
+#endif
 
-    void startInterrupt(void);                  // Enable communication if bus is free, otherwise
+    virtual void startInterrupt(void);          // Enable communication if bus is free, otherwise
                                                 // wait (doesn't actually wait)
-    void intReqFormCmplt(void);                 // Closes out the input Request Form
+    virtual void startTransfer(void);           // Start transfer of current Request Form
+    virtual void intReqFormCmplt(void);         // Closes out the input Request Form
+    uint8_t coalesceForm(void);                 // Continue with next Request Form, if to the
+                                                // same device (1 = continued)
+    void configCoalesce(Coalesce state);        // Enable/Disable coalescing of Request Forms
     void handleIRQ(void);                       // Interrupt Handle for SPI Device
 
         virtual ~SPIPeriph();
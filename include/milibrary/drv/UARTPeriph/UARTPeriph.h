@@ -152,6 +152,9 @@ public:
      enum CommLock : uint8_t {kCommunicating, kFree};       // Enumerate state for indicating if
                                                             // device iscommunicating
 
+     typedef void (*CmpltCallback)(void *context);
+         // Function type for UART Request Form completion callback
+
      typedef struct {           // UART Form structure, used to manage UART Communication
                                 // interrupts
          uint16_t               size;       // State the amount of data to be transferred
@@ -163,6 +166,8 @@ public:
          volatile DevFlt         *Flt;       // Provide a pointer to a UARTPeriph::DevFlt for the
                                              // I2C fault status to be provided to source
                                              // function
+         CmpltCallback           Callback;   // Function called once form is complete/faulted
+         void                    *Context;   // Context provided to "Callback"
      }   Form;
 
 /**************************************************************************************************
@@ -276,6 +281,8 @@ protected:  /*******************************************************************
     Form genericForm(uint8_t *data, uint16_t size,
                      volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag);
 
+    void cmpltCallback(Form *RequestForm);  // Call the form's completion callback (if linked)
+
     uint8_t getFormWriteData(Form *RequestForm);
     // Function will retrieve the next data entry from the source data specified within the
     // UART "RequestForm"
@@ -306,10 +313,14 @@ public:     /*******************************************************************
     void configReceiveIT(InterState intr);      // Configure the Receive full interrupt
 
     void intWrtePacket(uint8_t *wData, uint16_t size,
-                       volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag);
+                       volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag,
+                       CmpltCallback callback = __null, void *context = __null);
 
     void intReadPacket(uint8_t *rData, uint16_t size,
-                       volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag);
+                       volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag,
+                       CmpltCallback callback = __null, void *context = __null);
+    // "callback" (with "context") is called once the form is complete, from within the
+    // interrupt - see "FormEvent" (FilInd_FrmEvtHD) for a waitable callback
 
     virtual void startInterrupt(void);          // Enable communication is bus is free, otherwise
                                                 // wait (doesn't actually pause at this point)
@@ -16,11 +16,34 @@ void LnxCond::InitialSetup() {
  * within the Linux operating system
  *************************************************************************************************/
     uint8_t i, j   = 0;             // Variable for looping
-    this->TemperatureFile = "/sys/class/thermal/thermal_zone0/temp";
-                                        // Default location for CPU Temp
-    this->CPUFile         = "/proc/stat";
-                                        // Default location for CPU status
+
+    this->ThreadDirHandle = nullptr;    // Directory not opened yet
+    this->ThreadPass      = 0;          // No scans of thread directory yet
+    this->ThreadCnt       = 0;          // No threads captured yet
+    this->TotalDiff       = 0;          // No CPU time captured yet
+    this->OnlineCnt       = 0;          // No cores listed yet
+
+    this->MemoryFd        = -1;         // Files not opened yet
+    this->IRQFd           = -1;
+    this->IRQCnt          = 0;          // No interrupt lines captured yet
+    this->IRQTime.tv_sec  = 0;
+    this->IRQTime.tv_nsec = 0;
+    memset(&this->Memory, 0, sizeof(this->Memory));
+
+    for (j = 0; j != LNX_NUM_PSI; j++) {            // Loop through Pressure Stall entries
+        this->PressureFd[j] = -1;                   // Files not opened yet
+        memset(&this->Pressure[j], 0, sizeof(this->Pressure[j]));
+    }
+
+    this->LatencyState    = LNX_LAT_STOPPED;    // Latency probe not running
+    this->LatencyPeriod   = 0;
+    memset(&this->Latency, 0, sizeof(this->Latency));
+
+    this->SetRoot("");                  // Default location of files is the root of filesystem
+                                        // (files need to be closed prior to this)
     this->CheckFreq       = 1;          // Default for read rate
+    this->ReplayCnt       = 0;          // Default to not replaying snapshots
+    this->ReplayPos       = 0;
 
     this->Temp            = -999;       // Setup temperature to initially be very low
     this->classmode       = LNX_FIRST_PASS;         // Default mode set to "FIRST_PASS"
@@ -29,11 +52,16 @@ void LnxCond::InitialSetup() {
     for (j = 0; j != (LNX_NUM_CORES + 1); j++) {    // Loop through the top level array entries
         this->CurLoad[j]  = 0.00;                   // Setup load to 0.00%
 
+        this->CoreOnline[j] = 0;                    // Setup core to offline until read
+
         for (i = 0; i != LNX_NUM_CPU_STATES; i++) { // Loop through lower level array entries
             this->PrevCPU[j][i]     = 0;            // and clear them all
             this->CurCPU[j][i]      = 1;            // and clear them all
         }
     }
+
+    for (j = 0; j != LNX_MAX_THREADS; j++)          // Loop through thread entries
+        this->Thread[j].TID = 0;                    // and clear them all
 }
 
 LnxCond::LnxCond() {
@@ -55,35 +83,161 @@ LnxCond::LnxCond(float Frequency) {
     this->CheckFreq = Frequency;    // Set the Check Frequency as per input
 }
 
-_LnxFlt LnxCond::ConvertCPUText(uint32_t CPUData[], std::string CPUString) {
+LnxCond::LnxCond(std::string Root) {
+/**************************************************************************************************
+ * Calling condition for Linux Embedded Condition class.
+ * When invoking this, it will populate the class with default parameters, however all files will
+ * be read relative to the directory "Root" (i.e. "Root"/proc/stat)
+ *************************************************************************************************/
+    this->InitialSetup();           // Call hidden function defaulting all parameters
+    this->SetRoot(Root);            // Update location of files to be within "Root"
+}
+
+LnxCond::LnxCond(std::string Replay, uint16_t Snapshots, float Frequency) {
+/**************************************************************************************************
+ * Calling condition for Linux Embedded Condition class.
+ * When invoking this, the class will replay the recorded snapshots within directory "Replay",
+ * each call of "UpdateStatus" will move onto the next snapshot - see "UpdateStatus".
+ * "Frequency" is the rate that the snapshots were recorded at, and is used in place of the
+ * actual time between calls
+ *************************************************************************************************/
+    this->InitialSetup();           // Call hidden function defaulting all parameters
+    this->CheckFreq = Frequency;    // Set the Check Frequency as per input
+    this->ReplayDir = Replay;       // Capture location of snapshots
+    this->ReplayCnt = Snapshots;    // Capture number of snapshots
+}
+
+void LnxCond::SetRoot(std::string Root) {
+/**************************************************************************************************
+ * Function will update the location of all files read by the class, to be relative to the
+ * directory "Root".
+ * Any files which have been kept open are closed, so will be re-opened at the new location on
+ * the next "UpdateStatus". The list of threads is kept, so the history of each thread carries
+ * across to the new location (i.e. the next replay snapshot)
+ *************************************************************************************************/
+    this->ReleaseFiles();           // Close any files at the previous location
+
+    this->TemperatureFile = Root + "/sys/class/thermal/thermal_zone0/temp";
+                                        // Default location for CPU Temp
+    this->CPUFile         = Root + "/proc/stat";
+                                        // Default location for CPU status
+    this->ThreadDir       = Root + "/proc/self/task";
+                                        // Default location for process threads
+    this->PressureFile[LNX_PSI_CPU]     = Root + "/proc/pressure/cpu";
+    this->PressureFile[LNX_PSI_MEMORY]  = Root + "/proc/pressure/memory";
+    this->PressureFile[LNX_PSI_IO]      = Root + "/proc/pressure/io";
+                                        // Default location for Pressure Stall
+    this->MemoryFile      = Root + "/proc/meminfo";
+                                        // Default location for Memory Information
+    this->IRQFile         = Root + "/proc/interrupts";
+                                        // Default location for Interrupts
+}
+
+void LnxCond::CloseFiles(void) {
+/**************************************************************************************************
+ * Function will close all the files (and directories) which have been kept open between calls
+ * of "UpdateStatus", and clear the list of threads
+ *************************************************************************************************/
+    this->ReleaseFiles();                       // Close all files
+
+    while (this->ThreadCnt != 0)                // Remove all threads
+        this->RemoveThread(this->ThreadCnt - 1);
+}
+
+void LnxCond::ReleaseFiles(void) {
+/**************************************************************************************************
+ * Function will close all the files (and directories) which have been kept open between calls
+ * of "UpdateStatus". The list of threads is kept, with the files of each thread re-opened on the
+ * next scan of the thread directory - see "ScanThreads"
+ *************************************************************************************************/
+    uint16_t i;                     // Variable used for looping
+
+    for (i = 0; i != this->ThreadCnt; i++) {    // Close all thread files
+        if (this->Thread[i].StatFd >= 0)
+            close(this->Thread[i].StatFd);
+        if (this->Thread[i].StatusFd >= 0)
+            close(this->Thread[i].StatusFd);
+        this->Thread[i].StatFd   = -1;
+        this->Thread[i].StatusFd = -1;
+    }
+
+    if (this->ThreadDirHandle != nullptr) {     // If thread directory has been opened
+        closedir(this->ThreadDirHandle);        // then close it
+        this->ThreadDirHandle = nullptr;
+    }
+
+    for (i = 0; i != LNX_NUM_PSI; i++) {        // Close all cached files
+        if (this->PressureFd[i] >= 0)
+            close(this->PressureFd[i]);
+        this->PressureFd[i] = -1;
+    }
+    if (this->MemoryFd >= 0)
+        close(this->MemoryFd);
+    this->MemoryFd = -1;
+    if (this->IRQFd >= 0)
+        close(this->IRQFd);
+    this->IRQFd = -1;
+}
+
+_LnxFlt LnxCond::ConvertCPUText(uint32_t CPUData[][LNX_NUM_CPU_STATES], const char *CPUString,
+                                uint8_t *Core) {
 /**************************************************************************************************
  * Function will read the input string - "CPUString", and convert the text into entries within
  * array - CPUData[].
- * It is only expecting to see 10 columns of data, and will ignore the first entry as this will
- * be "cpu", "cpu0", etc.
+ * The first entry of the line is the label - "cpu" for the total, and "cpuN" for each core. This
+ * is used to determine the position within CPUData (total = 0, core N = N + 1), which is also
+ * returned via "Core". As offline cores are not listed, the label has to be used rather then the
+ * line number.
+ * If the core is beyond the size of CPUData ("LNX_NUM_CORES"), then line is ignored and "Core"
+ * will be set to "LNX_CORE_IGNORE".
+ *
+ * It is expecting to see up to 10 columns of data, older kernels provide less columns so any
+ * missing entries are set to 0.
+ * The kernel provides 64bit counters, these are truncated to 32bits - as the load is calculated
+ * from the difference between reads, the wrap around of the counter does not affect the result.
  *************************************************************************************************/
     uint8_t i = 0;              // Variable to keep trace of entries converted
-    std::string subline;        // Variable to store temporary line
-    std::stringstream stream;   // Create class "stringstream"
+    const char *ptr;            // Pointer to current position within string
+    char    *next;              // Pointer to end of converted number
+    unsigned long core;         // Core number within label
 
-    if (CPUString.compare(0, 3, "cpu") == 0) {  // Check beginning of string for "cpu"
-        // If equal to "0", then they are equal, otherwise not exactly equal
-        stream.str (CPUString);                 // Provide stream with input string
-        // As we know that the first 3 characters are "cpu", update character point to start at
-        // character 5
-        stream.seekg(5, std::ios::beg);
+    if (strncmp(CPUString, "cpu", 3) != 0)      // Check beginning of string for "cpu"
+        return (LnxCond_CPULoadConvert);        // If the start of the string isn't "cpu" then
+                                                // layout is unexpected, and fault is to be set
 
-        while(std::getline(stream, subline, ' ')) { // Cycle through line, and capture character's
-                                                    // between " " (spaces)
-            if (i >= LNX_NUM_CPU_STATES)            // If the number of loops exceeds defined size
-                return (LnxCond_CPULoadConvert);    // return fault
+    ptr = &CPUString[3];                        // Point to character after "cpu"
+    if (*ptr == ' ')                            // If followed by space, then total entry
+        *Core = 0;
+    else {                                      // Otherwise, should be the core number
+        core = strtoul(ptr, &next, 10);
+        if ((next == ptr) || (*next != ' '))    // If not a number, then layout is unexpected
+            return (LnxCond_CPULoadConvert);
 
-            CPUData[i++] = std::stoi(subline, nullptr);
+        ptr = next;
+        if (core >= LNX_NUM_CORES) {            // If core is beyond the size of array
+            *Core = LNX_CORE_IGNORE;            // then ignore the line
+            return (LnxCond_NoFault);
         }
+        *Core = (uint8_t)(core + 1);
+    }
 
-    } else
-        return (LnxCond_CPULoadConvert);        // If the start of the string isn't "cpu" then
-                                                // layout is unexpected, and fault is to be set
+    while (1) {                                 // Cycle through line, and capture the numbers
+        CPUData[*Core][i] = (uint32_t)strtoull(ptr, &next, 10);
+        if (next == ptr)                        // If no number converted, then end of line
+            break;
+
+        ptr = next;
+        if (++i >= LNX_NUM_CPU_STATES)          // If the number of entries reaches defined size
+            break;                              // then stop
+    }
+
+    while (*ptr == ' ')                         // Check that the end of line has been reached
+        ptr++;
+    if ((*ptr != '\0') && (*ptr != '\n'))       // If there are further entries, then layout is
+        return (LnxCond_CPULoadConvert);        // unexpected
+
+    for (; i != LNX_NUM_CPU_STATES; i++)        // Clear any missing entries
+        CPUData[*Core][i] = 0;
 
     return (LnxCond_NoFault);   // If have made it this far then, data has been converted without
                                 // error
@@ -135,10 +289,737 @@ void LnxCond::CalculateCPULoad(void) {
 
         ActiveDiff = Cur_ActiveTime - Prev_ActiveTime;          // Diff Active Times
         IdleDiff   = Cur_IdleTime - Prev_IdleTime;              // Diff Idle Times
+            // Unsigned difference correctly handles the counters wrapping around, however some
+            // counters (i.e. iowait) can go backwards - which would appear as a very large
+            // difference. So any difference larger then half the counter range is ignored
+        if (ActiveDiff > LNX_COUNTER_HALF)
+            ActiveDiff = 0;
+        if (IdleDiff > LNX_COUNTER_HALF)
+            IdleDiff = 0;
 
-        this->CurLoad[cores] = ((float)ActiveDiff) / ((float)(ActiveDiff + IdleDiff));
+        if (cores == 0)                                         // If this is the total entry
+            this->TotalDiff = ActiveDiff + IdleDiff;            // then capture for threads
+
+        if ((ActiveDiff + IdleDiff) != 0)                       // If time has passed for core
+            this->CurLoad[cores] = ((float)ActiveDiff) / ((float)(ActiveDiff + IdleDiff));
             // Calculate the load for CPU core
+        else                                                    // Otherwise core is offline
+            this->CurLoad[cores] = 0.00;                        // (or no time has passed)
+    }
+}
+
+_LnxFlt LnxCond::ScanThreads(void) {
+/**************************************************************************************************
+ * Function will scan the thread directory of this process ("ThreadDir"), and update the list of
+ * threads within "Thread".
+ * The directory handle is kept open between calls (and rewound), and any thread which has already
+ * been captured keeps its open file descriptors - so only new threads require files to be opened.
+ * If the files of a captured thread have been released (see "ReleaseFiles"), then they are
+ * re-opened - keeping the history of the thread.
+ * Threads which are no longer within the directory are removed from the list.
+ *************************************************************************************************/
+    struct dirent *entry;           // Entry within thread directory
+    char    *endptr;                // Pointer to end of converted number
+    int     tid;                    // Thread ID of directory entry
+    uint16_t i;                     // Variable used for looping through threads
+    _LnxFlt returnflt = LnxCond_NoFault;    // Fault to return
+
+    if (this->ThreadDirHandle == nullptr) {             // If directory has not been opened
+        this->ThreadDirHandle = opendir(this->ThreadDir.c_str());
+        if (this->ThreadDirHandle == nullptr)           // If unable to open directory
+            return (LnxCond_ThreadOpen);                // Return fault
+    }
+    else                                                // Otherwise directory is already open
+        rewinddir(this->ThreadDirHandle);               // so return to start of directory
+
+    this->ThreadPass++;                                 // Indicate a new scan of directory
+
+    while ((entry = readdir(this->ThreadDirHandle)) != nullptr) {
+        tid = (int)strtoul(entry->d_name, &endptr, 10); // Convert entry name into Thread ID
+        if ((*endptr != '\0') || (tid <= 0))            // If entry is not a number (i.e. ".")
+            continue;                                   // then skip entry
+
+        for (i = 0; i != this->ThreadCnt; i++) {        // Check if thread is already captured
+            if (this->Thread[i].TID == tid)
+                break;
+        }
+
+        if (i == this->ThreadCnt) {                     // If thread is new
+            if (this->ThreadCnt == LNX_MAX_THREADS) {   // If there is no space for the thread
+                returnflt = LnxCond_ThreadOverflow;     // Indicate fault, and skip thread
+                continue;
+            }
+
+            if (this->OpenThread(&this->Thread[i], entry->d_name) == 0)
+                continue;                               // If thread has exited during scan
+
+            this->Thread[i].TID             = tid;  // Capture the Thread ID
+            this->Thread[i].Name[0]         = '\0'; // Clear rest of the entries
+            this->Thread[i].UTime           = 0;
+            this->Thread[i].STime           = 0;
+            this->Thread[i].VolCtxt         = 0;
+            this->Thread[i].NonVolCtxt      = 0;
+            this->Thread[i].VolCtxtDiff     = 0;
+            this->Thread[i].NonVolCtxtDiff  = 0;
+            this->Thread[i].LastCPU         = -1;
+            this->Thread[i].Load            = 0.00;
+            this->Thread[i].PrevTime        = 0;
+            this->Thread[i].threadmode      = LNX_FIRST_PASS;
+
+            this->ThreadCnt++;                          // Increment number of threads
+        }
+        else if (this->Thread[i].StatFd < 0) {          // If files of thread have been released
+            if (this->OpenThread(&this->Thread[i], entry->d_name) == 0)
+                continue;                               // If thread has exited during scan
+        }
+
+        this->Thread[i].Pass = this->ThreadPass;        // Indicate thread seen on this scan
+    }
+
+    i = 0;
+    while (i != this->ThreadCnt) {                      // Loop through all captured threads
+        if (this->Thread[i].Pass != this->ThreadPass)   // If not seen on this scan
+            this->RemoveThread(i);                      // Remove (last entry is moved into "i")
+        else
+            i++;
+    }
+
+    return (returnflt);
+}
+
+uint8_t LnxCond::OpenThread(_LnxThrd *Thrd, const char *Name) {
+/**************************************************************************************************
+ * Function will open the "stat" and "status" files of the thread "Name" (entry within the thread
+ * directory). If either file cannot be opened, then the thread has exited - and 0 is returned
+ * (with no files left open)
+ *************************************************************************************************/
+    std::string ThreadLoc = this->ThreadDir + "/" + Name;   // Location of thread within directory
+
+    Thrd->StatFd   = open((ThreadLoc + "/stat").c_str(),   O_RDONLY | O_CLOEXEC);
+    Thrd->StatusFd = open((ThreadLoc + "/status").c_str(), O_RDONLY | O_CLOEXEC);
+
+    if ((Thrd->StatFd < 0) || (Thrd->StatusFd < 0)) {   // If unable to open either file
+        if (Thrd->StatFd >= 0)      close(Thrd->StatFd);
+        if (Thrd->StatusFd >= 0)    close(Thrd->StatusFd);
+        Thrd->StatFd   = -1;
+        Thrd->StatusFd = -1;
+        return (0);
+    }
+
+    return (1);
+}
+
+void LnxCond::RemoveThread(uint16_t entry) {
+/**************************************************************************************************
+ * Function will close the files of the thread at position "entry", and remove it from the list of
+ * threads.
+ * To keep the list packed, the last thread within the list is moved into the emptied entry.
+ *************************************************************************************************/
+    if (this->Thread[entry].StatFd >= 0)                // Close thread files (if open)
+        close(this->Thread[entry].StatFd);
+    if (this->Thread[entry].StatusFd >= 0)
+        close(this->Thread[entry].StatusFd);
+
+    this->ThreadCnt--;                                  // Reduce the number of threads
+    if (entry != this->ThreadCnt)                       // If entry is not the last one
+        this->Thread[entry] = this->Thread[this->ThreadCnt];    // Move last entry into position
+
+    this->Thread[this->ThreadCnt].TID = 0;              // Clear the unused entry
+}
+
+_LnxFlt LnxCond::ReadThread(_LnxThrd *Thrd, char Buff[]) {
+/**************************************************************************************************
+ * Function will read the latest status of the thread "Thrd", using the already opened files.
+ * Buffer "Buff" (size "LNX_THREAD_BUFF") is used for reading the files, so no allocation occurs.
+ *
+ * The "stat" file is of the form:
+ *      tid (name) state ppid ...
+ * as the name can contain spaces and brackets, the fields are counted from the last ')'.
+ *      field 14    = Time in User Mode
+ *      field 15    = Time in System Mode
+ *      field 39    = CPU last executed on
+ *
+ * The "status" file contains the context switches:
+ *      voluntary_ctxt_switches:    xx
+ *      nonvoluntary_ctxt_switches: xx
+ *
+ * The load of the thread is determined as a fraction of a single core. The total CPU time is
+ * only of the cores which are online, so is divided by the number of cores listed at the current
+ * read ("OnlineCnt" - hot-plugged cores, and cores beyond "LNX_NUM_CORES" are still counted):
+ *
+ *      Cur.ThreadTime - Prev.ThreadTime = ThreadDiff
+ *
+ *      Load = ThreadDiff / (TotalDiff / OnlineCnt)
+ *************************************************************************************************/
+    ssize_t len;                    // Number of bytes read from file
+    char    *start, *end;           // Pointers to start/end of thread name
+    char    *ptr;                   // Pointer to current field in file
+    uint8_t field;                  // Field number of "ptr"
+    uint32_t value;                 // Temporary value read from file
+    uint32_t ThreadTime;            // Current total time of thread
+
+    len = pread(Thrd->StatFd, Buff, LNX_THREAD_BUFF - 1, 0);
+    if (len <= 0)                                       // If unable to read file
+        return (LnxCond_ThreadRead);                    // Return fault
+    Buff[len] = '\0';                                   // Terminate string
+
+    start = strchr(Buff, '(');                          // Find start and end of thread name
+    end   = strrchr(Buff, ')');
+    if ((start == nullptr) || (end == nullptr) || (end < start) || (end[1] != ' '))
+        return (LnxCond_ThreadConvert);                 // If not found, return fault
+
+    len = end - start - 1;                              // Determine length of name
+    if (len > (LNX_THREAD_NAME - 1))                    // Limit length to size of array
+        len = LNX_THREAD_NAME - 1;
+    memcpy(Thrd->Name, start + 1, len);                 // Copy name across
+    Thrd->Name[len] = '\0';
+
+    ptr = end + 2;                                      // Point to first field after name
+    for (field = 3; field != LNX_THREAD_CPU; field++) { // Loop through fields until CPU field
+        if (field == LNX_THREAD_UTIME)
+            Thrd->UTime = (uint32_t)strtoul(ptr, nullptr, 10);
+        else if (field == LNX_THREAD_STIME)
+            Thrd->STime = (uint32_t)strtoul(ptr, nullptr, 10);
+
+        ptr = strchr(ptr, ' ');                         // Find next field
+        if (ptr == nullptr)                             // If not found, then layout is unexpected
+            return (LnxCond_ThreadConvert);             // Return fault
+        ptr++;
+    }
+    Thrd->LastCPU = (int)strtol(ptr, nullptr, 10);      // Capture the CPU last executed on
+
+    len = pread(Thrd->StatusFd, Buff, LNX_THREAD_BUFF - 1, 0);
+    if (len <= 0)                                       // If unable to read file
+        return (LnxCond_ThreadRead);                    // Return fault
+    Buff[len] = '\0';                                   // Terminate string
+
+    ptr = strstr(Buff, "\nvoluntary_ctxt_switches:");   // Find voluntary context switches
+    if (ptr == nullptr)                                 // If not found, then layout is unexpected
+        return (LnxCond_ThreadConvert);                 // Return fault
+    value = (uint32_t)strtoul(strchr(ptr, ':') + 1, nullptr, 10);
+    Thrd->VolCtxtDiff = value - Thrd->VolCtxt;          // Determine change since last read
+    Thrd->VolCtxt     = value;
+
+    ptr = strstr(ptr, "\nnonvoluntary_ctxt_switches:"); // Find involuntary context switches
+    if (ptr == nullptr)                                 // If not found, then layout is unexpected
+        return (LnxCond_ThreadConvert);                 // Return fault
+    value = (uint32_t)strtoul(strchr(ptr, ':') + 1, nullptr, 10);
+    Thrd->NonVolCtxtDiff = value - Thrd->NonVolCtxt;    // Determine change since last read
+    Thrd->NonVolCtxt     = value;
+
+    ThreadTime = Thrd->UTime + Thrd->STime;             // Calculate Thread Time (Current)
+
+    if ((Thrd->threadmode & LNX_FIRST_PASS) != LNX_FIRST_PASS) {    // If not First Pass
+        // Only calculate if CPU time has changed (and cores were listed)
+        if ((this->TotalDiff != 0) && (this->OnlineCnt != 0))
+            Thrd->Load = ((float)(ThreadTime - Thrd->PrevTime) * this->OnlineCnt) /
+                         ((float)this->TotalDiff);
+    }
+    else {                                              // If First Pass
+        Thrd->threadmode &= ~LNX_FIRST_PASS;            // Clear flag
+        Thrd->VolCtxtDiff     = 0;                      // No change can be determined yet
+        Thrd->NonVolCtxtDiff  = 0;
+    }
+
+    Thrd->PrevTime = ThreadTime;                        // Update historical time
+
+    return (LnxCond_NoFault);
+}
+
+_LnxFlt LnxCond::ReadProcFile(int *Fd, std::string &Loc, _LnxFlt OpenFlt, _LnxFlt ReadFlt,
+                              _LnxFlt OverflowFlt) {
+/**************************************************************************************************
+ * Function will read the complete file at "Loc" into "ProcBuff", and terminate it as a string.
+ * The file descriptor "Fd" is kept open between calls, and the file is re-read from the start, so
+ * no opening of files (or allocation) occurs after the first call.
+ * If the file is larger then "LNX_PROC_BUFF", then only the start of the file is captured, and
+ * "OverflowFlt" is returned (the captured start of the file is still terminated, so can be used).
+ *************************************************************************************************/
+    ssize_t len;                    // Number of bytes read from file
+    size_t  total = 0;              // Total number of bytes read from file
+    char    spare;                  // Byte beyond the end of the buffer
+
+    if (*Fd < 0) {                                      // If file has not been opened
+        *Fd = open(Loc.c_str(), O_RDONLY | O_CLOEXEC);
+        if (*Fd < 0)                                    // If unable to open file
+            return (OpenFlt);                           // Return fault
+    }
+
+    if (lseek(*Fd, 0, SEEK_SET) < 0)                    // Return to the start of the file
+        return (ReadFlt);
+
+    do {    // Files within procfs can return less data then requested, so keep reading until the
+            // end of the file (or buffer is full)
+        len = read(*Fd, &this->ProcBuff[total], LNX_PROC_BUFF - 1 - total);
+        if (len < 0)                                    // If unable to read file
+            return (ReadFlt);                           // Return fault
+        total += len;
+    } while ((len != 0) && (total != (LNX_PROC_BUFF - 1)));
+
+    if (total == 0)                                     // If file is empty
+        return (ReadFlt);                               // Return fault
+
+    this->ProcBuff[total] = '\0';                       // Terminate string
+
+    if (total == (LNX_PROC_BUFF - 1)) {                 // If the buffer is full, then check if
+        len = read(*Fd, &spare, 1);                     // there is any more of the file
+        if (len > 0)                                    // If so, then file has been truncated
+            return (OverflowFlt);
+    }
+
+    return (LnxCond_NoFault);
+}
+
+char *LnxCond::FindField(char Buff[], const char *Field) {
+/**************************************************************************************************
+ * Function will search through the buffer "Buff" for a line starting with "Field:", and will
+ * return a pointer to the character after the ':'.
+ * If the field is not found, then will return "nullptr"
+ *************************************************************************************************/
+    size_t  len = strlen(Field);    // Length of field
+    char    *ptr = Buff;            // Pointer to start of current line
+
+    while (ptr != nullptr) {
+        if ((strncmp(ptr, Field, len) == 0) && (ptr[len] == ':'))
+            return (&ptr[len + 1]);                     // If field found, return position
+
+        ptr = strchr(ptr, '\n');                        // Otherwise move to next line
+        if (ptr != nullptr)
+            ptr++;
+    }
+
+    return (nullptr);
+}
+
+_LnxFlt LnxCond::ReadPressure(void) {
+/**************************************************************************************************
+ * Function will read each of the Pressure Stall files (CPU, memory, io), which are of the form:
+ *      some avg10=0.00 avg60=0.00 avg300=0.00 total=0
+ *      full avg10=0.00 avg60=0.00 avg300=0.00 total=0
+ *
+ *  "some"  = Time where at least one task was stalled on the resource
+ *  "full"  = Time where all non-idle tasks were stalled on the resource
+ * The "total" is the cumulative time stalled (us), so the change since the previous read is also
+ * captured.
+ *************************************************************************************************/
+    uint8_t i;                      // Variable used for looping through files
+    char    *ptr[2];                // Pointer to "some" and "full" lines
+    char    *avg10, *avg60, *avg300, *total;   // Pointer to entries within line
+    float   *avg[2][3];             // Pointers to the averages to update
+    uint64_t *tot[2], *diff[2];     // Pointers to the totals to update
+    uint64_t value;                 // Temporary value read from file
+    _LnxFlt returnflt;              // Fault from file read
+
+    for (i = 0; i != LNX_NUM_PSI; i++) {
+        returnflt = this->ReadProcFile(&this->PressureFd[i], this->PressureFile[i],
+                                       LnxCond_PressureOpen, LnxCond_PressureRead,
+                                       LnxCond_PressureRead);
+        if (returnflt != LnxCond_NoFault)               // If unable to read file
+            return (returnflt);                         // Return fault
+
+        ptr[0] = strstr(this->ProcBuff, "some ");       // Find "some" line
+        ptr[1] = strstr(this->ProcBuff, "full ");       // Find "full" line (not within older
+                                                        // kernels for CPU)
+        avg[0][0] = &this->Pressure[i].SomeAvg10;   avg[1][0] = &this->Pressure[i].FullAvg10;
+        avg[0][1] = &this->Pressure[i].SomeAvg60;   avg[1][1] = &this->Pressure[i].FullAvg60;
+        avg[0][2] = &this->Pressure[i].SomeAvg300;  avg[1][2] = &this->Pressure[i].FullAvg300;
+        tot[0]    = &this->Pressure[i].SomeTotal;   tot[1]    = &this->Pressure[i].FullTotal;
+        diff[0]   = &this->Pressure[i].SomeDiff;    diff[1]   = &this->Pressure[i].FullDiff;
+
+        if (ptr[0] == nullptr)                          // If "some" line not found
+            return (LnxCond_PressureConvert);           // then layout is unexpected
+
+        for (uint8_t j = 0; j != 2; j++) {              // Loop through "some" and "full" lines
+            if (ptr[j] == nullptr)                      // If line is not present, then skip
+                continue;
+
+            avg10  = strstr(ptr[j], "avg10=");
+            avg60  = strstr(ptr[j], "avg60=");
+            avg300 = strstr(ptr[j], "avg300=");
+            total  = strstr(ptr[j], "total=");
+            if ((avg10 == nullptr) || (avg60 == nullptr) ||
+                (avg300 == nullptr) || (total == nullptr))
+                return (LnxCond_PressureConvert);       // If entry not found, then layout is
+                                                        // unexpected
+            *avg[j][0] = strtof(avg10  + 6, nullptr);
+            *avg[j][1] = strtof(avg60  + 6, nullptr);
+            *avg[j][2] = strtof(avg300 + 7, nullptr);
+
+            value = strtoull(total + 6, nullptr, 10);
+            *diff[j] = ((this->classmode & LNX_PRESSURE_PASS) == LNX_PRESSURE_PASS) ?
+                        (value - *tot[j]) : 0;          // Change can only be determined after the
+                                                        // first read
+            *tot[j]  = value;
+        }
+    }
+
+    this->classmode |= LNX_PRESSURE_PASS;               // Indicate first read has been done
+    return (LnxCond_NoFault);
+}
+
+_LnxFlt LnxCond::ReadMemory(void) {
+/**************************************************************************************************
+ * Function will read the Memory Information file, and capture the selected entries within
+ * "Memory". Each line is of the form:
+ *      MemTotal:         949444 kB
+ *************************************************************************************************/
+    uint8_t i;                      // Variable used for looping through entries
+    char    *ptr;                   // Pointer to entry within file
+    _LnxFlt returnflt;              // Fault from file read
+
+    const char  *Field[] = { "MemTotal", "MemFree", "MemAvailable", "Buffers",
+                             "Cached", "Dirty", "SwapTotal", "SwapFree" };
+    uint32_t    *Value[] = { &this->Memory.MemTotal, &this->Memory.MemFree,
+                             &this->Memory.MemAvailable, &this->Memory.Buffers,
+                             &this->Memory.Cached, &this->Memory.Dirty,
+                             &this->Memory.SwapTotal, &this->Memory.SwapFree };
+
+    returnflt = this->ReadProcFile(&this->MemoryFd, this->MemoryFile,
+                                   LnxCond_MemoryOpen, LnxCond_MemoryRead, LnxCond_MemoryRead);
+    if (returnflt != LnxCond_NoFault)                   // If unable to read file
+        return (returnflt);                             // Return fault
+
+    for (i = 0; i != (sizeof(Field) / sizeof(Field[0])); i++) {
+        ptr = this->FindField(this->ProcBuff, Field[i]);
+        if (ptr == nullptr)                             // If entry not found, then layout is
+            return (LnxCond_MemoryConvert);             // unexpected
+
+        *Value[i] = (uint32_t)strtoul(ptr, nullptr, 10);
+    }
+
+    return (LnxCond_NoFault);
+}
+
+_LnxFlt LnxCond::ReadInterrupts(void) {
+/**************************************************************************************************
+ * Function will read the Interrupts file, and capture the count of each interrupt line (total of
+ * all cores), along with the rate since the previous read. File is of the form:
+ *                 CPU0       CPU1       CPU2       CPU3
+ *       23:          0          0          0          0  ARMCTRL-level   1 Edge      spi0
+ *      IPI0:         0          0          0          0  CPU wakeup interrupts
+ *
+ * The header line is used to determine the number of cores (as offline cores are not listed).
+ * Each interrupt line is compared against the same position from the previous read, if the label
+ * does not match (interrupt line has been registered/freed), then no rate is determined for the
+ * line on this pass.
+ * If there are more lines than "LNX_MAX_IRQS", or the file does not fit within "ProcBuff" (the
+ * partial final line is then discarded), the lines which fit are still captured, and
+ * 'IRQOverflow' is returned.
+ *************************************************************************************************/
+    char    *line;                  // Pointer to start of current line
+    char    *ptr, *next;            // Pointers to entries within line
+    char    *end;                   // Pointer to end of current line
+    uint8_t numcpu = 0;             // Number of cores within file
+    uint8_t cpu;                    // Variable used for looping through cores
+    uint16_t entry = 0;             // Entry within "IRQ"
+    uint32_t count;                 // Count of interrupts for line
+    size_t  len;                    // Length of entry
+    float   elapsed;                // Time since previous read (s)
+    struct timespec now;            // Time of this read
+    _LnxFlt returnflt;              // Fault from file read
+
+    returnflt = this->ReadProcFile(&this->IRQFd, this->IRQFile, LnxCond_IRQOpen, LnxCond_IRQRead,
+                                   LnxCond_IRQOverflow);
+    if (returnflt == LnxCond_IRQOverflow) {             // If file has been truncated, then
+        end = strrchr(this->ProcBuff, '\n');            // discard the partial final line
+        if (end != nullptr)
+            end[1] = '\0';
+    }
+    else if (returnflt != LnxCond_NoFault)              // If unable to read file
+        return (returnflt);                             // Return fault
+
+    if (this->ReplayCnt != 0)                           // If replaying snapshots, then use the
+        elapsed = 1 / this->CheckFreq;                  // rate the snapshots were recorded at
+    else {                                              // Otherwise capture time of read
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        elapsed = (float)(now.tv_sec - this->IRQTime.tv_sec) +
+                  ((float)(now.tv_nsec - this->IRQTime.tv_nsec) / 1e9f);
+        this->IRQTime = now;
+    }
+
+    line = strchr(this->ProcBuff, '\n');                // Find end of header line
+    if (line == nullptr)
+        return (LnxCond_IRQConvert);                    // If not found, layout is unexpected
+    *line++ = '\0';                                     // Terminate header, and point to next line
+
+    ptr = this->ProcBuff;                               // Count number of cores within header
+    while ((ptr = strstr(ptr, "CPU")) != nullptr) {
+        numcpu++;
+        ptr += 3;
+    }
+    if (numcpu == 0)                                    // If no cores found, layout is unexpected
+        return (LnxCond_IRQConvert);
+
+    while (*line != '\0') {
+        if (entry == LNX_MAX_IRQS) {                    // If there is no space for the line
+            returnflt = LnxCond_IRQOverflow;            // Indicate fault, and skip the rest
+            break;
+        }
+
+        end = strchr(line, '\n');                       // Find end of line, and terminate
+        if (end != nullptr)
+            *end = '\0';
+
+        while (*line == ' ')                            // Skip leading spaces of label
+            line++;
+        ptr = strchr(line, ':');                        // Find end of label
+        if (ptr == nullptr)                             // If not found, layout is unexpected
+            return (LnxCond_IRQConvert);
+
+        count = 0;                                      // Total the count for all cores
+        next  = ptr + 1;
+        for (cpu = 0; cpu != numcpu; cpu++) {           // Some lines (i.e. "ERR:") only have a
+            ptr = next;                                 // single count, so stop at first
+            count += (uint32_t)strtoul(ptr, &next, 10); // non-number
+            if (next == ptr)
+                break;
+        }
+
+        len = strchr(line, ':') - line;                 // Determine length of label
+        if (len > (LNX_IRQ_NAME - 1))                   // Limit length to size of array
+            len = LNX_IRQ_NAME - 1;
+
+        if ((entry < this->IRQCnt) && (strncmp(this->IRQ[entry].Name, line, len) == 0) &&
+            (this->IRQ[entry].Name[len] == '\0')) {
+            // If same interrupt line as previous read, then determine rate
+            this->IRQ[entry].Diff = count - this->IRQ[entry].Count;
+            this->IRQ[entry].Rate = (elapsed > 0) ? ((float)this->IRQ[entry].Diff / elapsed) : 0;
+        }
+        else {
+            memcpy(this->IRQ[entry].Name, line, len);   // Otherwise capture new label
+            this->IRQ[entry].Name[len] = '\0';
+            this->IRQ[entry].Diff = 0;
+            this->IRQ[entry].Rate = 0.00;
+        }
+        this->IRQ[entry].Count = count;
+
+        ptr = strrchr(next, ' ');                       // Capture last entry of line as device
+        ptr = (ptr == nullptr) ? next : (ptr + 1);
+        len = strlen(ptr);
+        if (len > (LNX_IRQ_DESC - 1))                   // Limit length to size of array
+            len = LNX_IRQ_DESC - 1;
+        memcpy(this->IRQ[entry].Desc, ptr, len);
+        this->IRQ[entry].Desc[len] = '\0';
+
+        entry++;
+        if (end == nullptr)                             // If last line of file, then exit
+            break;
+        line = end + 1;
+    }
+
+    this->IRQCnt = entry;                               // Update number of interrupt lines
+    return (returnflt);                                 // Return overflow (if any)
+}
+
+_LnxFlt LnxCond::StartLatency(uint32_t Period, int Priority, int Core) {
+/**************************************************************************************************
+ * Function will start the latency probe thread, which will wake every "Period" (us), and capture
+ * how late the wake-up was.
+ * Thread is run with real-time priority "Priority" (SCHED_FIFO 1 to 99), or as a normal thread if
+ * 0. If "Core" is not -1, then the thread is limited to that core.
+ * If the thread cannot be started (i.e. no permission for real-time priority), will return
+ * 'LatencyStart'
+ *************************************************************************************************/
+    pthread_attr_t attr;            // Attributes of probe thread
+    struct sched_param param;       // Priority of probe thread
+    cpu_set_t cpuset;               // Core for probe thread
+    int returnval;                  // Return value from thread creation
+
+    if (this->LatencyState == LNX_LAT_RUNNING)  // If probe is already running, then stop it
+        this->StopLatency();
+
+    memset(this->LatencyCount, 0, sizeof(this->LatencyCount));  // Clear all statistics
+    memset(this->LatencyPrev,  0, sizeof(this->LatencyPrev));
+    memset(this->LatencyHist,  0, sizeof(this->LatencyHist));
+    memset(&this->Latency, 0, sizeof(this->Latency));
+    this->LatencySum     = 0;
+    this->LatencyPrevSum = 0;
+    this->LatencyIntMin  = UINT32_MAX;
+    this->LatencyIntMax  = 0;
+    this->LatencySeq     = 0;
+    this->LatencyPeriod  = Period;
+
+    pthread_attr_init(&attr);
+    if (Priority != 0) {                        // If real-time priority requested
+        pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+        pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+        param.sched_priority = Priority;
+        pthread_attr_setschedparam(&attr, &param);
+    }
+    if (Core >= 0) {                            // If core requested
+        CPU_ZERO(&cpuset);
+        CPU_SET(Core, &cpuset);
+        pthread_attr_setaffinity_np(&attr, sizeof(cpuset), &cpuset);
+    }
+
+    __atomic_store_n(&this->LatencyState, LNX_LAT_RUNNING, __ATOMIC_RELEASE);
+    returnval = pthread_create(&this->LatencyHandle, &attr, &LnxCond::LatencyThread, this);
+    pthread_attr_destroy(&attr);
+
+    if (returnval != 0) {                       // If unable to start thread
+        __atomic_store_n(&this->LatencyState, LNX_LAT_STOPPED, __ATOMIC_RELEASE);
+        return (LnxCond_LatencyStart);          // Return fault
+    }
+
+    return (LnxCond_NoFault);
+}
+
+void LnxCond::StopLatency(void) {
+/**************************************************************************************************
+ * Function will stop the latency probe thread, and wait for it to exit (will take up to a single
+ * period)
+ *************************************************************************************************/
+    if (this->LatencyState != LNX_LAT_RUNNING)  // If probe is not running, then exit
+        return;
+
+    __atomic_store_n(&this->LatencyState, LNX_LAT_STOPPED, __ATOMIC_RELEASE);
+    pthread_join(this->LatencyHandle, nullptr);
+}
+
+void *LnxCond::LatencyThread(void *Cond) {
+/**************************************************************************************************
+ * Latency probe thread. Will sleep until the next period (absolute time, so time to process does
+ * not drift the period), then capture the difference between the requested and actual wake-up
+ * time.
+ * If the wake-up is later then a full period, the next wake-up is based upon the current time -
+ * so missed periods are not all captured.
+ * The histogram and total are only written by this thread, the minimum and maximum are also reset
+ * by the reading thread - so are updated with a compare and swap. The sequence count is made odd
+ * whilst the statistics are being updated, so the reading thread can take a consistent copy
+ * within "UpdateLatency".
+ *************************************************************************************************/
+    LnxCond *Lnx = (LnxCond *)Cond; // Class which started the thread
+    struct timespec next, now;      // Requested, and actual wake-up time
+    int64_t  diff;                  // Difference between wake-up times (ns)
+    uint32_t latency;               // Wake-up latency (us)
+    uint32_t bucket;                // Entry within histogram
+    uint32_t seq;                   // Sequence count of updates
+    uint32_t value;                 // Current minimum/maximum
+
+    clock_gettime(CLOCK_MONOTONIC, &next);
+
+    while (__atomic_load_n(&Lnx->LatencyState, __ATOMIC_ACQUIRE) == LNX_LAT_RUNNING) {
+        next.tv_nsec += (long)Lnx->LatencyPeriod * 1000;    // Determine next wake-up time
+        while (next.tv_nsec >= 1000000000) {
+            next.tv_nsec -= 1000000000;
+            next.tv_sec++;
+        }
+
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, nullptr);
+        clock_gettime(CLOCK_MONOTONIC, &now);
+
+        diff = ((int64_t)(now.tv_sec - next.tv_sec) * 1000000000) + (now.tv_nsec - next.tv_nsec);
+        if (diff < 0)
+            diff = 0;
+        latency = (uint32_t)(diff / 1000);
+
+        if (latency > Lnx->LatencyPeriod)   // If later then a full period, then restart from
+            next = now;                     // current time
+
+        bucket = (latency < LNX_LAT_BUCKETS) ? latency : LNX_LAT_BUCKETS;
+
+        seq = Lnx->LatencySeq;                      // Indicate update has started (odd)
+        __atomic_store_n(&Lnx->LatencySeq, seq + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+
+        __atomic_store_n(&Lnx->LatencyCount[bucket], Lnx->LatencyCount[bucket] + 1,
+                         __ATOMIC_RELAXED);
+        __atomic_store_n(&Lnx->LatencySum, Lnx->LatencySum + latency, __ATOMIC_RELAXED);
+
+        value = __atomic_load_n(&Lnx->LatencyIntMax, __ATOMIC_RELAXED);
+        while ( (latency > value) &&
+                (!__atomic_compare_exchange_n(&Lnx->LatencyIntMax, &value, latency, false,
+                                              __ATOMIC_RELAXED, __ATOMIC_RELAXED)) ) {};
+        value = __atomic_load_n(&Lnx->LatencyIntMin, __ATOMIC_RELAXED);
+        while ( (latency < value) &&
+                (!__atomic_compare_exchange_n(&Lnx->LatencyIntMin, &value, latency, false,
+                                              __ATOMIC_RELAXED, __ATOMIC_RELAXED)) ) {};
+
+        __atomic_store_n(&Lnx->LatencySeq, seq + 2, __ATOMIC_RELEASE);  // Update complete
+    }
+
+    return (nullptr);
+}
+
+void LnxCond::UpdateLatency(void) {
+/**************************************************************************************************
+ * Function will update the latency statistics for the wake-ups since the previous call.
+ * The histogram since the previous call is the difference between the probe histogram, and a copy
+ * taken at the previous call. The 99.9th percentile is then the first entry where the running
+ * total of the histogram reaches 99.9% of the wake-ups.
+ * Minimum and maximum are exchanged with the probe thread (reset for the next call).
+ *
+ * The histogram, total, minimum and maximum are copied as a single snapshot; the sequence count
+ * of the probe thread is checked before and after the copy, and if an update has occurred, the
+ * copy is repeated. The minimum/maximum exchanged by each attempt are combined, so all the
+ * statistics cover the same wake-ups.
+ *************************************************************************************************/
+    uint32_t i;                     // Variable for looping through histogram
+    uint32_t value;                 // Exchanged minimum/maximum
+    uint64_t total;                 // Running total of histogram
+    uint64_t target;                // Number of wake-ups for 99.9th percentile
+    uint64_t sum;                   // Current total latency
+    uint32_t seq;                   // Sequence count of probe updates at start of copy
+    uint32_t samples = 0;           // Number of wake-ups since previous call
+
+    if (this->LatencyState != LNX_LAT_RUNNING)  // If probe is not running, then exit
+        return;
+
+    this->Latency.Min = UINT32_MAX;
+    this->Latency.Max = 0;
+
+    do {
+        do {                                    // If probe is part way through an update, then
+            seq = __atomic_load_n(&this->LatencySeq, __ATOMIC_ACQUIRE); // wait for it to complete
+        } while ((seq & 1) != 0);
+
+        for (i = 0; i != (LNX_LAT_BUCKETS + 1); i++)    // Copy probe histogram
+            this->LatencyHist[i] = __atomic_load_n(&this->LatencyCount[i], __ATOMIC_RELAXED);
+        sum = __atomic_load_n(&this->LatencySum, __ATOMIC_RELAXED);
+
+        value = __atomic_exchange_n(&this->LatencyIntMax, 0, __ATOMIC_RELAXED);
+        if (value > this->Latency.Max)
+            this->Latency.Max = value;
+        value = __atomic_exchange_n(&this->LatencyIntMin, UINT32_MAX, __ATOMIC_RELAXED);
+        if (value < this->Latency.Min)
+            this->Latency.Min = value;
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while (seq != __atomic_load_n(&this->LatencySeq, __ATOMIC_RELAXED));
+
+    for (i = 0; i != (LNX_LAT_BUCKETS + 1); i++) {  // Determine histogram since previous call
+        value = this->LatencyHist[i];
+        this->LatencyHist[i] = value - this->LatencyPrev[i];
+        this->LatencyPrev[i] = value;
+        samples += this->LatencyHist[i];
+    }
+
+    this->Latency.Samples  = samples;
+    this->Latency.Overflow = this->LatencyHist[LNX_LAT_BUCKETS];
+
+    if (samples == 0) {                         // If no wake-ups since previous call
+        this->Latency.Min  = 0;                 // then clear statistics
+        this->Latency.Max  = 0;
+        this->Latency.Avg  = 0.00;
+        this->Latency.P999 = 0;
+        return;
+    }
+
+    this->Latency.Avg = ((float)(sum - this->LatencyPrevSum)) / ((float)samples);
+    this->LatencyPrevSum = sum;
+
+    if (this->Latency.Max > this->Latency.MaxTotal)
+        this->Latency.MaxTotal = this->Latency.Max;
+
+    target = ((uint64_t)samples * 999 + 999) / 1000;    // 99.9% of wake-ups (rounded up)
+    total  = 0;
+    for (i = 0; i != (LNX_LAT_BUCKETS + 1); i++) {
+        total += this->LatencyHist[i];
+        if (total >= target)
+            break;
     }
+    this->Latency.P999 = (i < LNX_LAT_BUCKETS) ? i : this->Latency.Max;
+        // If within final entry (beyond histogram), use maximum
 }
 
 _LnxFlt LnxCond::UpdateStatus(void) {
@@ -147,11 +1028,32 @@ _LnxFlt LnxCond::UpdateStatus(void) {
  * Embedded Device
  * If any failure has been detected during reading of files, the function will return a fault
  * code, as per the enumerate type.
+ *
+ * If the class is replaying snapshots, then each call will move onto the next snapshot within
+ * the replay directory - "Replay"/0000, "Replay"/0001, etc. Each snapshot is laid out the same as
+ * the root of the filesystem (i.e. "Replay"/0000/proc/stat). Once all snapshots have been
+ * replayed, will return 'ReplayEnd'.
+ * Only the temperature and CPU load files are required within the snapshot, all other files are
+ * skipped if not present.
  *************************************************************************************************/
     std::ifstream EmbDevfile;       // Stream used to read parameters within file structure
     std::string line;               // String variable for capturing single line from file up to
                                     // "\n"
-    int TempInt;                    // Temporary Integer for function
+    char *endptr;                   // Pointer to end of converted number
+    long TempInt;                   // Temporary Integer for function
+    char SnapLoc[8];                // Name of snapshot directory
+
+    if (this->ReplayCnt != 0) {     // If replaying snapshots
+        if (this->ReplayPos == this->ReplayCnt) {   // If all snapshots have been replayed
+            this->FaultCode = LnxCond_ReplayEnd;        // Update Fault Code
+            return (this->FaultCode);                   // Return fault
+        }
+
+        snprintf(SnapLoc, sizeof(SnapLoc), "/%04u", this->ReplayPos++);
+        this->SetRoot(this->ReplayDir + SnapLoc);   // Move onto next snapshot
+    }
+
+    this->UpdateLatency();          // Update latency probe statistics (if running)
 
     // First check is to retrieve the CPU temperature of Linux Embedded Device
     EmbDevfile.open(this->TemperatureFile);     // Open file
@@ -162,7 +1064,11 @@ _LnxFlt LnxCond::UpdateStatus(void) {
     else {  // If read is successful then
         if (std::getline(EmbDevfile, line)) {   // Read the first (and only) line in Temperature
                                                 // file
-            TempInt = std::stoi(line, nullptr);     // Convert number in file to integer
+            TempInt = strtol(line.c_str(), &endptr, 10);    // Convert number in file to integer
+            if (endptr == line.c_str()) {               // If no number within file
+                this->FaultCode = LnxCond_TemperatureRead;  // Update Fault Code
+                return (this->FaultCode);                   // Return fault
+            }
             this->Temp = ((float)TempInt) / 1000;   // Transform scaled number into floating point
         }
         else {                                  // If read is unsuccessful then:
@@ -178,6 +1084,7 @@ _LnxFlt LnxCond::UpdateStatus(void) {
     // So if this is the first pass, then need to capture initial data point. Then on second+
     // runs can determine the load
     uint8_t j;                      // Variables used for looping with arrays
+    uint8_t core;                   // Core number of converted line
 
     EmbDevfile.open(this->CPUFile);         // Open file
     if (!EmbDevfile.is_open()) {            // If unable to open file
@@ -186,16 +1093,34 @@ _LnxFlt LnxCond::UpdateStatus(void) {
     }
     else {  // If read is successful then
             // Update the current CPU array to the latest data
-        for (j = 0; j != (LNX_NUM_CORES + 1); j++) {// Loop through the top level array entries
-            if (std::getline(EmbDevfile, line)) {   // Read the line, and then convert
-                this->FaultCode = this->ConvertCPUText(this->CurCPU[j], line);
-                    // Convert line into array entries
-                if (this->FaultCode != LnxCond_NoFault)
-                    return(this->FaultCode);        // Return fault
-            }
-            else {                                  // If read is unsuccessful then:
-                this->FaultCode = LnxCond_CPULoadRead;  // Update Fault Code
-                return (this->FaultCode);               // Return fault
+        for (j = 0; j != (LNX_NUM_CORES + 1); j++)  // Loop through the top level array entries
+            this->CoreOnline[j] = 0;                // and set as offline until read
+        this->OnlineCnt = 0;                        // No cores listed until read
+
+        while (std::getline(EmbDevfile, line)) {    // Read each line
+            if (line.compare(0, 3, "cpu") != 0)     // If not a "cpu" line, then all cores have
+                break;                              // been read
+
+            this->FaultCode = this->ConvertCPUText(this->CurCPU, line.c_str(), &core);
+                // Convert line into array entries
+            if (this->FaultCode != LnxCond_NoFault)
+                return(this->FaultCode);            // Return fault
+
+            if (core != LNX_CORE_IGNORE)            // If core is within array
+                this->CoreOnline[core] = 1;         // indicate core is online
+            if (core != 0)                          // Count each core listed (even if beyond
+                this->OnlineCnt++;                  // the array), for the thread loads
+        }
+
+        if (this->CoreOnline[0] == 0) {             // If total entry has not been read
+            this->FaultCode = LnxCond_CPULoadRead;      // Update Fault Code
+            return (this->FaultCode);                   // Return fault
+        }
+
+        for (j = 1; j != (LNX_NUM_CORES + 1); j++) {// Any cores which are offline, have their
+            if (this->CoreOnline[j] == 0) {         // previous entries copied across, so no
+                for (core = 0; core != LNX_NUM_CPU_STATES; core++)  // change is seen
+                    this->CurCPU[j][core] = this->PrevCPU[j][core];
             }
         }
 
@@ -212,6 +1137,63 @@ _LnxFlt LnxCond::UpdateStatus(void) {
 
     EmbDevfile.close();         // Close file
 
+    // Third check is to retrieve the status of each thread within this process
+    // Uses the CPU time calculated in the second check, so the load of each thread can only be
+    // determined from the second pass onwards
+    char    ThreadBuff[LNX_THREAD_BUFF];    // Buffer used to read thread files
+    uint16_t k;                             // Variable used for looping through threads
+    _LnxFlt ThreadFlt = this->ScanThreads();// Update list of threads
+
+    if ((ThreadFlt == LnxCond_ThreadOpen) && (this->ReplayCnt != 0))
+        ThreadFlt = LnxCond_NoFault;        // If replaying, thread directory is optional
+    else if (ThreadFlt == LnxCond_ThreadOpen) {     // If unable to open thread directory
+        this->FaultCode = ThreadFlt;            // Update Fault Code
+        return (this->FaultCode);               // Return fault
+    }
+
+    k = 0;
+    while (k != this->ThreadCnt) {          // Loop through all captured threads
+        this->FaultCode = this->ReadThread(&this->Thread[k], ThreadBuff);
+
+        if (this->FaultCode == LnxCond_ThreadRead)  // If unable to read, then thread has exited
+            this->RemoveThread(k);                  // Remove (last entry is moved into "k")
+        else if (this->FaultCode != LnxCond_NoFault)
+            return (this->FaultCode);               // Return fault
+        else
+            k++;
+    }
+
+    if (ThreadFlt != LnxCond_NoFault) {     // If there was a fault during the scan
+        this->FaultCode = ThreadFlt;            // Update Fault Code
+        return (this->FaultCode);               // Return fault
+    }
+
+    // Fourth check is to retrieve the Pressure Stall, Memory and Interrupt information
+    // Pressure Stall is only supported in newer kernels, so if the files cannot be opened it will
+    // no longer be checked
+    if ((this->classmode & LNX_NO_PRESSURE) != LNX_NO_PRESSURE) {
+        this->FaultCode = this->ReadPressure();
+        if (this->FaultCode == LnxCond_PressureOpen) {  // If not supported
+            this->classmode |= LNX_NO_PRESSURE;         // Then no longer check
+            if (this->ReplayCnt != 0)                   // If replaying, file is optional
+                this->FaultCode = LnxCond_NoFault;
+        }
+        if (this->FaultCode != LnxCond_NoFault)
+            return (this->FaultCode);                   // Return fault
+    }
+
+    this->FaultCode = this->ReadMemory();
+    if ((this->FaultCode == LnxCond_MemoryOpen) && (this->ReplayCnt != 0))
+        this->FaultCode = LnxCond_NoFault;              // If replaying, file is optional
+    if (this->FaultCode != LnxCond_NoFault)
+        return (this->FaultCode);                       // Return fault
+
+    this->FaultCode = this->ReadInterrupts();
+    if ((this->FaultCode == LnxCond_IRQOpen) && (this->ReplayCnt != 0))
+        this->FaultCode = LnxCond_NoFault;              // If replaying, file is optional
+    if (this->FaultCode != LnxCond_NoFault)
+        return (this->FaultCode);                       // Return fault
+
     this->FaultCode = LnxCond_NoFault;  // Update Fault Code
     return (this->FaultCode);           // If have made it this far, then function has completed
                                         // successfully return safe code
@@ -219,6 +1201,6 @@ _LnxFlt LnxCond::UpdateStatus(void) {
 
 LnxCond::~LnxCond()
 {
-    // TODO Auto-generated destructor stub
+    this->StopLatency();                        // Stop latency probe (if running)
+    this->CloseFiles();                         // Close all files kept open
 }
-
@@ -0,0 +1,202 @@
+/**************************************************************************************************
+ * @file        LnxPerf.cpp
+ * @author      Thomas
+ * @brief       Source file for the Linux Embedded Device Performance Counters
+ **************************************************************************************************
+ @ attention
+
+ << To be Introduced >>
+
+ *************************************************************************************************/
+#include "LnxCond/LnxPerf.h"
+
+void LnxPerf::InitialSetup() {
+/**************************************************************************************************
+ * When invoking this, it will populate the class with default parameters
+ *************************************************************************************************/
+    uint8_t i = 0;                  // Variable for looping
+
+    this->EventCnt      = 0;        // No counters opened yet
+    this->StartEnabled  = 0;
+    this->StartRunning  = 0;
+    this->perfmode      = 0;        // Default mode, not within region
+
+    this->Software      = 0;        // Default to hardware counters
+    this->Multiplexed   = 0;
+    this->Scopes        = 0;
+    this->FaultCode     = LnxPerf_Initialised;  // Default FaultCode to initialised
+
+    for (i = 0; i != LNX_PERF_NUM_EVENTS; i++) {    // Loop through counter entries
+        this->EventFd[i]    = -1;                   // and clear them all
+        this->Start[i]      = 0;
+        this->Count[i]      = 0;
+        this->Total[i]      = 0;
+    }
+}
+
+LnxPerf::LnxPerf() {
+/**************************************************************************************************
+ * Calling condition for Linux Embedded Performance Counters class.
+ * When invoking this, it will open the hardware counters for the calling thread, if these are not
+ * available then it will open the software counters instead.
+ * If neither can be opened, "FaultCode" will be set to 'Open'
+ *************************************************************************************************/
+    const uint32_t  HWType[]    = { PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+                                    PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE };
+    const uint64_t  HWConfig[]  = { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                    PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES };
+
+    const uint32_t  SWType[]    = { PERF_TYPE_SOFTWARE, PERF_TYPE_SOFTWARE };
+    const uint64_t  SWConfig[]  = { PERF_COUNT_SW_TASK_CLOCK, PERF_COUNT_SW_CONTEXT_SWITCHES };
+
+    this->InitialSetup();           // Call hidden function defaulting all parameters
+
+    this->FaultCode = this->OpenGroup(HWType, HWConfig, 4);
+    if (this->FaultCode != LnxPerf_NoFault) {   // If hardware counters are not available
+        this->Software  = 1;                    // then use software counters
+        this->FaultCode = this->OpenGroup(SWType, SWConfig, 2);
+    }
+}
+
+_LnxPerfFlt LnxPerf::OpenGroup(const uint32_t Type[], const uint64_t Config[], uint8_t Num) {
+/**************************************************************************************************
+ * Function will open "Num" counters, as per the "Type" and "Config" arrays, as a single group
+ * for the calling thread (on any CPU).
+ * The first counter is the group leader, all others are attached to it - so the whole group is
+ * scheduled onto the CPU together, and can be read with a single call.
+ * Only user space is counted, as this is allowed with the default "perf_event_paranoid" setting.
+ * If any counter cannot be opened, all are closed and a fault is returned.
+ *************************************************************************************************/
+    struct perf_event_attr attr;    // Configuration of counter
+    uint8_t i;                      // Variable for looping
+
+    this->CloseGroup();             // Close any counters already opened
+
+    for (i = 0; i != Num; i++) {
+        memset(&attr, 0, sizeof(attr));
+        attr.size           = sizeof(attr);
+        attr.type           = Type[i];
+        attr.config         = Config[i];
+        attr.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                              PERF_FORMAT_TOTAL_TIME_RUNNING;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+
+        this->EventFd[i] = (int)syscall(__NR_perf_event_open, &attr, 0, -1,
+                                        (i == 0) ? -1 : this->EventFd[0], 0);
+                // pid = 0 (calling thread), cpu = -1 (any), group = leader (first counter)
+
+        if (this->EventFd[i] < 0) {             // If unable to open counter
+            this->CloseGroup();                 // Close all counters
+            return (LnxPerf_Open);              // Return fault
+        }
+
+        this->EventCnt++;
+    }
+
+    return (LnxPerf_NoFault);
+}
+
+void LnxPerf::CloseGroup(void) {
+/**************************************************************************************************
+ * Function will close all counters which have been opened
+ *************************************************************************************************/
+    uint8_t i;                      // Variable for looping
+
+    for (i = 0; i != LNX_PERF_NUM_EVENTS; i++) {
+        if (this->EventFd[i] >= 0)
+            close(this->EventFd[i]);
+        this->EventFd[i] = -1;
+    }
+
+    this->EventCnt = 0;
+}
+
+_LnxPerfFlt LnxPerf::ReadGroup(uint64_t Values[], uint64_t *Enabled, uint64_t *Running) {
+/**************************************************************************************************
+ * Function will read all counters within the group (single read of the group leader), which is
+ * of the form:
+ *      nr              = Number of counters
+ *      time_enabled    = Time group has been enabled
+ *      time_running    = Time group has been running on the CPU
+ *      value[nr]       = Value of each counter
+ *************************************************************************************************/
+    uint64_t buff[3 + LNX_PERF_NUM_EVENTS]; // Buffer for read
+    ssize_t len;                    // Number of bytes read
+    uint8_t i;                      // Variable for looping
+
+    if (this->EventCnt == 0)                            // If no counters are open
+        return (LnxPerf_Open);                          // Return fault
+
+    len = read(this->EventFd[0], buff, sizeof(buff));
+    if ((len < (ssize_t)((3 + this->EventCnt) * sizeof(uint64_t))) || (buff[0] != this->EventCnt))
+        return (LnxPerf_Read);                          // If read is incomplete, return fault
+
+    *Enabled = buff[1];
+    *Running = buff[2];
+    for (i = 0; i != this->EventCnt; i++)
+        Values[i] = buff[3 + i];
+
+    return (LnxPerf_NoFault);
+}
+
+_LnxPerfFlt LnxPerf::Begin(void) {
+/**************************************************************************************************
+ * Function will capture the counters at the start of the region to be measured.
+ *************************************************************************************************/
+    this->FaultCode = this->ReadGroup(this->Start, &this->StartEnabled, &this->StartRunning);
+
+    if (this->FaultCode == LnxPerf_NoFault)             // If read successfully
+        this->perfmode |= LNX_PERF_IN_SCOPE;            // Indicate within region
+
+    return (this->FaultCode);
+}
+
+_LnxPerfFlt LnxPerf::End(void) {
+/**************************************************************************************************
+ * Function will capture the counters at the end of the region to be measured, and update "Count"
+ * with the difference from "Begin", and add this to "Total".
+ *************************************************************************************************/
+    uint64_t values[LNX_PERF_NUM_EVENTS];   // Counts at end of region
+    uint64_t enabled, running;      // Time counters enabled/running at end of region
+    uint8_t i;                      // Variable for looping
+
+    if ((this->perfmode & LNX_PERF_IN_SCOPE) != LNX_PERF_IN_SCOPE) {
+        this->FaultCode = LnxPerf_Scope;        // If "Begin" has not been called
+        return (this->FaultCode);               // Return fault
+    }
+    this->perfmode &= ~LNX_PERF_IN_SCOPE;       // Clear flag
+
+    this->FaultCode = this->ReadGroup(values, &enabled, &running);
+    if (this->FaultCode != LnxPerf_NoFault)     // If unable to read
+        return (this->FaultCode);               // Return fault
+
+    for (i = 0; i != this->EventCnt; i++) {
+        this->Count[i]  = values[i] - this->Start[i];
+        this->Total[i] += this->Count[i];
+    }
+    this->Scopes++;
+
+    // If the group was not running for the whole time it was enabled, the counters have been
+    // shared with other groups
+    this->Multiplexed = ((enabled - this->StartEnabled) != (running - this->StartRunning)) ? 1 : 0;
+
+    return (this->FaultCode);
+}
+
+void LnxPerf::Reset(void) {
+/**************************************************************************************************
+ * Function will clear the total counts of all regions
+ *************************************************************************************************/
+    uint8_t i;                      // Variable for looping
+
+    for (i = 0; i != LNX_PERF_NUM_EVENTS; i++)
+        this->Total[i] = 0;
+
+    this->Scopes = 0;
+}
+
+LnxPerf::~LnxPerf()
+{
+    this->CloseGroup();             // Close all counters
+}
@@ -0,0 +1,140 @@
+/**************************************************************************************************
+ * @file        FormEvent.cpp
+ * @author      Thomas
+ * @brief       Source file for the Request Form completion event
+ **************************************************************************************************
+  @ attention
+
+  << To be Introduced >>
+
+ *************************************************************************************************/
+#include <FileIndex.h>
+#include FilInd_FrmEvtHD
+
+FormEvent::FormEvent() {
+/**************************************************************************************************
+ * Create the event, with no signals.
+ *************************************************************************************************/
+    _count_ = 0;                        // No signals
+
+#if defined(zz__MiRaspbPi__zz)          // If the target device is an Raspberry Pi then
+//=================================================================================================
+    pthread_condattr_t  attr;           // Attributes of condition
+
+    pthread_mutex_init(&_lock_, __null);
+
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);  // Timeout is not affected by changes
+    pthread_cond_init(&_cond_, &attr);                  // to the system time
+    pthread_condattr_destroy(&attr);
+
+#endif
+}
+
+void FormEvent::clear(void) {
+/**************************************************************************************************
+ * Clear the number of signals. To be called prior to the Request Forms being requested.
+ *************************************************************************************************/
+#if defined(zz__MiRaspbPi__zz)          // If the target device is an Raspberry Pi then
+//=================================================================================================
+    pthread_mutex_lock(&_lock_);
+    _count_ = 0;
+    pthread_mutex_unlock(&_lock_);
+
+#else
+//=================================================================================================
+    _count_ = 0;
+
+#endif
+}
+
+void FormEvent::signal(void) {
+/**************************************************************************************************
+ * Signal the event (increment the number of signals), and wake any waiting thread.
+ * For STM32, can be called from an interrupt.
+ *************************************************************************************************/
+#if defined(zz__MiRaspbPi__zz)          // If the target device is an Raspberry Pi then
+//=================================================================================================
+    pthread_mutex_lock(&_lock_);
+    _count_++;
+    pthread_cond_broadcast(&_cond_);
+    pthread_mutex_unlock(&_lock_);
+
+#else
+//=================================================================================================
+    _count_++;
+
+#endif
+}
+
+uint16_t FormEvent::count(void) {
+/**************************************************************************************************
+ * Return the number of times the event has been signalled (since ".clear").
+ *************************************************************************************************/
+    return (_count_);
+}
+
+FormEvent::EvntState FormEvent::wait(uint16_t count, uint32_t timeout) {
+/**************************************************************************************************
+ * Wait until the event has been signalled "count" times (since ".clear"), or "timeout"
+ * milliseconds has passed (0 = wait forever).
+ *************************************************************************************************/
+#if defined(zz__MiRaspbPi__zz)          // If the target device is an Raspberry Pi then
+//=================================================================================================
+    struct timespec     endtime;        // Time to stop waiting
+    EvntState           returnval = EvntState::kSignalled;
+
+    clock_gettime(CLOCK_MONOTONIC, &endtime);
+    endtime.tv_sec  += timeout / 1000;
+    endtime.tv_nsec += (timeout % 1000) * 1000000;
+    if (endtime.tv_nsec >= 1000000000) {
+        endtime.tv_sec++;
+        endtime.tv_nsec -= 1000000000;
+    }
+
+    pthread_mutex_lock(&_lock_);
+
+    while (_count_ < count) {
+        if (timeout == 0)
+            pthread_cond_wait(&_cond_, &_lock_);
+        else if (pthread_cond_timedwait(&_cond_, &_lock_, &endtime) != 0) {
+            if (_count_ < count)                    // If timeout (and still not signalled)
+                returnval = EvntState::kTimeout;
+            break;
+        }
+    }
+
+    pthread_mutex_unlock(&_lock_);
+
+    return (returnval);
+
+#else
+//=================================================================================================
+    uint32_t starttime = HAL_GetTick(); // Time wait started (ms)
+
+    while (_count_ < count) {
+        if ( (timeout != 0) && ((HAL_GetTick() - starttime) >= timeout) )
+            return (EvntState::kTimeout);
+    }
+
+    return (EvntState::kSignalled);
+
+#endif
+}
+
+void FormEvent::formCallback(void *context) {
+/**************************************************************************************************
+ * Request Form completion callback, signals the FormEvent provided as "context".
+ *************************************************************************************************/
+    ((FormEvent *)context)->signal();
+}
+
+FormEvent::~FormEvent()
+{
+#if defined(zz__MiRaspbPi__zz)          // If the target device is an Raspberry Pi then
+//=================================================================================================
+    pthread_cond_destroy(&_cond_);
+    pthread_mutex_destroy(&_lock_);
+
+#endif
+}
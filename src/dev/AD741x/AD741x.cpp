@@ -25,6 +25,9 @@ void AD741x::popGenParam(DevPart DeviceNum, AddrBit ASPin) {
     _address_pointer_    = 0xFF;        // Initialise the Address pointer to 0xFF
                                         // This will be corrected on first transfer to device
 
+    for (uint8_t i = 0; i != (AD741x_RegSelMASK + 1); i++)  // Populate the Address Pointer
+        _pointer_reg_[i] = i;                               // value for each register
+
     _i2c_address = 0x0000;              // Populate I2C address, with 0. Will be updated
                                         // correctly, by next function call
     getAddress();   // Determine the I2C address from provided parameters
@@ -56,6 +59,17 @@ AD741x::AD741x(DevPart DeviceNum, AddrBit ASPin, Form *FormArray, uint16_t FormS
     reInitialise();       // Ensure that the internal mechanics of the class have been reset
 }
 
+void AD741x::configMuxChannel(uint8_t channel) {
+/**************************************************************************************************
+ * Device is behind the I2C multiplexer "channel", so the channel is added into the I2C address
+ * (see "I2CPeriph" - "I2CPe_MuxAddr"). Is to be called prior to any communication with the
+ * device.
+ *************************************************************************************************/
+    getAddress();                       // Determine the I2C address from provided parameters
+
+    _i2c_address = I2CPe_MuxAddr(channel, _i2c_address);
+}
+
 void AD741x::getAddress(void) {
 /**************************************************************************************************
  * Function will bring in the PartNumber and _address_pin_ provided to the class, and determine what
@@ -310,13 +324,8 @@ AD741x::DevFlt AD741x::poleConfigRead(I2CPeriph *hal_I2C) {
         // If Device class has just been created (fault = Initialised), or Address Pointer is not
         // equal to Configuration register.
         // Then request update to the Address pointer
-        packet_size = updateAddressPointer(&rData[0], AD741x_ConfigReg);
+        packet_size = updateAddressPointer(&_pointer_reg_[AD741x_ConfigReg], AD741x_ConfigReg);
             // Request Address Pointer update
-
-        // Then transmit the updated request via I2C
-        if ( hal_I2C->poleMasterTransmit(
-                _i2c_address, &rData[0], packet_size) != I2CPeriph::DevFlt::kNone )
-            return (flt = DevFlt::kFault);
     }
     // Ensure the Read of this register is captured.
     _address_buff_.inputWrite(
@@ -325,8 +334,16 @@ AD741x::DevFlt AD741x::poleConfigRead(I2CPeriph *hal_I2C) {
     // Ensure it is captured within the queue, and set to READ. Such that the decode will
     // check for any read backs
 
-    // Then commence a read of the Temperature Registers
-    if ( hal_I2C->poleMasterReceive(_i2c_address, &rData[0], 1) != I2CPeriph::DevFlt::kNone )
+    if (packet_size != 0) {
+        // If Address Pointer is to be updated, then transmit the update and read the Configuration
+        // Register (repeated START)
+        if ( hal_I2C->poleMasterWriteRead(_i2c_address,
+                                          &_pointer_reg_[AD741x_ConfigReg], packet_size,
+                                          &rData[0], 1) != I2CPeriph::DevFlt::kNone )
+            return (flt = DevFlt::kFault);
+    }
+    // Otherwise commence a read of the Configuration Register
+    else if ( hal_I2C->poleMasterReceive(_i2c_address, &rData[0], 1) != I2CPeriph::DevFlt::kNone )
         return (flt = DevFlt::kFault);
 
     return (deconstructData(&rData[0], 1));       // Decode data, and return any faults
@@ -367,13 +384,9 @@ AD741x::DevFlt AD741x::poleTempRead(I2CPeriph *hal_I2C) {
         // If Device class has just been created (fault = Initialised), or Address Pointer is not
         // equal to Temperature register.
         // Then request update to the Address pointer
-        packet_size = updateAddressPointer(&rData[0], AD741x_TemperatureReg);
+        packet_size = updateAddressPointer(&_pointer_reg_[AD741x_TemperatureReg],
+                                           AD741x_TemperatureReg);
             // Request Address Pointer update
-
-        // Then transmit the updated request via I2C
-        if ( hal_I2C->poleMasterTransmit(
-                _i2c_address, &rData[0], packet_size) != I2CPeriph::DevFlt::kNone )
-            return (flt = DevFlt::kFault);
     }
     // Ensure the Read of this register is captured.
     _address_buff_.inputWrite(
@@ -382,8 +395,16 @@ AD741x::DevFlt AD741x::poleTempRead(I2CPeriph *hal_I2C) {
     // Ensure it is captured within the queue, and set to READ. Such that the decode will
     // check for any read backs
 
-    // Then commence a read of the Temperature Registers
-    if ( hal_I2C->poleMasterReceive(_i2c_address, &rData[0], 2) != I2CPeriph::DevFlt::kNone )
+    if (packet_size != 0) {
+        // If Address Pointer is to be updated, then transmit the update and read the Temperature
+        // Register (repeated START)
+        if ( hal_I2C->poleMasterWriteRead(_i2c_address,
+                                          &_pointer_reg_[AD741x_TemperatureReg], packet_size,
+                                          &rData[0], 2) != I2CPeriph::DevFlt::kNone )
+            return (flt = DevFlt::kFault);
+    }
+    // Otherwise commence a read of the Temperature Register
+    else if ( hal_I2C->poleMasterReceive(_i2c_address, &rData[0], 2) != I2CPeriph::DevFlt::kNone )
         return (flt = DevFlt::kFault);
 
     return (deconstructData(&rData[0], 2));       // Decode data, and return any faults
@@ -416,15 +437,7 @@ void AD741x::intConfigRead(I2CPeriph *hal_I2C, uint8_t *rBuff, uint8_t *wBuff) {
          * equal to the "Temperature Register".
          * Then need to generate a I2C Form to write a update to the Address pointer
          */
-        temp_size = updateAddressPointer(&wBuff[wrte_cmp_target], AD741x_ConfigReg);
-
-        hal_I2C->intMasterReq(_i2c_address,
-                              temp_size,
-                              &wBuff[wrte_cmp_target],
-                              I2CPeriph::CommMode::kAutoEnd, I2CPeriph::Request::kStart_Write,
-                              &(i2c_wrte_flt), &(wrte_cmp_flg));
-
-        wrte_cmp_target   += temp_size;     // Copy expected size to write complete target
+        temp_size = updateAddressPointer(&_pointer_reg_[AD741x_ConfigReg], AD741x_ConfigReg);
     }
     // Ensure the Read of this register is captured.
     _address_buff_.inputWrite(
@@ -433,11 +446,18 @@ void AD741x::intConfigRead(I2CPeriph *hal_I2C, uint8_t *rBuff, uint8_t *wBuff) {
     // Ensure it is captured within the queue, and set to READ. Such that the decode will
     // check for any read backs
 
-    hal_I2C->intMasterReq(_i2c_address,
-                          1,
-                          &rBuff[read_cmp_target],
-                          I2CPeriph::CommMode::kAutoEnd, I2CPeriph::Request::kStart_Read,
-                          &(i2c_read_flt), &(read_cmp_flag));
+    if (temp_size != 0)         // If Address Pointer is to be updated, then write the update
+                                // and read the register as a single request (repeated START)
+        hal_I2C->intMasterWriteRead(_i2c_address,
+                                    temp_size, &_pointer_reg_[AD741x_ConfigReg],
+                                    1, &rBuff[read_cmp_target],
+                                    &(i2c_read_flt), &(read_cmp_flag));
+    else
+        hal_I2C->intMasterReq(_i2c_address,
+                              1,
+                              &rBuff[read_cmp_target],
+                              I2CPeriph::CommMode::kAutoEnd, I2CPeriph::Request::kStart_Read,
+                              &(i2c_read_flt), &(read_cmp_flag));
 
     read_cmp_target   += 1;     // Put expected size of read back into read complete target
 }
@@ -478,15 +498,8 @@ void AD741x::intTempRead(I2CPeriph *hal_I2C, uint8_t *rBuff, uint8_t *wBuff) {
          * equal to the "Temperature Register".
          * Then need to generate a I2C Form to write a update to the Address pointer
          */
-        temp_size = updateAddressPointer(&wBuff[wrte_cmp_target], AD741x_TemperatureReg);
-
-        hal_I2C->intMasterReq(_i2c_address,
-                              temp_size,
-                              &wBuff[wrte_cmp_target],
-                              I2CPeriph::CommMode::kAutoEnd, I2CPeriph::Request::kStart_Write,
-                              &(i2c_wrte_flt), &(wrte_cmp_flg));
-
-        wrte_cmp_target   += temp_size; // Copy expected size to write complete target
+        temp_size = updateAddressPointer(&_pointer_reg_[AD741x_TemperatureReg],
+                                         AD741x_TemperatureReg);
     }
     // Ensure the Read of this register is captured.
     _address_buff_.inputWrite(
@@ -495,11 +508,18 @@ void AD741x::intTempRead(I2CPeriph *hal_I2C, uint8_t *rBuff, uint8_t *wBuff) {
     // Ensure it is captured within the queue, and set to READ. Such that the decode will
     // check for any read backs
 
-    hal_I2C->intMasterReq(_i2c_address,
-                          2,
-                          &rBuff[read_cmp_target],
-                          I2CPeriph::CommMode::kAutoEnd, I2CPeriph::Request::kStart_Read,
-                          &(i2c_read_flt), &(read_cmp_flag));
+    if (temp_size != 0)         // If Address Pointer is to be updated, then write the update
+                                // and read the register as a single request (repeated START)
+        hal_I2C->intMasterWriteRead(_i2c_address,
+                                    temp_size, &_pointer_reg_[AD741x_TemperatureReg],
+                                    2, &rBuff[read_cmp_target],
+                                    &(i2c_read_flt), &(read_cmp_flag));
+    else
+        hal_I2C->intMasterReq(_i2c_address,
+                              2,
+                              &rBuff[read_cmp_target],
+                              I2CPeriph::CommMode::kAutoEnd, I2CPeriph::Request::kStart_Read,
+                              &(i2c_read_flt), &(read_cmp_flag));
 
     read_cmp_target   += 2;     // Put expected size of read back into read complete target
 }
@@ -0,0 +1,249 @@
+/**************************************************************************************************
+ * @file        I2CBusMngr.cpp
+ * @author      Thomas
+ * @brief       Source file for the manager of multiple I2C buses (each with its own worker)
+ **************************************************************************************************
+ @ attention
+
+ << To be Introduced >>
+
+ *************************************************************************************************/
+#include <FileIndex.h>
+#include FilInd_I2CMngHD
+
+I2CBusMngr::I2CBusMngr(void) {
+/**************************************************************************************************
+ * Create a I2CBusMngr class handler, with no buses (added via ".addBus")
+ *************************************************************************************************/
+    for (uint8_t i = 0; i != I2CMn_MaxBus; i++) {
+        _bus_[i]        = __null;
+        _bus_loc_[i]    = __null;
+    }
+
+    _worker_run_        = 0;                // Interrupt emulation threads not running
+    _worker_priority_   = 0;
+    _worker_core_       = -1;
+
+    BusCount            = 0;
+    _stats_start_       = timeNow();
+
+    Flt = DevFlt::kInitialised;
+}
+
+uint64_t I2CBusMngr::timeNow(void) {
+/**************************************************************************************************
+ * Returns the current time in nanoseconds, from the monotonic clock (same as 'I2CPeriph' busy
+ * time)
+ *************************************************************************************************/
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ( ((uint64_t) now.tv_sec * 1000000000) + (uint64_t) now.tv_nsec );
+}
+
+I2CBusMngr::DevFlt I2CBusMngr::startBus(uint8_t handle) {
+/**************************************************************************************************
+ * Start the interrupt emulation thread of the bus "handle". If a core has been requested, then
+ * each bus is limited to the next core along (wrapping around the number of cores).
+ *************************************************************************************************/
+    int core = -1;
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+
+    if ( (_worker_core_ >= 0) && (cores > 0) )
+        core = (int) ((_worker_core_ + handle) % cores);
+
+    if (_bus_[handle]->startWorker(_worker_priority_, core) != I2CPeriph::DevFlt::kNone)
+        return ( Flt = DevFlt::kWorker_Error );
+
+    return ( Flt = DevFlt::kNone );
+}
+
+uint8_t I2CBusMngr::addBus(const char *deviceloc) {
+/**************************************************************************************************
+ * Add a bus for the i2c-dev device "deviceloc", with its own I2C Request Form queue. If the
+ * interrupt emulation threads are running, then the thread of the new bus is also started.
+ * Returns the handle of the bus, or "I2CMn_NoBus" if no space for more buses ("kBus_Limit"), or
+ * the device cannot be opened ("kOpen_Error" - bus is not added).
+ *************************************************************************************************/
+    uint8_t handle = BusCount;
+
+    if (handle == I2CMn_MaxBus) {
+        Flt = DevFlt::kBus_Limit;
+        return (I2CMn_NoBus);
+    }
+
+    _bus_[handle]       = new I2CPeriph(deviceloc, _form_array_[handle], I2CMn_Forms);
+
+    if (_bus_[handle]->flt == I2CPeriph::DevFlt::kDriver_Error) {
+        // If unable to open the device, then the bus is not added
+        delete _bus_[handle];
+        _bus_[handle] = __null;
+
+        Flt = DevFlt::kOpen_Error;
+        return (I2CMn_NoBus);
+    }
+
+    _bus_loc_[handle]   = deviceloc;
+    BusCount++;
+
+    Flt = DevFlt::kNone;
+
+    if (_worker_run_ == 1)                  // If threads are running, then start this bus
+        startBus(handle);
+
+    return (handle);
+}
+
+I2CPeriph *I2CBusMngr::bus(uint8_t handle) {
+/**************************************************************************************************
+ * Returns the 'I2CPeriph' of the bus "handle", to be provided to the device drivers. If not a
+ * valid handle, then returns __null.
+ *************************************************************************************************/
+    if (handle >= BusCount)
+        return (__null);
+
+    return (_bus_[handle]);
+}
+
+I2CBusMngr::DevFlt I2CBusMngr::startWorkers(int priority, int core) {
+/**************************************************************************************************
+ * Start the interrupt emulation thread of each bus, with real-time priority "priority" (0 for a
+ * normal thread). If "core" is not -1, then the first bus is limited to "core", the next bus to
+ * the next core, etc.
+ * If any thread cannot be started, will return "kWorker_Error" (other buses are still started).
+ *************************************************************************************************/
+    DevFlt returnval = DevFlt::kNone;
+
+    _worker_priority_   = priority;
+    _worker_core_       = core;
+    _worker_run_        = 1;
+
+    for (uint8_t i = 0; i != BusCount; i++) {
+        if (startBus(i) != DevFlt::kNone)
+            returnval = DevFlt::kWorker_Error;
+    }
+
+    return ( Flt = returnval );
+}
+
+void I2CBusMngr::stopWorkers(void) {
+/**************************************************************************************************
+ * Stop the interrupt emulation thread of each bus (any forms being submitted will be completed
+ * first). Interrupt based functions will then block again (see 'I2CPeriph').
+ *************************************************************************************************/
+    _worker_run_ = 0;
+
+    for (uint8_t i = 0; i != BusCount; i++)
+        _bus_[i]->stopWorker();
+}
+
+void I2CBusMngr::resetStats(void) {
+/**************************************************************************************************
+ * Clear the statistics of each bus, and restart the elapsed time
+ *************************************************************************************************/
+    for (uint8_t i = 0; i != BusCount; i++)
+        _bus_[i]->resetStats();
+
+    _stats_start_ = timeNow();
+}
+
+I2CBusMngr::DevFlt I2CBusMngr::busReport(uint8_t handle, BusReport *Report) {
+/**************************************************************************************************
+ * Populate "Report" with the statistics of the bus "handle", along with the elapsed time since
+ * the statistics were reset. Utilisation is the fraction of the elapsed time which the bus was
+ * within a driver call.
+ *************************************************************************************************/
+    if (handle >= BusCount)
+        return ( Flt = DevFlt::kInvalid_Bus );
+
+    Report->Stats       = _bus_[handle]->readStats();
+    Report->Elapsed     = timeNow() - _stats_start_;
+
+    if (Report->Elapsed == 0) {
+        Report->Utilisation = 0;
+        Report->Throughput  = 0;
+    }
+    else {
+        Report->Utilisation = (float) Report->Stats.BusyTime / (float) Report->Elapsed;
+        Report->Throughput  = ((float) Report->Stats.Bytes * 1000000000) /
+                              (float) Report->Elapsed;
+    }
+
+    return ( Flt = DevFlt::kNone );
+}
+
+float I2CBusMngr::throughput(void) {
+/**************************************************************************************************
+ * Returns the aggregate throughput of all buses (bytes per second), since the statistics were
+ * reset
+ *************************************************************************************************/
+    uint64_t bytes = 0;
+    uint64_t elapsed = timeNow() - _stats_start_;
+
+    for (uint8_t i = 0; i != BusCount; i++)
+        bytes += _bus_[i]->readStats().Bytes;
+
+    if (elapsed == 0)
+        return (0);
+
+    return ( ((float) bytes * 1000000000) / (float) elapsed );
+}
+
+I2CBusMngr::DevFlt I2CBusMngr::report(FILE *out) {
+/**************************************************************************************************
+ * Write the CSV header line, a CSV line for each bus, and a "total" line into "out" (see header
+ * "How to use"). Utilisation of the total line is the average of the buses.
+ *************************************************************************************************/
+    BusReport   bus_report;
+    BusReport   total = { { 0, 0, 0, 0 }, 0, 0, 0 };
+    int         returnval = 0;
+
+    returnval = fprintf(out, "bus,device,forms,bytes,calls,busy_ns,elapsed_ns,utilisation,"
+                             "bytes_per_sec\n");
+
+    for (uint8_t i = 0; (i != BusCount) && (returnval >= 0); i++) {
+        busReport(i, &bus_report);
+
+        returnval = fprintf(out, "%u,%s,%llu,%llu,%llu,%llu,%llu,%.4f,%.1f\n",
+                            i, (_bus_loc_[i] == __null) ? "" : _bus_loc_[i],
+                            (unsigned long long) bus_report.Stats.Forms,
+                            (unsigned long long) bus_report.Stats.Bytes,
+                            (unsigned long long) bus_report.Stats.Calls,
+                            (unsigned long long) bus_report.Stats.BusyTime,
+                            (unsigned long long) bus_report.Elapsed,
+                            bus_report.Utilisation, bus_report.Throughput);
+
+        total.Stats.Forms       += bus_report.Stats.Forms;
+        total.Stats.Bytes       += bus_report.Stats.Bytes;
+        total.Stats.Calls       += bus_report.Stats.Calls;
+        total.Stats.BusyTime    += bus_report.Stats.BusyTime;
+        total.Elapsed            = bus_report.Elapsed;
+        total.Utilisation       += bus_report.Utilisation / BusCount;
+        total.Throughput        += bus_report.Throughput;
+    }
+
+    if (returnval >= 0)
+        returnval = fprintf(out, "total,,%llu,%llu,%llu,%llu,%llu,%.4f,%.1f\n",
+                            (unsigned long long) total.Stats.Forms,
+                            (unsigned long long) total.Stats.Bytes,
+                            (unsigned long long) total.Stats.Calls,
+                            (unsigned long long) total.Stats.BusyTime,
+                            (unsigned long long) total.Elapsed,
+                            total.Utilisation, total.Throughput);
+
+    if (returnval < 0)
+        return ( Flt = DevFlt::kOutput_Error );
+
+    fflush(out);
+
+    return ( Flt = DevFlt::kNone );
+}
+
+I2CBusMngr::~I2CBusMngr()
+{
+    stopWorkers();                          // Ensure interrupt emulation threads are stopped
+
+    for (uint8_t i = 0; i != BusCount; i++)
+        delete _bus_[i];
+}
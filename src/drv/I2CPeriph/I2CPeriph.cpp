@@ -22,11 +22,27 @@ void I2CPeriph::popGenParam(void) {
     comm_state    = CommLock::kFree;        // Indicate bus is free
 
     _cur_count_    = 0;                     // Initialise the current packet size count
+    _reload_count_ = 0;                     // Initialise the packets not yet requested
+    _cur_mode_     = CommMode::kAutoEnd;    // Initialise the current mode to "AutoEnd"
     _cur_form_     = { 0 };                 // Initialise the form to a blank entry
 
     _cur_reqst_    = Request::kNothing;     // Initialise the current request state to 0
+
+    _mux_address_  = 0;                     // No I2C multiplexer
+    _mux_channel_  = I2CPe_MuxUnknown;      // Selected channel is not known
+    _mux_select_   = 0;
+    _group_count_  = 0;
+
+    MuxSwitchCnt   = 0;                     // Clear the counters
+    GroupCnt       = 0;
+
+    _scan_flt_     = DevFlt::kTimeout;      // Cancelled bus scan probes are faulted
+    _scan_cmp_     = 0;
 }
 
+#if ( defined(zz__MiSTM32Fx__zz) || defined(zz__MiSTM32Lx__zz)  )
+// If the target device is either STM32Fxx or STM32Lxx from cubeMX then ...
+//=================================================================================================
 I2CPeriph::I2CPeriph(I2C_HandleTypeDef *I2C_Handle, Form *FormArray, uint16_t FormSize) {
 /**************************************************************************************************
  * Creates a I2C class specific for the STM32 device.
@@ -40,8 +56,387 @@ I2CPeriph::I2CPeriph(I2C_HandleTypeDef *I2C_Handle, Form *FormArray, uint16_t Fo
     _i2c_handle_  = I2C_Handle;       // Link input I2C handler to class.
 
     _form_queue_.create(FormArray, FormSize);
+
+    _mux_form_    = { 0 };            // No form waiting on a multiplexer channel select
+    _mux_pend_    = 0;
+    _mux_flt_     = DevFlt::kNone;
+    _mux_cmp_     = 0;
+}
+
+#elif defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
+//=================================================================================================
+I2CPeriph::I2CPeriph(const char *deviceloc, Form *FormArray, uint16_t FormSize) {
+/**************************************************************************************************
+ * Create a I2CPeriph class specific for RaspberryPi
+ * Receives the location of the i2c-dev device, as well as the I2C Request Form array pointer, and
+ * size.
+ *
+ * This will then open up the i2c-dev device. The address of each message is provided within the
+ * driver call ("I2C_RDWR"), so no device address is configured here.
+ * If the device cannot be opened, then "flt" is set to "kDriver_Error"
+ *************************************************************************************************/
+    popGenParam();                    // Populate generic class parameters
+
+    _device_loc_  = deviceloc;        // Capture the folder location of I2C device
+    _ioctl_       = &sysIoctl;        // Default driver calls to system "ioctl"
+
+    _form_queue_.create(FormArray, FormSize);
+
+    pthread_mutex_init(&_queue_lock_, __null);      // Setup the lock for the queue
+    pthread_mutex_init(&_bus_lock_, __null);        // Setup the lock for the bus
+    _event_fd_    = eventfd(0, EFD_CLOEXEC);        // Setup the wake for the interrupt emulation
+    _worker_run_  = 0;                              // Interrupt emulation not running
+
+    resetStats();                                   // Clear the bus statistics
+
+    _i2c_handle_  = open(_device_loc_, O_RDWR | O_CLOEXEC);
+        // Open the i2c-dev interface
+    if (_i2c_handle_ < 0)             // If unable to open the device, then indicate fault
+        flt = DevFlt::kDriver_Error;
+}
+
+int I2CPeriph::sysIoctl(int fd, unsigned long request, void *arg) {
+/**************************************************************************************************
+ * RaspberryPi specific function, default function for all driver calls (links to system "ioctl")
+ *************************************************************************************************/
+    return (ioctl(fd, request, arg));
+}
+
+void I2CPeriph::linkIoctl(IoctlFunc func) {
+/**************************************************************************************************
+ * RaspberryPi specific function, replaces the function used for all driver calls. Allows the
+ * class to be run against a different function (i.e. simulated device without hardware)
+ * The new function stands in for the i2c-dev device, so "flt" is returned to "kInitialised" (if
+ * the device could not be opened).
+ *************************************************************************************************/
+    _ioctl_ = func;
+
+    flt     = DevFlt::kInitialised;     // Linked function stands in for the device
+}
+
+uint8_t I2CPeriph::formMessages(Form *RequestForm, struct i2c_msg *msgs) {
+/**************************************************************************************************
+ * RaspberryPi specific function, will populate the i2c-dev message(s) "msgs" for the I2C Request
+ * Form. Address of the form is the 7bit address shifted up by 1 (same as STM32), so is shifted
+ * down for the driver (multiplexer channel is removed).
+ * A write then read form ("kStart_WriteRead") is two messages, the write then the read (driver
+ * puts a repeated START between). Returns the number of messages used.
+ *************************************************************************************************/
+    msgs[0].addr    = ((RequestForm->devAddress & I2CPe_AddrMASK) >> 1);
+        // Driver expects 7bit address (without multiplexer channel)
+    msgs[0].len     = RequestForm->size;
+    msgs[0].buf     = RequestForm->Buff;
+
+    if (RequestForm->Reqst == Request::kStart_Read) // If read request, then set the read bit
+        msgs[0].flags   = I2C_M_RD;
+    else                                            // Otherwise write
+        msgs[0].flags   = 0;
+
+    if (RequestForm->Reqst != Request::kStart_WriteRead)
+        return (1);
+
+    msgs[1].addr    = msgs[0].addr;                 // Read part of write then read
+    msgs[1].len     = RequestForm->readSize;
+    msgs[1].buf     = RequestForm->ReadBuff;
+    msgs[1].flags   = I2C_M_RD;
+
+    return (2);
+}
+
+I2CPeriph::DevFlt I2CPeriph::transferMessages(struct i2c_msg *msgs, uint8_t count) {
+/**************************************************************************************************
+ * RaspberryPi specific function, will submit the "count" messages to the i2c-dev driver in a
+ * single "I2C_RDWR" call (repeated START between each message, STOP at the end).
+ * If the driver rejects the call, then the fault is determined from "errno" - a device not
+ * acknowledging (ENXIO/EREMOTEIO) is "kNACK", otherwise "kDriver_Error". The driver also needs to
+ * have transferred all of the messages.
+ *************************************************************************************************/
+    struct i2c_rdwr_ioctl_data  rdwr;               // Driver call data
+    int         returnval = 0;                      // Return value from driver
+
+    rdwr.msgs   = msgs;
+    rdwr.nmsgs  = count;
+
+    errno = 0;
+    returnval = _ioctl_(_i2c_handle_, I2C_RDWR, &rdwr);
+
+    if (returnval == (int) count)                   // If all messages transferred, then no fault
+        return (DevFlt::kNone);
+
+    if ( (returnval < 0) && ((errno == ENXIO) || (errno == EREMOTEIO)) )
+        return (DevFlt::kNACK);                     // If device did not acknowledge
+
+    return (DevFlt::kDriver_Error);
+}
+
+uint8_t I2CPeriph::transferBatch(void) {
+/**************************************************************************************************
+ * RaspberryPi specific function, will take up to "I2CPe_MaxBatch" I2C Request Forms from the
+ * queue, and submit them to the i2c-dev driver in a single "I2C_RDWR" call. Each form is a
+ * message, or two for a write then read form (see ".formMessages").
+ *
+ * Any form which already has a fault is removed from the queue without being transferred (its
+ * completion callback is still called, once the queue is released - so the callback can request
+ * new forms).
+ * A form with a request other than "kStart_Write"/"kStart_Read" (i.e. "kStop"), ends the batch
+ * (STOP generated at the end of the call), and is completed with no data transferred.
+ * Forms on the selected multiplexer channel are taken first (".groupForm"). If the first form is
+ * for a different channel, the channel is selected first (separate driver call, as the channel
+ * becomes active at the STOP) - if this fails the form is faulted. A later form for a different
+ * channel ends the batch.
+ * A probe form ("kProbe") is always on its own, as the driver only indicates that a message within
+ * the call was not acknowledged (not which one).
+ *
+ * Once complete, each form's complete flag is updated with the amount of data transferred (read
+ * for a write then read form), or if
+ * the driver rejects the call, each form's fault flag is set (see ".transferMessages"). Both are
+ * updated with release ordering, so the read data is visible to the source function (which may
+ * be a different thread) once the flag is seen. Each form's completion callback is then called.
+ * The queue is only locked whilst forms are taken, not during the driver call or callbacks. The
+ * driver call is counted within the bus statistics (".readStats").
+ * Returns the number of forms taken from the queue (0 if queue is empty).
+ *************************************************************************************************/
+    struct i2c_msg  msgs[I2CPe_MaxBatch];           // Messages to submit to driver
+    Form        batch[I2CPe_MaxBatch];              // Forms within the call
+    Form        skipped[I2CPe_MaxBatch];            // Forms removed without transfer (faulted)
+    Form        end_form = Form();                  // Form which ends the batch (no message)
+    uint8_t     count = 0;                          // Number of forms within batch
+    uint8_t     mcount = 0;                         // Number of messages within batch
+    uint8_t     scount = 0;                         // Number of forms removed without transfer
+    uint8_t     taken = 0;                          // Number of forms taken from queue
+    uint8_t     i = 0;                              // Variable for looping
+    DevFlt      returnval = DevFlt::kNone;          // Fault from driver
+    uint64_t    bytes = 0;                          // Bytes within batch
+    struct timespec start, stop;                    // Time of driver call
+    uint16_t    select = 0;                         // Address needing a channel select
+    uint8_t     transfer = 0;                       // Indicate form is a transfer
+
+    pthread_mutex_lock(&_queue_lock_);              // Lock queue, whilst next form is checked
+
+    groupForm();                                    // Prefer form for selected channel
+    if (_form_queue_.state() != kGenBuffer_Empty) {
+        batch[0] = _form_queue_.readBuffer(_form_queue_.output_pointer);
+        if ( (__atomic_load_n(batch[0].Flt, __ATOMIC_ACQUIRE) == DevFlt::kNone) &&
+             (muxSwitchChk(batch[0].devAddress) == 1) )
+            select = batch[0].devAddress;           // If not faulted, and channel not selected
+    }
+
+    pthread_mutex_unlock(&_queue_lock_);            // Release queue
+
+    if ( (select != 0) && (poleMuxSelect(select) != DevFlt::kNone) ) {
+        // If channel select failed, then form cannot be transferred
+        pthread_mutex_lock(&_queue_lock_);
+        _form_queue_.outputRead( &(batch[0]) );
+        pthread_mutex_unlock(&_queue_lock_);
+
+        __atomic_store_n(batch[0].Flt, flt, __ATOMIC_RELEASE);
+        cmpltCallback(&(batch[0]));                 // Form is faulted
+
+        return (1);
+    }
+
+    pthread_mutex_lock(&_queue_lock_);              // Lock queue, whilst forms are taken
+
+    while ( ((I2CPe_MaxBatch - mcount) >= 2) && (scount != I2CPe_MaxBatch) &&
+            (_form_queue_.state() != kGenBuffer_Empty) ) {
+        // Whilst there is space for the largest form (write then read), and forms in the queue
+        groupForm();                                // Prefer form for selected channel
+        batch[count] = _form_queue_.readBuffer(_form_queue_.output_pointer);
+            // Check the next form, prior to removing from queue
+
+        transfer = ( (batch[count].Reqst == Request::kStart_Write) ||
+                     (batch[count].Reqst == Request::kStart_Read)  ||
+                     (batch[count].Reqst == Request::kStart_WriteRead) ||
+                     (batch[count].Reqst == Request::kProbe) );
+
+        if ( (batch[count].Reqst == Request::kProbe) && (count != 0) )
+            break;  // If a probe, then leave for next (needs to be on its own)
+
+        if ( (transfer == 1) &&
+             (__atomic_load_n(batch[count].Flt, __ATOMIC_ACQUIRE) == DevFlt::kNone) &&
+             (muxSwitchChk(batch[count].devAddress) == 1) )
+            break;  // If for a different multiplexer channel, then leave for next (channel select
+                    // needs a STOP)
+
+        _form_queue_.outputRead( &(batch[count]) );     // Capture form request
+        taken++;
+
+        if (__atomic_load_n(batch[count].Flt, __ATOMIC_ACQUIRE) != DevFlt::kNone) {
+            skipped[scount++] = batch[count];   // If fault has already been detected, then request
+            continue;                           // is no longer valid (is complete, no transfer)
+        }
+
+        if (transfer == 0) {
+            end_form = batch[count];                // If not a transfer, then batch ends here
+            break;
+        }
+
+        mcount += formMessages(&(batch[count]), &(msgs[mcount]));
+        count++;
+
+        if (batch[count - 1].Reqst == Request::kProbe)
+            break;  // If a probe, then is on its own
+    }
+
+    pthread_mutex_unlock(&_queue_lock_);            // Release queue
+
+    for (i = 0; i != scount; i++)                   // Forms removed without transfer are
+        cmpltCallback(&(skipped[i]));               // complete (queue released, as callback can
+                                                    // request new forms)
+
+    if (count != 0) {
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        returnval = transferMessages(msgs, mcount);
+        clock_gettime(CLOCK_MONOTONIC, &stop);
+
+        for (i = 0; i != mcount; i++)
+            bytes += msgs[i].len;
+
+        __atomic_fetch_add(&_stats_.Calls, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&_stats_.BusyTime,
+                           (uint64_t) ((stop.tv_sec - start.tv_sec) * 1000000000LL
+                                       + (stop.tv_nsec - start.tv_nsec)),
+                           __ATOMIC_RELAXED);
+
+        if (returnval == DevFlt::kNone) {           // Only count forms/bytes if transferred
+            __atomic_fetch_add(&_stats_.Forms, count, __ATOMIC_RELAXED);
+            __atomic_fetch_add(&_stats_.Bytes, bytes, __ATOMIC_RELAXED);
+        }
+    }
+
+    for (i = 0; i != count; i++) {                  // Update each of the forms
+        if (returnval != DevFlt::kNone)             // If driver rejected the transfer
+            __atomic_store_n(batch[i].Flt, returnval, __ATOMIC_RELEASE);
+        else if (batch[i].Reqst == Request::kStart_WriteRead)
+            __atomic_fetch_add(batch[i].Cmplt, batch[i].readSize, __ATOMIC_RELEASE);
+        else
+            __atomic_fetch_add(batch[i].Cmplt, batch[i].size, __ATOMIC_RELEASE);
+
+        cmpltCallback(&(batch[i]));                 // Form is complete (or faulted)
+    }
+
+    if (end_form.Cmplt != __null)                   // If batch was ended by a form, then it is
+        cmpltCallback(&(end_form));                 // complete (no data)
+
+    if (returnval != DevFlt::kNone)
+        flt = returnval;
+
+    return (taken);
+}
+
+void *I2CPeriph::workerThread(void *arg) {
+/**************************************************************************************************
+ * RaspberryPi specific function, interrupt emulation thread.
+ * Will wait (blocked) upon the eventfd, until woken by a new form being added to the queue (or
+ * request to stop). Then will submit all forms within the queue to the driver, before waiting
+ * again.
+ *************************************************************************************************/
+    I2CPeriph   *i2c = (I2CPeriph *)arg;            // Class which started the thread
+    uint64_t    wake = 0;                           // Value read from eventfd
+
+    while (__atomic_load_n(&i2c->_worker_run_, __ATOMIC_ACQUIRE) == 1) {
+        if (read(i2c->_event_fd_, &wake, sizeof(wake)) != sizeof(wake))
+            continue;                               // If interrupted, then wait again
+
+        pthread_mutex_lock(&i2c->_bus_lock_);       // Lock I2C bus (waits for polling transfer)
+        __atomic_store_n(&i2c->comm_state, CommLock::kCommunicating, __ATOMIC_RELEASE);
+
+        while (i2c->transferBatch() != 0) {};       // Submit all forms within queue
+
+        __atomic_store_n(&i2c->comm_state, CommLock::kFree, __ATOMIC_RELEASE);
+        pthread_mutex_unlock(&i2c->_bus_lock_);     // Indicate that I2C bus is now free
+    }
+
+    return (__null);
+}
+
+I2CPeriph::DevFlt I2CPeriph::startWorker(int priority, int core) {
+/**************************************************************************************************
+ * RaspberryPi specific function, will start the interrupt emulation thread. Once started, the
+ * interrupt based functions (".intMasterReq", ".intMasterWriteRead") will no longer block.
+ * Thread is run with real-time priority "priority" (SCHED_FIFO 1 to 99), or as a normal thread if
+ * 0. If "core" is not -1, then the thread is limited to that core.
+ * If the thread cannot be started (i.e. no permission for real-time priority), will return
+ * "kDriver_Error"
+ *************************************************************************************************/
+    pthread_attr_t      attr;                       // Attributes of thread
+    struct sched_param  param;                      // Priority of thread
+    cpu_set_t           cpuset;                     // Core for thread
+    int                 returnval = 0;              // Return value from thread creation
+
+    if ( (__atomic_load_n(&_worker_run_, __ATOMIC_ACQUIRE) == 1) || (_event_fd_ < 0) )
+        // If already running (or no eventfd)
+        return ( (_event_fd_ < 0) ? DevFlt::kDriver_Error : DevFlt::kNone );
+
+    pthread_attr_init(&attr);
+    if (priority != 0) {                            // If real-time priority requested
+        pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+        pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+        param.sched_priority = priority;
+        pthread_attr_setschedparam(&attr, &param);
+    }
+    if (core >= 0) {                                // If core requested
+        CPU_ZERO(&cpuset);
+        CPU_SET(core, &cpuset);
+        pthread_attr_setaffinity_np(&attr, sizeof(cpuset), &cpuset);
+    }
+
+    __atomic_store_n(&_worker_run_, 1, __ATOMIC_RELEASE);
+    returnval = pthread_create(&_worker_handle_, &attr, &workerThread, this);
+    pthread_attr_destroy(&attr);
+
+    if (returnval != 0) {                           // If unable to start thread
+        __atomic_store_n(&_worker_run_, 0, __ATOMIC_RELEASE);
+        return (DevFlt::kDriver_Error);
+    }
+
+    startInterrupt();       // Wake thread, in case forms have been queued prior to start
+
+    return (DevFlt::kNone);
+}
+
+void I2CPeriph::stopWorker(void) {
+/**************************************************************************************************
+ * RaspberryPi specific function, will stop the interrupt emulation thread, and wait for it to
+ * exit (any forms being submitted will be completed first).
+ *************************************************************************************************/
+    uint64_t wake = 1;                              // Value to write to eventfd
+
+    if (__atomic_load_n(&_worker_run_, __ATOMIC_ACQUIRE) == 0)  // If not running, then exit
+        return;
+
+    __atomic_store_n(&_worker_run_, 0, __ATOMIC_RELEASE);
+    if (write(_event_fd_, &wake, sizeof(wake)) == sizeof(wake))     // Wake thread, so it exits
+        pthread_join(_worker_handle_, __null);
+}
+
+I2CPeriph::BusStats I2CPeriph::readStats(void) {
+/**************************************************************************************************
+ * RaspberryPi specific function, returns a copy of the bus statistics. Each entry is read
+ * separately (may be updated by the interrupt emulation thread whilst being read).
+ *************************************************************************************************/
+    BusStats stats;
+
+    stats.Forms     = __atomic_load_n(&_stats_.Forms,    __ATOMIC_RELAXED);
+    stats.Bytes     = __atomic_load_n(&_stats_.Bytes,    __ATOMIC_RELAXED);
+    stats.Calls     = __atomic_load_n(&_stats_.Calls,    __ATOMIC_RELAXED);
+    stats.BusyTime  = __atomic_load_n(&_stats_.BusyTime, __ATOMIC_RELAXED);
+
+    return (stats);
+}
+
+void I2CPeriph::resetStats(void) {
+/**************************************************************************************************
+ * RaspberryPi specific function, clears the bus statistics.
+ *************************************************************************************************/
+    __atomic_store_n(&_stats_.Forms,    0, __ATOMIC_RELAXED);
+    __atomic_store_n(&_stats_.Bytes,    0, __ATOMIC_RELAXED);
+    __atomic_store_n(&_stats_.Calls,    0, __ATOMIC_RELAXED);
+    __atomic_store_n(&_stats_.BusyTime, 0, __ATOMIC_RELAXED);
 }
 
+#endif
+
 uint8_t I2CPeriph::readDR(void) {
 /**************************************************************************************************
  * Read from the I2C hardware
@@ -80,7 +475,8 @@ void I2CPeriph::writeDR(uint8_t data) {
 
 #elif defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
 //=================================================================================================
-
+// Not used, data is provided to the driver within each message (see ".formMessages")
+    (void) data;
 
 #else
 //=================================================================================================
@@ -144,6 +540,34 @@ uint8_t I2CPeriph::transmitComptChk(void) {
 //=================================================================================================
 
 
+#else
+//=================================================================================================
+
+#endif
+}
+
+uint8_t I2CPeriph::transferReloadChk(void) {
+/**************************************************************************************************
+ * Check the status of the Hardware Transfer Complete Reload (if current chunk of a transfer in
+ * RELOAD mode is complete, and next chunk is to be requested, output = 1)
+ *************************************************************************************************/
+
+#if   defined(zz__MiSTM32Fx__zz)        // If the target device is an STM32Fxx from cubeMX then
+//=================================================================================================
+
+
+#elif defined(zz__MiSTM32Lx__zz)        // If the target device is an STM32Lxx from cubeMX then
+//=================================================================================================
+
+    if ( (__HAL_I2C_GET_FLAG(_i2c_handle_, I2C_FLAG_TCR)  != 0 ) )
+        return (1);
+    else
+        return (0);
+
+#elif defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
+//=================================================================================================
+    return (0);                         // Transfers are not split (done by driver)
+
 #else
 //=================================================================================================
 
@@ -521,13 +945,15 @@ uint8_t I2CPeriph::busErrorITChk(void) {
 #endif
 }
 
-void I2CPeriph::requestTransfer(uint16_t devAddress, uint8_t size, CommMode mode, Request reqst) {
+void I2CPeriph::requestTransfer(uint16_t devAddress, uint16_t size, CommMode mode, Request reqst) {
 /**************************************************************************************************
  * Function will configure the device hardware/internal class parameters to setup a I2C
  * communication between this device (local) and the selected device (external). This communicate
- * can be either read/write, however the maximum number of packets which can be transmitted is
- * limited to 255 (1 byte). If more is required then this function will need to be called multiple
- * times with divisions of 255 to complete the communication.
+ * can be either read/write, however the maximum number of packets which the hardware can transmit
+ * within a single request is limited to "I2CPe_MaxNBYTES" (255). If more is requested, then
+ * only the first chunk is requested in RELOAD mode - with the remaining packets requested at the
+ * end of each chunk (see ".reloadTransfer"). "mode" then applies once the last chunk has been
+ * requested.
  * The devAddress that is provided needs to be provided as a 11bit or 8bit address; so the last
  * bit which is the read/write bit will need to be set to blank; actual entry will be ignored
  * however.
@@ -559,13 +985,23 @@ void I2CPeriph::requestTransfer(uint16_t devAddress, uint8_t size, CommMode mode
     // transfer
     //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
     // Setup Slave Address:
-    _i2c_handle_->Instance->CR2 |= ((uint32_t)devAddress & I2C_CR2_SADD);
+    _i2c_handle_->Instance->CR2 |= ((uint32_t)(devAddress & I2CPe_AddrMASK) & I2C_CR2_SADD);
+        // (without multiplexer channel)
+
+    _cur_count_   = size;       // Capture the number of packets to transmit
+    _cur_mode_    = mode;       // Capture the mode, once all packets have been requested
+
+    if (size > I2CPe_MaxNBYTES) {                       // If larger than a single request
+        _reload_count_  = size - I2CPe_MaxNBYTES;       // then capture remaining packets, and
+        size            = I2CPe_MaxNBYTES;              // only request the first chunk
+        mode            = CommMode::kReload;            // (in RELOAD mode)
+    }
+    else
+        _reload_count_  = 0;
 
     // Setup the size of data to be transmitted:
     _i2c_handle_->Instance->CR2 |= (((uint32_t)size << I2C_CR2_NBYTES_Pos) & I2C_CR2_NBYTES);
 
-    _cur_count_   = size;       // Capture the number of packets to transmit
-
     // Setup the communication mode:
     if      (mode == CommMode::kAutoEnd)                // If mode is "AutoEnd"
         _i2c_handle_->Instance->CR2 |= (uint32_t)(I2C_AUTOEND_MODE);
@@ -577,7 +1013,9 @@ void I2CPeriph::requestTransfer(uint16_t devAddress, uint8_t size, CommMode mode
     // the register clear part.
 
     // Setup the Request mode
-    if      (reqst == Request::kStart_Write) {          // If request is for START_WRITE
+    if      ( (reqst == Request::kStart_Write) ||       // If request is for START_WRITE (or
+              (reqst == Request::kStart_WriteRead) ||   // write part of WRITE then READ, or
+              (reqst == Request::kProbe) ) {            // PROBE - write with no data)
         _i2c_handle_->Instance->CR2 |= (uint32_t)(I2C_CR2_START);
         // just set START bit (write is done, by clearing the read bit)
         _cur_reqst_ = reqst;    // Bring across the request mode
@@ -593,8 +1031,62 @@ void I2CPeriph::requestTransfer(uint16_t devAddress, uint8_t size, CommMode mode
 
 #elif defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
 //=================================================================================================
+// Not used, the address, size and request of each message are provided to the driver directly
+// (see ".formMessages")
+    (void) devAddress;
+    (void) size;
+    (void) mode;
+    (void) reqst;
+
+#else
+//=================================================================================================
+
+#endif
+
+}
+
+void I2CPeriph::reloadTransfer(void) {
+/**************************************************************************************************
+ * Function will request the next chunk of the current communication, once the current chunk is
+ * complete (Transfer Complete Reload). Up to "I2CPe_MaxNBYTES" packets are requested, if more
+ * remain then RELOAD mode is kept, otherwise the mode of the communication is applied (i.e.
+ * "AutoEnd" will generate the STOP once the last chunk is complete).
+ * No START is generated, so is a continuation of the same communication on the bus.
+ *************************************************************************************************/
+
+#if   defined(zz__MiSTM32Fx__zz)        // If the target device is an STM32Fxx from cubeMX then
+//=================================================================================================
 // Not populated yet
 
+#elif defined(zz__MiSTM32Lx__zz)        // If the target device is an STM32Lxx from cubeMX then
+//=================================================================================================
+    uint16_t size = _reload_count_;     // Packets within next chunk
+
+    if (size > I2CPe_MaxNBYTES)         // Limit to the maximum of a single request
+        size = I2CPe_MaxNBYTES;
+
+    _reload_count_ -= size;             // Remove from packets not yet requested
+
+    // Clear the size and mode, then populate for the next chunk (writing NBYTES clears the
+    // Transfer Complete Reload flag)
+    _i2c_handle_->Instance->CR2 &= ~((I2C_CR2_NBYTES | I2C_CR2_RELOAD | I2C_CR2_AUTOEND));
+
+    _i2c_handle_->Instance->CR2 |= (((uint32_t)size << I2C_CR2_NBYTES_Pos) & I2C_CR2_NBYTES);
+
+    if      (_reload_count_ != 0)                       // If more chunks remain
+        _i2c_handle_->Instance->CR2 |= (uint32_t)(I2C_RELOAD_MODE);
+        // Keep the RELOAD bit in register
+    else if (_cur_mode_ == CommMode::kAutoEnd)          // If last chunk, and mode is "AutoEnd"
+        _i2c_handle_->Instance->CR2 |= (uint32_t)(I2C_AUTOEND_MODE);
+        // Set the AutoEnd bit in register
+    else if (_cur_mode_ == CommMode::kReload)           // If last chunk, and mode is "Reload"
+        _i2c_handle_->Instance->CR2 |= (uint32_t)(I2C_RELOAD_MODE);
+        // Set the RELOAD bit in register
+
+#elif defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
+//=================================================================================================
+// Not required (transfers are not split)
+
 #else
 //=================================================================================================
 
@@ -631,99 +1123,382 @@ void I2CPeriph::formW8bitArray(I2CPeriph::Form *RequestForm, uint8_t *pData) {
         // Indicate that data type is 8bit array.
 }
 
-void I2CPeriph::specificRequest(uint16_t devAddress, uint16_t size, uint8_t *pData,
-                        CommMode mode, Request reqst,
-                        volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag) {
+void I2CPeriph::formR8bitArray(I2CPeriph::Form *RequestForm, uint8_t *pData, uint16_t size) {
 /**************************************************************************************************
- * Function used to populate the internal I2C Form stack, with the input requested communication.
- * Data comes from an array (pointer - pData)
+ * Link input 8bit array pointer to the read part of the provided I2C Request Form (write then
+ * read form), along with the amount of data to read.
  *************************************************************************************************/
-    Form request_form = genericForm(devAddress, size, mode, reqst, fltReturn, cmpFlag);
-
-    formW8bitArray(&request_form, pData);
-
-
-    _form_queue_.inputWrite(request_form);      // Put request onto I2C Form Queue
+    RequestForm->ReadBuff   = pData;        // Pass data pointer to I2CForm
+    RequestForm->readSize   = size;         // Pass amount of data to read
 }
 
-uint8_t I2CPeriph::getFormWriteData(Form *RequestForm) {
+uint8_t I2CPeriph::muxChannel(uint16_t devAddress) {
 /**************************************************************************************************
- * Retrieve the next data point to write to external device from the selected I2C Request form
+ * Returns the I2C multiplexer channel of the device address ("I2CPe_MuxAddr"), or "I2CPe_NoMux"
+ * if the device is not behind the multiplexer.
  *************************************************************************************************/
-    uint8_t temp_val = 0;       // Temporary variable to store data value
-
-    temp_val = *(RequestForm->Buff);            // Retrieve data from array
-    RequestForm->Buff       += sizeof(uint8_t); // Increment array pointer
+    if ((devAddress & I2CPe_MuxFlag) == 0)
+        return (I2CPe_NoMux);
 
-    return (temp_val);      // Return value outside of function
+    return ( (uint8_t) ((devAddress >> I2CPe_MuxChanPos) & I2CPe_MuxChanMASK) );
 }
 
-void I2CPeriph::putFormReadData(Form *RequestForm, uint8_t readdata) {
+uint8_t I2CPeriph::muxSwitchChk(uint16_t devAddress) {
 /**************************************************************************************************
- * Data read from the I2C external device is copied into the requested source location, as per
- * the I2C Request form
+ * Check if the I2C multiplexer channel needs to be selected, prior to a transfer to the device
+ * address (output = 1). Not needed if no multiplexer has been provided, the device is not behind
+ * the multiplexer, or its channel is already selected.
  *************************************************************************************************/
-    *(RequestForm->Buff)    = readdata;         // Put data into array
-    RequestForm->Buff       += sizeof(uint8_t); // Increment array pointer
+    uint8_t channel = muxChannel(devAddress);
+
+    if ( (_mux_address_ == 0) || (channel == I2CPe_NoMux) || (channel == _mux_channel_) )
+        return (0);
+    else
+        return (1);
 }
 
-I2CPeriph::DevFlt I2CPeriph::poleMasterTransmit(uint16_t devAddress, uint8_t *pdata,
-                                                uint8_t size) {
+I2CPeriph::DevFlt I2CPeriph::poleMuxSelect(uint16_t devAddress) {
 /**************************************************************************************************
- * Function will setup a communication link with the selected Device address. Where it will then
- * send the requested amount of data to be written to the device.
- * Any errors observed with the bus during the interaction will result in exiting of the function,
- * and the class fault status being updated.
+ * If needed (".muxSwitchChk"), will select the I2C multiplexer channel of the device address -
+ * by writing the channel's bit to the multiplexer control register (polling, with a STOP). If
+ * the write fails, then the selected channel is no longer known (will be written again next
+ * time), and the fault is returned.
+ * The bus is to be held by the caller (for RaspberryPi, the polling functions and the submission
+ * of the queue hold the bus lock), so the select and the transfer it is for are not split.
  *************************************************************************************************/
-    // Indicate that the bus is not free
-    comm_state = CommLock::kCommunicating;      // Indicate bus is communicating
+    uint8_t channel = muxChannel(devAddress);
+    DevFlt  returnval = DevFlt::kNone;
 
-#if ( defined(zz__MiSTM32Fx__zz) || defined(zz__MiSTM32Lx__zz)  )
-// If the target device is either STM32Fxx or STM32Lxx from cubeMX then ...
-//=================================================================================================
-    //Enable();                     // Ensure that the device has been enabled
+    if (muxSwitchChk(devAddress) == 0)              // If no select is needed, then exit
+        return (DevFlt::kNone);
 
-    while(busBusyChk() == 1) {}   // Wait until the bus is no longer busy
+    _mux_select_ = (uint8_t) (1 << channel);
 
-    requestTransfer(devAddress, size, CommMode::kAutoEnd, Request::kStart_Write);
-    // Setup request for the I2C bus, of the size required, and the I2C device to communicate with
+#if   defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
+//=================================================================================================
+    struct i2c_msg msg;                             // Single message for driver
+    Form request_form = genericForm(_mux_address_, 1, CommMode::kAutoEnd, Request::kStart_Write,
+                                    __null, __null);
 
-    while(size != 0) {
-        while(transmitEmptyChk() == 0) {    // Whilst checking for Transmit Empty
-            if (busNACKChk() == 1) {        // If there is a NACK
-                clearNACK();                // Clear the NACK bit
-                return (flt = DevFlt::kNACK);       // Fault status of "I2C_NACK"
-            }
+    formW8bitArray(&request_form, &_mux_select_);
+    formMessages(&request_form, &msg);
 
-            if (busErroChk() == 1) {        // If there has been a bus error
-                clearBusEr();               // Clear the Bus error bit
-                return (flt = DevFlt::kBus_Error);  // Fault status of "I2C_BUS_ERROR"
-            }
-        }
-        writeDR(*pdata);                    // Put data onto the TXDR for transmission
-        pdata++;                            // Increment array
-        size--;                             // Decrease size
-    }
+    returnval = transferMessages(&msg, 1);          // Own driver call (STOP at the end), doesn't
+                                                    // change the bus state (may be within
+                                                    // ".transferBatch")
 
-    while(busStopChk() == 0) {              // Wait on the STOP to be set
-        if (busNACKChk() == 1) {            // If there is a NACK
-            clearNACK();                    // Clear the NACK bit
-            return (flt = DevFlt::kNACK);           // Fault status of "I2C_NACK"
-        }
+#else
+//=================================================================================================
+    returnval = poleMasterTransmit(_mux_address_, &_mux_select_, 1);
 
-        if (busErroChk() == 1) {            // If there has been a bus error
-            clearBusEr();                   // Clear the Bus error bit
-            return (flt = DevFlt::kBus_Error);      // Fault status of "I2C_BUS_ERROR"
-        }
+#endif
+
+    if (returnval != DevFlt::kNone) {
+        _mux_channel_ = I2CPe_MuxUnknown;
+        return (flt = returnval);
     }
 
-    clearStop();                    // Clear the STOP bit
+    _mux_channel_ = channel;
+    MuxSwitchCnt++;
+
+    return (DevFlt::kNone);
+}
+
+void I2CPeriph::groupForm(void) {
+/**************************************************************************************************
+ * If the next I2C Request Form needs a different multiplexer channel to the one selected, then
+ * check the following "I2CPe_GroupDepth" forms for one on the selected channel (and no fault),
+ * and bring it to the front of the queue - so the channel does not need to be changed.
+ * Forms skipped over are on a different channel (so are to different devices), therefore order of
+ * forms to the same device is kept. Checking stops at a form which is part of a multi-form
+ * communication ("kSoftEnd"/"kReload"/"kStop"/"kNothing"), so these are not split.
+ * Once "I2CPe_GroupLimit" forms have been brought forward, the next form is left in order (so
+ * forms cannot be starved).
+ *************************************************************************************************/
+    Form            next_form;                  // Form within the queue
+    uint16_t        count   = _form_queue_.unreadCount();   // Number of forms within the queue
+    uint16_t        i       = 0;                // Variable for looping
+
+    if ( (count == 0) || (_mux_channel_ == I2CPe_MuxUnknown) )
+        return;                                 // If queue is empty (or no channel selected)
+
+    next_form = _form_queue_.readBuffer(_form_queue_.output_pointer);
+    if ( (muxSwitchChk(next_form.devAddress) == 0) || (_group_count_ >= I2CPe_GroupLimit) ) {
+        _group_count_ = 0;                      // If channel is selected, or limit has been
+        return;                                 // reached, then leave in order
+    }
+
+    if (count > (I2CPe_GroupDepth + 1))         // Limit the number of forms checked
+        count = I2CPe_GroupDepth + 1;
+
+    for (i = 0; i < count; i++) {
+        next_form = _form_queue_.readBuffer(_form_queue_.output_pointer + i);
+
+        if ( ( (next_form.Mode != CommMode::kAutoEnd) &&
+               (next_form.Reqst != Request::kStart_WriteRead) ) ||
+             ( (next_form.Reqst != Request::kStart_Write) &&
+               (next_form.Reqst != Request::kStart_Read)  &&
+               (next_form.Reqst != Request::kStart_WriteRead) &&
+               (next_form.Reqst != Request::kProbe) ) )
+            return;     // If part of a multi-form communication, then stop checking
+
+        if ( (i != 0) && (muxChannel(next_form.devAddress) == _mux_channel_) &&
+             (*(next_form.Flt) == DevFlt::kNone) ) {
+            _form_queue_.promoteEntry(i);       // If selected channel, bring to the front
+            _group_count_++;
+            GroupCnt++;
+            return;
+        }
+    }
+}
+
+void I2CPeriph::configMux(uint16_t muxAddress) {
+/**************************************************************************************************
+ * Provide the address of the I2C multiplexer (full 8bit address, same as devices), or 0 if there
+ * is none. Selected channel is not known, so will be written before the next transfer to a device
+ * behind the multiplexer.
+ *************************************************************************************************/
+    _mux_address_ = muxAddress & I2CPe_AddrMASK;
+    _mux_channel_ = I2CPe_MuxUnknown;
+}
+
+void I2CPeriph::specificRequest(uint16_t devAddress, uint16_t size, uint8_t *pData,
+                        CommMode mode, Request reqst,
+                        volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag,
+                        CmpltCallback callback, void *context) {
+/**************************************************************************************************
+ * Function used to populate the internal I2C Form stack, with the input requested communication.
+ * Data comes from an array (pointer - pData)
+ *************************************************************************************************/
+    Form request_form = genericForm(devAddress, size, mode, reqst, fltReturn, cmpFlag);
+
+    formW8bitArray(&request_form, pData);
+
+    request_form.Callback       = callback;     // Populate completion callback
+    request_form.Context        = context;      //
+
+#if   defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
+//=================================================================================================
+    pthread_mutex_lock(&_queue_lock_);
+
+    _form_queue_.inputWrite(request_form);      // Put request onto I2C Form Queue
+
+    pthread_mutex_unlock(&_queue_lock_);
+
+#else
+//=================================================================================================
+    _form_queue_.inputWrite(request_form);      // Put request onto I2C Form Queue
+
+#endif
+}
+
+void I2CPeriph::cmpltCallback(Form *RequestForm) {
+/**************************************************************************************************
+ * Call the completion callback of the I2C Request Form, if one has been linked.
+ *************************************************************************************************/
+    if (RequestForm->Callback != __null)
+        RequestForm->Callback(RequestForm->Context);
+}
+
+void I2CPeriph::scanCallback(void *context) {
+/**************************************************************************************************
+ * Completion callback of the bus scan probes (".poleBusScan"), "context" is the count of completed
+ * probes - which is incremented (release ordering, so the probe's fault flag is visible once the
+ * count is seen).
+ *************************************************************************************************/
+    __atomic_fetch_add((uint16_t *) context, 1, __ATOMIC_RELEASE);
+}
+
+uint8_t I2CPeriph::releaseProbe(Form *RequestForm, uint16_t *done) {
+/**************************************************************************************************
+ * If "RequestForm" is a bus scan probe counted by "done", then its fault/complete flags are moved
+ * to the class ("_scan_flt_"/"_scan_cmp_"), and its callback is removed - so nothing is written
+ * back into ".poleBusScan". Returns 1 if released.
+ *************************************************************************************************/
+    if ( (RequestForm->Callback != &scanCallback) || (RequestForm->Context != done) )
+        return (0);
+
+    RequestForm->Flt        = &_scan_flt_;
+    RequestForm->Cmplt      = &_scan_cmp_;
+    RequestForm->Callback   = __null;
+    RequestForm->Context    = __null;
+
+    return (1);
+}
+
+uint16_t I2CPeriph::cancelProbes(uint16_t *done) {
+/**************************************************************************************************
+ * Cancel the bus scan probes counted by "done", which have not been completed. Probes within the
+ * queue are released (see ".releaseProbe"), and as "_scan_flt_" is faulted ("kTimeout") are then
+ * removed without being transferred.
+ * For STM32 the probe in progress (or waiting on the multiplexer channel select) is also
+ * released. For RaspberryPi, probes already taken by a driver call are left to complete.
+ * Returns the number of probes cancelled.
+ *************************************************************************************************/
+    uint16_t    count   = 0;                        // Number of probes cancelled
+    uint16_t    i       = 0;                        // Variable for looping
+
+    _scan_flt_ = DevFlt::kTimeout;
+
+#if   defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
+//=================================================================================================
+    pthread_mutex_lock(&_queue_lock_);
+
+#endif
+    for (i = 0; i != _form_queue_.unreadCount(); i++)
+        count += releaseProbe(&(_form_queue_.pa[(_form_queue_.output_pointer + i) %
+                                                _form_queue_.length]), done);
+
+#if   defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
+//=================================================================================================
+    pthread_mutex_unlock(&_queue_lock_);
+
+#elif ( defined(zz__MiSTM32Fx__zz) || defined(zz__MiSTM32Lx__zz)  )
+// If the target device is either STM32Fxx or STM32Lxx from cubeMX then ...
+//=================================================================================================
+    if (comm_state == CommLock::kCommunicating)     // Probe in progress
+        count += releaseProbe(&_cur_form_, done);
+
+    if (_mux_pend_ == 1)                            // Probe waiting on channel select
+        count += releaseProbe(&_mux_form_, done);
+
+#endif
+    return (count);
+}
+
+uint32_t I2CPeriph::tickNow(void) {
+/**************************************************************************************************
+ * Returns the current time in milliseconds (wraps around), for timeouts. STM32 uses the HAL tick,
+ * RaspberryPi the monotonic clock.
+ *************************************************************************************************/
+#if   defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
+//=================================================================================================
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ( (uint32_t) (((uint64_t) now.tv_sec * 1000) + ((uint64_t) now.tv_nsec / 1000000)) );
+
+#elif ( defined(zz__MiSTM32Fx__zz) || defined(zz__MiSTM32Lx__zz)  )
+// If the target device is either STM32Fxx or STM32Lxx from cubeMX then ...
+//=================================================================================================
+    return (HAL_GetTick());
+
+#else
+//=================================================================================================
+    return (0);
+
+#endif
+}
+
+uint8_t I2CPeriph::getFormWriteData(Form *RequestForm) {
+/**************************************************************************************************
+ * Retrieve the next data point to write to external device from the selected I2C Request form
+ *************************************************************************************************/
+    uint8_t temp_val = 0;       // Temporary variable to store data value
+
+    temp_val = *(RequestForm->Buff);            // Retrieve data from array
+    RequestForm->Buff       += sizeof(uint8_t); // Increment array pointer
+
+    return (temp_val);      // Return value outside of function
+}
+
+void I2CPeriph::putFormReadData(Form *RequestForm, uint8_t readdata) {
+/**************************************************************************************************
+ * Data read from the I2C external device is copied into the requested source location, as per
+ * the I2C Request form
+ *************************************************************************************************/
+    *(RequestForm->Buff)    = readdata;         // Put data into array
+    RequestForm->Buff       += sizeof(uint8_t); // Increment array pointer
+}
+
+I2CPeriph::DevFlt I2CPeriph::poleMasterTransmit(uint16_t devAddress, uint8_t *pdata,
+                                                uint16_t size) {
+/**************************************************************************************************
+ * Function will setup a communication link with the selected Device address. Where it will then
+ * send the requested amount of data to be written to the device (requested in chunks, if larger
+ * than "I2CPe_MaxNBYTES").
+ * Any errors observed with the bus during the interaction will result in exiting of the function,
+ * and the class fault status being updated.
+ *************************************************************************************************/
+#if   defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
+//=================================================================================================
+    pthread_mutex_lock(&_bus_lock_);    // Lock I2C bus (waits for interrupt emulation thread)
+
+#endif
+
+    if (poleMuxSelect(devAddress) != DevFlt::kNone) {   // Select the multiplexer channel (if
+#if   defined(zz__MiRaspbPi__zz)                        // needed)
+        pthread_mutex_unlock(&_bus_lock_);              // Release I2C bus
+#endif
+        return (flt);
+    }
+
+    // Indicate that the bus is not free
+    __atomic_store_n(&comm_state, CommLock::kCommunicating, __ATOMIC_RELEASE);
+
+#if ( defined(zz__MiSTM32Fx__zz) || defined(zz__MiSTM32Lx__zz)  )
+// If the target device is either STM32Fxx or STM32Lxx from cubeMX then ...
+//=================================================================================================
+    //Enable();                     // Ensure that the device has been enabled
+
+    while(busBusyChk() == 1) {}   // Wait until the bus is no longer busy
+
+    requestTransfer(devAddress, size, CommMode::kAutoEnd, Request::kStart_Write);
+    // Setup request for the I2C bus, of the size required, and the I2C device to communicate with
+
+    while(size != 0) {
+        while(transmitEmptyChk() == 0) {    // Whilst checking for Transmit Empty
+            if (transferReloadChk() == 1)   // If end of chunk, then request the next
+                reloadTransfer();
+
+            if (busNACKChk() == 1) {        // If there is a NACK
+                clearNACK();                // Clear the NACK bit
+                return (flt = DevFlt::kNACK);       // Fault status of "I2C_NACK"
+            }
+
+            if (busErroChk() == 1) {        // If there has been a bus error
+                clearBusEr();               // Clear the Bus error bit
+                return (flt = DevFlt::kBus_Error);  // Fault status of "I2C_BUS_ERROR"
+            }
+        }
+        writeDR(*pdata);                    // Put data onto the TXDR for transmission
+        pdata++;                            // Increment array
+        size--;                             // Decrease size
+    }
+
+    while(busStopChk() == 0) {              // Wait on the STOP to be set
+        if (busNACKChk() == 1) {            // If there is a NACK
+            clearNACK();                    // Clear the NACK bit
+            return (flt = DevFlt::kNACK);           // Fault status of "I2C_NACK"
+        }
+
+        if (busErroChk() == 1) {            // If there has been a bus error
+            clearBusEr();                   // Clear the Bus error bit
+            return (flt = DevFlt::kBus_Error);      // Fault status of "I2C_BUS_ERROR"
+        }
+    }
+
+    clearStop();                    // Clear the STOP bit
 
     //Disable();                    // Ensure that the device has been disable
 
 #elif defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
 //=================================================================================================
-// Not populated yet
+    struct i2c_msg msg;                     // Single message for driver
+    Form request_form = genericForm(devAddress, size, CommMode::kAutoEnd, Request::kStart_Write,
+                                    __null, __null);
+
+    formW8bitArray(&request_form, pdata);
+    formMessages(&request_form, &msg);      // Same message as an I2C Request Form
+
+    flt = transferMessages(&msg, 1);
+
+    __atomic_store_n(&comm_state, CommLock::kFree, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&_bus_lock_);      // Release I2C bus
+
+    return (flt);
+
 #else
 //=================================================================================================
 // Device not supported
@@ -731,21 +1506,34 @@ I2CPeriph::DevFlt I2CPeriph::poleMasterTransmit(uint16_t devAddress, uint8_t *pd
 #endif
 
     // Indicate that the bus is free
-    comm_state = CommLock::kFree;       // Indicate bus is free
+    __atomic_store_n(&comm_state, CommLock::kFree, __ATOMIC_RELEASE);
 
     return (flt = DevFlt::kNone);       // No fault by this point, so return no fault
 }
 
 I2CPeriph::DevFlt I2CPeriph::poleMasterReceive(uint16_t devAddress, uint8_t *pdata,
-                                               uint8_t size) {
+                                               uint16_t size) {
 /**************************************************************************************************
  * Function will setup a communication link with the selected Device address. Where it will then
  * read back the request amount of data from the device.
  * Any errors observed with the bus during the interaction will result in exiting of the function,
  * and the class fault status being updated.
  *************************************************************************************************/
+#if   defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
+//=================================================================================================
+    pthread_mutex_lock(&_bus_lock_);    // Lock I2C bus (waits for interrupt emulation thread)
+
+#endif
+
+    if (poleMuxSelect(devAddress) != DevFlt::kNone) {   // Select the multiplexer channel (if
+#if   defined(zz__MiRaspbPi__zz)                        // needed)
+        pthread_mutex_unlock(&_bus_lock_);              // Release I2C bus
+#endif
+        return (flt);
+    }
+
     // Indicate that the bus is not free
-    comm_state = CommLock::kCommunicating;      // Indicate bus is communicating
+    __atomic_store_n(&comm_state, CommLock::kCommunicating, __ATOMIC_RELEASE);
 
 #if ( defined(zz__MiSTM32Fx__zz) || defined(zz__MiSTM32Lx__zz)  )
 // If the target device is either STM32Fxx or STM32Lxx from cubeMX then ...
@@ -759,6 +1547,9 @@ I2CPeriph::DevFlt I2CPeriph::poleMasterReceive(uint16_t devAddress, uint8_t *pda
 
     while(size != 0) {
         while(receiveToReadChk() == 0) {    // Whilst checking for Receive buffer is full
+            if (transferReloadChk() == 1)   // If end of chunk, then request the next
+                reloadTransfer();
+
             if (busNACKChk() == 1) {        // If there is a NACK
                 clearNACK();                // Clear the NACK bit
                 return (flt = DevFlt::kNACK);       // Fault status of "I2C_NACK"
@@ -792,7 +1583,20 @@ I2CPeriph::DevFlt I2CPeriph::poleMasterReceive(uint16_t devAddress, uint8_t *pda
 
 #elif defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
 //=================================================================================================
-// Not populated yet
+    struct i2c_msg msg;                     // Single message for driver
+    Form request_form = genericForm(devAddress, size, CommMode::kAutoEnd, Request::kStart_Read,
+                                    __null, __null);
+
+    formW8bitArray(&request_form, pdata);
+    formMessages(&request_form, &msg);      // Same message as an I2C Request Form
+
+    flt = transferMessages(&msg, 1);
+
+    __atomic_store_n(&comm_state, CommLock::kFree, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&_bus_lock_);      // Release I2C bus
+
+    return (flt);
+
 #else
 //=================================================================================================
 // Device not supported
@@ -800,7 +1604,138 @@ I2CPeriph::DevFlt I2CPeriph::poleMasterReceive(uint16_t devAddress, uint8_t *pda
 #endif
 
     // Indicate that the bus is free
-    comm_state = CommLock::kFree;       // Indicate bus is free
+    __atomic_store_n(&comm_state, CommLock::kFree, __ATOMIC_RELEASE);
+
+    return (flt = DevFlt::kNone);       // No fault by this point, so return no fault
+}
+
+I2CPeriph::DevFlt I2CPeriph::poleMasterWriteRead(uint16_t devAddress, uint8_t *wdata,
+                                                 uint16_t wsize, uint8_t *rdata, uint16_t rsize) {
+/**************************************************************************************************
+ * Function will setup a communication link with the selected Device address. Where it will then
+ * send the requested amount of data to be written to the device, followed by a repeated START
+ * (no STOP) and read back the requested amount of data from the device - i.e. register read.
+ * Any errors observed with the bus during the interaction will result in exiting of the function,
+ * and the class fault status being updated.
+ *************************************************************************************************/
+#if   defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
+//=================================================================================================
+    pthread_mutex_lock(&_bus_lock_);    // Lock I2C bus (waits for interrupt emulation thread)
+
+#endif
+
+    if (poleMuxSelect(devAddress) != DevFlt::kNone) {   // Select the multiplexer channel (if
+#if   defined(zz__MiRaspbPi__zz)                        // needed)
+        pthread_mutex_unlock(&_bus_lock_);              // Release I2C bus
+#endif
+        return (flt);
+    }
+
+    // Indicate that the bus is not free
+    __atomic_store_n(&comm_state, CommLock::kCommunicating, __ATOMIC_RELEASE);
+
+#if ( defined(zz__MiSTM32Fx__zz) || defined(zz__MiSTM32Lx__zz)  )
+// If the target device is either STM32Fxx or STM32Lxx from cubeMX then ...
+//=================================================================================================
+    while(busBusyChk() == 1) {}   // Wait until the bus is no longer busy
+
+    requestTransfer(devAddress, wsize, CommMode::kSoftEnd, Request::kStart_Write);
+    // Setup write request for the I2C bus, without generating a STOP once complete
+
+    while(wsize != 0) {
+        while(transmitEmptyChk() == 0) {    // Whilst checking for Transmit Empty
+            if (transferReloadChk() == 1)   // If end of chunk, then request the next
+                reloadTransfer();
+
+            if (busNACKChk() == 1) {        // If there is a NACK
+                clearNACK();                // Clear the NACK bit
+                return (flt = DevFlt::kNACK);       // Fault status of "I2C_NACK"
+            }
+
+            if (busErroChk() == 1) {        // If there has been a bus error
+                clearBusEr();               // Clear the Bus error bit
+                return (flt = DevFlt::kBus_Error);  // Fault status of "I2C_BUS_ERROR"
+            }
+        }
+        writeDR(*wdata);                    // Put data onto the TXDR for transmission
+        wdata++;                            // Increment array
+        wsize--;                            // Decrease size
+    }
+
+    while(transmitComptChk() == 0) {        // Wait on the write to be complete
+        if (busNACKChk() == 1) {            // If there is a NACK
+            clearNACK();                    // Clear the NACK bit
+            return (flt = DevFlt::kNACK);           // Fault status of "I2C_NACK"
+        }
+
+        if (busErroChk() == 1) {            // If there has been a bus error
+            clearBusEr();                   // Clear the Bus error bit
+            return (flt = DevFlt::kBus_Error);      // Fault status of "I2C_BUS_ERROR"
+        }
+    }
+
+    requestTransfer(devAddress, rsize, CommMode::kAutoEnd, Request::kStart_Read);
+    // Setup read request for the I2C bus (repeated START), with STOP once complete
+
+    while(rsize != 0) {
+        while(receiveToReadChk() == 0) {    // Whilst checking for Receive buffer is full
+            if (transferReloadChk() == 1)   // If end of chunk, then request the next
+                reloadTransfer();
+
+            if (busNACKChk() == 1) {        // If there is a NACK
+                clearNACK();                // Clear the NACK bit
+                return (flt = DevFlt::kNACK);       // Fault status of "I2C_NACK"
+            }
+
+            if (busErroChk() == 1) {        // If there has been a bus error
+                clearBusEr();               // Clear the Bus error bit
+                return (flt = DevFlt::kBus_Error);  // Fault status of "I2C_BUS_ERROR"
+            }
+        }
+        *rdata = readDR();                  // Read the data from RXDR into array
+        rdata++;                            // Increment array
+        rsize--;                            // Decrease size
+    }
+
+    while(busStopChk() == 0) {              // Wait on the STOP to be set
+        if (busNACKChk() == 1) {            // If there is a NACK
+            clearNACK();                    // Clear the NACK bit
+            return (flt = DevFlt::kNACK);           // Fault status of "I2C_NACK"
+        }
+
+        if (busErroChk() == 1) {            // If there has been a bus error
+            clearBusEr();                   // Clear the Bus error bit
+            return (flt = DevFlt::kBus_Error);      // Fault status of "I2C_BUS_ERROR"
+        }
+    }
+
+    clearStop();                    // Clear the STOP bit
+
+#elif defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
+//=================================================================================================
+    struct i2c_msg msgs[2];                 // Write then read messages for driver
+    Form request_form = genericForm(devAddress, wsize, CommMode::kSoftEnd,
+                                    Request::kStart_WriteRead, __null, __null);
+
+    formW8bitArray(&request_form, wdata);
+    formR8bitArray(&request_form, rdata, rsize);
+
+    flt = transferMessages(msgs, formMessages(&request_form, msgs));
+        // Same messages as an I2C Request Form
+
+    __atomic_store_n(&comm_state, CommLock::kFree, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&_bus_lock_);      // Release I2C bus
+
+    return (flt);
+
+#else
+//=================================================================================================
+// Device not supported
+
+#endif
+
+    // Indicate that the bus is free
+    __atomic_store_n(&comm_state, CommLock::kFree, __ATOMIC_RELEASE);
 
     return (flt = DevFlt::kNone);       // No fault by this point, so return no fault
 }
@@ -812,9 +1747,39 @@ I2CPeriph::DevFlt I2CPeriph::poleDeviceRdy(uint16_t devAddress) {
  * Any errors observed with the bus during the interaction will result in exiting of the function,
  * and the class fault status being updated.
  *************************************************************************************************/
+#if   defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
+//=================================================================================================
+    pthread_mutex_lock(&_bus_lock_);    // Lock I2C bus (waits for interrupt emulation thread)
+
+#endif
+
+    if (poleMuxSelect(devAddress) != DevFlt::kNone) {   // Select the multiplexer channel (if
+#if   defined(zz__MiRaspbPi__zz)                        // needed)
+        pthread_mutex_unlock(&_bus_lock_);              // Release I2C bus
+#endif
+        return (flt);
+    }
+
     // Indicate that the bus is not free
-    comm_state = CommLock::kCommunicating;      // Indicate bus is communicating
+    __atomic_store_n(&comm_state, CommLock::kCommunicating, __ATOMIC_RELEASE);
+
+#if   defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
+//=================================================================================================
+    DevFlt returnval = DevFlt::kNone;   // Fault from driver
+    struct i2c_msg msg;                 // Single message for driver (no data)
+    Form request_form = genericForm(devAddress, 0, CommMode::kAutoEnd, Request::kStart_Write,
+                                    __null, __null);
+
+    formMessages(&request_form, &msg);
+    returnval = transferMessages(&msg, 1);
 
+    __atomic_store_n(&comm_state, CommLock::kFree, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&_bus_lock_);  // Release I2C bus
+
+    return (returnval);
+
+#else
+//=================================================================================================
     //Enable();                     // Ensure that the device has been enabled
 
     requestTransfer(devAddress, 0, CommMode::kAutoEnd, Request::kStart_Write);
@@ -836,9 +1801,111 @@ I2CPeriph::DevFlt I2CPeriph::poleDeviceRdy(uint16_t devAddress) {
     //Disable();                    // Ensure that the device has been disable
 
     // Indicate that the bus is free
-    comm_state = CommLock::kFree;       // Indicate bus is free
+    __atomic_store_n(&comm_state, CommLock::kFree, __ATOMIC_RELEASE);
 
     return(DevFlt::kNone);
+
+#endif
+}
+
+I2CPeriph::DevFlt I2CPeriph::poleBusScan(uint8_t *Bitmap, uint8_t channel) {
+/**************************************************************************************************
+ * Function will probe each 7bit address ("I2CPe_ScanFirst" to "I2CPe_ScanLast"), on the I2C
+ * multiplexer "channel" if not "I2CPe_NoMux". "Bitmap" ("I2CPe_ScanBytes" in size) is cleared,
+ * then the bit for each address which acknowledged is set (bit "address & 7" of byte
+ * "address >> 3").
+ *
+ * Each probe is an I2C Request Form ("kProbe"), queued as many as there is space for within the
+ * queue (forms already within the queue are not overwritten), and started together. Function
+ * waits for each set of probes to complete (counted by ".scanCallback"), before queuing the next.
+ * A NACK indicates that there is no device, any other fault is returned (last one seen).
+ * If a set of probes does not complete within "I2CPe_ScanTimeout", then the remaining probes are
+ * cancelled (see ".cancelProbes"), and "kTimeout" is returned - bitmap only covers the addresses
+ * of the previous sets.
+ *************************************************************************************************/
+    volatile DevFlt     probe_flt[I2CPe_ScanLast + 1];  // Fault flag of each probe
+    volatile uint16_t   probe_cmp[I2CPe_ScanLast + 1];  // Complete flag of each probe
+    uint16_t            done    = 0;                // Number of probes completed
+    uint16_t            queued  = 0;                // Number of probes queued
+    uint16_t            space   = 0;                // Space within the queue
+    uint16_t            cancelled = 0;              // Number of probes cancelled (timeout)
+    uint8_t             address = I2CPe_ScanFirst;  // Next address to probe
+    uint8_t             first   = I2CPe_ScanFirst;  // First address of current set of probes
+    uint8_t             scanned = I2CPe_ScanLast + 1;   // Addresses below have been probed
+    uint32_t            start   = 0;                // Time current set of probes was started
+    uint8_t             i       = 0;                // Variable for looping
+    uint16_t            devAddress = 0;             // Address of probe (with channel)
+    DevFlt              returnval = DevFlt::kNone;
+    Form                request_form;
+
+    for (i = 0; i != I2CPe_ScanBytes; i++)          // Clear the bitmap
+        Bitmap[i] = 0;
+
+    while (address <= I2CPe_ScanLast) {
+        first = address;
+
+#if   defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
+//=================================================================================================
+        pthread_mutex_lock(&_queue_lock_);
+
+#endif
+        space = _form_queue_.spaceRemaining();
+
+        while ( (space != 0) && (address <= I2CPe_ScanLast) ) {
+            // Queue probes whilst there is space
+            devAddress = (uint16_t) (address << 1);
+            if (channel != I2CPe_NoMux)
+                devAddress = I2CPe_MuxAddr(channel, devAddress);
+
+            probe_flt[address] = DevFlt::kNone;
+            probe_cmp[address] = 0;
+
+            request_form = genericForm(devAddress, 0, CommMode::kAutoEnd, Request::kProbe,
+                                       &(probe_flt[address]), &(probe_cmp[address]));
+            request_form.Callback   = &scanCallback;    // Count completed probes
+            request_form.Context    = &done;            //
+
+            _form_queue_.inputWrite(request_form);      // Put request onto I2C Form Queue
+
+            address++;
+            queued++;
+            space--;
+        }
+
+#if   defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
+//=================================================================================================
+        pthread_mutex_unlock(&_queue_lock_);
+
+#endif
+        startInterrupt();                           // Start the probes
+        start = tickNow();
+
+        while ( (__atomic_load_n(&done, __ATOMIC_ACQUIRE) != queued) &&
+                ((tickNow() - start) <= I2CPe_ScanTimeout) ) {}
+            // Wait for all queued probes to complete (or timeout)
+
+        if (__atomic_load_n(&done, __ATOMIC_ACQUIRE) != queued) {
+            // If timed out, then cancel the remaining probes - only waiting for the probes which
+            // have already been taken by a driver call (RaspberryPi)
+            cancelled = cancelProbes(&done);
+            while ( (uint16_t) (__atomic_load_n(&done, __ATOMIC_ACQUIRE) + cancelled) < queued ) {}
+
+            scanned = first;                        // Current set of probes not known
+            break;
+        }
+    }
+
+    for (address = I2CPe_ScanFirst; address < scanned; address++) {
+        if      (probe_flt[address] == DevFlt::kNone)           // If acknowledged, then device
+            Bitmap[address >> 3] |= (uint8_t) (1 << (address & 0x07));    // is present
+        else if (probe_flt[address] != DevFlt::kNACK)           // Otherwise if not a NACK, then
+            returnval = probe_flt[address];                     // capture fault
+    }
+
+    if (scanned != (I2CPe_ScanLast + 1))                        // If timed out, then indicate
+        returnval = DevFlt::kTimeout;                           // fault
+
+    return (flt = returnval);
 }
 
 void I2CPeriph::configTransmtIT(InterState intr) {
@@ -1023,7 +2090,8 @@ void I2CPeriph::configBusErroIT(InterState intr) {
 
 void I2CPeriph::intMasterReq(uint16_t devAddress, uint16_t size, uint8_t *Buff,
                              CommMode mode, Request reqst,
-                             volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag) {
+                             volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag,
+                             CmpltCallback callback, void *context) {
 /**************************************************************************************************
  * Function will be called to start off a new I2C communication.
  * This version of the I2C Form update functions, is expected to be only used for "Interrupt"
@@ -1034,26 +2102,111 @@ void I2CPeriph::intMasterReq(uint16_t devAddress, uint16_t size, uint8_t *Buff,
                           size,
                           Buff,
                           mode, reqst,
-                          fltReturn, cmpFlag
+                          fltReturn, cmpFlag,
+                          callback, context
                          );
 
     // Trigger interrupt(s)
     startInterrupt();
 }
 
+void I2CPeriph::intMasterWriteRead(uint16_t devAddress, uint16_t wSize, uint8_t *wBuff,
+                                   uint16_t rSize, uint8_t *rBuff,
+                                   volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag,
+                                   CmpltCallback callback, void *context) {
+/**************************************************************************************************
+ * Function will be called to start off a new I2C communication, which writes "wSize" of "wBuff"
+ * then reads "rSize" into "rBuff" - with a repeated START between (no STOP), as a single I2C
+ * Request Form ("kStart_WriteRead"). Write part is in "kSoftEnd" mode, so the read part can be
+ * started once the write is complete.
+ * Complete flag is updated with the amount of data read.
+ *************************************************************************************************/
+    Form request_form = genericForm(devAddress, wSize, CommMode::kSoftEnd,
+                                    Request::kStart_WriteRead, fltReturn, cmpFlag);
+
+    formW8bitArray(&request_form, wBuff);
+    formR8bitArray(&request_form, rBuff, rSize);
+
+    request_form.Callback       = callback;     // Populate completion callback
+    request_form.Context        = context;      //
+
+#if   defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
+//=================================================================================================
+    pthread_mutex_lock(&_queue_lock_);
+
+    _form_queue_.inputWrite(request_form);      // Put request onto I2C Form Queue
+
+    pthread_mutex_unlock(&_queue_lock_);
+
+#else
+//=================================================================================================
+    _form_queue_.inputWrite(request_form);      // Put request onto I2C Form Queue
+
+#endif
+
+    // Trigger interrupt(s)
+    startInterrupt();
+}
+
 void I2CPeriph::startInterrupt(void) {
 /**************************************************************************************************
  * Function will be called to start off a new I2C communication if there is something in the
  * queue, and the bus is free.
+ *
+ * For RaspberryPi, there are no interrupts - so the queue is drained through the i2c-dev driver
+ * (in batches), before returning. Unless the interrupt emulation thread is running, in which case
+ * it is woken to drain the queue (function does not block).
  *************************************************************************************************/
+#if   defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
+//=================================================================================================
+    uint64_t wake = 1;                          // Value to write to eventfd
+
+    if (__atomic_load_n(&_worker_run_, __ATOMIC_ACQUIRE) == 1) {
+        // If interrupt emulation thread is running, then wake it
+        if (write(_event_fd_, &wake, sizeof(wake)) != sizeof(wake))
+            flt = DevFlt::kDriver_Error;
+    }
+    else if (__atomic_load_n(&comm_state, __ATOMIC_ACQUIRE) == CommLock::kFree) {
+        // Otherwise if the I2C bus is free
+        pthread_mutex_lock(&_bus_lock_);        // Lock I2C bus (waits for polling transfer)
+        __atomic_store_n(&comm_state, CommLock::kCommunicating, __ATOMIC_RELEASE);
+
+        while (transferBatch() != 0) {};        // Submit all forms within queue
+
+        __atomic_store_n(&comm_state, CommLock::kFree, __ATOMIC_RELEASE);
+        pthread_mutex_unlock(&_bus_lock_);      // Indicate that I2C bus is now free
+    }
+
+#else
+//=================================================================================================
+    if ( (comm_state == CommLock::kFree) && (_mux_pend_ == 1) ) {
+        // If the multiplexer channel select has completed, then the form waiting on it is next
+        _mux_pend_ = 0;
+
+        if (_mux_flt_ == DevFlt::kNone) {           // If channel selected, then start the form
+            _mux_channel_ = muxChannel(_mux_form_.devAddress);
+            _cur_form_    = _mux_form_;
+
+            startTransfer();
+            return;
+        }
+
+        _mux_channel_       = I2CPe_MuxUnknown;     // Otherwise channel is not known, and the
+        *(_mux_form_.Flt)   = _mux_flt_;            // form is faulted
+        cmpltCallback( &(_mux_form_) );
+    }
+
     if ( (comm_state == CommLock::kFree) && (_form_queue_.state() != kGenBuffer_Empty) ) {
         // If the I2C bus is free, and there is I2C request forms in the queue
+        groupForm();                                        // Prefer form for selected channel
         _form_queue_.outputRead( &(_cur_form_) );           // Capture form request
 
         // Check current form to see if a fault has already been detected - therefore any new
         // request is no longer valid
         while (  *(_cur_form_.Flt) != DevFlt::kNone  ) {
-            // If there is a fault in request form, check to see if there is a new request
+            // If there is a fault in request form, then it is complete (no transfer), check to
+            // see if there is a new request
+            cmpltCallback( &(_cur_form_) );
             if ( _form_queue_.state() == kGenBuffer_Empty ) {   // If buffer is empty, break out
                 //Disable();
                 return;
@@ -1062,44 +2215,89 @@ void I2CPeriph::startInterrupt(void) {
             _form_queue_.outputRead( &(_cur_form_) );           // Capture form request
         }
 
-        comm_state = CommLock::kCommunicating;      // Lock I2C bus
-
-        //Enable();
-
-        requestTransfer(  _cur_form_.devAddress,
-                (uint8_t) _cur_form_.size,
-                          _cur_form_.Mode,
-                          _cur_form_.Reqst
-                        );
-            // Trigger communication as per Form request
-
-        if (_cur_reqst_ == Request::kStart_Write) {     // If this is a write request
-            configTransmtIT(InterState::kIT_Enable);    // Then enable Transmit Empty buffer
-        }                                               // interrupt
+        if (muxSwitchChk(_cur_form_.devAddress) == 1) {
+            // If the multiplexer channel of the form is not selected, then the form waits, and
+            // the channel select is written first (STOP at the end)
+            _mux_form_    = _cur_form_;
+            _mux_pend_    = 1;
+            _mux_flt_     = DevFlt::kNone;
+            _mux_cmp_     = 0;
+            _mux_select_  = (uint8_t) (1 << muxChannel(_mux_form_.devAddress));
+            MuxSwitchCnt++;
+
+            _cur_form_    = genericForm(_mux_address_, 1, CommMode::kAutoEnd,
+                                        Request::kStart_Write, &_mux_flt_, &_mux_cmp_);
+            formW8bitArray(&_cur_form_, &_mux_select_);
+        }
 
-        else if (_cur_reqst_ == Request::kStart_Read) { // If this is a read request
-            configReceiveIT(InterState::kIT_Enable);    // Then enable Receive buffer full
-        }                                               // interrupt
+        startTransfer();
     }
     else if ( (comm_state == CommLock::kFree) && (_form_queue_.state() == kGenBuffer_Empty) ) {
         //Disable();
     }
+
+#endif
+}
+
+#if ( defined(zz__MiSTM32Fx__zz) || defined(zz__MiSTM32Lx__zz)  )
+// If the target device is either STM32Fxx or STM32Lxx from cubeMX then ...
+//=================================================================================================
+void I2CPeriph::startTransfer(void) {
+/**************************************************************************************************
+ * STM32 specific function, will start the transfer of the current I2C Request Form - locking the
+ * bus, requesting the transfer from the hardware, and enabling the interrupts needed for the
+ * request.
+ *************************************************************************************************/
+    comm_state = CommLock::kCommunicating;      // Lock I2C bus
+
+    //Enable();
+
+    requestTransfer(  _cur_form_.devAddress,
+                      _cur_form_.size,
+                      _cur_form_.Mode,
+                      _cur_form_.Reqst
+                    );
+        // Trigger communication as per Form request
+
+    if (_reload_count_ != 0)                        // If larger than a single request
+        configTransCmIT(InterState::kIT_Enable);    // Then enable Transmit Complete
+                                                    // interrupt (to request each chunk)
+
+    if (_cur_reqst_ == Request::kStart_Write) {     // If this is a write request
+        configTransmtIT(InterState::kIT_Enable);    // Then enable Transmit Empty buffer
+    }                                               // interrupt
+
+    else if (_cur_reqst_ == Request::kStart_WriteRead) {    // If this is a write then read
+        configTransmtIT(InterState::kIT_Enable);    // Then enable Transmit Empty buffer
+        configTransCmIT(InterState::kIT_Enable);    // interrupt, and Transmit Complete (to
+    }                                               // start the read part)
+
+    else if (_cur_reqst_ == Request::kStart_Read) { // If this is a read request
+        configReceiveIT(InterState::kIT_Enable);    // Then enable Receive buffer full
+    }                                               // interrupt
 }
 
+#endif
+
 void I2CPeriph::intReqFormCmplt(void) {
 /**************************************************************************************************
  * Updates the active form, to indicate how much data has been completed.
  * Indicate that the I2C Device is now free for any new communication
  * Disables the Receive/Transmit Interrupts
+ * Calls the completion callback of the form (if linked)
  *************************************************************************************************/
     *(_cur_form_.Cmplt)  += (_cur_form_.size - _cur_count_);
     // Indicate how many data points have been transfered (curCount should be 0)
 
     // Indicate that I2C bus is now free, and disable any interrupts
     comm_state = CommLock::kFree;
+    _reload_count_ = 0;                         // No more chunks to request (if faulted)
 
     configReceiveIT(InterState::kIT_Disable);   // Disable Receive buffer full interrupt
     configTransmtIT(InterState::kIT_Disable);   // Disable Transmit empty buffer interrupt
+    configTransCmIT(InterState::kIT_Disable);   // Disable Transmit complete interrupt
+
+    cmpltCallback( &(_cur_form_) );             // Form is complete (or faulted)
 }
 
 void I2CPeriph:: handleEventIRQ(void) {
@@ -1117,12 +2315,16 @@ void I2CPeriph:: handleEventIRQ(void) {
  * ones are enabled. If both a status event has occured, and the interrupt is enabled, then this
  * function will take action.
  * Events covered by this function:
+ *      Transfer Complete Reload Flag
+ *          - Used for forms larger than "I2CPe_MaxNBYTES", at the end of each chunk the next
+ *            chunk is requested (see ".reloadTransfer").
+ *
  *      Transmit Complete Flag
- *          - This functionality is not supported, however this status should be used if the
- *            "Auto" communication has not been selected. Such that when the current pack of 255
- *            bytes to transmit has been done, completed then the same communication can continue
- *            with a new set of data.
- *            For communicating packets of data > 255bytes.
+ *          - Used for write then read forms ("kStart_WriteRead"), once the write part is
+ *            complete the read part is started (repeated START), with the form's read location
+ *            and size becoming current.
+ *            Otherwise not used (forms larger than "I2CPe_MaxNBYTES" use the Transfer Complete
+ *            Reload Flag).
  *            Note - Will be cleared by hardware, when either a START or STOP has been triggered.
  *
  *      Transmit Buffer Empty
@@ -1135,23 +2337,49 @@ void I2CPeriph:: handleEventIRQ(void) {
  *            from the hardware the current read value. This will then be passed to the requested
  *            data location (as per Request form).
  *
- *      I2C Stop has been set
- *          - If a STOP has been detected, then current Request form has been completed.
- *            Will then indicate how much data has been transmitted, and look to see if there is
- *            another other requests. If none, then communication interrupts are disabled.
- *
  *      I2C data has not been acknowledged (NACK)
- *          - If a NACK is detected during the communication with the external device. Then the
- *            current Request Form is binned. A fault is provided to the requested source
- *            location, and the return complete indication is setup to show how many bytes had
- *            been transmitted prior to NACK.
+ *          - If a NACK is detected during the communication with the external device. Then a
+ *            fault is provided to the requested source location of the current Request Form.
+ *            The hardware then generates the STOP, which completes the form (complete indication
+ *            shows how many bytes had been transmitted prior to NACK).
+ *            Checked ahead of the STOP, as both can be pending within the same entry.
  *            Source functional will then need to determine what to do in this situation.
  *
+ *      I2C Stop has been set
+ *          - If a STOP has been detected, then current Request form has been completed (whether
+ *            or not NACKed). Will then indicate how much data has been transmitted, and look to
+ *            see if there is another other requests. If none, then communication interrupts are
+ *            disabled.
+ *
  *      No other interrupts are currently supported.
  *************************************************************************************************/
-    if ( (transmitComptChk() & transmitComptITChk()) == 0x01) {
+    if ( (transferReloadChk() & transmitComptITChk()) == 0x01) {
+        // If Transfer Complete Reload triggered (end of chunk)
+        reloadTransfer();                               // Request the next chunk
+    }
+    else if ( (transmitComptChk() & transmitComptITChk()) == 0x01) {
         // If Transmit Complete triggered
-        // Not really supported yet!
+        if (_cur_reqst_ == Request::kStart_WriteRead) { // If write part of write then read
+            configTransmtIT(InterState::kIT_Disable);   // Disable Transmit empty buffer, and
+            configTransCmIT(InterState::kIT_Disable);   // Transmit complete interrupts
+
+            _cur_form_.Buff = _cur_form_.ReadBuff;      // Read part is now current
+            _cur_form_.size = _cur_form_.readSize;
+
+            requestTransfer(  _cur_form_.devAddress,
+                              _cur_form_.size,
+                              CommMode::kAutoEnd,
+                              Request::kStart_Read
+                            );
+                // Trigger read (repeated START), STOP once complete
+
+            configReceiveIT(InterState::kIT_Enable);    // Enable Receive buffer full interrupt
+
+            if (_reload_count_ != 0)                    // If larger than a single request
+                configTransCmIT(InterState::kIT_Enable);// Then enable Transmit Complete
+                                                        // interrupt (to request each chunk)
+        }
+        // Otherwise not really supported yet!
     }
 
     uint8_t temp_DR = 0;
@@ -1186,28 +2414,27 @@ void I2CPeriph:: handleEventIRQ(void) {
         }
     }
 
-    if ( (busStopChk() & busStopITChk()) == 0x01) { // If I2C Stop triggered
-        clearStop();                                // Clear the STOP status
+    if ( (busNACKChk() & busNACKITChk()) == 0x01) { // If I2C NACK received
         clearNACK();                                // Clear the NACK status
 
-        // Flush the contents of the Transmit buffer
-        //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-          __HAL_I2C_CLEAR_FLAG(_i2c_handle_, I2C_FLAG_TXE);
-
-        intReqFormCmplt();          // Complete the current request form
-        startInterrupt();           // Check if any new requests remain
+        if (comm_state == CommLock::kCommunicating) // If a form is in progress, then set its
+            *(_cur_form_.Flt) = DevFlt::kNACK;      // requested fault flag (completed at STOP)
     }
 
-    if ( (busNACKChk() & busNACKITChk()) == 0x01) { // If I2C NACK received
+    if ( (busStopChk() & busStopITChk()) == 0x01) { // If I2C Stop triggered
+        clearStop();                                // Clear the STOP status
         clearNACK();                                // Clear the NACK status
-        *(_cur_form_.Flt) = DevFlt::kNACK;          // Set requested fault flag
 
         // Flush the contents of the Transmit buffer
         //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+#if ( defined(zz__MiSTM32Fx__zz) || defined(zz__MiSTM32Lx__zz)  )
           __HAL_I2C_CLEAR_FLAG(_i2c_handle_, I2C_FLAG_TXE);
+#endif
 
-        intReqFormCmplt();          // Complete the current request form
-        startInterrupt();           // Check if any new requests remain
+        if (comm_state == CommLock::kCommunicating) {   // If a form is in progress
+            intReqFormCmplt();      // Complete the current request form
+            startInterrupt();       // Check if any new requests remain
+        }
     }
 }
 
@@ -1226,18 +2453,38 @@ void I2CPeriph:: handleErrorIRQ(void) {
  * ones are enabled. If both a status event has occurred, and the interrupt is enabled, then this
  * function will take action.
  * Events covered by this function:
- *      Bus Error
+ *      Bus Error       - form in progress is faulted ("kBus_Error") and completed, then the next
+ *                        form is started
  *
  *      No other interrupts are currently supported.
  *************************************************************************************************/
     if ( (busErroChk() & busErrorITChk()) == 0x01) {// If Bus Error triggered
         clearBusEr();                               // Clear the Bus Error
-        *(_cur_form_.Flt)    = DevFlt::kBus_Error;  // Set requested fault flag
+
+        if (comm_state == CommLock::kCommunicating) {   // If a form is in progress, then it is
+            *(_cur_form_.Flt)    = DevFlt::kBus_Error;  // faulted - set requested fault flag
+
+            intReqFormCmplt();      // Complete the current request form
+            startInterrupt();       // Check if any new requests remain
+        }
     }
 }
 
 I2CPeriph::~I2CPeriph()
 {
-    // TODO Auto-generated destructor stub
+#if   defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
+//=================================================================================================
+    stopWorker();                       // Stop interrupt emulation thread (if running)
+
+    if (_i2c_handle_ >= 0)              // If i2c-dev device was opened
+        close(_i2c_handle_);            // then close it
+
+    if (_event_fd_ >= 0)                // If eventfd was opened
+        close(_event_fd_);              // then close it
+
+    pthread_mutex_destroy(&_queue_lock_);
+    pthread_mutex_destroy(&_bus_lock_);
+
+#endif
 }
 
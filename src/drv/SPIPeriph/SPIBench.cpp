@@ -0,0 +1,327 @@
+/**************************************************************************************************
+ * @file        SPIBench.cpp
+ * @author      Thomas
+ * @brief       Source file for the SPIPeriph throughput and latency benchmark
+ **************************************************************************************************
+ @ attention
+
+ << To be Introduced >>
+
+ *************************************************************************************************/
+#include <FileIndex.h>
+#include FilInd_SPIBchHD
+
+static const uint16_t kBenchSizes[] = { 1, 4, 16, 64, 256, 1024, 4096, 16384, SPIBch_MaxSize };
+    // Transfer sizes covered by ".run"
+
+static const char *kBenchModeName[] = { "polled", "form", "batched" };
+static const char *kBenchBackName[] = { "loopback", "spidev" };
+
+SPIBench::SPIBench(const char *deviceloc, int speed, SPIPeriph::SPIMode Mode)
+/**************************************************************************************************
+ * Create a SPIBench class handler, which will setup the 'SPIPeriph' to be measured.
+ * If the spidev device doesn't exist (or __null is provided), then the driver calls are linked to
+ * the loop back (".loopback") - so the benchmark can be run on any Linux host.
+ * Otherwise the bytes within a single driver call are limited to the spidev buffer size.
+ *************************************************************************************************/
+: _spi_(deviceloc, speed, Mode, _form_array_, SPIBch_Forms) {
+
+    if ( (deviceloc == __null) || (access(deviceloc, R_OK | W_OK) != 0) ) {
+        // If no device, or unable to access the device
+        _spi_.linkIoctl(&loopback);         // Link driver calls to the loop back
+        Back    = Backend::kLoopback;
+        MaxSize = SPIBch_MaxSize;
+    }
+    else {
+        Back    = Backend::kSpidev;
+        MaxSize = driverLimit();            // Limited by the spidev buffer
+    }
+
+    for (uint32_t i = 0; i != SPIBch_MaxSize; i++)  // Populate transmit data with a pattern,
+        _tx_buff_[i] = (uint8_t) ((i * 7) + (i >> 8));  // which changes each byte
+
+    Flt = DevFlt::kInitialised;
+}
+
+int SPIBench::loopback(int fd, unsigned long request, void *arg) {
+/**************************************************************************************************
+ * Replacement function for the 'SPIPeriph' driver calls. For message requests (SPI_IOC_MESSAGE),
+ * the transmit data of each transfer is copied into the read back data (zeros if no transmit
+ * data), and the total number of bytes returned (same as spidev).
+ * All other requests (mode, speed, etc.) are accepted with no action.
+ *************************************************************************************************/
+    struct spi_ioc_transfer *xfer = (struct spi_ioc_transfer *) arg;
+    uint32_t count = 0;
+    int total = 0;
+
+    (void) fd;
+
+    if ( (_IOC_TYPE(request) != SPI_IOC_MAGIC) || (_IOC_NR(request) != 0) )
+        return (0);                     // If not a message request, nothing to do
+
+    count = _IOC_SIZE(request) / sizeof(struct spi_ioc_transfer);
+
+    for (uint32_t i = 0; i != count; i++) {     // Cycle through each transfer
+        if (xfer[i].rx_buf != 0) {                  // If there is read back data
+            if (xfer[i].tx_buf != 0)                // and transmit data, then copy
+                memcpy((void *)(uintptr_t) xfer[i].rx_buf,
+                       (const void *)(uintptr_t) xfer[i].tx_buf, xfer[i].len);
+            else                                    // Otherwise, read back zeros
+                memset((void *)(uintptr_t) xfer[i].rx_buf, 0, xfer[i].len);
+        }
+
+        total += (int) xfer[i].len;
+    }
+
+    return (total);
+}
+
+uint32_t SPIBench::driverLimit(void) {
+/**************************************************************************************************
+ * Returns the size of the spidev buffer (bytes), the largest number of bytes within a single
+ * driver call - as per the "bufsiz" module parameter. If unable to be read, then the spidev
+ * default is assumed. Limited to "SPIBch_MaxSize".
+ *************************************************************************************************/
+    FILE            *file = fopen(SPIBch_BufsizLoc, "r");
+    unsigned long   bufsiz = 0;
+
+    if (file != __null) {
+        if (fscanf(file, "%lu", &bufsiz) != 1)
+            bufsiz = 0;
+        fclose(file);
+    }
+
+    if (bufsiz == 0)                    // If unable to read the size, then use the default
+        bufsiz = SPIBch_BufsizDef;
+
+    if (bufsiz > SPIBch_MaxSize)
+        bufsiz = SPIBch_MaxSize;
+
+    return ( (uint32_t) bufsiz );
+}
+
+uint64_t SPIBench::timeNow(void) {
+/**************************************************************************************************
+ * Returns the current time in nanoseconds, from the raw monotonic clock (not adjusted by NTP)
+ *************************************************************************************************/
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+
+    return ( ((uint64_t) now.tv_sec * 1000000000) + (uint64_t) now.tv_nsec );
+}
+
+int SPIBench::compareLatency(const void *first, const void *second) {
+/**************************************************************************************************
+ * Sort order of the latency samples (ascending), for "qsort"
+ *************************************************************************************************/
+    uint32_t a = *((const uint32_t *) first);
+    uint32_t b = *((const uint32_t *) second);
+
+    return ( (a > b) - (a < b) );
+}
+
+uint32_t SPIBench::transferPolled(uint16_t size, uint32_t *faults) {
+/**************************************************************************************************
+ * Single polled transfer of "size" bytes, returns the time taken (ns).
+ *************************************************************************************************/
+    uint64_t start = 0, stop = 0;
+    SPIPeriph::DevFlt returnval = SPIPeriph::DevFlt::kNone;
+
+    start = timeNow();
+    returnval = _spi_.poleMasterTransfer(_tx_buff_, _rx_buff_, size);
+    stop  = timeNow();
+
+    if (returnval != SPIPeriph::DevFlt::kNone)
+        (*faults)++;
+
+    return ( (uint32_t) (stop - start) );
+}
+
+uint32_t SPIBench::transferForm(uint16_t size, uint32_t *faults) {
+/**************************************************************************************************
+ * Single SPI Request Form of "size" bytes, submitted by the interrupt emulation thread (expected
+ * to be running). Returns the time taken (ns) from the request, to the form being completed.
+ *************************************************************************************************/
+    uint64_t start = 0, stop = 0;
+    volatile SPIPeriph::DevFlt fault = SPIPeriph::DevFlt::kNone;
+    volatile uint16_t cmplt = 0;
+
+    start = timeNow();
+    _spi_.intMasterTransfer(size, _tx_buff_, _rx_buff_, &fault, &cmplt);
+
+    while ( (cmplt == 0) && (fault == SPIPeriph::DevFlt::kNone) ) {};
+        // Wait for the form to be completed (or faulted)
+    stop  = timeNow();
+
+    if (fault != SPIPeriph::DevFlt::kNone)
+        (*faults)++;
+
+    return ( (uint32_t) (stop - start) );
+}
+
+uint32_t SPIBench::transferBatched(uint16_t size, uint8_t batch, uint32_t *faults) {
+/**************************************************************************************************
+ * "batch" SPI Request Forms of "size" bytes (upto "SPIPe_MaxBatch"), queued whilst the bus is
+ * held - then submitted together. Returns the time taken (ns) to submit the forms, divided by the
+ * number of forms (per transfer latency).
+ *************************************************************************************************/
+    uint64_t start = 0, stop = 0;
+    volatile SPIPeriph::DevFlt fault[SPIPe_MaxBatch];
+    volatile uint16_t cmplt[SPIPe_MaxBatch];
+
+    _spi_.holdBus();                    // Hold the bus, so forms are queued
+
+    for (uint8_t i = 0; i != batch; i++) {
+        fault[i] = SPIPeriph::DevFlt::kNone;
+        cmplt[i] = 0;
+        _spi_.intMasterTransfer(size, _tx_buff_, _rx_buff_, &fault[i], &cmplt[i]);
+    }
+
+    start = timeNow();
+    _spi_.releaseBus();                 // Release the bus, and submit the queue
+    stop  = timeNow();
+
+    for (uint8_t i = 0; i != batch; i++) {
+        if ( (fault[i] != SPIPeriph::DevFlt::kNone) || (cmplt[i] == 0) )
+            (*faults)++;
+    }
+
+    return ( (uint32_t) ((stop - start) / batch) );
+}
+
+SPIBench::DevFlt SPIBench::header(FILE *out) {
+/**************************************************************************************************
+ * Write the CSV header line (column names) into "out"
+ *************************************************************************************************/
+    if (fprintf(out, "backend,mode,size,transfers,faults,mismatches,total_ns,bytes_per_sec,"
+                     "lat_min_ns,lat_p50_ns,lat_p99_ns,lat_max_ns\n") < 0)
+        Flt = DevFlt::kOutput_Error;
+    else
+        Flt = DevFlt::kNone;
+
+    return (Flt);
+}
+
+SPIBench::DevFlt SPIBench::runMode(FILE *out, BenchMode mode, uint16_t size,
+                                   uint16_t iterations) {
+/**************************************************************************************************
+ * Run a single "mode" at "size" bytes, "iterations" times (limited to "SPIBch_MaxIter"). Each
+ * iteration's latency is captured, and the read back data is compared against the transmitted
+ * data. Once complete a CSV line is written into "out" (see header "How to use").
+ * A single warm up iteration is run first, which is not captured.
+ * "size" is limited to "MaxSize", and the number of forms within a batch is limited such that
+ * the batch is within "MaxSize" (as submitted within a single driver call).
+ *
+ * "form" mode needs the interrupt emulation thread, which is started for the duration of the run.
+ * "batched" mode holds the bus itself, so the thread is stopped (else it would take the forms as
+ * they are queued).
+ *************************************************************************************************/
+    uint32_t faults = 0, mismatches = 0, transfers = 0;
+    uint64_t total  = 0, bytes = 0;
+    uint32_t perIteration = 1;          // Transfers per iteration
+    uint8_t  batch = SPIPe_MaxBatch;    // Forms per batch
+
+    if (size == 0)                      // Zero size transfers are not supported by 'SPIPeriph'
+        size = 1;
+    if (size > MaxSize)
+        size = (uint16_t) MaxSize;
+    if ((MaxSize / size) < batch)       // Batch is to be within a single driver call
+        batch = (uint8_t) (MaxSize / size);
+    if (iterations > SPIBch_MaxIter)
+        iterations = SPIBch_MaxIter;
+    if (iterations == 0)
+        iterations = 1;
+
+    if (mode == BenchMode::kForm) {
+        if (_spi_.startWorker(0, -1) != SPIPeriph::DevFlt::kNone) {
+            Flt = DevFlt::kWorker_Error;
+            return (Flt);
+        }
+    }
+    else
+        _spi_.stopWorker();
+
+    if (mode == BenchMode::kBatched)
+        perIteration = batch;
+
+    if      (mode == BenchMode::kPolled)    // Warm up with a single iteration, which is not
+        transferPolled(size, &faults);      // captured (thread start up, caches, etc.)
+    else if (mode == BenchMode::kForm)
+        transferForm(size, &faults);
+    else
+        transferBatched(size, batch, &faults);
+    faults = 0;
+
+    for (uint16_t i = 0; i != iterations; i++) {
+        memset(_rx_buff_, 0, size);     // Clear read back, so stale data isn't a match
+
+        if      (mode == BenchMode::kPolled)
+            _latency_[i] = transferPolled(size, &faults);
+        else if (mode == BenchMode::kForm)
+            _latency_[i] = transferForm(size, &faults);
+        else
+            _latency_[i] = transferBatched(size, batch, &faults);
+
+        total += (uint64_t) _latency_[i] * perIteration;
+
+        if (memcmp(_tx_buff_, _rx_buff_, size) != 0)
+            mismatches++;
+    }
+
+    if (mode == BenchMode::kForm)
+        _spi_.stopWorker();
+
+    transfers = iterations * perIteration;
+    bytes     = (uint64_t) transfers * size;
+
+    qsort(_latency_, iterations, sizeof(_latency_[0]), &compareLatency);
+
+    if (fprintf(out, "%s,%s,%u,%u,%u,%u,%llu,%llu,%u,%u,%u,%u\n",
+                kBenchBackName[Back], kBenchModeName[mode], size, transfers, faults, mismatches,
+                (unsigned long long) total,
+                (unsigned long long) ((total == 0) ? 0 : ((bytes * 1000000000) / total)),
+                _latency_[0], _latency_[iterations / 2], _latency_[(iterations * 99) / 100],
+                _latency_[iterations - 1]) < 0)
+        Flt = DevFlt::kOutput_Error;
+    else
+        Flt = DevFlt::kNone;
+
+    return (Flt);
+}
+
+SPIBench::DevFlt SPIBench::run(FILE *out, uint16_t iterations) {
+/**************************************************************************************************
+ * Run each mode for each of the transfer sizes (1 byte to 64KB, limited to "MaxSize"), writing
+ * the CSV header line and a CSV line per mode/size into "out".
+ * Stops if a line cannot be written, or the interrupt emulation thread cannot be started. Faults
+ * of the transfers themselves do not stop the run (counted within each CSV line).
+ *************************************************************************************************/
+    uint32_t size = 0, last = 0;        // Size of the current/previous run
+
+    if (header(out) != DevFlt::kNone)
+        return (Flt);
+
+    for (uint8_t m = BenchMode::kPolled; m <= BenchMode::kBatched; m++) {
+        last = 0;
+
+        for (uint8_t s = 0; s != (sizeof(kBenchSizes) / sizeof(kBenchSizes[0])); s++) {
+            size = (kBenchSizes[s] > MaxSize) ? MaxSize : kBenchSizes[s];
+            if (size == last)           // If already run (limited to "MaxSize"), then skip
+                continue;
+            last = size;
+
+            if (runMode(out, (BenchMode) m, (uint16_t) size, iterations) != DevFlt::kNone)
+                return (Flt);
+        }
+    }
+
+    fflush(out);
+
+    return (Flt);
+}
+
+SPIBench::~SPIBench()
+{
+    _spi_.stopWorker();                 // Ensure interrupt emulation thread is stopped
+}
@@ -0,0 +1,414 @@
+/**************************************************************************************************
+ * @file        SPIDMAPeriph.cpp
+ * @author      Thomas
+ * @brief       Source file for the Generic SPI with DMA Class handle
+ **************************************************************************************************
+ @ attention
+
+ << To be Introduced >>
+
+ *************************************************************************************************/
+#include <FileIndex.h>
+#include FilInd_SPIDMAHD
+
+SPIDMAPeriph::SPIDMAPeriph(SPI_HandleTypeDef *SPIHandle, Form *FormArray, uint16_t FormSize,
+                           DMA_HandleTypeDef *DMA_Rx_Handle, DMA_HandleTypeDef *DMA_Tx_Handle)
+/**************************************************************************************************
+ * Create a SPIDMAPeriph class handler. This class is based upon the SPIPeriph adding functions
+ * to support interfacing with DMA (DMAPeriph)
+ *************************************************************************************************/
+: SPIPeriph(SPIHandle, FormArray, FormSize) {
+
+    // Link the DMA handles to the class internals
+    _dma_rx_ = DMA_Rx_Handle;
+    _dma_tx_ = DMA_Tx_Handle;
+
+    // Determine what mode has been selected -
+    //  if either handle is not provided (NULL) then indicate DMA is disabled, as SPI needs both
+    //  Transmit and Receive
+    if ( (DMA_Rx_Handle == __null) || (DMA_Tx_Handle == __null) )
+        _dma_mode_  =  DMAMode::kDisable;
+    else
+        _dma_mode_  =  DMAMode::kEnable;
+
+    _dma_active_    = DMAMode::kDisable;    // No form currently being transferred by DMA
+
+    _dummy_tx_  = 0;                    // Transmit 0, if form has no data to write
+    _dummy_rx_  = 0;
+
+    _cadence_tim_   = __null;           // No stream started
+    _cadence_dma_   = __null;
+}
+
+uint32_t SPIDMAPeriph::configDMA(DMA_HandleTypeDef *hdma, DataWidth width,
+                                 uint8_t *Buff, uint16_t *Dummy) {
+/**************************************************************************************************
+ * Configure the DMA data size for both the peripheral and memory, as per the data width "width"
+ * (8bit or 16bit).
+ * If there is no data location within the form (__null), then the DMA will use the dummy
+ * location, with the memory increment disabled (so all data is transmitted from/read into the
+ * single location).
+ *
+ * Returns the memory address to be linked to the DMA.
+ *************************************************************************************************/
+    if (width == DataWidth::k16bit)
+        MODIFY_REG(hdma->Instance->CCR, DMA_CCR_PSIZE | DMA_CCR_MSIZE,
+                   DMA_CCR_PSIZE_0 | DMA_CCR_MSIZE_0);          // 16bit peripheral and memory
+    else
+        CLEAR_BIT(hdma->Instance->CCR, DMA_CCR_PSIZE | DMA_CCR_MSIZE);  // 8bit
+
+    if (Buff == __null) {                   // If there is no data location, then use dummy
+        CLEAR_BIT(hdma->Instance->CCR, DMA_CCR_MINC);
+        return ( (uint32_t) (uintptr_t) Dummy );
+    }
+
+    SET_BIT(hdma->Instance->CCR, DMA_CCR_MINC);
+    return ( (uint32_t) (uintptr_t) Buff );
+}
+
+void SPIDMAPeriph::stopDMA(void) {
+/**************************************************************************************************
+ * Disable both the Transmit and Receive DMAs (along with their interrupts), and remove the link
+ * from the SPI peripheral.
+ *************************************************************************************************/
+    CLEAR_BIT(_spi_handle_->Instance->CR2, SPI_CR2_TXDMAEN | SPI_CR2_RXDMAEN);
+        // Unlink SPI from DMA
+
+    __HAL_DMA_DISABLE(_dma_tx_);                // Disable DMA
+    __HAL_DMA_DISABLE_IT(_dma_tx_, DMA_IT_TC);  // Disable DMA complete interrupt
+    __HAL_DMA_DISABLE_IT(_dma_tx_, DMA_IT_TE);  // Disable DMA error interrupt
+
+    __HAL_DMA_DISABLE(_dma_rx_);                // Disable DMA
+    __HAL_DMA_DISABLE_IT(_dma_rx_, DMA_IT_TC);  // Disable DMA complete interrupt
+    __HAL_DMA_DISABLE_IT(_dma_rx_, DMA_IT_TE);  // Disable DMA error interrupt
+
+    _dma_active_ = DMAMode::kDisable;
+}
+
+void SPIDMAPeriph::startTransfer(void) {
+/**************************************************************************************************
+ * Start the transfer of the current SPI Request Form, with the device already selected.
+ *   If the 'SPIDMAPeriph' class has been constructed with both DMA pointers, and the form is not
+ *   scatter-gather, then the DMAs will be used for the whole form. Otherwise the interrupts are
+ *   enabled (same as 'SPIPeriph').
+ *************************************************************************************************/
+    uint32_t tx_address = 0;    // Memory address for Transmit DMA
+    uint32_t rx_address = 0;    // Memory address for Receive DMA
+
+    if ( (_dma_mode_ == DMAMode::kDisable) ||
+         (_cur_form_.TxSeg != __null) || (_cur_form_.RxSeg != __null) ) {
+        _dma_active_ = DMAMode::kDisable;
+        SPIPeriph::startTransfer();         // Use interrupts for transfer
+        return;
+    }
+
+    /* Steps to setup Transmit/Receive DMA
+        1] Disable DMAs
+        2] Link Receive DMA from SPI Peripheral register to first array location
+            2a] Enter number of data points, and data size (Mode should be configured via
+                STM32CubeMX)
+            2b] Enable SPI Register for DMA Receive management, then enable DMA
+        3] Link Transmit DMA from first array location to SPI Peripheral register
+            3a] Enter number of data points, and data size
+            3b] Enable DMA, then enable SPI Register for DMA Transmit management (which starts
+                the communication)
+     */
+    __HAL_DMA_DISABLE(_dma_rx_);    // Disable DMA
+    __HAL_DMA_DISABLE(_dma_tx_);    // Disable DMA
+
+    _dma_active_    = DMAMode::kEnable;
+    _tx_count_      = 0;                    // All data is handed to the DMA
+
+    rx_address = configDMA(_dma_rx_, _cur_form_.Width, _cur_form_.RxBuff, &_dummy_rx_);
+    popDMARegisters(_dma_rx_,  (uint32_t)(uintptr_t)&_spi_handle_->Instance->DR, rx_address,
+                               _cur_form_.size);
+
+    SET_BIT(_spi_handle_->Instance->CR2, SPI_CR2_RXDMAEN);  // Link SPI to DMA
+
+    __HAL_DMA_ENABLE_IT(_dma_rx_, DMA_IT_TC);   // Enable DMA complete interrupt
+    __HAL_DMA_ENABLE_IT(_dma_rx_, DMA_IT_TE);   // Enable DMA error interrupt
+    __HAL_DMA_ENABLE(_dma_rx_);                 // Enable DMA
+
+    tx_address = configDMA(_dma_tx_, _cur_form_.Width, _cur_form_.TxBuff, &_dummy_tx_);
+    popDMARegisters(_dma_tx_,  tx_address, (uint32_t)(uintptr_t)&_spi_handle_->Instance->DR,
+                               _cur_form_.size);
+
+    // Transmit complete interrupt not required, as communication is only complete once all data
+    // has been received
+    __HAL_DMA_ENABLE_IT(_dma_tx_, DMA_IT_TE);   // Enable DMA error interrupt
+    __HAL_DMA_ENABLE(_dma_tx_);                 // Enable DMA
+
+    SET_BIT(_spi_handle_->Instance->CR2, SPI_CR2_TXDMAEN);  // Link SPI to DMA
+}
+
+void SPIDMAPeriph::intReqFormCmplt(void) {
+/**************************************************************************************************
+ * Updates the active form, to indicate how much data has been completed.
+ *   If the form has been transferred by DMA, the amount of data is retrieved from the Receive DMA
+ *   count register, and the DMAs will be disabled along with the interrupt flags.
+ *
+ * Then tidied up the same as 'SPIPeriph' (device de-selected, and bus is now free).
+ *************************************************************************************************/
+    if (_dma_active_ == DMAMode::kEnable) {
+        _cur_count_ = (uint16_t) __HAL_DMA_GET_COUNTER(_dma_rx_);
+            // Number of data points not received (should be 0)
+
+        stopDMA();
+    }
+
+    SPIPeriph::intReqFormCmplt();
+}
+
+void SPIDMAPeriph::handleDMATxIRQ(void) {
+/**************************************************************************************************
+ * INTERRUPTS:
+ * Interrupt Service Routine for the SPIDMA class.
+ *
+ * Function will then read the hardware status flags, and determine which interrupt has been
+ * triggered (will only run if the Transmit DMA interrupt has been triggered):
+ *      If a DMA error has occurred, then clear the flag, disable DMA (will already be disabled),
+ *      and set the fault flag to 'kDMA_Tx_Error'. The current form is then completed, and the
+ *      next form (if any) started.
+ *
+ *      If DMA half/transfer complete - not supported (completion is from the Receive DMA)
+ *
+ *      At the end will use the 'Global' clear interrupt flag for the DMA, to ensure that all
+ *      events have been cleared.
+ *      No other interrupts are currently supported.
+ *************************************************************************************************/
+    // Check to see if there are ANY status updates for the DMA
+    if (__HAL_DMA_GET_FLAG(_dma_tx_, __HAL_DMA_GET_GI_FLAG_INDEX(_dma_tx_)) != 0) {
+        // If an interrupt has been detected, then...
+        // Now check to see which interrupt has been triggered:
+        // 1 - Error(s)
+        if ( (__HAL_DMA_GET_IT_SOURCE(_dma_tx_, DMA_IT_TE) != 0) &&
+             (__HAL_DMA_GET_FLAG(_dma_tx_, __HAL_DMA_GET_TE_FLAG_INDEX(_dma_tx_)) != 0) ) {
+
+            __HAL_DMA_CLEAR_FLAG(_dma_tx_, __HAL_DMA_GET_TE_FLAG_INDEX(_dma_tx_));
+                // Clear the interrupt flag
+
+            __HAL_DMA_DISABLE(_dma_tx_);    // This type of error will already have disabled
+                                            // DMA, however this is to enforce within code
+            *(_cur_form_.Flt) = DevFlt::kDMA_Tx_Error;  // Indicate fault (Tx_Error)
+
+            intReqFormCmplt();              // Complete the current request form
+            startInterrupt();               // Check if any new requests remain
+        }
+
+        // Use global clear flag, to clear all interrupts (if not already done so)
+        __HAL_DMA_CLEAR_FLAG(_dma_tx_, __HAL_DMA_GET_GI_FLAG_INDEX(_dma_tx_));
+    }
+}
+
+void SPIDMAPeriph::handleDMARxIRQ(void) {
+/**************************************************************************************************
+ * INTERRUPTS:
+ * Interrupt Service Routine for the SPIDMA class.
+ *
+ * Function will then read the hardware status flags, and determine which interrupt has been
+ * triggered (will only run if the Receive DMA interrupt has been triggered):
+ *      If a DMA error has occurred, then clear the flag, disable DMA (will already be disabled),
+ *      and set the fault flag to 'kDMA_Rx_Error'. The current form is then completed, and the
+ *      next form (if any) started. If streaming, the class fault is set instead, and the stream
+ *      stopped - without waiting for the last frame (the Receive DMA has already stopped, so
+ *      the bus is not waited upon within the interrupt).
+ *
+ *      If DMA half complete - not supported
+ *
+ *      If DMA transfer complete - all data for the form has been transferred. If coalescing is
+ *      enabled and the next form is to the same device, it is started without deselecting the
+ *      device. Otherwise the form is completed, and the next form (if any) started.
+ *      Will also clear the DMA interrupt flag
+ *
+ *      At the end will use the 'Global' clear interrupt flag for the DMA, to ensure that all
+ *      events have been cleared.
+ *      No other interrupts are currently supported.
+ *************************************************************************************************/
+    // Check to see if there are ANY status updates for the DMA
+    if (__HAL_DMA_GET_FLAG(_dma_rx_, __HAL_DMA_GET_GI_FLAG_INDEX(_dma_rx_)) != 0) {
+        // If an interrupt has been detected, then...
+        // Now check to see which interrupt has been triggered:
+        // 1 - Error(s)
+        if ( (__HAL_DMA_GET_IT_SOURCE(_dma_rx_, DMA_IT_TE) != 0) &&
+             (__HAL_DMA_GET_FLAG(_dma_rx_, __HAL_DMA_GET_TE_FLAG_INDEX(_dma_rx_)) != 0) ) {
+
+            __HAL_DMA_CLEAR_FLAG(_dma_rx_, __HAL_DMA_GET_TE_FLAG_INDEX(_dma_rx_));
+                // Clear the interrupt flag
+
+            __HAL_DMA_DISABLE(_dma_rx_);    // This type of error will already have disabled
+                                            // DMA, however this is to enforce within code
+            if (_stream_run_ == 1) {        // If streaming, then stop the stream (without
+                Flt = DevFlt::kDMA_Rx_Error;            // waiting for the last frame)
+                stopCadence();
+                closeStream();
+            }
+            else {
+                *(_cur_form_.Flt) = DevFlt::kDMA_Rx_Error;  // Indicate fault (Rx_Error)
+
+                intReqFormCmplt();          // Complete the current request form
+                startInterrupt();           // Check if any new requests remain
+            }
+        }
+
+        // 2 - Half Transmission - Not utilised within this class set
+        // 3 - Full Transmission
+        if ( (__HAL_DMA_GET_IT_SOURCE(_dma_rx_, DMA_IT_TC) != 0) &&
+             (__HAL_DMA_GET_FLAG(_dma_rx_, __HAL_DMA_GET_TC_FLAG_INDEX(_dma_rx_)) != 0) ) {
+            __HAL_DMA_CLEAR_FLAG(_dma_rx_, __HAL_DMA_GET_TC_FLAG_INDEX(_dma_rx_));
+                // Clear the interrupt flag
+
+            _cur_count_ = (uint16_t) __HAL_DMA_GET_COUNTER(_dma_rx_);
+            stopDMA();
+
+            if (coalesceForm() == 1)        // If next form is to the same device (and
+                startTransfer();            // coalescing) then continue with next form
+            else {
+                intReqFormCmplt();          // Complete the current request form (no faults)
+                startInterrupt();           // Check if any new requests remain
+            }
+        }
+
+        // Use global clear flag, to clear all interrupts (if not already done so)
+        __HAL_DMA_CLEAR_FLAG(_dma_rx_, __HAL_DMA_GET_GI_FLAG_INDEX(_dma_rx_));
+    }
+}
+
+SPIDMAPeriph::DevFlt SPIDMAPeriph::startStream(const uint8_t *Command, uint16_t size,
+                                               DataWidth width, GenBuffer<uint8_t> *ReadArray,
+                                               TIM_HandleTypeDef *Cadence,
+                                               DMA_HandleTypeDef *CadenceDMA) {
+/**************************************************************************************************
+ * Start the stream of "Command" ("size" frames of "width", 8bit or 16bit), with each reply put
+ * into "ReadArray" (see ".streamLink"). Uses the hardware managed Chip Select.
+ *   The "Cadence" timer update event requests "CadenceDMA" (configured via STM32CubeMX as memory
+ *   to peripheral, circular) to write the next frame of the command into the SPI - so a frame
+ *   is transferred each timer period, with the command repeated. The Receive DMA is put into
+ *   circular mode over the 'GenBuffer' array.
+ *   No interrupts are used, so there is no CPU use per sample (".updateStream" is used to bring
+ *   the 'GenBuffer' up to date).
+ *
+ * Can only be started with the DMAs enabled, and whilst the bus is free (otherwise
+ * "kStream_Error"). Forms requested whilst streaming are queued, and started once the stream is
+ * stopped.
+ *************************************************************************************************/
+    DevFlt returnval = DevFlt::kNone;
+
+    if ( (_dma_mode_ == DMAMode::kDisable) || (Cadence == __null) || (CadenceDMA == __null) ||
+         (CommState != CommLock::kFree) )
+        return ( Flt = DevFlt::kStream_Error );
+
+    if (width == DataWidth::k32bit)                 // 32bit is not supported by the hardware
+        return ( Flt = DevFlt::kData_Size );
+
+    returnval = streamLink(Command, size, width, ReadArray);
+    if (returnval != DevFlt::kNone)
+        return (returnval);
+
+    CommState       = CommLock::kCommunicating;     // Lock SPI bus
+    _cadence_tim_   = Cadence;
+    _cadence_dma_   = CadenceDMA;
+
+    configBus(deviceConfig(__null));                // Set hardware to the configuration of the
+    configDataWidth(width);                         // hardware Chip Select, and data width
+    enable();
+
+    __HAL_DMA_DISABLE(_dma_rx_);                    // Disable DMAs
+    __HAL_DMA_DISABLE(_cadence_dma_);
+
+    // Receive DMA, circular over the 'GenBuffer', no interrupts other than errors
+    configDMA(_dma_rx_, width, ReadArray->pa, &_dummy_rx_);
+    SET_BIT(_dma_rx_->Instance->CCR, DMA_CCR_CIRC);
+    popDMARegisters(_dma_rx_,  (uint32_t)(uintptr_t)&_spi_handle_->Instance->DR,
+                               (uint32_t)(uintptr_t)ReadArray->pa,
+                               ReadArray->length / (width / 8));
+
+    SET_BIT(_spi_handle_->Instance->CR2, SPI_CR2_RXDMAEN);  // Link SPI to DMA
+
+    __HAL_DMA_DISABLE_IT(_dma_rx_, DMA_IT_TC);  // Disable DMA complete interrupt
+    __HAL_DMA_ENABLE_IT(_dma_rx_, DMA_IT_TE);   // Enable DMA error interrupt
+    __HAL_DMA_ENABLE(_dma_rx_);                 // Enable DMA
+
+    // Cadence DMA, circular over the command
+    configDMA(_cadence_dma_, width, (uint8_t *)Command, &_dummy_tx_);
+    SET_BIT(_cadence_dma_->Instance->CCR, DMA_CCR_CIRC);
+    popDMARegisters(_cadence_dma_,  (uint32_t)(uintptr_t)Command,
+                                    (uint32_t)(uintptr_t)&_spi_handle_->Instance->DR, size);
+    __HAL_DMA_ENABLE(_cadence_dma_);            // Enable DMA
+
+    __HAL_TIM_ENABLE_DMA(_cadence_tim_, TIM_DMA_UPDATE);    // Link timer update to DMA
+    __HAL_TIM_ENABLE(_cadence_tim_);                        // Start the timer
+
+    _stream_run_ = 1;
+
+    return (DevFlt::kNone);
+}
+
+void SPIDMAPeriph::updateStream(void) {
+/**************************************************************************************************
+ * Update the "input_pointer" of the stream 'GenBuffer', to the end of the last complete sample -
+ * as per the Receive DMA count register.
+ *************************************************************************************************/
+    uint16_t bytes      = _stream_width_ / 8;       // Bytes within each frame
+    uint16_t position   = 0;                        // Position within 'GenBuffer'
+
+    if (_stream_run_ == 0)                          // If stream is not running, then exit
+        return;
+
+    position = _stream_buff_->length - (uint16_t) (__HAL_DMA_GET_COUNTER(_dma_rx_) * bytes);
+    position -= position % streamBytes();           // Only complete samples
+
+    _stream_buff_->input_pointer = position % _stream_buff_->length;
+}
+
+void SPIDMAPeriph::stopCadence(void) {
+/**************************************************************************************************
+ * Stop the timer of the stream (along with the link to its DMA), so no further frames are
+ * written into the SPI.
+ *************************************************************************************************/
+    __HAL_TIM_DISABLE_DMA(_cadence_tim_, TIM_DMA_UPDATE);   // Stop the timer and DMA link
+    __HAL_TIM_DISABLE(_cadence_tim_);
+
+    __HAL_DMA_DISABLE(_cadence_dma_);
+    CLEAR_BIT(_cadence_dma_->Instance->CCR, DMA_CCR_CIRC);
+}
+
+void SPIDMAPeriph::closeStream(void) {
+/**************************************************************************************************
+ * Close out the stream, with the timer already stopped. The 'GenBuffer' is brought up to date,
+ * the Receive DMA is stopped, and any forms requested whilst streaming are started.
+ *************************************************************************************************/
+    updateStream();                                 // Bring 'GenBuffer' up to date
+
+    CLEAR_BIT(_dma_rx_->Instance->CCR, DMA_CCR_CIRC);   // Return to normal mode (for forms)
+    stopDMA();
+
+    _stream_run_    = 0;
+    CommState       = CommLock::kFree;              // Indicate that SPI bus is now free
+
+    startInterrupt();                               // Check if any new requests remain
+}
+
+void SPIDMAPeriph::stopStream(void) {
+/**************************************************************************************************
+ * Stop the stream, the timer is stopped (along with the link to its DMA), and once the last frame
+ * has been received the Receive DMA is stopped. The 'GenBuffer' is brought up to date, and any
+ * forms requested whilst streaming are started.
+ * Waits for the last frame, so is not to be called from an interrupt.
+ *************************************************************************************************/
+    if (_stream_run_ == 0)                          // If stream is not running, then exit
+        return;
+
+    stopCadence();
+
+    while(busBusyChk() == 1) {};                    // Wait for last frame to complete
+
+    closeStream();
+}
+
+SPIDMAPeriph::~SPIDMAPeriph() {
+/**************************************************************************************************
+ * When the destructor is called, need to ensure that the memory allocation is cleaned up, so as
+ * to avoid "memory leakage"
+ *************************************************************************************************/
+    // None
+}
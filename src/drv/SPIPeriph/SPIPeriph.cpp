@@ -22,8 +22,30 @@ void SPIPeriph::popGenParam(void) {
     CommState     = CommLock::kFree;          // Indicate bus is free
 
     _cur_count_   = 0;                // Initialise the current packet size count
+    _tx_count_    = 0;                // Initialise the current packets to transmit count
 
     _cur_form_    = { 0 };            // Initialise the form to a blank entry
+
+    resetQueueWait();                 // Clear the queue wait times (and aging)
+
+    _coalesce_    = Coalesce::kCoalesce_Off;  // Coalescing of forms is disabled by default
+    CoalesceCnt   = 0;                // No forms coalesced
+
+    _dev_count_   = 0;                // No devices configured (all use the default)
+    _group_count_ = 0;                // No forms taken out of order
+    ReconfigCnt   = 0;                // No changes to the bus configuration
+    GroupCnt      = 0;                //
+
+    _stream_buff_   = __null;         // No stream linked
+    _stream_cmd_    = __null;         //
+    _stream_size_   = 0;              //
+    _stream_width_  = DataWidth::k8bit;
+    _stream_run_    = 0;              // Stream not running
+
+#if defined(SPI_TRACE_ENABLE)           // If tracing of SPI Request Forms is enabled then
+//=================================================================================================
+    resetTrace();                     // Clear trace histograms
+#endif
 }
 
 #if ( defined(zz__MiSTM32Fx__zz) || defined(zz__MiSTM32Lx__zz)  )
@@ -54,33 +76,571 @@ SPIPeriph::SPIPeriph(SPI_HandleTypeDef *SPIHandle, Form *FormArray, uint16_t For
             _mode_ = SPIMode::kMode0;                       // MODE is 0
     }
 
+    // Default bus configuration is as per cubeMX setup
+    _default_config_.Mode   = _mode_;
+    _default_config_.Order  = (_spi_handle_->Instance->CR1 & SPI_CR1_LSBFIRST) ?
+                                BitOrder::kLSBFirst : BitOrder::kMSBFirst;
+    _default_config_.Speed  = busClock() >>
+                    (((_spi_handle_->Instance->CR1 & SPI_CR1_BR) >> SPI_CR1_BR_Pos) + 1);
+        // Baud rate is the peripheral clock divided by 2^(BR + 1)
+
+    _bus_config_ = _default_config_;    // Hardware is already at the default configuration
+
+    _data_width_ = DataWidth::k32bit;   // Force the hardware to be configured for 8bit frames
+    configDataWidth(DataWidth::k8bit);  // (32bit is not supported by the hardware)
+
     enable();                     // Enable the SPI device
 }
 #elif defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
 //=================================================================================================
-SPIPeriph::SPIPeriph(int channel, int speed, _SPIMode Mode) {
+SPIPeriph::SPIPeriph(const char *deviceloc, int speed, SPIMode Mode,
+                     Form *FormArray, uint16_t FormSize) {
 /**************************************************************************************************
  * Create a SPIPeriph class specific for RaspberryPi
- * Receives the desired channel, speed and Mode
+ * Receives the location of the spidev device, desired speed and Mode. As well as the SPI Request
+ * Form array pointer, and size
+ *
+ * This will then open up the spidev device, and configure the mode, speed and data size (8bits)
+ * If the device cannot be opened or configured, then "Flt" is set to "kDriver_Error"
  *************************************************************************************************/
     popGenParam();                // Populate generic class parameters
 
+    _device_loc_  = deviceloc;    // Capture the folder location of SPI device
+    _speed_       = (uint32_t) speed;   // Capture the desired speed
     _mode_        = Mode;         // Copy across the selected Mode
-    _spi_handle_  = channel;      //
-    int tempMode = 0;
+    _ioctl_       = &sysIoctl;    // Default driver calls to system "ioctl"
+    _data_width_  = DataWidth::k8bit;   // Default data size (each transfer states its own)
+
+    _default_config_.Speed  = _speed_;  // Default bus configuration is as per the input
+    _default_config_.Mode   = _mode_;   // (speed is stated per transfer, mode is configured
+    _default_config_.Order  = BitOrder::kMSBFirst;  // below)
+    _bus_config_ = _default_config_;
+
+    _form_queue_.create(FormArray, FormSize);
+
+    pthread_mutex_init(&_queue_lock_, __null);      // Setup the lock for the queue
+    _event_fd_    = eventfd(0, EFD_CLOEXEC);        // Setup the wake for the interrupt emulation
+    _worker_run_  = 0;                              // Interrupt emulation not running
+
+    pthread_mutex_init(&_stream_lock_, __null);     // Setup the lock for the stream
+    pthread_mutex_init(&_bus_lock_, __null);        // Setup the lock for the bus
+    _stream_delay_  = 0;
+
+    _spi_handle_ = open(_device_loc_, O_RDWR | O_CLOEXEC);
+        // Open the spidev interface
+    if (_spi_handle_ < 0) {             // If unable to open the device, then indicate fault
+        Flt = DevFlt::kDriver_Error;    // and exit
+        return;
+    }
+
+    Flt = configDriver();               // Configure selected mode, speed and data size (8bits)
+}
+
+SPIPeriph::DevFlt SPIPeriph::configDriver(void) {
+/**************************************************************************************************
+ * RaspberryPi specific function, will configure the selected mode, speed and data size (8bits) of
+ * the spidev device. If any are rejected by the driver, will return "kDriver_Error", otherwise
+ * "kInitialised" (as per construction)
+ *************************************************************************************************/
+    uint8_t tempMode = 0;
+    uint8_t tempBits = 8;
 
     if      (_mode_ == SPIMode::kMode1) // If Mode 1 is selected then
-        tempMode = 1;                   // Store "1"
+        tempMode = SPI_MODE_1;          // Store "1"
     else if (_mode_ == SPIMode::kMode2) // If Mode 2 is selected then
-        tempMode = 2;                   // Store "2"
+        tempMode = SPI_MODE_2;          // Store "2"
     else if (_mode_ == SPIMode::kMode3) // If Mode 3 is selected then
-        tempMode = 3;                   // Store "3"
+        tempMode = SPI_MODE_3;          // Store "3"
     else                                // If any other Mode is selected then
-       tempMode = 0;                    // Default to "0"
+        tempMode = SPI_MODE_0;          // Default to "0"
 
-    wiringPiSPISetupMode(_spi_channel_, speed, tempMode);
-        // Enable SPI interface for selected SPI channel, speed and mode
+    _bus_config_ = _default_config_;    // Bus is returned to the default configuration
+
+    if ( (_ioctl_(_spi_handle_, SPI_IOC_WR_MODE,          &tempMode) < 0) ||
+         (_ioctl_(_spi_handle_, SPI_IOC_WR_BITS_PER_WORD, &tempBits) < 0) ||
+         (_ioctl_(_spi_handle_, SPI_IOC_WR_MAX_SPEED_HZ,  &_speed_)  < 0) )
+        return (DevFlt::kDriver_Error);
+
+    return (DevFlt::kInitialised);
+}
+
+int SPIPeriph::sysIoctl(int fd, unsigned long request, void *arg) {
+/**************************************************************************************************
+ * RaspberryPi specific function, default function for all driver calls (links to system "ioctl")
+ *************************************************************************************************/
+    return (ioctl(fd, request, arg));
+}
+
+void SPIPeriph::linkIoctl(IoctlFunc func) {
+/**************************************************************************************************
+ * RaspberryPi specific function, replaces the function used for all driver calls. Allows the
+ * class to be run against a different function (i.e. loop back of data without hardware)
+ * The configuration of the device is sent through the new function, with "Flt" updated - so if
+ * the spidev device could not be opened, the new function stands in for it.
+ *************************************************************************************************/
+    _ioctl_ = func;
+
+    Flt = configDriver();               // Configure selected mode, speed and data size (8bits)
 }
+
+uint8_t SPIPeriph::formTransfers(Form *RequestForm, struct spi_ioc_transfer *xfer, uint8_t space) {
+/**************************************************************************************************
+ * RaspberryPi specific function, will populate the spidev transfers "xfer" for the SPI Request
+ * Form. A single array form is one transfer. A scatter-gather form is split into a transfer each
+ * time either the transmit or receive segment changes (so each transfer points straight at the
+ * segment data, no copies), with the Chip Select kept between them.
+ * Last transfer of the form has "cs_change" set (Chip Select released after form).
+ * Returns the number of transfers used, or 0 if more than "space" transfers would be needed.
+ *************************************************************************************************/
+    Segment         tx_single   = { RequestForm->TxBuff, RequestForm->size };
+    Segment         rx_single   = { RequestForm->RxBuff, RequestForm->size };
+    const Segment   *tx_seg     = &(tx_single);     // Segments to walk through, single array
+    const Segment   *rx_seg     = &(rx_single);     // forms are treated as a single segment
+    uint8_t         tx_cnt      = 1;                // Number of segments
+    uint8_t         rx_cnt      = 1;                //
+    uint16_t        tx_rem      = 0;                // Packets remaining within current segment
+    uint16_t        rx_rem      = 0;                //
+    uint8_t         *tx_buff    = __null;           // Position within current segment
+    uint8_t         *rx_buff    = __null;           //
+    uint16_t        packets     = 0;                // Packets within transfer
+    uint8_t         bytes       = RequestForm->Width / 8;   // Bytes per packet
+    uint8_t         used        = 0;                // Transfers used
+
+    if (RequestForm->TxSeg != __null) {             // If scatter-gather form, then walk through
+        tx_seg = RequestForm->TxSeg;    tx_cnt = RequestForm->TxSegCnt; // segment lists
+        rx_seg = RequestForm->RxSeg;    rx_cnt = RequestForm->RxSegCnt;
+    }
+
+    while (1) {
+        while ( (tx_rem == 0) && (tx_cnt != 0) ) {  // Move to next transmit segment (if needed)
+            tx_buff = tx_seg->Buff;     tx_rem = tx_seg->size;
+            tx_seg++;                   tx_cnt--;
+        }
+        while ( (rx_rem == 0) && (rx_cnt != 0) ) {  // Move to next receive segment (if needed)
+            rx_buff = rx_seg->Buff;     rx_rem = rx_seg->size;
+            rx_seg++;                   rx_cnt--;
+        }
+
+        if ( (tx_rem == 0) || (rx_rem == 0) )       // If either list is complete, then exit
+            break;
+
+        if (used == space)                          // If no space for another transfer, then
+            return (0);                             // form cannot be submitted within batch
+
+        packets = (tx_rem < rx_rem) ? tx_rem : rx_rem;  // Transfer up to the next segment change
+
+        xfer[used].tx_buf           = (unsigned long) tx_buff;  // __null segments, transmit 0s
+        xfer[used].rx_buf           = (unsigned long) rx_buff;  // or discard read back data
+        xfer[used].len              = packets * bytes;
+        xfer[used].speed_hz         = RequestForm->devLoc.Config.Speed;
+        xfer[used].bits_per_word    = RequestForm->Width;
+        xfer[used].cs_change        = 0;            // Keep Chip Select within form
+
+        if (tx_buff != __null)      tx_buff += packets * bytes;
+        if (rx_buff != __null)      rx_buff += packets * bytes;
+        tx_rem -= packets;
+        rx_rem -= packets;
+
+        used++;
+    }
+
+    if (used != 0)
+        xfer[used - 1].cs_change = 1;               // Release Chip Select after form
+
+    return (used);
+}
+
+uint8_t SPIPeriph::transferBatch(void) {
+/**************************************************************************************************
+ * RaspberryPi specific function, will take up to "SPIPe_MaxBatch" SPI Request Forms from the
+ * queue, and submit them to the spidev driver in a single "SPI_IOC_MESSAGE" call.
+ * Each form is a separate transfer (scatter-gather forms can be several, see ".formTransfers"),
+ * with the Chip Select released between each ("cs_change"), except the last (as "cs_change" on
+ * the last transfer would leave the device selected).
+ * Each transfer uses the data width of its form ("bits_per_word"), and its length is the number
+ * of bytes (size x width). Speed of each transfer is as per its device ("speed_hz").
+ * All forms within the batch are to have the same mode and bit order (configured prior to the
+ * driver call, see ".configBus"), forms with the same as the batch are taken first (see
+ * ".groupForm").
+ * A form which needs more than "SPIPe_MaxBatch" transfers has its fault flag set to
+ * "kData_Size", and is removed from the queue.
+ *
+ * Forms are taken in priority order (see ".selectQueue").
+ * Any form which already has a fault is removed from the queue without being transferred (its
+ * completion callback is still called, once the queue is released - so the callback can request
+ * new forms).
+ * Any form which uses a software GPIO Chip Select, is submitted on its own - so the GPIO can be
+ * selected/deselected either side of the driver call.
+ *
+ * If coalescing is enabled (".configCoalesce"), consecutive forms to the same Chip Select are
+ * kept selected between each ("cs_change" = 0), including software GPIO Chip Select forms (which
+ * are then submitted together, with the GPIO selected once). Each form is still a separate
+ * transfer, so the read back data is split into each form's own location.
+ *
+ * Once complete, each form's complete flag is updated with the amount of data transferred, or if
+ * the driver rejects the call, each form's fault flag is set to "kDriver_Error". Both are updated
+ * with release ordering, so the read back data is visible to the source function (which may be
+ * a different thread) once the flag is seen. Each form's completion callback is then called.
+ * The queue is only locked whilst forms are taken, not during the driver call or callbacks.
+ * Returns the number of forms taken from the queue (0 if queue is empty).
+ *************************************************************************************************/
+    struct spi_ioc_transfer xfer[SPIPe_MaxBatch];   // Transfers to submit to driver
+    Form        batch[SPIPe_MaxBatch];              // Forms within the transfer
+    Form        skipped[SPIPe_MaxBatch];            // Forms removed without transfer (faulted)
+    Form        next_form;                          // Next form within the queue
+    uint8_t     count = 0;                          // Number of forms within batch
+    uint8_t     scount = 0;                         // Number of forms removed without transfer
+    uint8_t     xcount = 0;                         // Number of transfers within batch
+    uint8_t     used = 0;                           // Number of transfers for next form
+    uint8_t     i = 0;                              // Variable for looping
+    uint8_t     priority = 0;                       // Priority of queue to take next form from
+    int         returnval = 0;                      // Return value from driver
+
+    memset(xfer, 0, sizeof(xfer));                  // Clear all transfers
+
+    pthread_mutex_lock(&_queue_lock_);              // Lock queue, whilst forms are taken
+
+    while ( (xcount != SPIPe_MaxBatch) && (scount != SPIPe_MaxBatch) ) {
+        priority = selectQueue();                   // Determine queue to take next form from
+        if (priority == SPIPe_NumPriority)          // If all queues are empty, then exit loop
+            break;
+
+        groupForm(priority, (count != 0) ? batch[0].devLoc.Config : _bus_config_);
+            // Prefer form with the same bus configuration as the batch
+
+        next_form = formQueue((FormPriority) priority)->readBuffer(
+                        formQueue((FormPriority) priority)->output_pointer);
+            // Check the next form, prior to removing from queue
+
+        if (__atomic_load_n(next_form.Flt, __ATOMIC_ACQUIRE) != SPIPeriph::DevFlt::kNone) {
+            // If fault has already been detected, then request is no longer valid, so remove
+            takeForm(priority, &(skipped[scount++]));       // from queue (is complete)
+            continue;
+        }
+
+        if ( (count != 0) &&
+             (configMatch(batch[0].devLoc.Config, next_form.devLoc.Config) == 0) )
+            break;  // If different mode/bit order, then leave for next (bus needs reconfiguring)
+
+        if (count != 0) {                           // If not first in batch
+            if ( (_coalesce_ == Coalesce::kCoalesce_Off) ||
+                 (chipSelectMatch(batch[count - 1].devLoc, next_form.devLoc) == 0) ) {
+                if ( (next_form.devLoc.Type        == CSHandle::CSType::kSoftware_GPIO) ||
+                     (batch[count - 1].devLoc.Type == CSHandle::CSType::kSoftware_GPIO) )
+                    break;  // If software Chip Select (and not coalesced), then leave for next
+            }
+        }
+
+        used = formTransfers(&(next_form), &(xfer[xcount]), SPIPe_MaxBatch - xcount);
+        if (used == 0) {                            // If form does not fit within batch
+            if (xcount != 0)                        // If not first in batch, then leave for next
+                break;
+
+            __atomic_store_n(next_form.Flt, DevFlt::kData_Size, __ATOMIC_RELEASE);
+            takeForm(priority, &(skipped[scount++]));   // Otherwise cannot be submitted (or has
+            continue;                                   // no data), so remove from queue
+        }
+
+        if ( (count != 0) && (_coalesce_ == Coalesce::kCoalesce_On) &&
+             (chipSelectMatch(batch[count - 1].devLoc, next_form.devLoc) == 1) ) {
+            xfer[xcount - 1].cs_change = 0;         // If coalescing, and same Chip Select then
+            CoalesceCnt++;                          // keep the device selected
+        }
+
+        takeForm(priority, &(batch[count]));                // Capture form request
+
+        xcount += used;
+        count++;
+
+        if ( (batch[count - 1].devLoc.Type == CSHandle::CSType::kSoftware_GPIO) &&
+             (_coalesce_ == Coalesce::kCoalesce_Off) )
+            break;      // If software Chip Select, then needs to be on its own
+    }
+
+    pthread_mutex_unlock(&_queue_lock_);            // Release queue
+
+    for (i = 0; i != scount; i++)                   // Forms removed without transfer are
+        cmpltCallback(&(skipped[i]));               // complete (queue released, as callback can
+                                                    // request new forms)
+
+    if (count == 0)                                 // If no forms to transfer, then exit
+        return (scount);
+
+    xfer[xcount - 1].cs_change = 0;                 // Release Chip Select at end of message
+
+    configBus(batch[0].devLoc.Config);              // Set mode/bit order of the batch
+    chipSelectHandle(batch[0].devLoc, CSSelection::kSelect);
+        // Select the device (only does anything for software Chip Select)
+
+#if defined(SPI_TRACE_ENABLE)           // If tracing of SPI Request Forms is enabled then
+//=================================================================================================
+    for (i = 0; i != count; i++)                    // All forms start with the driver call
+        traceFormStart(&(batch[i]));
+#endif
+
+    if (configMatch(batch[0].devLoc.Config, _bus_config_) == 1)
+        returnval = _ioctl_(_spi_handle_, SPI_IOC_MESSAGE(xcount), xfer);
+    else                                            // If mode/bit order could not be set, then
+        returnval = -1;                             // treat as rejected by driver
+
+    chipSelectHandle(batch[0].devLoc, CSSelection::kDeselect);
+
+    for (i = 0; i != count; i++) {                  // Update each of the forms
+        if (returnval < 0)                          // If driver rejected the transfer
+            __atomic_store_n(batch[i].Flt, DevFlt::kDriver_Error, __ATOMIC_RELEASE);
+        else {
+#if defined(SPI_TRACE_ENABLE)           // If tracing of SPI Request Forms is enabled then
+//=================================================================================================
+            traceFormCmplt(&(batch[i]), batch[i].size);
+#endif
+            __atomic_fetch_add(batch[i].Cmplt, batch[i].size, __ATOMIC_RELEASE);
+        }
+
+        cmpltCallback(&(batch[i]));                 // Form is complete (or faulted)
+    }
+
+    if (returnval < 0)
+        Flt = DevFlt::kDriver_Error;
+
+    return (count + scount);
+}
+
+void *SPIPeriph::workerThread(void *arg) {
+/**************************************************************************************************
+ * RaspberryPi specific function, interrupt emulation thread.
+ * Will wait (blocked) upon the eventfd, until woken by a new form being added to the queue (or
+ * request to stop). Then will submit all forms within the queue to the driver, before waiting
+ * again.
+ * Whilst a stream is running (".startStream"), doesn't wait - instead continually submits the
+ * stream samples, with any forms within the queue submitted between each.
+ *************************************************************************************************/
+    SPIPeriph   *spi = (SPIPeriph *)arg;            // Class which started the thread
+    uint64_t    wake = 0;                           // Value read from eventfd
+
+    while (__atomic_load_n(&spi->_worker_run_, __ATOMIC_ACQUIRE) == 1) {
+        if (__atomic_load_n(&spi->_stream_run_, __ATOMIC_ACQUIRE) == 0) {
+            if (read(spi->_event_fd_, &wake, sizeof(wake)) != sizeof(wake))
+                continue;                           // If interrupted, then wait again
+        }   // If stream is running, then don't wait (forms are checked between stream calls)
+
+        pthread_mutex_lock(&spi->_bus_lock_);       // Lock SPI bus (waits for polling transfer)
+        __atomic_store_n(&spi->CommState, CommLock::kCommunicating, __ATOMIC_RELEASE);
+
+        while (spi->transferBatch() != 0) {};       // Submit all forms within queue
+        spi->streamBatch();                         // Submit stream samples (if running)
+
+        __atomic_store_n(&spi->CommState, CommLock::kFree, __ATOMIC_RELEASE);
+        pthread_mutex_unlock(&spi->_bus_lock_);     // Indicate that SPI bus is now free
+    }
+
+    return (__null);
+}
+
+SPIPeriph::DevFlt SPIPeriph::startWorker(int priority, int core) {
+/**************************************************************************************************
+ * RaspberryPi specific function, will start the interrupt emulation thread. Once started, the
+ * interrupt based functions (".intMasterTransfer") will no longer block.
+ * Thread is run with real-time priority "priority" (SCHED_FIFO 1 to 99), or as a normal thread if
+ * 0. If "core" is not -1, then the thread is limited to that core.
+ * If the thread cannot be started (i.e. no permission for real-time priority), will return
+ * "kDriver_Error"
+ *************************************************************************************************/
+    pthread_attr_t      attr;                       // Attributes of thread
+    struct sched_param  param;                      // Priority of thread
+    cpu_set_t           cpuset;                     // Core for thread
+    int                 returnval = 0;              // Return value from thread creation
+
+    if ( (_worker_run_ == 1) || (_event_fd_ < 0) )  // If already running (or no eventfd)
+        return ( (_event_fd_ < 0) ? DevFlt::kDriver_Error : DevFlt::kNone );
+
+    pthread_attr_init(&attr);
+    if (priority != 0) {                            // If real-time priority requested
+        pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+        pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+        param.sched_priority = priority;
+        pthread_attr_setschedparam(&attr, &param);
+    }
+    if (core >= 0) {                                // If core requested
+        CPU_ZERO(&cpuset);
+        CPU_SET(core, &cpuset);
+        pthread_attr_setaffinity_np(&attr, sizeof(cpuset), &cpuset);
+    }
+
+    __atomic_store_n(&_worker_run_, 1, __ATOMIC_RELEASE);
+    returnval = pthread_create(&_worker_handle_, &attr, &workerThread, this);
+    pthread_attr_destroy(&attr);
+
+    if (returnval != 0) {                           // If unable to start thread
+        __atomic_store_n(&_worker_run_, 0, __ATOMIC_RELEASE);
+        return (DevFlt::kDriver_Error);
+    }
+
+    startInterrupt();       // Wake thread, in case forms have been queued prior to start
+
+    return (DevFlt::kNone);
+}
+
+void SPIPeriph::stopWorker(void) {
+/**************************************************************************************************
+ * RaspberryPi specific function, will stop the interrupt emulation thread, and wait for it to
+ * exit (any forms being submitted will be completed first). Any stream is stopped.
+ * The thread is always waited for - the wake is retried if interrupted by a signal.
+ *************************************************************************************************/
+    uint64_t wake = 1;                              // Value to write to eventfd
+
+    if (__atomic_load_n(&_worker_run_, __ATOMIC_ACQUIRE) == 0)  // If not running, then exit
+        return;
+
+    stopStream();                                   // Stream is run by the thread, so stop it
+
+    __atomic_store_n(&_worker_run_, 0, __ATOMIC_RELEASE);
+
+    while ( (write(_event_fd_, &wake, sizeof(wake)) != sizeof(wake)) && (errno == EINTR) ) {};
+        // Wake thread, so it sees the request to stop and exits
+
+    pthread_join(_worker_handle_, __null);
+}
+
+void SPIPeriph::holdBus(void) {
+/**************************************************************************************************
+ * RaspberryPi specific function, will hold the bus (waiting for any submission of the queue, or
+ * polling transfer, to complete). Forms requested whilst held are queued, and then submitted
+ * together once released (".releaseBus").
+ * To be released by the same thread, with no polling transfers whilst held.
+ *************************************************************************************************/
+    pthread_mutex_lock(&_bus_lock_);                // Lock SPI bus
+    __atomic_store_n(&CommState, CommLock::kCommunicating, __ATOMIC_RELEASE);
+}
+
+void SPIPeriph::releaseBus(void) {
+/**************************************************************************************************
+ * RaspberryPi specific function, will release the bus held by ".holdBus", and submit the forms
+ * queued whilst held (".startInterrupt" - blocking, unless the interrupt emulation thread is
+ * running).
+ *************************************************************************************************/
+    __atomic_store_n(&CommState, CommLock::kFree, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&_bus_lock_);              // Indicate that SPI bus is now free
+
+    startInterrupt();                               // Submit the queue
+}
+
+SPIPeriph::DevFlt SPIPeriph::startStream(const uint8_t *Command, uint16_t size, DataWidth width,
+                                         GenBuffer<uint8_t> *ReadArray, uint32_t period) {
+/**************************************************************************************************
+ * RaspberryPi specific function, will start the stream of "Command" ("size" frames of "width"),
+ * repeated every "period" (us), with each reply put into "ReadArray" (see ".streamLink").
+ * The stream is run by the interrupt emulation thread, which needs to be running (otherwise
+ * "kStream_Error"). Uses the hardware managed Chip Select.
+ * Period is from the start of each sample, the time of the sample is determined from the speed of
+ * the hardware managed Chip Select device - any remainder is the delay after the sample (limited
+ * to 65535us). A period of 0 has no delay.
+ *************************************************************************************************/
+    DevFlt      returnval   = DevFlt::kNone;
+    uint32_t    sample_us   = 0;                    // Time of each sample (us)
+    DevConfig   config      = deviceConfig(__null); // Configuration of hardware Chip Select
+
+    if (_worker_run_ == 0)                          // If the interrupt emulation thread is not
+        return ( Flt = DevFlt::kStream_Error );     // running, then exit
+
+    returnval = streamLink(Command, size, width, ReadArray);
+    if (returnval != DevFlt::kNone)
+        return (returnval);
+
+    if (config.Speed != 0)
+        sample_us = (uint32_t) ( ((uint64_t) streamBytes() * 8 * 1000000) / config.Speed );
+
+    if (period > (sample_us + 0xFFFF))              // Delay is limited to 16bits (driver
+        _stream_delay_ = 0xFFFF;                    // transfer entry)
+    else if (period > sample_us)
+        _stream_delay_ = (uint16_t) (period - sample_us);
+    else
+        _stream_delay_ = 0;
+
+    __atomic_store_n(&_stream_run_, 1, __ATOMIC_RELEASE);
+    startInterrupt();                               // Wake thread to start stream
+
+    return (DevFlt::kNone);
+}
+
+void SPIPeriph::stopStream(void) {
+/**************************************************************************************************
+ * RaspberryPi specific function, will stop the stream. Waits for any stream samples with the
+ * driver to complete, such that the 'GenBuffer' is no longer written to once returned.
+ *************************************************************************************************/
+    __atomic_store_n(&_stream_run_, 0, __ATOMIC_RELEASE);
+
+    pthread_mutex_lock(&_stream_lock_);             // Wait for driver call to complete
+    pthread_mutex_unlock(&_stream_lock_);
+}
+
+uint16_t SPIPeriph::streamBatch(void) {
+/**************************************************************************************************
+ * RaspberryPi specific function, will submit upto "SPIPe_StreamBatch" stream samples to the
+ * spidev driver in a single "SPI_IOC_MESSAGE" call (limited to half the number of samples within
+ * the 'GenBuffer', so the "input_pointer" cannot wrap round to the reader within a call).
+ * Each sample is a separate transfer, transmitting the command, and reading straight into the
+ * 'GenBuffer' (from the "input_pointer" onwards, wrapping round). The Chip Select is released
+ * between each ("cs_change"), after the delay ("delay_usecs").
+ * Once complete, the "input_pointer" is moved past the samples (release ordering, so the data is
+ * visible to the reader once the pointer is seen). If the driver rejects the call, the stream is
+ * stopped, and the fault is set to "kDriver_Error".
+ * Returns the number of samples submitted (0 if stream is not running).
+ *************************************************************************************************/
+    struct spi_ioc_transfer xfer[SPIPe_StreamBatch];    // Transfers to submit to driver
+    DevConfig   config      = deviceConfig(__null);     // Configuration of hardware Chip Select
+    uint16_t    bytes       = 0;                        // Number of bytes within each sample
+    uint16_t    count       = 0;                        // Number of samples within batch
+    uint16_t    position    = 0;                        // Position within 'GenBuffer'
+    uint16_t    i           = 0;                        // Variable for looping
+    int         returnval   = 0;                        // Return value from driver
+
+    pthread_mutex_lock(&_stream_lock_);
+
+    if (__atomic_load_n(&_stream_run_, __ATOMIC_ACQUIRE) == 0) {    // If stream not running,
+        pthread_mutex_unlock(&_stream_lock_);                       // then exit
+        return (0);
+    }
+
+    memset(xfer, 0, sizeof(xfer));                      // Clear all transfers
+
+    bytes       = streamBytes();
+    count       = (_stream_buff_->length / bytes) / 2;  // Limit to half the samples within
+    if (count > SPIPe_StreamBatch)                      // buffer (so reader can keep up)
+        count = SPIPe_StreamBatch;
+    position    = _stream_buff_->input_pointer;
+
+    for (i = 0; i != count; i++) {
+        xfer[i].tx_buf          = (unsigned long) _stream_cmd_;
+        xfer[i].rx_buf          = (unsigned long) &(_stream_buff_->pa[position]);
+        xfer[i].len             = bytes;
+        xfer[i].speed_hz        = config.Speed;
+        xfer[i].bits_per_word   = _stream_width_;
+        xfer[i].delay_usecs     = _stream_delay_;
+        xfer[i].cs_change       = 1;                    // Release Chip Select after sample
+
+        position = (position + bytes) % _stream_buff_->length;
+    }
+    xfer[count - 1].cs_change = 0;                      // Release Chip Select at end of message
+
+    configBus(config);                                  // Set mode/bit order of the stream
+
+    if (configMatch(config, _bus_config_) == 1)
+        returnval = _ioctl_(_spi_handle_, SPI_IOC_MESSAGE(count), xfer);
+    else                                                // If mode/bit order could not be set,
+        returnval = -1;                                 // then treat as rejected by driver
+
+    if (returnval < 0) {                                // If driver rejected the transfer, then
+        __atomic_store_n(&_stream_run_, 0, __ATOMIC_RELEASE);   // stop the stream
+        Flt = DevFlt::kDriver_Error;
+    }
+    else
+        __atomic_store_n(&(_stream_buff_->input_pointer), position, __ATOMIC_RELEASE);
+
+    pthread_mutex_unlock(&_stream_lock_);
+
+    return (count);
+}
+
 #else
 //=================================================================================================
 SPIPeriph::SPIPeriph() {
@@ -110,49 +670,392 @@ void SPIPeriph::enable(void) {
 #endif
 }
 
-void SPIPeriph::disable(void) {
+void SPIPeriph::disable(void) {
+/**************************************************************************************************
+ * Enable the SPI Device
+ *************************************************************************************************/
+
+#if   defined(zz__MiSTM32Fx__zz)        // If the target device is an STM32Fxx from cubeMX then
+//=================================================================================================
+    __HAL_SPI_DISABLE(_spi_handle_);    // Disable the SPI interface
+
+#elif defined(zz__MiSTM32Lx__zz)        // If the target device is an STM32Lxx from cubeMX then
+//=================================================================================================
+    __HAL_SPI_DISABLE(_spi_handle_);    // Disable the SPI interface
+
+#elif defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
+//=================================================================================================
+    // Done in initial call.
+
+#else
+//=================================================================================================
+
+#endif
+}
+
+uint16_t SPIPeriph::readDR(void) {
+/**************************************************************************************************
+ * Read from the SPI hardware (8bits or 16bits, as per the configured data width)
+ *************************************************************************************************/
+
+#if   defined(zz__MiSTM32Fx__zz)        // If the target device is an STM32Fxx from cubeMX then
+//=================================================================================================
+    return ((uint16_t) _spi_handle_->Instance->DR);
+
+#elif defined(zz__MiSTM32Lx__zz)        // If the target device is an STM32Lxx from cubeMX then
+//=================================================================================================
+// STM32L4 uses a RXFIFO of 32bits (4 x 8bits), so the size of the access to the Data Register
+// (DR) needs to match the data width - otherwise more than one frame will be taken from the FIFO
+    if (_data_width_ == DataWidth::k8bit)
+        return ( *(__IO uint8_t *)&_spi_handle_->Instance->DR );
+    else
+        return ( *(__IO uint16_t *)&_spi_handle_->Instance->DR );
+
+#elif defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
+//=================================================================================================
+// Unable to get to this level of granularity using the wiringPi library. Function will not be
+// called by upper level functions
+    return 0;
+
+#else
+//=================================================================================================
+
+#endif
+}
+
+void SPIPeriph::writeDR(uint16_t data) {
+/**************************************************************************************************
+ * Write to the SPI hardware (8bits or 16bits, as per the configured data width)
+ *************************************************************************************************/
+
+#if   defined(zz__MiSTM32Fx__zz)        // If the target device is an STM32Fxx from cubeMX then
+//=================================================================================================
+    _spi_handle_->Instance->DR = data;
+
+#elif defined(zz__MiSTM32Lx__zz)        // If the target device is an STM32Lxx from cubeMX then
+//=================================================================================================
+// STM32L4 uses a TXFIFO of 32bits (4 x 8bits), so the size of the access to the Data Register
+// (DR) needs to match the data width. For 8bits, need to ensure that we cast the Data Register
+// (DR) to unsigned 8bits (otherwise 2 frames are transmitted), hence the initial casing
+    if (_data_width_ == DataWidth::k8bit)
+        *(__IO uint8_t *)&_spi_handle_->Instance->DR = (uint8_t) data;
+    else
+        *(__IO uint16_t *)&_spi_handle_->Instance->DR = data;
+
+#elif defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
+//=================================================================================================
+// Unable to get to this level of granularity using the wiringPi library. Function will not be
+// called by upper level functions
+    (void) data;
+
+#else
+//=================================================================================================
+// Unable to get to this level of granularity using the wiringPi library. Function will not be
+// called by upper level functions
+#endif
+}
+
+uint16_t SPIPeriph::readDRPacked(void) {
+/**************************************************************************************************
+ * Read 2x 8bit frames from the SPI hardware, within a single 16bit access of the Data Register.
+ * First frame received is within the lower 8bits.
+ * Only to be used for 8bit data width, when the RXFIFO contains at least 2 frames (STM32L)
+ *************************************************************************************************/
+
+#if   defined(zz__MiSTM32Fx__zz)        // If the target device is an STM32Fxx from cubeMX then
+//=================================================================================================
+// STM32F has no RXFIFO, so will only ever have a single frame to read. Function will not be
+// called by upper level functions
+    return ((uint16_t) _spi_handle_->Instance->DR);
+
+#elif defined(zz__MiSTM32Lx__zz)        // If the target device is an STM32Lxx from cubeMX then
+//=================================================================================================
+    return ( *(__IO uint16_t *)&_spi_handle_->Instance->DR );
+
+#elif defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
+//=================================================================================================
+// Unable to get to this level of granularity using the wiringPi library. Function will not be
+// called by upper level functions
+    return 0;
+
+#else
+//=================================================================================================
+
+#endif
+}
+
+void SPIPeriph::writeDRPacked(uint16_t data) {
+/**************************************************************************************************
+ * Write 2x 8bit frames to the SPI hardware, within a single 16bit access of the Data Register.
+ * First frame to transmit is within the lower 8bits.
+ * Only to be used for 8bit data width, when the TXFIFO has space for 2 frames (STM32L)
+ *************************************************************************************************/
+
+#if   defined(zz__MiSTM32Fx__zz)        // If the target device is an STM32Fxx from cubeMX then
+//=================================================================================================
+// STM32F has no TXFIFO, so will only ever transmit a single frame. Function will not be
+// called by upper level functions
+    _spi_handle_->Instance->DR = data;
+
+#elif defined(zz__MiSTM32Lx__zz)        // If the target device is an STM32Lxx from cubeMX then
+//=================================================================================================
+    *(__IO uint16_t *)&_spi_handle_->Instance->DR = data;
+
+#elif defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
+//=================================================================================================
+// Unable to get to this level of granularity using the wiringPi library. Function will not be
+// called by upper level functions
+    (void) data;
+
+#else
+//=================================================================================================
+
+#endif
+}
+
+void SPIPeriph::fillTransmitFIFO(void) {
+/**************************************************************************************************
+ * Fill the hardware TXFIFO with data from the current SPI Request Form (STM32L).
+ * The number of frames "in flight" (written to the TXFIFO, but not yet read from the RXFIFO) is
+ * limited to the size of the RXFIFO ("SPIPe_FIFODepth"), so the RXFIFO cannot overrun - even if
+ * the interrupt is delayed. For 8bit data width, 2 frames are written within a single access
+ * where there is space (".writeDRPacked").
+ *
+ * Once all data for the form has been written, or the limit has been reached, the Transmit
+ * Empty interrupt is disabled. Space is then freed by ".drainReceiveFIFO", after which this
+ * function is to be called again (from the Receive interrupt).
+ *************************************************************************************************/
+    uint16_t frame      = (uint16_t) (_cur_form_.Width / 8);    // Number of bytes per frame
+    uint16_t inflight   = (uint16_t) ((_cur_count_ - _tx_count_) * frame);
+        // Number of bytes written to hardware, but not yet read back
+    uint16_t temp_val   = 0;    // Temporary variable to store data value
+
+    while ( (_tx_count_ != 0) && ((inflight + frame) <= SPIPe_FIFODepth) &&
+            (transmitFIFOLvl() != SPIPe_FIFOFull) ) {
+        if ( (frame == 1) && (_tx_count_ >= 2) && ((inflight + 2) <= SPIPe_FIFODepth) &&
+             (transmitFIFOLvl() <= SPIPe_FIFOHalf) ) {
+            temp_val  = getFormWriteData( &(_cur_form_) );
+            temp_val |= (uint16_t) (getFormWriteData( &(_cur_form_) ) << 8);
+            writeDRPacked(temp_val);                // Pack 2 frames into single access
+
+            _tx_count_  -= 2;
+            inflight    += 2;
+        } else {
+            writeDR (  getFormWriteData( &(_cur_form_) )  );
+
+            _tx_count_  -= 1;
+            inflight    += frame;
+        }
+    }
+
+    if ( (_tx_count_ == 0) || ((inflight + frame) > SPIPe_FIFODepth) )
+        configTransmtIT(InterState::kIT_Disable);   // No more data, or no space within RXFIFO
+    else
+        configTransmtIT(InterState::kIT_Enable);    // Otherwise wait for TXFIFO space
+}
+
+void SPIPeriph::drainReceiveFIFO(void) {
+/**************************************************************************************************
+ * Empty the hardware RXFIFO into the current SPI Request Form (STM32L), decrementing the current
+ * count for each frame read. For 8bit data width, 2 frames are read within a single access where
+ * available (".readDRPacked").
+ *************************************************************************************************/
+    uint16_t temp_val   = 0;    // Temporary variable to store data value
+
+    while ( (_cur_count_ != 0) && (receiveFIFOLvl() != 0) ) {
+        if ( (_cur_form_.Width == DataWidth::k8bit) && (_cur_count_ >= 2) &&
+             (receiveFIFOLvl() >= SPIPe_FIFOHalf) ) {
+            temp_val = readDRPacked();              // Unpack 2 frames from single access
+            putFormReadData( &(_cur_form_), (uint16_t) (temp_val & 0xFF) );
+            putFormReadData( &(_cur_form_), (uint16_t) (temp_val >> 8) );
+
+            _cur_count_ -= 2;
+        } else {
+            putFormReadData( &(_cur_form_), readDR() );
+
+            _cur_count_ -= 1;
+        }
+    }
+}
+
+void SPIPeriph::configDataWidth(DataWidth width) {
+/**************************************************************************************************
+ * Configure the hardware data width (frame size). Only changed if different from the current
+ * width, as the SPI device needs to be disabled to change it (so to be called whilst the bus is
+ * free, prior to ".enable").
+ *      STM32F  - DFF bit (8bit or 16bit)
+ *      STM32L  - DS bits (8bit or 16bit), as well as the RXNE threshold (FRXTH), so that the
+ *                receive event triggers once a single frame is within the RXFIFO
+ *      RaspberryPi - Nothing to configure, as each transfer states its own width
+ *
+ * 32bit is not supported by the STM32 hardware (forms are rejected when queued).
+ *************************************************************************************************/
+    if (width == _data_width_)          // If already at the requested width, then exit
+        return;
+
+#if   defined(zz__MiSTM32Fx__zz)        // If the target device is an STM32Fxx from cubeMX then
+//=================================================================================================
+    disable();                          // Data width can only be changed with SPI disabled
+
+    if (width == DataWidth::k16bit)
+        SET_BIT(_spi_handle_->Instance->CR1, SPI_CR1_DFF);
+    else
+        CLEAR_BIT(_spi_handle_->Instance->CR1, SPI_CR1_DFF);
+
+#elif defined(zz__MiSTM32Lx__zz)        // If the target device is an STM32Lxx from cubeMX then
+//=================================================================================================
+    disable();                          // Data width can only be changed with SPI disabled
+
+    if (width == DataWidth::k16bit)
+        MODIFY_REG(_spi_handle_->Instance->CR2, SPI_CR2_DS | SPI_CR2_FRXTH,
+                   (15U << SPI_CR2_DS_Pos));                    // 16bit, RXNE at 1/2 full
+    else
+        MODIFY_REG(_spi_handle_->Instance->CR2, SPI_CR2_DS | SPI_CR2_FRXTH,
+                   (7U  << SPI_CR2_DS_Pos) | SPI_CR2_FRXTH);    // 8bit,  RXNE at 1/4 full
+
+#elif defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
+//=================================================================================================
+    // Done per transfer.
+
+#else
+//=================================================================================================
+
+#endif
+
+    _data_width_ = width;
+}
+
+void SPIPeriph::configBus(DevConfig config) {
+/**************************************************************************************************
+ * Configure the hardware speed, mode and bit order. Only changed if different from the current
+ * configuration (see ".configMatch"), as the SPI device needs to be disabled to change it (so to
+ * be called whilst the bus is free, prior to ".enable").
+ *      STM32       - BR (baud rate divider), CPOL/CPHA and LSBFIRST bits. Divider is the
+ *                    smallest which doesn't exceed the speed (speeds from ".configDevice" are
+ *                    already exact)
+ *      RaspberryPi - Mode and bit order via "SPI_IOC_WR_MODE", speed is stated per transfer.
+ *                    If the driver rejects the change, the fault is set to "kDriver_Error" (and
+ *                    the next call will try again)
+ *************************************************************************************************/
+    if (configMatch(config, _bus_config_) == 1) // If already at the requested configuration, then
+        return;                                 // exit
+
+#if ( defined(zz__MiSTM32Fx__zz) || defined(zz__MiSTM32Lx__zz)  )
+// If the target device is either STM32Fxx or STM32Lxx from cubeMX then ...
+//=================================================================================================
+    uint32_t    clock   = busClock();       // Clock feeding the SPI peripheral
+    uint32_t    divider = 0;                // Baud rate divider (BR bits)
+    uint32_t    setting = 0;                // New CR1 bits
+
+    while ( ((clock >> (divider + 1)) > config.Speed) && (divider != 7) )
+        divider++;                          // Find the smallest divider, not exceeding speed
+
+    setting  = (divider << SPI_CR1_BR_Pos);
+    if (config.Mode & 0x02)                 // Mode 2 and 3, clock idles HIGH
+        setting |= SPI_CR1_CPOL;
+    if (config.Mode & 0x01)                 // Mode 1 and 3, captures on the second edge
+        setting |= SPI_CR1_CPHA;
+    if (config.Order == BitOrder::kLSBFirst)
+        setting |= SPI_CR1_LSBFIRST;
+
+    disable();                              // Configuration can only be changed with SPI disabled
+
+    MODIFY_REG(_spi_handle_->Instance->CR1,
+               SPI_CR1_BR | SPI_CR1_CPOL | SPI_CR1_CPHA | SPI_CR1_LSBFIRST, setting);
+
+#elif defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
+//=================================================================================================
+    uint8_t tempMode = (uint8_t) config.Mode;   // SPIMode matches the spidev mode bits (CPHA = 1,
+                                                // CPOL = 2)
+    if (config.Order == BitOrder::kLSBFirst)
+        tempMode |= SPI_LSB_FIRST;
+
+    if (_ioctl_(_spi_handle_, SPI_IOC_WR_MODE, &tempMode) < 0) {
+        Flt = DevFlt::kDriver_Error;            // If rejected, indicate fault and exit (not
+        return;                                 // updating the current configuration)
+    }
+
+#else
+//=================================================================================================
+
+#endif
+
+    _bus_config_ = config;
+    ReconfigCnt++;
+}
+
+uint32_t SPIPeriph::busClock(void) {
+/**************************************************************************************************
+ * Clock feeding the SPI peripheral (Hz), from which the SPI clock is divided.
+ *      STM32       - SPI1 is on the APB2 bus (PCLK2), all others are on APB1 (PCLK1)
+ *      RaspberryPi - Not used (spidev driver manages the clock), returns 0
+ *************************************************************************************************/
+#if ( defined(zz__MiSTM32Fx__zz) || defined(zz__MiSTM32Lx__zz)  )
+// If the target device is either STM32Fxx or STM32Lxx from cubeMX then ...
+//=================================================================================================
+#if defined(SPI1)
+    if (_spi_handle_->Instance == SPI1)
+        return (HAL_RCC_GetPCLK2Freq());
+#endif
+
+    return (HAL_RCC_GetPCLK1Freq());
+
+#else
+//=================================================================================================
+    return (0);
+
+#endif
+}
+
+uint32_t SPIPeriph::clockSpeed(uint32_t speed) {
 /**************************************************************************************************
- * Enable the SPI Device
+ * Fastest speed the hardware can achieve, which doesn't exceed "speed" (Hz).
+ *      STM32       - Peripheral clock divided by 2, 4, ... 256. If "speed" is below the slowest,
+ *                    then the slowest is returned
+ *      RaspberryPi - spidev driver manages the clock, so "speed" is returned unchanged
  *************************************************************************************************/
-
-#if   defined(zz__MiSTM32Fx__zz)        // If the target device is an STM32Fxx from cubeMX then
+#if ( defined(zz__MiSTM32Fx__zz) || defined(zz__MiSTM32Lx__zz)  )
+// If the target device is either STM32Fxx or STM32Lxx from cubeMX then ...
 //=================================================================================================
-    __HAL_SPI_DISABLE(_spi_handle_);    // Disable the SPI interface
+    uint32_t    clock   = busClock();       // Clock feeding the SPI peripheral
+    uint32_t    divider = 0;                // Baud rate divider (BR bits)
 
-#elif defined(zz__MiSTM32Lx__zz)        // If the target device is an STM32Lxx from cubeMX then
-//=================================================================================================
-    __HAL_SPI_DISABLE(_spi_handle_);    // Disable the SPI interface
+    while ( ((clock >> (divider + 1)) > speed) && (divider != 7) )
+        divider++;
 
-#elif defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
-//=================================================================================================
-    // Done in initial call.
+    return (clock >> (divider + 1));
 
 #else
 //=================================================================================================
+    return (speed);
 
 #endif
 }
 
-uint8_t SPIPeriph::readDR(void) {
+uint8_t SPIPeriph::transmitEmptyChk(void) {
 /**************************************************************************************************
- * Read from the SPI hardware
+ * Check the status of the Hardware Transmit buffer (if empty, output = 1)
  *************************************************************************************************/
 
 #if   defined(zz__MiSTM32Fx__zz)        // If the target device is an STM32Fxx from cubeMX then
 //=================================================================================================
-    return ((uint8_t) _spi_handle_->Instance->DR);
+    if ( __HAL_SPI_GET_FLAG(_spi_handle_, SPI_FLAG_TXE) != 0 )
+        return (1);
+    else
+        return (0);
 
 #elif defined(zz__MiSTM32Lx__zz)        // If the target device is an STM32Lxx from cubeMX then
 //=================================================================================================
-// STM32L4 uses a RXFIFO of 32bits (4 x 8bits), this function will only work if the hardware has
-// been configured to allow a read of only 8bits (or less)
-    return( (uint8_t) _spi_handle_->Instance->DR );
+    if ( __HAL_SPI_GET_FLAG(_spi_handle_, SPI_FLAG_TXE) != 0 )
+        return (1);
+    else
+        return (0);
 
 #elif defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
 //=================================================================================================
 // Unable to get to this level of granularity using the wiringPi library. Function will not be
 // called by upper level functions
-    return 0;
+    return (0);
 
 #else
 //=================================================================================================
@@ -160,53 +1063,54 @@ uint8_t SPIPeriph::readDR(void) {
 #endif
 }
 
-void SPIPeriph::writeDR(uint8_t data) {
+uint8_t SPIPeriph::receiveToReadChk(void) {
 /**************************************************************************************************
- * Write to the SPI hardware
+ * Check the status of the Hardware Receive buffer (if not empty "data to read", output = 1)
  *************************************************************************************************/
 
 #if   defined(zz__MiSTM32Fx__zz)        // If the target device is an STM32Fxx from cubeMX then
 //=================================================================================================
-    _spi_handle_->Instance->DR = data;
+    if ( __HAL_SPI_GET_FLAG(_spi_handle_, SPI_FLAG_RXNE) != 0 )
+        return (1);
+    else
+        return (0);
 
 #elif defined(zz__MiSTM32Lx__zz)        // If the target device is an STM32Lxx from cubeMX then
 //=================================================================================================
-// STM32L4 uses a TXFIFO of 32bits (4 x 8bits), this function will only work if the hardware has
-// been configured to allow a read of only 8bits (or less)
-// To ensure only 8bits is transmitted, need to ensure that we cast the Data Register (DR) to
-// unsigned 8bits, hence the initial casing
-    *(uint8_t *)&_spi_handle_->Instance->DR = data;
+    if ( __HAL_SPI_GET_FLAG(_spi_handle_, SPI_FLAG_RXNE) != 0 )
+        return (1);
+    else
+        return (0);
 
 #elif defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
 //=================================================================================================
 // Unable to get to this level of granularity using the wiringPi library. Function will not be
 // called by upper level functions
+    return (0);
 
 #else
 //=================================================================================================
-// Unable to get to this level of granularity using the wiringPi library. Function will not be
-// called by upper level functions
+
 #endif
 }
 
-uint8_t SPIPeriph::transmitEmptyChk(void) {
+uint8_t SPIPeriph::transmitFIFOLvl(void) {
 /**************************************************************************************************
- * Check the status of the Hardware Transmit buffer (if empty, output = 1)
+ * Check the level of the Hardware Transmit FIFO, in quarters (0 = empty, 1 = 1/4, 2 = 1/2,
+ * 3 = full) - "FTLVL"
  *************************************************************************************************/
 
 #if   defined(zz__MiSTM32Fx__zz)        // If the target device is an STM32Fxx from cubeMX then
 //=================================================================================================
+// STM32F has no TXFIFO, so indicate full if the transmit buffer is not empty
     if ( __HAL_SPI_GET_FLAG(_spi_handle_, SPI_FLAG_TXE) != 0 )
-        return (1);
-    else
         return (0);
+    else
+        return (SPIPe_FIFOFull);
 
 #elif defined(zz__MiSTM32Lx__zz)        // If the target device is an STM32Lxx from cubeMX then
 //=================================================================================================
-    if ( __HAL_SPI_GET_FLAG(_spi_handle_, SPI_FLAG_TXE) != 0 )
-        return (1);
-    else
-        return (0);
+    return ( (uint8_t) ((_spi_handle_->Instance->SR & SPI_SR_FTLVL) >> SPI_SR_FTLVL_Pos) );
 
 #elif defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
 //=================================================================================================
@@ -220,13 +1124,15 @@ uint8_t SPIPeriph::transmitEmptyChk(void) {
 #endif
 }
 
-uint8_t SPIPeriph::receiveToReadChk(void) {
+uint8_t SPIPeriph::receiveFIFOLvl(void) {
 /**************************************************************************************************
- * Check the status of the Hardware Receive buffer (if not empty "data to read", output = 1)
+ * Check the level of the Hardware Receive FIFO, in quarters (0 = empty, 1 = 1/4, 2 = 1/2,
+ * 3 = full) - "FRLVL"
  *************************************************************************************************/
 
 #if   defined(zz__MiSTM32Fx__zz)        // If the target device is an STM32Fxx from cubeMX then
 //=================================================================================================
+// STM32F has no RXFIFO, so indicate 1/4 if there is data to read
     if ( __HAL_SPI_GET_FLAG(_spi_handle_, SPI_FLAG_RXNE) != 0 )
         return (1);
     else
@@ -234,10 +1140,7 @@ uint8_t SPIPeriph::receiveToReadChk(void) {
 
 #elif defined(zz__MiSTM32Lx__zz)        // If the target device is an STM32Lxx from cubeMX then
 //=================================================================================================
-    if ( __HAL_SPI_GET_FLAG(_spi_handle_, SPI_FLAG_RXNE) != 0 )
-        return (1);
-    else
-        return (0);
+    return ( (uint8_t) ((_spi_handle_->Instance->SR & SPI_SR_FRLVL) >> SPI_SR_FRLVL_Pos) );
 
 #elif defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
 //=================================================================================================
@@ -501,6 +1404,7 @@ SPIPeriph::CSHandle SPIPeriph::hardwareCS(void) {
 
     temp_struct.Type  = CSHandle::CSType::kHardware_Managed;    // Indicate that SPI device is
                                                                 // hardware managed
+    temp_struct.Config  = deviceConfig(__null);         // Link bus configuration of device
     return (temp_struct);                               // Return build structure
 }
 
@@ -514,6 +1418,7 @@ SPIPeriph::CSHandle SPIPeriph::softwareGPIO(GPIO *CS) {
     temp_struct.GPIO_CS  = CS;                          // Link input Chip Select to struct
     temp_struct.Type  = CSHandle::CSType::kSoftware_GPIO;   // Indicate that SPI device is software
                                                             // managed
+    temp_struct.Config  = deviceConfig(CS);             // Link bus configuration of device
     return (temp_struct);                               // Return build structure
 }
 
@@ -527,77 +1432,573 @@ void SPIPeriph::chipSelectHandle(CSHandle selection, CSSelection Mode) {
         if (Mode == CSSelection::kSelect)                   // If Mode is "Select"
             selection.GPIO_CS->setValue(GPIO::kLow);        // Pull the GPIO "LOW"
 
-        else                                                // If Mode is "DeSelect"
-            selection.GPIO_CS->setValue(GPIO::kHigh);       // Pull the GPIO "HIGH"
-    }
-    // Hardware Managed doesn't require any software interaction. Therefore doesn't do anything
-    // is selected.
+        else                                                // If Mode is "DeSelect"
+            selection.GPIO_CS->setValue(GPIO::kHigh);       // Pull the GPIO "HIGH"
+    }
+    // Hardware Managed doesn't require any software interaction. Therefore doesn't do anything
+    // is selected.
+}
+
+SPIPeriph::Form SPIPeriph::genericForm(CSHandle devLoc, uint16_t size,
+                                       volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag) {
+/**************************************************************************************************
+ * Generate a SPIForm request, based upon the generic information provided as input.
+ *************************************************************************************************/
+    Form request_form = { 0 };                  // Generate the "Form" variable to provide as 
+                                                // output
+
+    request_form.devLoc          = devLoc;      // Populate form with input data
+    request_form.size            = size;        //
+    request_form.Width           = DataWidth::k8bit;    // Default to 8bit data
+
+    // Indications used for source functionality to get status of requested communication
+    request_form.Flt             = fltReturn;   // Populate return fault flag
+    request_form.Cmplt           = cmpFlag;     // Populate complete communication indication
+
+    return (request_form);
+}
+
+uint8_t SPIPeriph::chipSelectMatch(CSHandle first, CSHandle second) {
+/**************************************************************************************************
+ * Check if both Chip Select handles select the same device (1 = same device).
+ *************************************************************************************************/
+    if (first.Type != second.Type)                          // If different types, then are not
+        return (0);                                         // the same device
+
+    if (first.Type == CSHandle::CSType::kSoftware_GPIO)     // If software GPIO, then needs to be
+        return ( (first.GPIO_CS == second.GPIO_CS) ? 1 : 0 );   // the same GPIO
+
+    return (1);                 // Only one hardware managed Chip Select, so is the same device
+}
+
+SPIPeriph::DevConfig SPIPeriph::deviceConfig(GPIO *CS) {
+/**************************************************************************************************
+ * Bus configuration of the device selected by "CS" (__null for hardware managed Chip Select), as
+ * per ".configDevice". If the device has not been configured, then the default is returned.
+ *************************************************************************************************/
+    uint8_t i = 0;                              // Variable for looping
+
+    for (i = 0; i != _dev_count_; i++) {
+        if (_dev_gpio_[i] == CS)
+            return (_dev_config_[i]);
+    }
+
+    return (_default_config_);
+}
+
+uint8_t SPIPeriph::configMatch(DevConfig first, DevConfig second) {
+/**************************************************************************************************
+ * Check if both bus configurations are the same, such that the hardware doesn't need to be
+ * reconfigured (1 = same).
+ * For RaspberryPi, speed is stated per transfer - so is not checked.
+ *************************************************************************************************/
+    if ( (first.Mode != second.Mode) || (first.Order != second.Order) )
+        return (0);
+
+#if   defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
+//=================================================================================================
+    return (1);
+
+#else
+//=================================================================================================
+    return ( (first.Speed == second.Speed) ? 1 : 0 );
+
+#endif
+}
+
+void SPIPeriph::formW8bitArray(Form *RequestForm, uint8_t *TxData, uint8_t *RxData) {
+/**************************************************************************************************
+ * Link input 8bit array pointer(s) to the provided SPI Request Form.
+ *************************************************************************************************/
+    RequestForm->TxBuff     = TxData;           // Pass Transmit Buffer to SPIForm
+
+    RequestForm->RxBuff     = RxData;           // Pass Transmit Buffer to SPIForm
+
+    RequestForm->Width      = DataWidth::k8bit;
+}
+
+void SPIPeriph::formW16bitArray(Form *RequestForm, uint16_t *TxData, uint16_t *RxData) {
+/**************************************************************************************************
+ * Link input 16bit array pointer(s) to the provided SPI Request Form. Each entry is a single
+ * 16bit frame.
+ *************************************************************************************************/
+    RequestForm->TxBuff     = (uint8_t *) TxData;   // Pass Transmit Buffer to SPIForm
+
+    RequestForm->RxBuff     = (uint8_t *) RxData;   // Pass Transmit Buffer to SPIForm
+
+    RequestForm->Width      = DataWidth::k16bit;
+}
+
+void SPIPeriph::formW32bitArray(Form *RequestForm, uint32_t *TxData, uint32_t *RxData) {
+/**************************************************************************************************
+ * Link input 32bit array pointer(s) to the provided SPI Request Form. Each entry is a single
+ * 32bit frame (RaspberryPi only).
+ *************************************************************************************************/
+    RequestForm->TxBuff     = (uint8_t *) TxData;   // Pass Transmit Buffer to SPIForm
+
+    RequestForm->RxBuff     = (uint8_t *) RxData;   // Pass Transmit Buffer to SPIForm
+
+    RequestForm->Width      = DataWidth::k32bit;
+}
+
+uint32_t SPIPeriph::timeStamp(void) {
+/**************************************************************************************************
+ * Return the current time, used to determine how long SPI Request Forms wait within the queue.
+ *      STM32       - Core clock cycles (DWT cycle counter, needs to be enabled outside of class)
+ *      RaspberryPi - Nanoseconds (wraps every ~4.3s, only differences are used)
+ *************************************************************************************************/
+#if ( defined(zz__MiSTM32Fx__zz) || defined(zz__MiSTM32Lx__zz)  )
+// If the target device is either STM32Fxx or STM32Lxx from cubeMX then ...
+//=================================================================================================
+    return (DWT->CYCCNT);
+
+#elif defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
+//=================================================================================================
+    struct timespec time_now;
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &time_now);
+
+    return ( (uint32_t) ((uint64_t)time_now.tv_sec * 1000000000ULL + time_now.tv_nsec) );
+
+#else
+//=================================================================================================
+    return (0);
+
+#endif
+}
+
+GenBuffer<SPIPeriph::Form> *SPIPeriph::formQueue(FormPriority priority) {
+/**************************************************************************************************
+ * Return the queue for the requested priority. If the "kHigh"/"kLow" queue has not been linked,
+ * then the "kNormal" queue is returned.
+ *************************************************************************************************/
+    if      ( (priority == FormPriority::kHigh) && (_high_queue_.length != 0) )
+        return ( &(_high_queue_) );
+
+    else if ( (priority == FormPriority::kLow)  && (_low_queue_.length  != 0) )
+        return ( &(_low_queue_) );
+
+    return ( &(_form_queue_) );
+}
+
+uint8_t SPIPeriph::queueLinked(uint8_t priority) {
+/**************************************************************************************************
+ * Check if the queue of "priority" has been linked - "kNormal" is always linked, "kHigh"/"kLow"
+ * only once linked via ".linkPriorityQueue" (otherwise their forms are within "kNormal").
+ * Returns 1 if linked, otherwise 0.
+ *************************************************************************************************/
+    if ( (priority == FormPriority::kNormal) ||
+         (formQueue((FormPriority) priority) != &(_form_queue_)) )
+        return (1);
+
+    return (0);
+}
+
+uint8_t SPIPeriph::formSegments(Form *RequestForm, const Segment *TxSeg, uint8_t TxCnt,
+                                const Segment *RxSeg, uint8_t RxCnt) {
+/**************************************************************************************************
+ * Link the scatter-gather segment lists to the provided SPI Request Form (8bit packets). The
+ * size of the form is the total of the transmit segments, which needs to equal the total of the
+ * receive segments.
+ * Returns 1 if the lists are valid, otherwise 0.
+ *************************************************************************************************/
+    uint32_t    tx_total = 0, rx_total = 0;     // Total packets within each list
+    uint8_t     i = 0;                          // Variable for looping
+
+    for (i = 0; i != TxCnt; i++)                tx_total += TxSeg[i].size;
+    for (i = 0; i != RxCnt; i++)                rx_total += RxSeg[i].size;
+
+    RequestForm->TxSeg      = TxSeg;            // Pass segment lists to SPIForm
+    RequestForm->TxSegCnt   = TxCnt;
+    RequestForm->TxSegRem   = 0;                // Segment is taken on first packet
+    RequestForm->TxBuff     = __null;
+
+    RequestForm->RxSeg      = RxSeg;
+    RequestForm->RxSegCnt   = RxCnt;
+    RequestForm->RxSegRem   = 0;
+    RequestForm->RxBuff     = __null;
+
+    RequestForm->Width      = DataWidth::k8bit;
+    RequestForm->size       = (uint16_t) tx_total;
+
+    if ( (tx_total != rx_total) || (tx_total == 0) || (tx_total > 0xFFFF) )
+        return (0);
+
+    return (1);
+}
+
+void SPIPeriph::formCallback(Form *RequestForm, CmpltCallback callback, void *context) {
+/**************************************************************************************************
+ * Link the completion callback (and its context) to the provided SPI Request Form.
+ *************************************************************************************************/
+    RequestForm->Callback   = callback;
+    RequestForm->Context    = context;
+}
+
+void SPIPeriph::cmpltCallback(Form *RequestForm) {
+/**************************************************************************************************
+ * Call the completion callback of the SPI Request Form, if one has been linked.
+ *************************************************************************************************/
+    if (RequestForm->Callback != __null)
+        RequestForm->Callback(RequestForm->Context);
+}
+
+void SPIPeriph::queueForm(Form *RequestForm, FormPriority priority) {
+/**************************************************************************************************
+ * Add the SPI Request form into the queue of the requested priority, with the time it was added
+ * (for the queue wait).
+ * For RaspberryPi, the queue is locked whilst the form is added, as the interrupt emulation
+ * thread may be taking forms from the queue at the same time.
+ * For STM32, 32bit forms are not supported by the hardware, so the form's fault flag is set to
+ * "kData_Size", and is not added to the queue.
+ *************************************************************************************************/
+    RequestForm->Queued = timeStamp();          // Capture time form was added to queue
+
+#if ( defined(zz__MiSTM32Fx__zz) || defined(zz__MiSTM32Lx__zz)  )
+// If the target device is either STM32Fxx or STM32Lxx from cubeMX then ...
+//=================================================================================================
+    if (RequestForm->Width == DataWidth::k32bit) {
+        *(RequestForm->Flt) = DevFlt::kData_Size;
+        cmpltCallback(RequestForm);
+        return;
+    }
+
+    formQueue(priority)->inputWrite(*RequestForm);
+
+#elif defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
+//=================================================================================================
+    pthread_mutex_lock(&_queue_lock_);
+
+    formQueue(priority)->inputWrite(*RequestForm);
+
+    pthread_mutex_unlock(&_queue_lock_);
+
+#else
+//=================================================================================================
+    formQueue(priority)->inputWrite(*RequestForm);
+
+#endif
+}
+
+uint8_t SPIPeriph::selectQueue(void) {
+/**************************************************************************************************
+ * Determine which queue the next SPI Request Form is to be taken from.
+ * Any lower priority queue which has had "SPIPe_AgeLimit" forms taken from higher priority
+ * queues, whilst it has been waiting, is selected first. Otherwise the highest priority queue
+ * with a form is selected.
+ * Priorities which have not been linked are skipped (their forms are within the "kNormal" queue),
+ * so the forms are taken/aged/timed as "kNormal".
+ * If all queues are empty, then "SPIPe_NumPriority" is returned.
+ *************************************************************************************************/
+    uint8_t i = 0;                              // Variable for looping
+
+    for (i = 0; i != SPIPe_NumPriority; i++) {  // Check for any queue which has aged
+        if ( (queueLinked(i) == 1) && (_age_count_[i] >= SPIPe_AgeLimit) &&
+             (formQueue((FormPriority) i)->state() != kGenBuffer_Empty) )
+            return (i);
+    }
+
+    for (i = 0; i != SPIPe_NumPriority; i++) {  // Otherwise take the highest priority
+        if ( (queueLinked(i) == 1) &&
+             (formQueue((FormPriority) i)->state() != kGenBuffer_Empty) )
+            return (i);
+    }
+
+    return (SPIPe_NumPriority);
+}
+
+void SPIPeriph::takeForm(uint8_t priority, Form *RequestForm) {
+/**************************************************************************************************
+ * Take the next SPI Request Form from the queue of "priority".
+ * Aging of this queue is cleared, and any lower priority queue with forms waiting is aged.
+ * Time the form has waited is then added to the queue wait for "priority".
+ *************************************************************************************************/
+    uint8_t     i    = 0;                       // Variable for looping
+
+    formQueue((FormPriority) priority)->outputRead(RequestForm);
+
+    _age_count_[priority] = 0;                  // Queue has been served, so clear aging
+    for (i = priority + 1; i < SPIPe_NumPriority; i++) {    // Age any lower priority queue
+        if ( (queueLinked(i) == 1) &&
+             (formQueue((FormPriority) i)->state() != kGenBuffer_Empty) &&
+             (_age_count_[i] != SPIPe_AgeLimit) )
+            _age_count_[i]++;
+    }
+
+    addWaitStat(&(QueueWait[priority]), timeStamp() - RequestForm->Queued);
+    // Add how long form has waited
+}
+
+SPIPeriph::DevFlt SPIPeriph::streamLink(const uint8_t *Command, uint16_t size, DataWidth width,
+                                        GenBuffer<uint8_t> *ReadArray) {
+/**************************************************************************************************
+ * Check and link the parameters of the stream - "Command" ("size" frames of "width") is repeated
+ * for each sample, with the reply put into "ReadArray".
+ * The 'GenBuffer' needs to be a whole number of samples (of at least 2), otherwise "kData_Size"
+ * is returned. If a stream is already running, then "kStream_Error" is returned.
+ * Doesn't start the stream.
+ *************************************************************************************************/
+    uint16_t bytes = size * (width / 8);            // Number of bytes within each sample
+
+    if (_stream_run_ == 1)                          // If stream already running, then exit
+        return ( Flt = DevFlt::kStream_Error );
+
+    if ( (Command == __null) || (ReadArray == __null) || (size == 0) ||
+         (ReadArray->length < (2 * bytes)) || ((ReadArray->length % bytes) != 0) )
+        return ( Flt = DevFlt::kData_Size );        // If buffer is not a whole number of samples
+
+    _stream_cmd_    = Command;
+    _stream_size_   = size;
+    _stream_width_  = width;
+    _stream_buff_   = ReadArray;
+
+    return (DevFlt::kNone);
+}
+
+uint16_t SPIPeriph::streamBytes(void) {
+/**************************************************************************************************
+ * Number of bytes within each stream sample.
+ *************************************************************************************************/
+    return ( _stream_size_ * (_stream_width_ / 8) );
+}
+
+void SPIPeriph::groupForm(uint8_t priority, DevConfig config) {
+/**************************************************************************************************
+ * If the next SPI Request Form of "priority" has a different bus configuration to "config", then
+ * check the following "SPIPe_GroupDepth" forms for one with the same bus configuration (and no
+ * fault), and bring it to the front of the queue - so the hardware does not need to be
+ * reconfigured.
+ * Forms skipped over have a different configuration (so are to different devices), therefore
+ * order of forms to the same device is kept.
+ * Once "SPIPe_GroupLimit" forms have been brought forward, the next form is left in order (so
+ * forms cannot be starved).
+ *************************************************************************************************/
+    GenBuffer<Form> *queue  = formQueue((FormPriority) priority);
+    Form            next_form;                  // Form within the queue
+    uint16_t        count   = queue->unreadCount(); // Number of forms within the queue
+    uint16_t        i       = 0;                // Variable for looping
+
+    if (count == 0)                             // If the queue is empty, then exit
+        return;
+
+    next_form = queue->readBuffer(queue->output_pointer);
+    if ( (configMatch(next_form.devLoc.Config, config) == 1) ||
+         (_group_count_ >= SPIPe_GroupLimit) ) {
+        _group_count_ = 0;                      // If same configuration, or limit has been
+        return;                                 // reached, then leave in order
+    }
+
+    if (count > (SPIPe_GroupDepth + 1))         // Limit the number of forms checked
+        count = SPIPe_GroupDepth + 1;
+
+    for (i = 1; i < count; i++) {
+        next_form = queue->readBuffer(queue->output_pointer + i);
+
+        if ( (configMatch(next_form.devLoc.Config, config) == 1) &&
+             (*(next_form.Flt) == SPIPeriph::DevFlt::kNone) ) {
+            queue->promoteEntry(i);             // If same configuration, bring to the front
+            _group_count_++;
+            GroupCnt++;
+            return;
+        }
+    }
+}
+
+void SPIPeriph::addWaitStat(WaitStats *stat, uint32_t wait) {
+/**************************************************************************************************
+ * Add the time "wait" (ticks) into the count, maximum, total and log2 histogram of "stat".
+ *************************************************************************************************/
+    uint8_t     bin  = 0;                       // Histogram bin of the wait
+
+    while ( (bin != (SPIPe_WaitBins - 1)) && ((wait >> bin) != 0) )
+        bin++;                                  // Determine the log2 bin
+
+    stat->Count++;
+    stat->Total += wait;
+    stat->Hist[bin]++;
+    if (wait > stat->Max)
+        stat->Max = wait;
+}
+
+void SPIPeriph::clearWaitStat(WaitStats *stat) {
+/**************************************************************************************************
+ * Clear the count, maximum, total and log2 histogram of "stat".
+ *************************************************************************************************/
+    uint8_t i = 0;                              // Variable for looping
+
+    stat->Count = 0;
+    stat->Max   = 0;
+    stat->Total = 0;
+    for (i = 0; i != SPIPe_WaitBins; i++)
+        stat->Hist[i] = 0;
+}
+
+#if defined(SPI_TRACE_ENABLE)           // If tracing of SPI Request Forms is enabled then
+//=================================================================================================
+void SPIPeriph::traceFormStart(Form *RequestForm) {
+/**************************************************************************************************
+ * Capture the time the SPI Request Form has started (device selected).
+ *************************************************************************************************/
+    RequestForm->Started = timeStamp();
+}
+
+void SPIPeriph::traceFormCmplt(Form *RequestForm, uint16_t count) {
+/**************************************************************************************************
+ * SPI Request Form has completed "count" packets. Add the time on the wire (from start), and the
+ * time from being queued into the trace histograms, and add the bytes transferred.
+ *************************************************************************************************/
+    uint32_t time_now = timeStamp();
+
+    addWaitStat(&(WireTime), time_now - RequestForm->Started);
+    addWaitStat(&(FormTime), time_now - RequestForm->Queued);
+
+    TraceBytes += (uint64_t)count * (RequestForm->Width / 8);
 }
 
-SPIPeriph::Form SPIPeriph::genericForm(CSHandle devLoc, uint16_t size,
-                                       volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag) {
+uint32_t SPIPeriph::traceThroughput(void) {
 /**************************************************************************************************
- * Generate a SPIForm request, based upon the generic information provided as input.
+ * Return the bytes per second transferred since the previous call of this function (or
+ * ".resetTrace").
+ * As the ticks of ".timeStamp" wrap, needs to be called at least every ~4s for RaspberryPi
+ * (nanoseconds), or every 2^32 core clock cycles for STM32.
  *************************************************************************************************/
-    Form request_form = { 0 };                  // Generate the "Form" variable to provide as 
-                                                // output
+    uint32_t    time_now    = timeStamp();
+    uint64_t    bytes_now   = TraceBytes;
+    uint32_t    ticks       = time_now - _trace_time_;
+    uint64_t    bytes       = bytes_now - _trace_bytes_;
 
-    request_form.devLoc          = devLoc;      // Populate form with input data
-    request_form.size            = size;        //
+    _trace_time_  = time_now;
+    _trace_bytes_ = bytes_now;
 
-    // Indications used for source functionality to get status of requested communication
-    request_form.Flt             = fltReturn;   // Populate return fault flag
-    request_form.Cmplt           = cmpFlag;     // Populate complete communication indication
+    if (ticks == 0)                             // If no time has passed, then exit
+        return (0);
 
-    return (request_form);
+#if ( defined(zz__MiSTM32Fx__zz) || defined(zz__MiSTM32Lx__zz)  )
+// If the target device is either STM32Fxx or STM32Lxx from cubeMX then ...
+//=================================================================================================
+    return ( (uint32_t) ((bytes * SystemCoreClock) / ticks) );
+
+#else
+//=================================================================================================
+    return ( (uint32_t) ((bytes * 1000000000ULL) / ticks) );
+
+#endif
 }
 
-void SPIPeriph::formW8bitArray(Form *RequestForm, uint8_t *TxData, uint8_t *RxData) {
+void SPIPeriph::resetTrace(void) {
 /**************************************************************************************************
- * Link input 8bit array pointer(s) to the provided SPI Request Form.
+ * Clear the trace histograms, and byte count.
  *************************************************************************************************/
-    RequestForm->TxBuff     = TxData;           // Pass Transmit Buffer to SPIForm
+    clearWaitStat(&(WireTime));
+    clearWaitStat(&(FormTime));
 
-    RequestForm->RxBuff     = RxData;           // Pass Transmit Buffer to SPIForm
+    TraceBytes      = 0;
+    _trace_bytes_   = 0;
+    _trace_time_    = timeStamp();
 }
 
-uint8_t SPIPeriph::getFormWriteData(Form *RequestForm) {
+#endif
+
+uint16_t SPIPeriph::getFormWriteData(Form *RequestForm) {
 /**************************************************************************************************
  * Retrieve the next data point to write to external device from the selected SPI Request form
+ * (a whole 8bit or 16bit frame, as per the form's data width)
+ * For scatter-gather forms, moves onto the next segment once the current one is complete. If
+ * there is no data (__null segment), 0 is transmitted.
  *************************************************************************************************/
-    uint8_t temp_val = 0;       // Temporary variable to store data value
+    uint16_t temp_val = 0;      // Temporary variable to store data value
+
+    if (RequestForm->TxSeg != __null) {         // If scatter-gather form
+        while ( (RequestForm->TxSegRem == 0) && (RequestForm->TxSegCnt != 0) ) {
+            RequestForm->TxBuff     = RequestForm->TxSeg->Buff;     // Move to next segment
+            RequestForm->TxSegRem   = RequestForm->TxSeg->size;
+            RequestForm->TxSeg++;
+            RequestForm->TxSegCnt--;
+        }
+
+        if (RequestForm->TxSegRem == 0)         // If beyond the end of the list, then transmit 0
+            return (0);
+
+        RequestForm->TxSegRem--;
+    }
+
+    if (RequestForm->TxBuff == __null)          // If no data, then transmit 0
+        return (0);
 
-    temp_val = *(RequestForm->TxBuff);          // Retrieve data from array
-    RequestForm->TxBuff     += sizeof(uint8_t); // Increment array pointer
+    if (RequestForm->Width == DataWidth::k16bit) {
+        temp_val = *((uint16_t *)RequestForm->TxBuff);  // Retrieve data from array
+        RequestForm->TxBuff += sizeof(uint16_t);        // Increment array pointer
+    } else {
+        temp_val = *(RequestForm->TxBuff);              // Retrieve data from array
+        RequestForm->TxBuff += sizeof(uint8_t);         // Increment array pointer
+    }
 
     return (temp_val);          // Return value outside of function
 }
 
-void SPIPeriph::putFormReadData(Form *RequestForm, uint8_t readdata) {
+void SPIPeriph::putFormReadData(Form *RequestForm, uint16_t readdata) {
 /**************************************************************************************************
  * Data read from the SPI external device is copied into the requested source location, as per
- * the SPI Request form
+ * the SPI Request form (a whole 8bit or 16bit frame, as per the form's data width)
+ * For scatter-gather forms, moves onto the next segment once the current one is complete. If
+ * there is no location (__null segment), the data is discarded.
  *************************************************************************************************/
-    *(RequestForm->RxBuff)  = readdata;         // Put data into array
-    RequestForm->RxBuff     += sizeof(uint8_t); // Increment array pointer
+    if (RequestForm->RxSeg != __null) {         // If scatter-gather form
+        while ( (RequestForm->RxSegRem == 0) && (RequestForm->RxSegCnt != 0) ) {
+            RequestForm->RxBuff     = RequestForm->RxSeg->Buff;     // Move to next segment
+            RequestForm->RxSegRem   = RequestForm->RxSeg->size;
+            RequestForm->RxSeg++;
+            RequestForm->RxSegCnt--;
+        }
+
+        if (RequestForm->RxSegRem == 0)         // If beyond the end of the list, then discard
+            return;
+
+        RequestForm->RxSegRem--;
+    }
+
+    if (RequestForm->RxBuff == __null)          // If no location, then discard data
+        return;
+
+    if (RequestForm->Width == DataWidth::k16bit) {
+        *((uint16_t *)RequestForm->RxBuff) = readdata;  // Put data into array
+        RequestForm->RxBuff += sizeof(uint16_t);        // Increment array pointer
+    } else {
+        *(RequestForm->RxBuff) = (uint8_t) readdata;    // Put data into array
+        RequestForm->RxBuff += sizeof(uint8_t);         // Increment array pointer
+    }
 }
 
-SPIPeriph::DevFlt SPIPeriph::poleMasterTransfer(uint8_t *wData, uint8_t *rData, uint16_t size) {
+SPIPeriph::DevFlt SPIPeriph::poleTransfer(DevConfig config, const uint8_t *wData, uint8_t *rData,
+                                          uint16_t size) {
 /**************************************************************************************************
  * Function will setup a communication link with the external device; selected by the Chip Select
  * Pin. The Master being this local device.
- *   This is an OVERLOADED function, and forms the bases of the poling transmission for SPI. This
- *   version doesn't pull down any pins within software. Relies upon a hardware managed CS.
+ *   This forms the bases of the poling transmission for SPI (see ".poleMasterTransfer"), with the
+ *   bus configured as per "config". Doesn't pull down any pins within software.
+ *
+ * If "rData" is __null, then the transfer is transmit only - data read back from the device is
+ * discarded.
+ * For RaspberryPi, waits for any submission of the queue by the interrupt emulation thread to
+ * complete (bus lock), so the driver calls/bus configuration are not interleaved.
  *************************************************************************************************/
-    if (wData == __null || rData == __null || size == 0)    // If no data has been requested
+    if (wData == __null || size == 0)                       // If no data has been requested
         return ( Flt = DevFlt::kData_Size );                // to be set return error
 
+#if   defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
+//=================================================================================================
+    pthread_mutex_lock(&_bus_lock_);    // Lock SPI bus (waits for interrupt emulation thread)
+
+#endif
+
     // Indicate that the bus is not free
-    CommState = CommLock::kCommunicating;       // Indicate bus is communicating
+    __atomic_store_n(&CommState, CommLock::kCommunicating, __ATOMIC_RELEASE);
 
 #if ( defined(zz__MiSTM32Fx__zz) || defined(zz__MiSTM32Lx__zz)  )
 // If the target device is either STM32Fxx or STM32Lxx from cubeMX then ...
 //=================================================================================================
+    configBus(config);                  // Set hardware to the configuration of device
+    configDataWidth(DataWidth::k8bit);  // Polling transfers are 8bit
     enable();                       // Ensure that the device has been enabled
 
     SET_BIT(_spi_handle_->Instance->CR2, SPI_RXFIFO_THRESHOLD_QF);
@@ -636,11 +2037,16 @@ SPIPeriph::DevFlt SPIPeriph::poleMasterTransfer(uint8_t *wData, uint8_t *rData,
             }
         };
 
-        *rData = readDR();          // Put data read from device back into array
+        if (rData != __null) {      // If read back data is requested
+            *rData = readDR();      // Put data read from device back into array
+            rData += sizeof(uint8_t);   // Increment pointer for read array by the size of the
+                                        // data type.
+        }
+        else                        // If transmit only
+            readDR();               // Read data to clear the Receive buffer (discarded)
+
         wData += sizeof(uint8_t);   // Increment pointer for write array by the size of the data
                                     // type.
-        rData += sizeof(uint8_t);   // Increment pointer for read array by the size of the data
-                                    // type.
         size--;                     // Decrement count
     }
 
@@ -651,14 +2057,26 @@ SPIPeriph::DevFlt SPIPeriph::poleMasterTransfer(uint8_t *wData, uint8_t *rData,
 
 #elif defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
 //=================================================================================================
-    uint16_t i = 0;
-
-    for (i = 0; i != size; i++)         // Cycle through the data to be written
-        rData[i] = wData[i];            // and copy into the read data
-
-
-    wiringPiSPIDataRW(_spi_channel_, rData, (int)size);
-        // Using wiringPiSPI function, transfer data from RaspberryPi to selected device
+    struct spi_ioc_transfer xfer;       // Transfer to submit to driver
+    memset(&xfer, 0, sizeof(xfer));
+
+    xfer.tx_buf         = (unsigned long) wData;    // Full duplex transfer, straight from/to the
+    xfer.rx_buf         = (unsigned long) rData;    // source arrays (driver discards read data if
+                                                    // "rData" is __null)
+    xfer.len            = size;
+    xfer.speed_hz       = config.Speed;
+    xfer.bits_per_word  = 8;
+
+    configBus(config);                  // Set mode/bit order of device
+
+    if ( (configMatch(config, _bus_config_) == 0) ||
+         (_ioctl_(_spi_handle_, SPI_IOC_MESSAGE(1), &xfer) < 0) ) {
+        // Using spidev driver (with mode/bit order of device), transfer data from RaspberryPi to
+        // selected device
+        __atomic_store_n(&CommState, CommLock::kFree, __ATOMIC_RELEASE);
+        pthread_mutex_unlock(&_bus_lock_);          // Indicate bus is free
+        return ( Flt = DevFlt::kDriver_Error );     // Indicate fault, and exit
+    }
 
 #else
 //=================================================================================================
@@ -666,14 +2084,34 @@ SPIPeriph::DevFlt SPIPeriph::poleMasterTransfer(uint8_t *wData, uint8_t *rData,
 #endif
 
     // Indicate that the bus is free
-    CommState = CommLock::kFree;        // Indicate bus is free
+    __atomic_store_n(&CommState, CommLock::kFree, __ATOMIC_RELEASE);
+
+#if   defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
+//=================================================================================================
+    pthread_mutex_unlock(&_bus_lock_);  // Release SPI bus
+
+#endif
 
     return ( Flt = DevFlt::kNone );
 }
 
+SPIPeriph::DevFlt SPIPeriph::poleMasterTransfer(const uint8_t *wData, uint8_t *rData,
+                                                uint16_t size) {
+/**************************************************************************************************
+ * Function will setup a communication link with the external device; selected by the Chip Select
+ * Pin. The Master being this local device.
+ *   This is an OVERLOADED function, and forms the bases of the poling transmission for SPI. This
+ *   version doesn't pull down any pins within software. Relies upon a hardware managed CS (bus
+ *   configuration as per hardware managed Chip Select).
+ *
+ * If "rData" is __null, then the transfer is transmit only - data read back from the device is
+ * discarded.
+ *************************************************************************************************/
+    return ( poleTransfer(deviceConfig(__null), wData, rData, size) );
+}
 
 SPIPeriph::DevFlt SPIPeriph::poleMasterTransfer(GPIO *ChipSelect,
-                                        uint8_t *wData, uint8_t *rData, uint16_t size) {
+                                        const uint8_t *wData, uint8_t *rData, uint16_t size) {
 /**************************************************************************************************
  * Second version of the OVERLOADED function.
  * This version utilises the basic version, however prior to calling this, pulls down the input
@@ -683,8 +2121,8 @@ SPIPeriph::DevFlt SPIPeriph::poleMasterTransfer(GPIO *ChipSelect,
 
     chipSelectHandle(softwareGPIO(ChipSelect), CSSelection::kSelect);
 
-    return_value = poleMasterTransfer(wData, rData, size);
-        // Use private function to transfer data
+    return_value = poleTransfer(deviceConfig(ChipSelect), wData, rData, size);
+        // Use private function to transfer data (bus configuration as per device)
 
     chipSelectHandle(softwareGPIO(ChipSelect), CSSelection::kDeselect);
 
@@ -692,7 +2130,7 @@ SPIPeriph::DevFlt SPIPeriph::poleMasterTransfer(GPIO *ChipSelect,
 }
 
 SPIPeriph::DevFlt SPIPeriph::poleMasterTransfer(DeMux *DeMuxCS, uint8_t CSNum,
-                               uint8_t *wData, uint8_t *rData, uint16_t size) {
+                               const uint8_t *wData, uint8_t *rData, uint16_t size) {
 /**************************************************************************************************
  * Third version of the OVERLOADED function.
  * This version is able to select the device via the DeMux class (DeMuxCS), along with the
@@ -703,6 +2141,7 @@ SPIPeriph::DevFlt SPIPeriph::poleMasterTransfer(DeMux *DeMuxCS, uint8_t CSNum,
  * This specific pin will not have been provided to the DeMux class, as is managed by the SPI
  * peripheral.
  * Once transmission has finished, the Demultiplexor will be disabled
+ * Bus configuration is as per the hardware managed Chip Select.
  *************************************************************************************************/
     DevFlt return_value = DevFlt::kInitialised;     // Variable to store output of RWTransfer
 
@@ -811,7 +2250,9 @@ void SPIPeriph::configBusErroIT(InterState intr) {
 }
 
 void SPIPeriph::intMasterTransfer(uint16_t size, uint8_t *TxBuff, uint8_t *RxBuff,
-                                  volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag) {
+                                  volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag,
+                                  FormPriority priority,
+                                  CmpltCallback callback, void *context) {
 /**************************************************************************************************
  * Function will be called to start off a new SPI communication.
  * Two arrays are provided which will contain the data to transmit, and the location to store
@@ -820,12 +2261,13 @@ void SPIPeriph::intMasterTransfer(uint16_t size, uint8_t *TxBuff, uint8_t *RxBuf
  *   being managed by the hardware.
  *************************************************************************************************/
     Form request_form = genericForm(hardwareCS(), size, fltReturn, cmpFlag);
+    formCallback(&request_form, callback, context);
     // Build the generic parts of the SPI Request Form
 
     formW8bitArray(&request_form, TxBuff, RxBuff);
     // Populate with specific entries for the data type provided as input
 
-    _form_queue_.inputWrite(request_form);
+    queueForm(&request_form, priority);
     // Add to queue
 
     // Trigger interrupt(s)
@@ -833,7 +2275,9 @@ void SPIPeriph::intMasterTransfer(uint16_t size, uint8_t *TxBuff, uint8_t *RxBuf
 }
 
 void SPIPeriph::intMasterTransfer(GPIO *CS, uint16_t size, uint8_t *TxBuff, uint8_t *RxBuff,
-                                  volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag) {
+                                  volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag,
+                                  FormPriority priority,
+                                  CmpltCallback callback, void *context) {
 /**************************************************************************************************
  * Function will be called to start off a new SPI communication.
  * Two arrays are provided which will contain the data to transmit, and the location to store
@@ -842,53 +2286,385 @@ void SPIPeriph::intMasterTransfer(GPIO *CS, uint16_t size, uint8_t *TxBuff, uint
  *   This version populates the form, but states that the Chip select is managed by the software.
  *************************************************************************************************/
     Form request_form = genericForm(softwareGPIO(CS), size, fltReturn, cmpFlag);
+    formCallback(&request_form, callback, context);
 
     formW8bitArray(&request_form, TxBuff, RxBuff);
     // Populate with specific entries for the data type provided as input
 
-    _form_queue_.inputWrite(request_form);
+    queueForm(&request_form, priority);
+    // Add to queue
+
+    // Trigger interrupt(s)
+    startInterrupt();
+}
+
+void SPIPeriph::intMasterTransfer(uint16_t size, uint16_t *TxBuff, uint16_t *RxBuff,
+                                  volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag,
+                                  FormPriority priority,
+                                  CmpltCallback callback, void *context) {
+/**************************************************************************************************
+ * Function will be called to start off a new SPI communication.
+ * Two arrays are provided which will contain the data to transmit, and the location to store
+ * read back data.
+ *   Version of the OVERLOADED function for 16bit frames ("size" is the number of frames), with
+ *   the Chip select being managed by the hardware.
+ *************************************************************************************************/
+    Form request_form = genericForm(hardwareCS(), size, fltReturn, cmpFlag);
+    formCallback(&request_form, callback, context);
+
+    formW16bitArray(&request_form, TxBuff, RxBuff);
+    // Populate with specific entries for the data type provided as input
+
+    queueForm(&request_form, priority);
+    // Add to queue
+
+    // Trigger interrupt(s)
+    startInterrupt();
+}
+
+void SPIPeriph::intMasterTransfer(GPIO *CS, uint16_t size, uint16_t *TxBuff, uint16_t *RxBuff,
+                                  volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag,
+                                  FormPriority priority,
+                                  CmpltCallback callback, void *context) {
+/**************************************************************************************************
+ * Function will be called to start off a new SPI communication.
+ * Two arrays are provided which will contain the data to transmit, and the location to store
+ * read back data.
+ *   Version of the OVERLOADED function for 16bit frames ("size" is the number of frames), with
+ *   the Chip select being managed by the software.
+ *************************************************************************************************/
+    Form request_form = genericForm(softwareGPIO(CS), size, fltReturn, cmpFlag);
+    formCallback(&request_form, callback, context);
+
+    formW16bitArray(&request_form, TxBuff, RxBuff);
+    // Populate with specific entries for the data type provided as input
+
+    queueForm(&request_form, priority);
+    // Add to queue
+
+    // Trigger interrupt(s)
+    startInterrupt();
+}
+
+void SPIPeriph::intMasterTransfer(uint16_t size, uint32_t *TxBuff, uint32_t *RxBuff,
+                                  volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag,
+                                  FormPriority priority,
+                                  CmpltCallback callback, void *context) {
+/**************************************************************************************************
+ * Function will be called to start off a new SPI communication.
+ * Two arrays are provided which will contain the data to transmit, and the location to store
+ * read back data.
+ *   Version of the OVERLOADED function for 32bit frames ("size" is the number of frames), with
+ *   the Chip select being managed by the hardware.
+ *   32bit frames are only supported for RaspberryPi (STM32 will set "fltReturn" to "kData_Size")
+ *************************************************************************************************/
+    Form request_form = genericForm(hardwareCS(), size, fltReturn, cmpFlag);
+    formCallback(&request_form, callback, context);
+
+    formW32bitArray(&request_form, TxBuff, RxBuff);
+    // Populate with specific entries for the data type provided as input
+
+    queueForm(&request_form, priority);
+    // Add to queue
+
+    // Trigger interrupt(s)
+    startInterrupt();
+}
+
+void SPIPeriph::intMasterTransfer(GPIO *CS, uint16_t size, uint32_t *TxBuff, uint32_t *RxBuff,
+                                  volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag,
+                                  FormPriority priority,
+                                  CmpltCallback callback, void *context) {
+/**************************************************************************************************
+ * Function will be called to start off a new SPI communication.
+ * Two arrays are provided which will contain the data to transmit, and the location to store
+ * read back data.
+ *   Version of the OVERLOADED function for 32bit frames ("size" is the number of frames), with
+ *   the Chip select being managed by the software.
+ *   32bit frames are only supported for RaspberryPi (STM32 will set "fltReturn" to "kData_Size")
+ *************************************************************************************************/
+    Form request_form = genericForm(softwareGPIO(CS), size, fltReturn, cmpFlag);
+    formCallback(&request_form, callback, context);
+
+    formW32bitArray(&request_form, TxBuff, RxBuff);
+    // Populate with specific entries for the data type provided as input
+
+    queueForm(&request_form, priority);
+    // Add to queue
+
+    // Trigger interrupt(s)
+    startInterrupt();
+}
+
+void SPIPeriph::intMasterTransfer(const Segment *TxSeg, uint8_t TxCnt,
+                                  const Segment *RxSeg, uint8_t RxCnt,
+                                  volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag,
+                                  FormPriority priority,
+                                  CmpltCallback callback, void *context) {
+/**************************************************************************************************
+ * Function will be called to start off a new SPI communication.
+ * Two segment lists are provided which will contain the data to transmit, and the locations to
+ * store read back data (see ".formSegments").
+ *   Scatter-gather version of the OVERLOADED function, with the Chip select being managed by the
+ *   hardware.
+ *   If the lists do not have the same number of packets, then "fltReturn" is set to
+ *   "kData_Size" (not queued).
+ *************************************************************************************************/
+    Form request_form = genericForm(hardwareCS(), 0, fltReturn, cmpFlag);
+    formCallback(&request_form, callback, context);
+
+    if (formSegments(&request_form, TxSeg, TxCnt, RxSeg, RxCnt) == 0) {
+        *fltReturn = DevFlt::kData_Size;
+        cmpltCallback(&request_form);
+        return;
+    }
+
+    queueForm(&request_form, priority);
+    // Add to queue
+
+    // Trigger interrupt(s)
+    startInterrupt();
+}
+
+void SPIPeriph::intMasterTransfer(GPIO *CS, const Segment *TxSeg, uint8_t TxCnt,
+                                  const Segment *RxSeg, uint8_t RxCnt,
+                                  volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag,
+                                  FormPriority priority,
+                                  CmpltCallback callback, void *context) {
+/**************************************************************************************************
+ * Function will be called to start off a new SPI communication.
+ * Two segment lists are provided which will contain the data to transmit, and the locations to
+ * store read back data (see ".formSegments").
+ *   Scatter-gather version of the OVERLOADED function, with the Chip select being managed by the
+ *   software.
+ *   If the lists do not have the same number of packets, then "fltReturn" is set to
+ *   "kData_Size" (not queued).
+ *************************************************************************************************/
+    Form request_form = genericForm(softwareGPIO(CS), 0, fltReturn, cmpFlag);
+    formCallback(&request_form, callback, context);
+
+    if (formSegments(&request_form, TxSeg, TxCnt, RxSeg, RxCnt) == 0) {
+        *fltReturn = DevFlt::kData_Size;
+        cmpltCallback(&request_form);
+        return;
+    }
+
+    queueForm(&request_form, priority);
     // Add to queue
 
     // Trigger interrupt(s)
     startInterrupt();
 }
 
+SPIPeriph::DevFlt SPIPeriph::configDevice(GPIO *CS, uint32_t speed, SPIMode mode,
+                                          BitOrder order) {
+/**************************************************************************************************
+ * Set the bus configuration (speed, mode and bit order) for the device selected by "CS" (__null
+ * for the hardware managed Chip Select). If "speed" is 0, then the default speed is used.
+ * Speed is rounded down to the fastest the hardware can achieve (".clockSpeed").
+ * Only forms requested after this call use the configuration (is captured within the form).
+ * If "SPIPe_MaxDevices" devices have already been configured, returns "kDevice_Limit".
+ *************************************************************************************************/
+    uint8_t i = 0;                              // Variable for looping
+
+    for (i = 0; i != _dev_count_; i++) {        // Find the device (if already configured)
+        if (_dev_gpio_[i] == CS)
+            break;
+    }
+
+    if (i == SPIPe_MaxDevices)                  // If no space for a new device, then exit
+        return (DevFlt::kDevice_Limit);
+
+    if (speed == 0)                             // If no speed provided, then use the default
+        speed = _default_config_.Speed;
+
+    _dev_gpio_[i]           = CS;
+    _dev_config_[i].Speed   = clockSpeed(speed);
+    _dev_config_[i].Mode    = mode;
+    _dev_config_[i].Order   = order;
+
+    if (i == _dev_count_)                       // If a new device, then include
+        _dev_count_++;
+
+    return (DevFlt::kNone);
+}
+
+void SPIPeriph::linkPriorityQueue(FormPriority priority, Form *FormArray, uint16_t FormSize) {
+/**************************************************************************************************
+ * Link the SPI Request Form array to be used for the "kHigh" or "kLow" priority queue (the
+ * "kNormal" queue is provided to the constructor).
+ * To be called prior to any forms being requested at this priority.
+ *************************************************************************************************/
+    if      (priority == FormPriority::kHigh)
+        _high_queue_.create(FormArray, FormSize);
+
+    else if (priority == FormPriority::kLow)
+        _low_queue_.create(FormArray, FormSize);
+}
+
+void SPIPeriph::resetQueueWait(void) {
+/**************************************************************************************************
+ * Clear the time SPI Request Forms have waited within each of the priority queues.
+ *************************************************************************************************/
+    uint8_t i = 0;                              // Variable for looping
+
+    for (i = 0; i != SPIPe_NumPriority; i++) {
+        _age_count_[i]          = 0;
+
+        clearWaitStat(&(QueueWait[i]));
+    }
+}
+
 void SPIPeriph::startInterrupt(void) {
 /**************************************************************************************************
  * Function will be called to start off a new SPI communication if there is something in the
- * queue, and the bus is free.
+ * queue, and the bus is free. Forms are taken in priority order (see ".selectQueue"), preferring
+ * forms with the current bus configuration (see ".groupForm").
+ *
+ * For RaspberryPi, there are no interrupts - so the queue is drained through the spidev driver
+ * (in batches), before returning. Unless the interrupt emulation thread is running, in which case
+ * it is woken to drain the queue (function does not block).
  *************************************************************************************************/
-    if ( (CommState == CommLock::kFree) && (_form_queue_.state() != kGenBuffer_Empty) ) {
+#if   defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
+//=================================================================================================
+    uint64_t wake = 1;                          // Value to write to eventfd
+
+    if (__atomic_load_n(&_worker_run_, __ATOMIC_ACQUIRE) == 1) {
+        // If interrupt emulation thread is running, then wake it
+        if (write(_event_fd_, &wake, sizeof(wake)) != sizeof(wake))
+            Flt = DevFlt::kDriver_Error;
+    }
+    else if (__atomic_load_n(&CommState, __ATOMIC_ACQUIRE) == CommLock::kFree) {
+        // Otherwise if the SPI bus is free
+        pthread_mutex_lock(&_bus_lock_);        // Lock SPI bus (waits for polling transfer)
+        __atomic_store_n(&CommState, CommLock::kCommunicating, __ATOMIC_RELEASE);
+
+        while (transferBatch() != 0) {};        // Submit all forms within queue
+
+        __atomic_store_n(&CommState, CommLock::kFree, __ATOMIC_RELEASE);
+        pthread_mutex_unlock(&_bus_lock_);      // Indicate that SPI bus is now free
+    }
+
+#else
+//=================================================================================================
+    uint8_t priority = selectQueue();           // Determine queue to take next form from
+
+    if ( (CommState == CommLock::kFree) && (priority != SPIPe_NumPriority) ) {
         // If the I2C bus is free, and there is I2C request forms in the queue
-        _form_queue_.outputRead( &(_cur_form_) );       // Capture form request
+        groupForm(priority, _bus_config_);              // Prefer form for current configuration
+        takeForm(priority, &(_cur_form_));              // Capture form request
 
         // Check current form to see if a fault has already been detected - therefore any new
         // request is no longer valid
         while (  *(_cur_form_.Flt) != SPIPeriph::DevFlt::kNone  ) {
-            // If there is a fault in request form, check to see if there is a new request
-            if ( _form_queue_.state() == kGenBuffer_Empty ) {   // If buffer is empty, break out
+            // If there is a fault in request form, then it is complete (no transfer), check to
+            // see if there is a new request
+            cmpltCallback( &(_cur_form_) );
+            priority = selectQueue();
+            if ( priority == SPIPe_NumPriority ) {              // If buffer is empty, break out
                 disable();
                 return;
             }
             // If there is something in the queue, then make it current. Then re-check
-            _form_queue_.outputRead( &(_cur_form_) );           // Capture form request
+            groupForm(priority, _bus_config_);
+            takeForm(priority, &(_cur_form_));                  // Capture form request
         }
 
         CommState = CommLock::kCommunicating;   // Lock SPI bus
 
+        configBus(_cur_form_.devLoc.Config);    // Set hardware to the configuration of device
+        configDataWidth(_cur_form_.Width);      // Set hardware to the data width of the form
         enable();
 
         _cur_count_  = _cur_form_.size;
+        _tx_count_   = _cur_form_.size;
 
         chipSelectHandle(_cur_form_.devLoc, CSSelection::kSelect);
             // Select the specified device location as per SPI Request Form
 
-        configReceiveIT(InterState::kIT_Enable);    // Then enable Receive buffer full interrupt
-        configTransmtIT(InterState::kIT_Enable);    // Then enable Transmit Empty buffer interrupt
+#if defined(SPI_TRACE_ENABLE)           // If tracing of SPI Request Forms is enabled then
+//=================================================================================================
+        traceFormStart( &(_cur_form_) );
+#endif
+
+        startTransfer();                        // Start the transfer of the current form
     }
-    else if ( (CommState == CommLock::kFree) && (_form_queue_.state() == kGenBuffer_Empty) ) {
+    else if ( (CommState == CommLock::kFree) && (priority == SPIPe_NumPriority) ) {
         disable();
     }
+
+#endif
+}
+
+void SPIPeriph::startTransfer(void) {
+/**************************************************************************************************
+ * Start the transfer of the current SPI Request Form, with the device already selected. Enables
+ * the Receive/Transmit interrupts, such that ".handleIRQ" progresses the communication.
+ * Virtual, so that child classes can use other means of transfer (see "SPIDMAPeriph").
+ *************************************************************************************************/
+    configReceiveIT(InterState::kIT_Enable);    // Enable Receive buffer full interrupt
+    configTransmtIT(InterState::kIT_Enable);    // Enable Transmit Empty buffer interrupt
+}
+
+uint8_t SPIPeriph::coalesceForm(void) {
+/**************************************************************************************************
+ * If coalescing is enabled, check whether the next SPI Request Form (in priority order) is for
+ * the same Chip Select as the current form. If so, the current form is completed (complete flag
+ * updated), and the next form is made current - without deselecting the device, or disabling the
+ * interrupts.
+ * Returns 1 if the next form has been made current, otherwise 0 (no change made).
+ *************************************************************************************************/
+    uint8_t priority = 0;                       // Priority of queue to take next form from
+    Form    next_form;                          // Next form within the queue
+
+    if (_coalesce_ == Coalesce::kCoalesce_Off)  // If coalescing is not enabled, then exit
+        return (0);
+
+    priority = selectQueue();
+    if (priority == SPIPe_NumPriority)          // If there are no forms, then exit
+        return (0);
+
+    next_form = formQueue((FormPriority) priority)->readBuffer(
+                    formQueue((FormPriority) priority)->output_pointer);
+        // Check the next form, prior to removing from queue
+
+    if ( (chipSelectMatch(_cur_form_.devLoc, next_form.devLoc) == 0) ||
+         (*(next_form.Flt) != SPIPeriph::DevFlt::kNone) || (next_form.size == 0) ||
+         (next_form.Width != _cur_form_.Width) ||
+         (configMatch(next_form.devLoc.Config, _cur_form_.devLoc.Config) == 0) )
+        return (0);     // If different device, form already has a fault, no data, or different
+                        // data width/bus configuration (hardware cannot be changed whilst
+                        // selected) then exit
+
+#if defined(SPI_TRACE_ENABLE)           // If tracing of SPI Request Forms is enabled then
+//=================================================================================================
+    traceFormCmplt( &(_cur_form_), (_cur_form_.size - _cur_count_) );
+#endif
+
+    *(_cur_form_.Cmplt)  += (_cur_form_.size - _cur_count_);
+    // Indicate how many data points have been transfered (curCount should be 0)
+
+    cmpltCallback( &(_cur_form_) );             // Current form is complete
+
+    takeForm(priority, &(_cur_form_));          // Next form is now current
+    _cur_count_ = _cur_form_.size;
+    _tx_count_  = _cur_form_.size;
+
+#if defined(SPI_TRACE_ENABLE)           // If tracing of SPI Request Forms is enabled then
+//=================================================================================================
+    traceFormStart( &(_cur_form_) );
+#endif
+
+    CoalesceCnt++;
+
+    return (1);
+}
+
+void SPIPeriph::configCoalesce(Coalesce state) {
+/**************************************************************************************************
+ * Enable/Disable coalescing of consecutive SPI Request Forms to the same Chip Select.
+ *************************************************************************************************/
+    _coalesce_ = state;
 }
 
 void SPIPeriph::intReqFormCmplt(void) {
@@ -897,7 +2673,13 @@ void SPIPeriph::intReqFormCmplt(void) {
  * Will then de-select the active SPI device.
  * Indicate that the SPI Device is now free for any new communication
  * Disables the Receive/Transmit Interrupts
+ * Calls the completion callback of the form (if linked)
  *************************************************************************************************/
+#if defined(SPI_TRACE_ENABLE)           // If tracing of SPI Request Forms is enabled then
+//=================================================================================================
+    traceFormCmplt( &(_cur_form_), (_cur_form_.size - _cur_count_) );
+#endif
+
     *(_cur_form_.Cmplt)  += (_cur_form_.size - _cur_count_);
     // Indicate how many data points have been transfered (curCount should be 0)
 
@@ -908,6 +2690,10 @@ void SPIPeriph::intReqFormCmplt(void) {
     CommState = CommLock::kFree;
     configReceiveIT(InterState::kIT_Disable);   // Disable Receive buffer full interrupt
     configTransmtIT(InterState::kIT_Disable);   // Disable Transmit empty buffer interrupt
+
+    cmpltCallback( &(_cur_form_) );             // Form is complete (or faulted), so call the
+                                                // completion callback (bus is free, so can
+                                                // request a new form)
 }
 
 void SPIPeriph::handleIRQ(void) {
@@ -918,8 +2704,8 @@ void SPIPeriph::handleIRQ(void) {
  * The enabling of the interrupt for embedded devices (STM32) is done by enabling them via the
  * STM32cube GUI, and then in the main loop, enabling the required interrupts.
  * Then place this Interrupt routine handler within the function call for the interrupt vector.
- * For the Raspberry Pi, it involves creating a separate thread to handle the interrupts on a
- * periodic bases - essentially emulating the interrupt vector triggered from embedded devices.
+ * For the Raspberry Pi, the interrupt vector is emulated by a separate thread (see
+ * ".startWorker"), which submits the queue to the spidev driver - so this function is not used.
  *
  * Function will go each of the status indicators which can trigger and interrupt, and see which
  * ones are enabled. If both a status event has occured, and the interrupt is enabled, then this
@@ -931,14 +2717,18 @@ void SPIPeriph::handleIRQ(void) {
  *            If this the data to be added to the hardware queue is the last data point to
  *            transmit, then disable the interrupt.
  *            >> NOTE <<
- *              For the STM32L, so as to support single 8bit transmission, this interrupt is
- *              disabled everytime data is added.
+ *              For the STM32L, the TXFIFO is filled (".fillTransmitFIFO"), limited so that the
+ *              RXFIFO cannot overrun. The interrupt is disabled once the limit is reached, with
+ *              the TXFIFO then being refilled from the Receive interrupt.
  *
  *      Receive Buffer full (not empty)
- *          - Data is to be added to the source location requested as per Request Form. If this is
- *            the last data point. Then the current target SPI device will be "Deselected".
+ *          - Data is to be added to the source location requested as per Request Form (for
+ *            STM32L, all data within the RXFIFO - ".drainReceiveFIFO"). If this is the last data
+ *            point. Then the current target SPI device will be "Deselected".
  *            The complete flag will be updated, and if there is still Request Forms to be worked
  *            on, then the next will be selected.
+ *            If coalescing is enabled and the next Request Form is to the same device, then it is
+ *            continued without deselecting the device (see ".coalesceForm").
  *
  *      Bus errors:
  *      Overrun
@@ -952,34 +2742,48 @@ void SPIPeriph::handleIRQ(void) {
  *************************************************************************************************/
     if ( (transmitEmptyChk() & transmitEmptyITChk()) == 0x01) { // If Transmit Buffer Empty
                                                                 // triggered
-        writeDR (  getFormWriteData( &(_cur_form_) )  );
-        // Retrieve next data point from the Request SPI Form, and put onto hardware queue
-
 #if   defined(zz__MiSTM32Lx__zz)        // If the target device is an STM32Lxx from cubeMX then
 //=================================================================================================
-        // STM32F utilises a TXFIFO, which will only be filled (and remove the interrupt) if
-        // 3x8bits are populated within the buffer.
-        // This feature of the hardware is not really used within the class, so interrupt is to be
-        // disabled once single byte has been put into FIFO.
-        // Will be enabled once a read of the hardware has occurred.
-        configTransmtIT(InterState::kIT_Disable);
+        // STM32L utilises a TXFIFO (32bits), so fill as much as possible within this interrupt.
+        // Interrupt is disabled once the RXFIFO limit is reached, and then refilled once a read
+        // of the hardware has occurred.
+        fillTransmitFIFO();
 #else
 //=================================================================================================
+        writeDR (  getFormWriteData( &(_cur_form_) )  );
+        // Retrieve next data point from the Request SPI Form, and put onto hardware queue
+
         if (_cur_count_ <= 1)
             configTransmtIT(InterState::kIT_Disable);
 #endif
     }
 
     if ( (receiveToReadChk() & receiveToReadITChk()) == 0x01) { // If Receive Buffer full triggered
+#if   defined(zz__MiSTM32Lx__zz)        // If the target device is an STM32Lxx from cubeMX then
+//=================================================================================================
+        drainReceiveFIFO();             // Read all data within RXFIFO into the SPI Form
+#else
+//=================================================================================================
         putFormReadData( &(_cur_form_) , readDR() );
         // Put next data point into the area requested from the SPI Form
         _cur_count_--;                  // Decrement the class global current count
+#endif
 
         if (_cur_count_ == 0) {
-            intReqFormCmplt();          // Complete the current request form (no faults)
-            startInterrupt();           // Check if any new requests remain
+            if (coalesceForm() == 1)    // If next form is to the same device (and coalescing)
+                configTransmtIT(InterState::kIT_Enable);    // then continue with next form
+            else {
+                intReqFormCmplt();      // Complete the current request form (no faults)
+                startInterrupt();       // Check if any new requests remain
+            }
         } else {                                        // Only when the count is none zero
+#if   defined(zz__MiSTM32Lx__zz)        // If the target device is an STM32Lxx from cubeMX then
+//=================================================================================================
+            fillTransmitFIFO();         // Refill TXFIFO now RXFIFO space has been freed
+#else
+//=================================================================================================
             configTransmtIT(InterState::kIT_Enable);    // Re-enable the Transmit empty interrupt
+#endif
         }
     }
 
@@ -1007,6 +2811,21 @@ void SPIPeriph::handleIRQ(void) {
 
 SPIPeriph::~SPIPeriph()
 {
-    // TODO Auto-generated destructor stub
+#if   defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
+//=================================================================================================
+    stopWorker();                       // Stop interrupt emulation thread (if running), and
+                                        // stream
+
+    if (_spi_handle_ >= 0)              // If spidev device was opened
+        close(_spi_handle_);            // then close it
+
+    if (_event_fd_ >= 0)                // If eventfd was opened
+        close(_event_fd_);              // then close it
+
+    pthread_mutex_destroy(&_queue_lock_);
+    pthread_mutex_destroy(&_stream_lock_);
+    pthread_mutex_destroy(&_bus_lock_);
+
+#endif
 }
 
@@ -220,6 +220,8 @@ void UARTDMAPeriph::intWrteFormCmplt(void) {
 
     // Indicate that UART bus is now free, and disable any interrupts
     wrte_comm_state = CommLock::kFree;
+
+    cmpltCallback( &(_cur_wrte_form_) );            // Form is complete
 }
 
 void UARTDMAPeriph::intReadFormCmplt(void) {
@@ -249,6 +251,8 @@ void UARTDMAPeriph::intReadFormCmplt(void) {
 
     // Indicate that UART bus is now free, and disable any interrupts
     read_comm_state = CommLock::kFree;
+
+    cmpltCallback( &(_cur_read_form_) );            // Form is complete
 }
 
 void UARTDMAPeriph::readGenBufferLock(GenBuffer<uint8_t> *ReadArray,
@@ -356,6 +356,14 @@ UARTPeriph::Form UARTPeriph::genericForm(uint8_t *data, uint16_t size,
     return (request_form);
 }
 
+void UARTPeriph::cmpltCallback(Form *RequestForm) {
+/**************************************************************************************************
+ * Call the completion callback of the UART Request Form, if one has been linked.
+ *************************************************************************************************/
+    if (RequestForm->Callback != __null)
+        RequestForm->Callback(RequestForm->Context);
+}
+
 uint8_t UARTPeriph::getFormWriteData(Form *RequestForm) {
 /**************************************************************************************************
  * Retrieve the next data point to write to external device from the selected UART Request form
@@ -646,12 +654,16 @@ void UARTPeriph::configReceiveIT(InterState intr) {
 }
 
 void UARTPeriph::intWrtePacket(uint8_t *wData, uint16_t size,
-                               volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag) {
+                               volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag,
+                               CmpltCallback callback, void *context) {
 /**************************************************************************************************
  * Function will generate a new form for the write UART communication
  *************************************************************************************************/
     Form request_form = genericForm(wData, size, fltReturn, cmpFlag);
 
+    request_form.Callback       = callback;     // Populate completion callback
+    request_form.Context        = context;      //
+
     _form_wrte_q_.inputWrite(request_form);
     // Add to queue
 
@@ -660,12 +672,16 @@ void UARTPeriph::intWrtePacket(uint8_t *wData, uint16_t size,
 }
 
 void UARTPeriph::intReadPacket(uint8_t *rData, uint16_t size,
-                               volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag) {
+                               volatile DevFlt *fltReturn, volatile uint16_t *cmpFlag,
+                               CmpltCallback callback, void *context) {
 /**************************************************************************************************
  * Function will generate a new form for the read UART communication
  *************************************************************************************************/
     Form request_form = genericForm(rData, size, fltReturn, cmpFlag);
 
+    request_form.Callback       = callback;     // Populate completion callback
+    request_form.Context        = context;      //
+
     _form_read_q_.inputWrite(request_form);
     // Add to queue
 
@@ -755,6 +771,8 @@ void UARTPeriph::intWrteFormCmplt(void) {
 
     configTransmtIT(InterState::kIT_Disable);   // Disable Transmit empty buffer interrupt
     configTransCmIT(InterState::kIT_Disable);   // Disable Transmit complete interrupt
+
+    cmpltCallback( &(_cur_wrte_form_) );        // Form is complete
 }
 
 void UARTPeriph::intReadFormCmplt(void) {
@@ -770,6 +788,8 @@ void UARTPeriph::intReadFormCmplt(void) {
     read_comm_state = CommLock::kFree;
 
     configReceiveIT(InterState::kIT_Disable);   // Disable Receive buffer full interrupt
+
+    cmpltCallback( &(_cur_read_form_) );        // Form is complete
 }
 
 void UARTPeriph::readGenBufferLock(GenBuffer<uint8_t> *ReadArray,
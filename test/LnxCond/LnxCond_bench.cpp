@@ -0,0 +1,190 @@
+/**************************************************************************************************
+ * @file        LnxCond_bench.cpp
+ * @author      Thomas
+ * @brief       Host benchmark of the Linux Embedded Device Operating Conditions file parsing
+ **************************************************************************************************
+ @ attention
+
+ << To be Introduced >>
+
+ *************************************************************************************************/
+/**************************************************************************************************
+ * How to use
+ * ----------
+ * Times "UpdateStatus" (all files parsed each call), for:
+ *      replay  - fixed snapshots written into a temporary directory, with "LNX_NUM_CORES" cores,
+ *                "LNX_MAX_THREADS" / 2 threads and "LNX_MAX_IRQS" interrupt lines (files are
+ *                within the page cache). Includes opening the files of each snapshot
+ *      live    - the files of the host (a temporary root, with "proc" linked to "/proc", and a
+ *                fixed temperature file - as the host may not have a thermal zone)
+ *
+ *      g++ -std=gnu++11 -O2 -Dzz__MiRaspbPi__zz -Iinclude -Iinclude/milibrary
+ *          test/LnxCond/LnxCond_bench.cpp src/LnxCond/LnxCond.cpp -pthread
+ *
+ * Writes the average time of each call (us) to stdout. Only returns non-zero if a call faults
+ * (other than 'ThreadOverflow'/'IRQOverflow'/'PressureOpen', which depend upon the host).
+ *************************************************************************************************/
+#include "LnxCond/LnxCond.h"
+
+#include <sys/stat.h>                   // mkdir
+
+#define BENCH_SNAPSHOTS     200         // Number of replay snapshots
+#define BENCH_LIVE_CALLS    2000        // Number of live calls
+
+static std::string rootdir;             // Location of snapshots/root
+
+static double timeNow(void) {
+/**************************************************************************************************
+ * Returns the current time in microseconds
+ *************************************************************************************************/
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ( ((double) now.tv_sec * 1e6) + ((double) now.tv_nsec / 1e3) );
+}
+
+static void writeFile(const std::string &Loc, const std::string &Contents) {
+/**************************************************************************************************
+ * Write "Contents" into file "Loc", creating any directories which are missing
+ *************************************************************************************************/
+    size_t  pos = 1;
+    FILE    *file;
+
+    while ((pos = Loc.find('/', pos)) != std::string::npos) {
+        mkdir(Loc.substr(0, pos).c_str(), 0755);
+        pos++;
+    }
+
+    file = fopen(Loc.c_str(), "w");
+    fputs(Contents.c_str(), file);
+    fclose(file);
+}
+
+static void writeSnapshot(uint16_t Snap) {
+/**************************************************************************************************
+ * Write a complete snapshot "Snap", with the counters increasing each snapshot
+ *************************************************************************************************/
+    char        loc[64];
+    char        line[256];
+    std::string root, text;
+    uint32_t    tick = (uint32_t) Snap * 100;
+
+    snprintf(loc, sizeof(loc), "/%04u", Snap);
+    root = rootdir + loc;
+
+    writeFile(root + "/sys/class/thermal/thermal_zone0/temp", "45123\n");
+
+    snprintf(line, sizeof(line), "cpu  %u 0 %u %u 10 0 0 0 0 0\n", tick * LNX_NUM_CORES,
+             tick, tick * LNX_NUM_CORES * 2);
+    text = line;
+    for (uint16_t i = 0; i != LNX_NUM_CORES; i++) {
+        snprintf(line, sizeof(line), "cpu%u %u 0 %u %u 10 0 0 0 0 0\n", i, tick, tick / 2,
+                 tick * 2);
+        text += line;
+    }
+    writeFile(root + "/proc/stat", text + "intr 0\nctxt 0\n");
+
+    for (int tid = 1000; tid != (1000 + (LNX_MAX_THREADS / 2)); tid++) {
+        snprintf(loc, sizeof(loc), "/proc/self/task/%d/", tid);
+        text = std::to_string(tid) + " (worker) S 1 1 1 0 -1 0 0 0 0 0 " + std::to_string(tick) +
+               " " + std::to_string(tick / 2);
+        for (uint8_t field = 16; field != 52; field++)
+            text += " 0";
+        writeFile(root + loc + "stat", text + "\n");
+        writeFile(root + loc + "status", "Name:\tworker\nvoluntary_ctxt_switches:\t" +
+                  std::to_string(tick) + "\nnonvoluntary_ctxt_switches:\t1\n");
+    }
+
+    text = "some avg10=1.50 avg60=2.00 avg300=3.25 total=" + std::to_string(tick) + "\n"
+           "full avg10=0.10 avg60=0.20 avg300=0.30 total=500\n";
+    writeFile(root + "/proc/pressure/cpu",    text);
+    writeFile(root + "/proc/pressure/memory", text);
+    writeFile(root + "/proc/pressure/io",     text);
+
+    writeFile(root + "/proc/meminfo", "MemTotal:         949444 kB\nMemFree:           10000 kB\n"
+                                      "MemAvailable:     500000 kB\nBuffers:            2000 kB\n"
+                                      "Cached:            30000 kB\nDirty:                12 kB\n"
+                                      "SwapTotal:        102396 kB\nSwapFree:         102000 kB\n");
+
+    text = "          ";
+    for (uint16_t i = 0; i != LNX_NUM_CORES; i++)
+        text += "     CPU" + std::to_string(i);
+    text += "\n";
+    for (uint16_t irq = 0; irq != LNX_MAX_IRQS; irq++) {
+        text += std::to_string(irq) + ":";
+        for (uint16_t i = 0; i != LNX_NUM_CORES; i++)
+            text += " " + std::to_string(tick + irq);
+        text += "   GIC-0  " + std::to_string(irq) + " Level     dev" + std::to_string(irq) + "\n";
+    }
+    writeFile(root + "/proc/interrupts", text);
+}
+
+static int benchReplay(void) {
+/**************************************************************************************************
+ * Time the replay of all snapshots
+ *************************************************************************************************/
+    LnxCond     cond(rootdir, BENCH_SNAPSHOTS, 10.0f);
+    _LnxFlt     flt;
+    double      start;
+    uint16_t    calls = 0;
+
+    start = timeNow();
+    while ((flt = cond.UpdateStatus()) == LnxCond_NoFault)
+        calls++;
+
+    printf("replay: %4u calls, %8.2f us/call (%u threads, %u interrupt lines)\n", calls,
+           (timeNow() - start) / calls, cond.ThreadCnt, cond.IRQCnt);
+
+    return ( (flt == LnxCond_ReplayEnd) && (calls == BENCH_SNAPSHOTS) ) ? 0 : 1;
+}
+
+static int benchLive(void) {
+/**************************************************************************************************
+ * Time the calls against the files of the host
+ *************************************************************************************************/
+    std::string root = rootdir + "/live";
+    _LnxFlt     flt  = LnxCond_NoFault;
+    double      start;
+    uint32_t    i;
+
+    writeFile(root + "/sys/class/thermal/thermal_zone0/temp", "45123\n");
+    if (symlink("/proc", (root + "/proc").c_str()) != 0)
+        return (1);
+
+    LnxCond cond(root);
+
+    start = timeNow();
+    for (i = 0; i != BENCH_LIVE_CALLS; i++) {
+        flt = cond.UpdateStatus();
+        if ( (flt != LnxCond_NoFault) && (flt != LnxCond_ThreadOverflow) &&
+             (flt != LnxCond_IRQOverflow) && (flt != LnxCond_PressureOpen) )
+            break;
+    }
+
+    printf("live:   %4u calls, %8.2f us/call (%u threads, %u interrupt lines, fault %d)\n", i,
+           (timeNow() - start) / i, cond.ThreadCnt, cond.IRQCnt, (int) flt);
+
+    return ( (i == BENCH_LIVE_CALLS) ? 0 : 1 );
+}
+
+int main(void) {
+    char    tempdir[] = "/tmp/LnxCond_benchXXXXXX";
+    int     returnval = 0;
+
+    if (mkdtemp(tempdir) == __null) {
+        printf("Unable to create temporary directory\n");
+        return (1);
+    }
+    rootdir = tempdir;
+
+    for (uint16_t i = 0; i != BENCH_SNAPSHOTS; i++)
+        writeSnapshot(i);
+
+    returnval += benchReplay();
+    returnval += benchLive();
+
+    if (system(("rm -rf " + rootdir).c_str()) != 0)
+        printf("Unable to remove %s\n", tempdir);
+
+    return (returnval);
+}
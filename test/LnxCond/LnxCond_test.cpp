@@ -0,0 +1,378 @@
+/**************************************************************************************************
+ * @file        LnxCond_test.cpp
+ * @author      Thomas
+ * @brief       Host test of the Linux Embedded Device Operating Conditions (snapshot replay)
+ **************************************************************************************************
+ @ attention
+
+ << To be Introduced >>
+
+ *************************************************************************************************/
+/**************************************************************************************************
+ * How to use
+ * ----------
+ * Writes a set of recorded snapshots (see 'LnxCond' - replay calling condition) into a temporary
+ * directory, and replays them - checking the parsed and calculated values against the expected
+ * values. As the snapshots are fixed, the results are deterministic (no dependency upon the host).
+ *
+ * Built with "LNX_NUM_CORES" = 2, and "LNX_MAX_IRQS" = 8 (see "test/run_tests.sh"):
+ *      g++ -std=gnu++11 -Dzz__MiRaspbPi__zz -DLNX_NUM_CORES=2 -DLNX_MAX_IRQS=8 -Iinclude
+ *          -Iinclude/milibrary test/LnxCond/LnxCond_test.cpp src/LnxCond/LnxCond.cpp -pthread
+ *
+ * Returns 0 if all checks pass, otherwise the number of failed checks.
+ *************************************************************************************************/
+#include "LnxCond/LnxCond.h"
+
+#include <sys/stat.h>                   // mkdir
+#include <cmath>                        // fabsf
+
+#if (LNX_NUM_CORES != 2) || (LNX_MAX_IRQS != 8)
+#error "Test requires LNX_NUM_CORES = 2, and LNX_MAX_IRQS = 8"
+#endif
+
+static int  failcnt = 0;                // Number of failed checks
+
+#define CHECK(cond)         do { if (!(cond)) { failcnt++;                                      \
+                                 printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); }       \
+                            } while (0)
+#define CHECK_NEAR(a, b)    CHECK(fabsf((float)(a) - (float)(b)) < 0.001f)
+
+static std::string snapdir;             // Location of snapshots
+
+static void writeFile(const std::string &Loc, const char *Contents) {
+/**************************************************************************************************
+ * Write "Contents" into file "Loc", creating any directories which are missing
+ *************************************************************************************************/
+    size_t  pos = 1;
+    FILE    *file;
+
+    while ((pos = Loc.find('/', pos)) != std::string::npos) {
+        mkdir(Loc.substr(0, pos).c_str(), 0755);
+        pos++;
+    }
+
+    file = fopen(Loc.c_str(), "w");
+    fputs(Contents, file);
+    fclose(file);
+}
+
+static void writeThread(uint16_t Snap, int TID, uint32_t UTime, uint32_t STime, int CPU,
+                        uint32_t Vol, uint32_t NonVol) {
+/**************************************************************************************************
+ * Write the "stat" and "status" files of thread "TID" into snapshot "Snap". Name of the thread
+ * contains spaces and brackets, to check the fields are counted from the last ')'
+ *************************************************************************************************/
+    char    loc[64];
+    char    buff[512];
+    int     len;
+
+    snprintf(loc, sizeof(loc), "/%04u/proc/self/task/%d/", Snap, TID);
+
+    len = snprintf(buff, sizeof(buff), "%d (wo rk) er) S 1 1 1 0 -1 0 0 0 0 0 %u %u", TID, UTime,
+                   STime);
+    for (uint8_t field = 16; field != LNX_THREAD_CPU; field++)
+        len += snprintf(&buff[len], sizeof(buff) - len, " 0");
+    snprintf(&buff[len], sizeof(buff) - len, " %d 0 0 0 0 0\n", CPU);
+    writeFile(snapdir + loc + "stat", buff);
+
+    snprintf(buff, sizeof(buff), "Name:\twork\nState:\tS\nvoluntary_ctxt_switches:\t%u\n"
+                                 "nonvoluntary_ctxt_switches:\t%u\n", Vol, NonVol);
+    writeFile(snapdir + loc + "status", buff);
+}
+
+static void writeSnapshot(uint16_t Snap, const char *Stat, const char *Pressure,
+                          const char *Interrupts) {
+/**************************************************************************************************
+ * Write the temperature, CPU, Pressure Stall, Memory and Interrupts files of snapshot "Snap".
+ * Pressure Stall and Interrupts are not written if __null
+ *************************************************************************************************/
+    char    loc[8];
+    std::string root;
+
+    snprintf(loc, sizeof(loc), "/%04u", Snap);
+    root = snapdir + loc;
+
+    writeFile(root + "/sys/class/thermal/thermal_zone0/temp", "45123\n");
+    writeFile(root + "/proc/stat", Stat);
+    writeFile(root + "/proc/meminfo", "MemTotal:         949444 kB\nMemFree:           10000 kB\n"
+                                      "MemAvailable:     500000 kB\nBuffers:            2000 kB\n"
+                                      "Cached:            30000 kB\nSwapCached:            0 kB\n"
+                                      "Dirty:                12 kB\nSwapTotal:        102396 kB\n"
+                                      "SwapFree:         102000 kB\n");
+    if (Pressure != __null) {
+        writeFile(root + "/proc/pressure/cpu",    Pressure);
+        writeFile(root + "/proc/pressure/memory", Pressure);
+        writeFile(root + "/proc/pressure/io",     Pressure);
+    }
+    if (Interrupts != __null)
+        writeFile(root + "/proc/interrupts", Interrupts);
+}
+
+static void testReplay(void) {
+/**************************************************************************************************
+ * Replay of CPU load, thread load, Pressure Stall, Memory and Interrupts over 3 snapshots:
+ *      0000    - initial values (no loads can be determined)
+ *      0001    - core 0 100% loaded, core 1 offline (hot-plugged); thread 100 uses half a core,
+ *                thread 101 exits
+ *      0002    - core 1 back online, counters of core 0 wrap around 32bits, and iowait goes
+ *                backwards; a new thread 102 appears
+ *************************************************************************************************/
+    writeSnapshot(0, "cpu  100 0 100 1000 10 0 0 0 0 0\n"
+                     "cpu0 50 0 50 500 5 0 0 0 0 0\n"
+                     "cpu1 50 0 50 500 5 0 0 0 0 0\n"
+                     "cpu2 1 1 1 1 1 1 1 1 1 1\n"       // beyond LNX_NUM_CORES, ignored
+                     "intr 0\n",
+                  "some avg10=1.50 avg60=2.00 avg300=3.25 total=1000\n"
+                  "full avg10=0.10 avg60=0.20 avg300=0.30 total=500\n",
+                  "           CPU0       CPU1\n"
+                  " 23:         10         20   ARMCTRL-level   1 Edge      spi0\n"
+                  "IPI0:         1          2   CPU wakeup interrupts\n"
+                  "ERR:          0\n");
+    writeThread(0, 100, 10, 5, 0, 3, 1);
+    writeThread(0, 101, 1, 1, 1, 0, 0);
+
+    writeSnapshot(1, "cpu  200 0 100 1100 10 0 0 0 0 0\n"    // total active +100, idle +100
+                     "cpu0 150 0 50 500 5 0 0 0 0 0\n"      // core 0 active +100, idle +0
+                     "intr 0\n",
+                  "some avg10=1.50 avg60=2.00 avg300=3.25 total=1600\n"
+                  "full avg10=0.10 avg60=0.20 avg300=0.30 total=500\n",
+                  "           CPU0       CPU1\n"
+                  " 23:         60         70   ARMCTRL-level   1 Edge      spi0\n"
+                  "IPI0:         1          2   CPU wakeup interrupts\n"
+                  "ERR:          0\n");
+    writeThread(1, 100, 55, 10, 1, 10, 3);                  // +50 ticks, of total 200 ticks
+
+    writeSnapshot(2, "cpu  4294967546 0 100 1100 5 0 0 0 0 0\n" // active +50 (wrap), idle -10
+                     "cpu0 4294967546 0 50 505\n"           // active +100 (wrap), fewer columns
+                     "cpu1 50 0 50 550 5 0 0 0 0 0\n"       // back online, +50 idle
+                     "intr 0\n",
+                  "some avg10=0.00 avg60=0.00 avg300=0.00 total=1600\n",    // no "full" line
+                  __null);
+    writeThread(2, 100, 55, 10, 1, 10, 3);
+    writeThread(2, 102, 7, 7, 0, 1, 1);
+
+    LnxCond cond(snapdir, 3, 10.0f);        // Recorded at 10Hz
+
+    // Snapshot 0000
+    CHECK(cond.UpdateStatus() == LnxCond_NoFault);
+    CHECK_NEAR(cond.Temp, 45.123f);
+    CHECK(cond.CoreOnline[0] == 1);
+    CHECK(cond.CoreOnline[1] == 1);
+    CHECK(cond.CoreOnline[2] == 1);
+    CHECK(cond.CurCPU[1][0] == 50);
+    CHECK(cond.ThreadCnt == 2);
+    CHECK(cond.Memory.MemTotal == 949444);
+    CHECK(cond.Memory.Dirty == 12);
+    CHECK(cond.Memory.SwapFree == 102000);
+    CHECK_NEAR(cond.Pressure[LNX_PSI_CPU].SomeAvg300, 3.25f);
+    CHECK(cond.Pressure[LNX_PSI_IO].SomeTotal == 1000);
+    CHECK(cond.Pressure[LNX_PSI_IO].SomeDiff == 0);
+    CHECK(cond.IRQCnt == 3);
+    CHECK(strcmp(cond.IRQ[0].Name, "23") == 0);
+    CHECK(strcmp(cond.IRQ[0].Desc, "spi0") == 0);
+    CHECK(cond.IRQ[0].Count == 30);
+    CHECK(strcmp(cond.IRQ[2].Name, "ERR") == 0);
+
+    // Snapshot 0001
+    CHECK(cond.UpdateStatus() == LnxCond_NoFault);
+    CHECK_NEAR(cond.CurLoad[0], 0.5f);
+    CHECK_NEAR(cond.CurLoad[1], 1.0f);
+    CHECK(cond.CoreOnline[2] == 0);
+    CHECK_NEAR(cond.CurLoad[2], 0.0f);      // Offline, so no change
+    CHECK(cond.ThreadCnt == 1);             // Thread 101 has exited
+    CHECK(cond.Thread[0].TID == 100);
+    CHECK(strcmp(cond.Thread[0].Name, "wo rk) er") == 0);
+    CHECK(cond.Thread[0].UTime == 55);
+    CHECK(cond.Thread[0].STime == 10);
+    CHECK(cond.Thread[0].LastCPU == 1);
+    CHECK(cond.Thread[0].VolCtxtDiff == 7);
+    CHECK(cond.Thread[0].NonVolCtxtDiff == 2);
+    CHECK_NEAR(cond.Thread[0].Load, 0.25f); // 50 ticks * 1 online core / 200 ticks
+    CHECK(cond.Pressure[LNX_PSI_MEMORY].SomeDiff == 600);
+    CHECK(cond.Pressure[LNX_PSI_MEMORY].FullDiff == 0);
+    CHECK(cond.IRQ[0].Diff == 100);
+    CHECK_NEAR(cond.IRQ[0].Rate, 1000.0f);  // 100 interrupts in 0.1s
+    CHECK(cond.IRQ[1].Diff == 0);
+
+    // Snapshot 0002
+    CHECK(cond.UpdateStatus() == LnxCond_NoFault);
+    CHECK_NEAR(cond.CurLoad[0], 1.0f);      // Wrap handled, idle backwards (iowait) ignored
+    CHECK_NEAR(cond.CurLoad[1], 1.0f);      // 4294967546 truncated to 250
+    CHECK(cond.CurCPU[1][5] == 0);          // Missing columns cleared
+    CHECK(cond.CoreOnline[2] == 1);
+    CHECK_NEAR(cond.CurLoad[2], 0.0f);      // No change since offline
+    CHECK(cond.ThreadCnt == 2);
+    CHECK(cond.Thread[0].TID == 100);
+    CHECK_NEAR(cond.Thread[0].Load, 0.0f);  // No time used
+    CHECK(cond.Thread[1].TID == 102);
+    CHECK(cond.Thread[1].VolCtxtDiff == 0); // First pass of new thread
+    CHECK(cond.Pressure[LNX_PSI_CPU].SomeDiff == 0);
+    CHECK(cond.IRQCnt == 3);                // Interrupts not within snapshot, so unchanged
+
+    CHECK(cond.UpdateStatus() == LnxCond_ReplayEnd);
+}
+
+static void testOffline(void) {
+/**************************************************************************************************
+ * Thread load scaled by the number of cores online at each read (including cores beyond
+ * "LNX_NUM_CORES"), over 3 snapshots:
+ *      0000    - initial values, 4 cores online
+ *      0001    - 4 cores online, each +50 active +50 idle; thread 100 +100 ticks (a full core)
+ *      0002    - core 1 offline (hot-plugged), other 3 cores +100 active; thread 100 +90 ticks
+ *************************************************************************************************/
+    writeSnapshot(0, "cpu  400 0 0 400 0 0 0 0 0 0\n"
+                     "cpu0 100 0 0 100 0 0 0 0 0 0\n"
+                     "cpu1 100 0 0 100 0 0 0 0 0 0\n"
+                     "cpu2 100 0 0 100 0 0 0 0 0 0\n"     // beyond LNX_NUM_CORES, still online
+                     "cpu3 100 0 0 100 0 0 0 0 0 0\n"
+                     "intr 0\n", __null, __null);
+    writeThread(0, 100, 10, 0, 0, 0, 0);
+
+    writeSnapshot(1, "cpu  600 0 0 600 0 0 0 0 0 0\n"     // total +400
+                     "cpu0 150 0 0 150 0 0 0 0 0 0\n"
+                     "cpu1 150 0 0 150 0 0 0 0 0 0\n"
+                     "cpu2 150 0 0 150 0 0 0 0 0 0\n"
+                     "cpu3 150 0 0 150 0 0 0 0 0 0\n"
+                     "intr 0\n", __null, __null);
+    writeThread(1, 100, 110, 0, 0, 0, 0);
+
+    writeSnapshot(2, "cpu  900 0 0 600 0 0 0 0 0 0\n"     // total +300 (3 cores online)
+                     "cpu0 250 0 0 150 0 0 0 0 0 0\n"
+                     "cpu2 250 0 0 150 0 0 0 0 0 0\n"
+                     "cpu3 250 0 0 150 0 0 0 0 0 0\n"
+                     "intr 0\n", __null, __null);
+    writeThread(2, 100, 200, 0, 2, 0, 0);
+
+    LnxCond cond(snapdir, 3, 10.0f);        // Recorded at 10Hz
+
+    CHECK(cond.UpdateStatus() == LnxCond_NoFault);
+
+    CHECK(cond.UpdateStatus() == LnxCond_NoFault);
+    CHECK_NEAR(cond.CurLoad[0], 0.5f);
+    CHECK_NEAR(cond.Thread[0].Load, 1.0f);  // 100 ticks * 4 online cores / 400 ticks
+
+    CHECK(cond.UpdateStatus() == LnxCond_NoFault);
+    CHECK(cond.CoreOnline[2] == 0);
+    CHECK_NEAR(cond.CurLoad[0], 1.0f);
+    CHECK_NEAR(cond.Thread[0].Load, 0.9f);  // 90 ticks * 3 online cores / 300 ticks
+
+    CHECK(cond.UpdateStatus() == LnxCond_ReplayEnd);
+}
+
+static void testFaults(void) {
+/**************************************************************************************************
+ * Faults from layout of the files:
+ *      0000    - more interrupt lines than "LNX_MAX_IRQS" (lines which fit are still captured)
+ *      0001    - unexpected layout of CPU file
+ *      0002    - no temperature file
+ *************************************************************************************************/
+    std::string irq = "           CPU0       CPU1\n";
+    char        line[64];
+
+    for (uint8_t i = 0; i != (LNX_MAX_IRQS + 2); i++) {
+        snprintf(line, sizeof(line), "%3u:  %9u %9u   GIC   dev%u\n", i, i, i, i);
+        irq += line;
+    }
+
+    writeSnapshot(0, "cpu  1 1 1 1 1 1 1 1 1 1\n", __null, irq.c_str());
+    writeSnapshot(1, "cpu  1 1 1 1 x\n", __null, __null);
+    writeFile(snapdir + "/0002/proc/stat", "cpu  1 1 1 1\n");
+
+    LnxCond cond(snapdir, 3, 1.0f);
+
+    CHECK(cond.UpdateStatus() == LnxCond_IRQOverflow);
+    CHECK(cond.IRQCnt == LNX_MAX_IRQS);
+    CHECK(strcmp(cond.IRQ[LNX_MAX_IRQS - 1].Desc, "dev7") == 0);
+
+    CHECK(cond.UpdateStatus() == LnxCond_CPULoadConvert);
+    CHECK(cond.UpdateStatus() == LnxCond_TemperatureOpen);
+    CHECK(cond.UpdateStatus() == LnxCond_ReplayEnd);
+}
+
+static void testLatency(void) {
+/**************************************************************************************************
+ * Consistency of the latency probe statistics, whilst the probe thread is updating them. The
+ * statistics are updated by "UpdateStatus" before any files are read, so a root without any files
+ * is used (fault is ignored).
+ * As the latency is captured in whole microseconds, the minimum and maximum must be the first and
+ * last used entries of the histogram of the same call (unless beyond the histogram).
+ *************************************************************************************************/
+    LnxCond     cond(snapdir + "/none");
+    uint32_t    first, last, total;
+    uint32_t    calls = 0;
+
+    CHECK(cond.StartLatency(1, 0, -1) == LnxCond_NoFault);
+
+    for (uint16_t n = 0; n != 2000; n++) {    // Probe is woken as fast as possible, so is
+        cond.UpdateStatus();                    // updating during most of the copies
+
+        first = LNX_LAT_BUCKETS + 1;
+        last  = 0;
+        total = 0;
+        for (uint32_t i = 0; i != (LNX_LAT_BUCKETS + 1); i++) {
+            if (cond.LatencyHist[i] == 0)
+                continue;
+            if (first == (LNX_LAT_BUCKETS + 1))
+                first = i;
+            last   = i;
+            total += cond.LatencyHist[i];
+        }
+
+        CHECK(total == cond.Latency.Samples);
+        if (cond.Latency.Samples == 0) {
+            CHECK(cond.Latency.Min == 0);
+            CHECK(cond.Latency.Max == 0);
+            continue;
+        }
+
+        calls++;
+        if (first != LNX_LAT_BUCKETS)
+            CHECK(cond.Latency.Min == first);
+        else
+            CHECK(cond.Latency.Min >= LNX_LAT_BUCKETS);
+
+        if (last != LNX_LAT_BUCKETS)
+            CHECK(cond.Latency.Max == last);
+        else
+            CHECK(cond.Latency.Max >= LNX_LAT_BUCKETS);
+
+        CHECK(cond.Latency.Avg >= (float)cond.Latency.Min);
+        CHECK(cond.Latency.Avg <= (float)cond.Latency.Max);
+        CHECK(cond.Latency.MaxTotal >= cond.Latency.Max);
+    }
+
+    cond.StopLatency();
+    CHECK(calls != 0);
+}
+
+static void clearSnapshots(void) {
+/**************************************************************************************************
+ * Remove all snapshots from the temporary directory
+ *************************************************************************************************/
+    std::string command = "rm -rf " + snapdir + "/0*";
+
+    if (system(command.c_str()) != 0)
+        printf("Unable to clear %s\n", snapdir.c_str());
+}
+
+int main(void) {
+    char    tempdir[] = "/tmp/LnxCond_testXXXXXX";
+
+    if (mkdtemp(tempdir) == __null) {
+        printf("Unable to create temporary directory\n");
+        return (1);
+    }
+    snapdir = tempdir;
+
+    testReplay();
+    clearSnapshots();
+    testOffline();
+    clearSnapshots();
+    testFaults();
+    clearSnapshots();
+    testLatency();
+    rmdir(tempdir);
+
+    printf("%s: %d failed\n", __FILE__, failcnt);
+    return (failcnt);
+}
@@ -0,0 +1,476 @@
+/**************************************************************************************************
+ * @file        I2CPeriph_L4_test.cpp
+ * @author      Thomas
+ * @brief       Host test of the I2C driver interrupt transfers (STM32L4), against a register model
+ **************************************************************************************************
+ @ attention
+
+ << To be Introduced >>
+
+ *************************************************************************************************/
+/**************************************************************************************************
+ * How to use
+ * ----------
+ * Models the STM32L4 I2C master - a transfer is started by "START" within "CR2" (address, read or
+ * write, "NBYTES", "RELOAD"/"AUTOEND"), then one byte is moved each step. Status register ("ISR")
+ * is updated as the hardware would:
+ *      TXIS/TXE            - Transmit Data Register empty, and (TXIS) more data needed
+ *      RXNE                - byte received, held (clock stretched) until read
+ *      TCR                 - end of a chunk in RELOAD mode, "NBYTES" is zeroed by the model so a
+ *                            new (non-zero) write of "NBYTES" continues the transfer
+ *      TC                  - end of transfer in SOFTEND mode, waits for a (repeated) START
+ *      STOPF               - end of transfer in AUTOEND mode (bus no longer BUSY)
+ *      NACKF               - address not acknowledged, followed by the STOP on the next step
+ * The slave at "TEST_ADDR" captures all written bytes, and reads return "readData" of the byte
+ * count read. Any other address is not acknowledged.
+ * The Data Register accesses of 'I2CPeriph' (".readDR", ".writeDR") are provided by this test in
+ * place of the driver library, so each access is applied to the model. Interrupt transfers are
+ * run with "TEST_LATENCY" steps between each interrupt entry. Checks:
+ *      Data                - bytes written reach the slave, bytes read are in the form's buffer
+ *      Completion          - the form completes, with all bytes and no fault; bus is freed
+ *      Chunks              - forms larger than "I2CPe_MaxNBYTES" are requested in chunks (RELOAD),
+ *                            one TCR per chunk boundary, and the last chunk in the form's mode
+ *      Write then read     - write part (any size) ends on TC, the read part is then started with
+ *                            a repeated START (no STOP between)
+ *      Data Register       - no write whilst full, or read whilst empty; TX flushed at the STOP
+ *      NACK                - probes (and a write) to an address which doesn't acknowledge are
+ *                            faulted "kNACK", and completed once by the STOP which follows. Then
+ *                            the next form is started. NACK and STOP seen within separate
+ *                            interrupt entries (latency 1), and the same entry
+ *
+ * Built as the driver in a shared library, linked to this test (see "test/run_tests.sh"):
+ *      g++ -std=gnu++11 -fPIC -shared -Dzz__MiSTM32Lx__zz -Iinclude -Iinclude/milibrary
+ *          -Itest/stubs -Itest/stubs/l4 src/drv/I2CPeriph/I2CPeriph.cpp
+ *          test/stubs/HostStubs.cpp -o libI2CPeriph_L4_test.so
+ *      g++ -std=gnu++11 -Dzz__MiSTM32Lx__zz -Iinclude -Iinclude/milibrary -Itest/stubs
+ *          -Itest/stubs/l4 test/drv/I2CPeriph/I2CPeriph_L4_test.cpp -L. -lI2CPeriph_L4_test
+ *
+ * Returns 0 if all checks pass, otherwise the number of failed checks.
+ *************************************************************************************************/
+#include "FileIndex.h"
+#include FilInd_I2CPe__HD
+
+#include <stdio.h>                      // printf
+#include <string.h>                     // memset
+
+static int  failcnt = 0;                // Number of failed checks
+
+#define CHECK(cond)         do { if (!(cond)) { failcnt++;                                      \
+                                 printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); }       \
+                            } while (0)
+
+#define TEST_ADDR           0x48        // Address of the simulated slave (7bit)
+#define TEST_DEVADDR        (TEST_ADDR << 1)    // Address as provided to 'I2CPeriph'
+#define TEST_FORMS          8           // Size of the I2C Request Form queue
+#define TEST_BUFFER         640         // Size of the write/read buffers (bytes)
+#define TEST_LATENCY        3           // Maximum steps between interrupt entries
+#define TEST_TIMEOUT        100000      // Maximum interrupt checks of a transfer
+
+typedef enum {
+    kIdle,                              // No transfer (or STOP generated)
+    kTransfer,                          // Moving bytes of the current chunk
+    kReload,                            // End of chunk (TCR), waiting on "NBYTES"
+    kRestart,                           // End of transfer (TC), waiting on START
+    kNACK                               // Address not acknowledged, STOP next
+} ModelState;
+
+static I2C_TypeDef  regs;               // Modelled I2C registers
+
+static ModelState   state;              // State of the modelled master
+static uint8_t      reading;            // Current transfer is a read
+static uint16_t     chunk;              // Bytes remaining within current chunk
+
+static uint8_t      slave[TEST_BUFFER]; // Bytes written to the slave
+static uint16_t     written;            // Number of bytes written to the slave
+static uint16_t     readcnt;            // Number of bytes read from the slave
+
+static uint32_t     reloads;            // Number of chunk boundaries (TCR)
+static uint32_t     restarts;           // Number of repeated STARTs (after TC)
+static uint32_t     stops;              // Number of STOPs generated
+static uint32_t     nacks;              // Number of addresses not acknowledged
+static uint8_t      txoverflow;         // Write whilst the Transmit Data Register was full
+static uint8_t      rxunderflow;        // Read whilst the Receive Data Register was empty
+
+static uint8_t readData(uint16_t count) {
+    return ( (uint8_t) ((count * 5) + 1) );
+}
+
+static void startChunk(void) {
+/**************************************************************************************************
+ * Capture size of the next chunk from "CR2"
+ *************************************************************************************************/
+    chunk = (uint16_t) ((regs.CR2 & I2C_CR2_NBYTES) >> I2C_CR2_NBYTES_Pos);
+    state = kTransfer;
+}
+
+static void generateStop(void) {
+    regs.ISR |= I2C_FLAG_STOPF;
+    regs.ISR &= ~I2C_FLAG_BUSY;
+    state = kIdle;
+    stops++;
+}
+
+static void endChunk(void) {
+/**************************************************************************************************
+ * Current chunk is complete - RELOAD waits for the next chunk, AUTOEND generates the STOP,
+ * otherwise (SOFTEND) waits for a START/STOP
+ *************************************************************************************************/
+    if ((regs.CR2 & I2C_CR2_RELOAD) != 0) {
+        regs.ISR |= I2C_FLAG_TCR;
+        regs.CR2 &= ~I2C_CR2_NBYTES;
+        state = kReload;
+        reloads++;
+    }
+    else if ((regs.CR2 & I2C_CR2_AUTOEND) != 0)
+        generateStop();
+    else {
+        regs.ISR |= I2C_FLAG_TC;
+        state = kRestart;
+    }
+}
+
+static void step(void) {
+/**************************************************************************************************
+ * Apply the flag clears, then move the model on by a single byte
+ *************************************************************************************************/
+    regs.ISR &= ~regs.ICR;
+    regs.ICR = 0;
+
+    switch (state) {
+        case kIdle:
+        case kRestart:
+            if ((regs.CR2 & I2C_CR2_START) == 0)
+                break;
+
+            if (state == kRestart)
+                restarts++;
+
+            regs.CR2 &= ~I2C_CR2_START;             // Address sent
+            regs.ISR &= ~I2C_FLAG_TC;
+            regs.ISR |= I2C_FLAG_BUSY;
+            reading = ((regs.CR2 & I2C_CR2_RD_WRN) != 0) ? 1 : 0;
+
+            if (((regs.CR2 & I2C_CR2_SADD) >> 1) != TEST_ADDR) {
+                regs.ISR |= I2C_FLAG_AF;
+                state = kNACK;
+                nacks++;
+                break;
+            }
+
+            startChunk();
+            if (chunk == 0)                         // Address only
+                endChunk();
+            break;
+
+        case kNACK:
+            generateStop();
+            break;
+
+        case kReload:
+            if ((regs.CR2 & I2C_CR2_NBYTES) == 0)
+                break;
+
+            regs.ISR &= ~I2C_FLAG_TCR;
+            startChunk();
+            break;
+
+        case kTransfer:
+            if ( (reading == 0) && ((regs.ISR & I2C_FLAG_TXE) == 0) ) {
+                if (written != TEST_BUFFER)
+                    slave[written] = (uint8_t) regs.TXDR;
+                written++;
+                regs.ISR |= I2C_FLAG_TXE;
+                if (--chunk == 0)
+                    endChunk();
+            }
+            else if ( (reading == 1) && ((regs.ISR & I2C_FLAG_RXNE) == 0) ) {
+                regs.RXDR = readData(readcnt++);
+                regs.ISR |= I2C_FLAG_RXNE;
+                if (--chunk == 0)
+                    endChunk();
+            }
+            break;
+    }
+
+    if ( (state == kTransfer) && (reading == 0) && ((regs.ISR & I2C_FLAG_TXE) != 0) )
+        regs.ISR |= I2C_FLAG_TXIS;
+    else
+        regs.ISR &= ~I2C_FLAG_TXIS;
+}
+
+uint8_t I2CPeriph::readDR(void) {
+    if ((regs.ISR & I2C_FLAG_RXNE) == 0)
+        rxunderflow = 1;
+
+    regs.ISR &= ~I2C_FLAG_RXNE;
+    return ((uint8_t) regs.RXDR);
+}
+
+void I2CPeriph::writeDR(uint8_t data) {
+    if ((regs.ISR & I2C_FLAG_TXE) == 0)
+        txoverflow = 1;
+
+    regs.TXDR = data;
+    regs.ISR &= ~(I2C_FLAG_TXE | I2C_FLAG_TXIS);
+}
+
+static uint8_t eventPending(void) {
+/**************************************************************************************************
+ * Returns 1 if an enabled event interrupt is pending
+ *************************************************************************************************/
+    uint32_t isr = regs.ISR;
+    uint32_t cr1 = regs.CR1;
+
+    return ( ( ((isr & I2C_FLAG_TXIS)  != 0) && ((cr1 & I2C_CR1_TXIE)   != 0) ) ||
+             ( ((isr & I2C_FLAG_RXNE)  != 0) && ((cr1 & I2C_CR1_RXIE)   != 0) ) ||
+             ( ((isr & (I2C_FLAG_TC | I2C_FLAG_TCR)) != 0) && ((cr1 & I2C_CR1_TCIE) != 0) ) ||
+             ( ((isr & I2C_FLAG_STOPF) != 0) && ((cr1 & I2C_CR1_STOPIE) != 0) ) ||
+             ( ((isr & I2C_FLAG_AF)    != 0) && ((cr1 & I2C_CR1_NACKIE) != 0) ) );
+}
+
+static void resetModel(void) {
+    memset(&regs, 0, sizeof(regs));
+    regs.ISR = I2C_FLAG_TXE;
+
+    state   = kIdle;
+    reading = 0;
+    chunk   = 0;
+    written = readcnt = 0;
+    reloads = restarts = stops = nacks = 0;
+    txoverflow = rxunderflow = 0;
+    memset(slave, 0, sizeof(slave));
+}
+
+static uint32_t runModel(I2CPeriph *i2c, uint8_t latency) {
+/**************************************************************************************************
+ * Step the model, with "latency" steps between each interrupt entry - until the bus is free (and
+ * no event pending). Returns the number of interrupt entries.
+ *************************************************************************************************/
+    uint32_t irqs = 0;
+
+    for (uint32_t i = 0; i != TEST_TIMEOUT; i++) {
+        for (uint8_t k = 0; k != latency; k++)
+            step();
+
+        if (eventPending() == 1) {
+            irqs++;
+            i2c->handleEventIRQ();
+        }
+        else if ( (i2c->comm_state == I2CPeriph::CommLock::kFree) && (state == kIdle) )
+            break;
+    }
+
+    return (irqs);
+}
+
+static void checkBus(I2CPeriph *i2c) {
+/**************************************************************************************************
+ * Bus is free, and the Data Registers were used correctly
+ *************************************************************************************************/
+    CHECK(i2c->comm_state == I2CPeriph::CommLock::kFree);
+    CHECK(state == kIdle);
+    CHECK((regs.ISR & I2C_FLAG_BUSY) == 0);
+    CHECK((regs.ISR & I2C_FLAG_TXE)  != 0);     // Anything left in TXDR flushed
+    CHECK((regs.CR1 & (I2C_CR1_TXIE | I2C_CR1_RXIE | I2C_CR1_TCIE)) == 0);
+    CHECK(txoverflow  == 0);
+    CHECK(rxunderflow == 0);
+}
+
+static uint32_t chunkBounds(uint16_t size) {
+    return ( (size == 0) ? 0 : ((uint32_t) (size - 1) / I2CPe_MaxNBYTES) );
+}
+
+static void runWrite(uint16_t size, uint8_t latency) {
+/**************************************************************************************************
+ * Write form of "size" bytes (AUTOEND)
+ *************************************************************************************************/
+    I2C_HandleTypeDef           handle;
+    I2CPeriph::Form             forms[TEST_FORMS];
+    static uint8_t              wr[TEST_BUFFER];
+    volatile I2CPeriph::DevFlt  flt = I2CPeriph::DevFlt::kNone;
+    volatile uint16_t           cmp = 0;
+    uint32_t                    irqs = 0;
+    uint16_t                    i = 0;
+
+    resetModel();
+    handle.Instance = &regs;
+    for (i = 0; i != size; i++)
+        wr[i] = (uint8_t) ((i * 7) + 3);
+
+    I2CPeriph i2c(&handle, forms, TEST_FORMS);
+    i2c.configBusSTOPIT(I2CPeriph::InterState::kIT_Enable);
+    i2c.configBusNACKIT(I2CPeriph::InterState::kIT_Enable);
+
+    i2c.intMasterReq(TEST_DEVADDR, size, wr, I2CPeriph::CommMode::kAutoEnd,
+                     I2CPeriph::Request::kStart_Write, &flt, &cmp);
+    irqs = runModel(&i2c, latency);
+
+    printf("write %3u latency %u: %4u interrupts, %u reloads\n", size, latency, irqs, reloads);
+
+    checkBus(&i2c);
+    CHECK( (flt == I2CPeriph::DevFlt::kNone) && (cmp == size) );
+    CHECK(written == size);
+    CHECK(reloads == chunkBounds(size));
+    CHECK( (stops == 1) && (restarts == 0) );
+    for (i = 0; i != size; i++)
+        CHECK(slave[i] == wr[i]);
+}
+
+static void runRead(uint16_t size, uint8_t latency) {
+/**************************************************************************************************
+ * Read form of "size" bytes (AUTOEND)
+ *************************************************************************************************/
+    I2C_HandleTypeDef           handle;
+    I2CPeriph::Form             forms[TEST_FORMS];
+    static uint8_t              rd[TEST_BUFFER];
+    volatile I2CPeriph::DevFlt  flt = I2CPeriph::DevFlt::kNone;
+    volatile uint16_t           cmp = 0;
+    uint32_t                    irqs = 0;
+    uint16_t                    i = 0;
+
+    resetModel();
+    handle.Instance = &regs;
+    memset(rd, 0, sizeof(rd));
+
+    I2CPeriph i2c(&handle, forms, TEST_FORMS);
+    i2c.configBusSTOPIT(I2CPeriph::InterState::kIT_Enable);
+    i2c.configBusNACKIT(I2CPeriph::InterState::kIT_Enable);
+
+    i2c.intMasterReq(TEST_DEVADDR, size, rd, I2CPeriph::CommMode::kAutoEnd,
+                     I2CPeriph::Request::kStart_Read, &flt, &cmp);
+    irqs = runModel(&i2c, latency);
+
+    printf("read  %3u latency %u: %4u interrupts, %u reloads\n", size, latency, irqs, reloads);
+
+    checkBus(&i2c);
+    CHECK( (flt == I2CPeriph::DevFlt::kNone) && (cmp == size) );
+    CHECK(readcnt == size);
+    CHECK(reloads == chunkBounds(size));
+    CHECK( (stops == 1) && (restarts == 0) );
+    for (i = 0; i != size; i++)
+        CHECK(rd[i] == readData(i));
+}
+
+static void runWriteRead(uint16_t wsize, uint16_t rsize, uint8_t latency) {
+/**************************************************************************************************
+ * Write then read form, "wsize" bytes written (SOFTEND), repeated START then "rsize" bytes read
+ * (AUTOEND)
+ *************************************************************************************************/
+    I2C_HandleTypeDef           handle;
+    I2CPeriph::Form             forms[TEST_FORMS];
+    static uint8_t              wr[TEST_BUFFER];
+    static uint8_t              rd[TEST_BUFFER];
+    volatile I2CPeriph::DevFlt  flt = I2CPeriph::DevFlt::kNone;
+    volatile uint16_t           cmp = 0;
+    uint32_t                    irqs = 0;
+    uint16_t                    i = 0;
+
+    resetModel();
+    handle.Instance = &regs;
+    memset(rd, 0, sizeof(rd));
+    for (i = 0; i != wsize; i++)
+        wr[i] = (uint8_t) ((i * 3) + 11);
+
+    I2CPeriph i2c(&handle, forms, TEST_FORMS);
+    i2c.configBusSTOPIT(I2CPeriph::InterState::kIT_Enable);
+    i2c.configBusNACKIT(I2CPeriph::InterState::kIT_Enable);
+
+    i2c.intMasterWriteRead(TEST_DEVADDR, wsize, wr, rsize, rd, &flt, &cmp);
+    irqs = runModel(&i2c, latency);
+
+    printf("write %3u read %3u latency %u: %4u interrupts, %u reloads\n", wsize, rsize, latency,
+           irqs, reloads);
+
+    checkBus(&i2c);
+    CHECK( (flt == I2CPeriph::DevFlt::kNone) && (cmp == rsize) );
+    CHECK( (written == wsize) && (readcnt == rsize) );
+    CHECK(reloads == (chunkBounds(wsize) + chunkBounds(rsize)));
+    CHECK( (stops == 1) && (restarts == 1) );       // No STOP between write and read
+    for (i = 0; i != wsize; i++)
+        CHECK(slave[i] == wr[i]);
+    for (i = 0; i != rsize; i++)
+        CHECK(rd[i] == readData(i));
+}
+
+static void probeCallback(void *context) {
+/**************************************************************************************************
+ * Completion callback, counts the completions of the form ("context")
+ *************************************************************************************************/
+    ((uint8_t *) context)[0]++;
+}
+
+static void runProbes(uint8_t latency) {
+/**************************************************************************************************
+ * Probes of an address which doesn't acknowledge, the slave, and another which doesn't
+ * acknowledge - then a write to the address which doesn't acknowledge, followed by a read of the
+ * slave. All queued together.
+ *************************************************************************************************/
+    I2C_HandleTypeDef           handle;
+    I2CPeriph::Form             forms[TEST_FORMS];
+    static const uint16_t       probe_addr[3] = { (TEST_ADDR + 1) << 1, TEST_DEVADDR,
+                                                  (TEST_ADDR + 2) << 1 };
+    uint8_t                     wr[2]   = { 0x01, 0x02 };
+    uint8_t                     rd[2]   = { 0 };
+    volatile I2CPeriph::DevFlt  flt[5];
+    volatile uint16_t           cmp[5];
+    uint32_t                    irqs = 0;
+    uint8_t                     calls[5] = { 0 };
+    uint8_t                     i = 0;
+
+    resetModel();
+    handle.Instance = &regs;
+    for (i = 0; i != 5; i++) {
+        flt[i] = I2CPeriph::DevFlt::kNone;
+        cmp[i] = 0;
+    }
+
+    I2CPeriph i2c(&handle, forms, TEST_FORMS);
+    i2c.configBusSTOPIT(I2CPeriph::InterState::kIT_Enable);
+    i2c.configBusNACKIT(I2CPeriph::InterState::kIT_Enable);
+
+    for (i = 0; i != 3; i++)
+        i2c.intMasterReq(probe_addr[i], 0, __null, I2CPeriph::CommMode::kAutoEnd,
+                         I2CPeriph::Request::kProbe, &flt[i], &cmp[i], &probeCallback,
+                         &calls[i]);
+    i2c.intMasterReq((TEST_ADDR + 1) << 1, sizeof(wr), wr, I2CPeriph::CommMode::kAutoEnd,
+                     I2CPeriph::Request::kStart_Write, &flt[3], &cmp[3], &probeCallback,
+                     &calls[3]);
+    i2c.intMasterReq(TEST_DEVADDR, sizeof(rd), rd, I2CPeriph::CommMode::kAutoEnd,
+                     I2CPeriph::Request::kStart_Read, &flt[4], &cmp[4], &probeCallback,
+                     &calls[4]);
+    irqs = runModel(&i2c, latency);
+
+    printf("probes latency %u: %4u interrupts, %u nacks\n", latency, irqs, nacks);
+
+    checkBus(&i2c);
+    CHECK( (nacks == 3) && (stops == 5) );
+    for (i = 0; i != 5; i++)
+        CHECK(calls[i] == 1);                       // Each form completed once
+    CHECK(flt[0] == I2CPeriph::DevFlt::kNACK);
+    CHECK(flt[1] == I2CPeriph::DevFlt::kNone);
+    CHECK(flt[2] == I2CPeriph::DevFlt::kNACK);
+    CHECK( (flt[3] == I2CPeriph::DevFlt::kNACK) && (written == 0) );
+    CHECK(cmp[3] <= 1);                             // Byte preloaded into TXDR is counted
+    CHECK( (flt[4] == I2CPeriph::DevFlt::kNone) && (cmp[4] == sizeof(rd)) );
+    CHECK( (rd[0] == readData(0)) && (rd[1] == readData(1)) );
+}
+
+int main(void) {
+    static const uint16_t sizes[] = { 1, 2, 255, 256, 300, 510, 511, 600 };
+
+    for (uint8_t latency = 1; latency <= TEST_LATENCY; latency++) {
+        for (uint8_t i = 0; i != (sizeof(sizes) / sizeof(sizes[0])); i++) {
+            runWrite(sizes[i], latency);
+            runRead(sizes[i], latency);
+        }
+
+        runWriteRead(1,   2,   latency);
+        runWriteRead(2,   300, latency);
+        runWriteRead(300, 2,   latency);
+        runWriteRead(511, 600, latency);
+        runProbes(latency);
+    }
+
+    printf("%d failed checks\n", failcnt);
+    return (failcnt);
+}
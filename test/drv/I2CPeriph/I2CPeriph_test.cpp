@@ -0,0 +1,567 @@
+/**************************************************************************************************
+ * @file        I2CPeriph_test.cpp
+ * @author      Thomas
+ * @brief       Host test of the I2C driver i2c-dev calls (RaspberryPi), against a simulated slave
+ **************************************************************************************************
+ @ attention
+
+ << To be Introduced >>
+
+ *************************************************************************************************/
+/**************************************************************************************************
+ * How to use
+ * ----------
+ * Constructs 'I2CPeriph' against an i2c-dev device which doesn't exist, then links a function
+ * (".linkIoctl") which stands in for the driver - capturing each "I2C_RDWR" call, and simulating a
+ * slave device with a register pointer (first byte written), at address "TEST_ADDR". Any other
+ * address is not acknowledged. Checks:
+ *      Configuration       - fault if the device cannot be opened (and 'I2CBusMngr' doesn't
+ *                            add the bus), cleared once a function is linked
+ *      Framing             - "I2C_RDWR" messages of write, read and write then read forms;
+ *                            address, flags, length and data of each message. A batch of forms
+ *                            within a single call, and polling transfers
+ *      Faults              - not acknowledged address is "kNACK", driver rejection is
+ *                            "kDriver_Error"
+ *      Faulted forms       - a form faulted whilst queued is not transferred, but its completion
+ *                            callback is still called (signals its 'FormEvent'). The callback can
+ *                            request a new form (queue is not locked during the callback)
+ *      Bus scan            - bitmap of the acknowledged addresses. Driver calls which are slower
+ *                            than the timeout (interrupt emulation thread) return "kTimeout", and
+ *                            the probes not yet taken are not transferred
+ *      Worker              - forms submitted by the interrupt emulation thread, whilst polling
+ *                            transfers are made from another thread - no driver call overlaps
+ *                            another
+ *
+ * Built with the host stubs (see "test/run_tests.sh"):
+ *      g++ -std=gnu++11 -Dzz__MiRaspbPi__zz -Iinclude -Iinclude/milibrary -Itest/stubs
+ *          test/drv/I2CPeriph/I2CPeriph_test.cpp src/drv/I2CPeriph/I2CPeriph.cpp
+ *          src/drv/I2CPeriph/I2CBusMngr.cpp src/com/FormEvent/FormEvent.cpp -pthread
+ *
+ * Returns 0 if all checks pass, otherwise the number of failed checks.
+ *************************************************************************************************/
+#include "FileIndex.h"
+#include FilInd_I2CPe__HD
+#include FilInd_I2CMngHD
+#include FilInd_FrmEvtHD
+
+#include <stdio.h>                      // printf
+#include <string.h>                     // memcpy, memset
+#include <unistd.h>                     // usleep
+
+static int  failcnt = 0;                // Number of failed checks
+
+#define CHECK(cond)         do { if (!(cond)) { failcnt++;                                      \
+                                 printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); }       \
+                            } while (0)
+
+#define TEST_ADDR           0x48        // Address of the simulated slave (7bit)
+#define TEST_DEVADDR        (TEST_ADDR << 1)    // Address as provided to 'I2CPeriph'
+#define TEST_REGS           16          // Number of registers of the simulated slave
+#define TEST_CALLS          8           // Number of "I2C_RDWR" calls captured
+#define TEST_MSGS           8           // Number of messages captured per call
+#define TEST_FORMS          16          // Size of the I2C Request Form queue
+
+typedef struct {
+    uint8_t             Count;                  // Number of messages within call
+    struct i2c_msg      Msg[TEST_MSGS];         // Messages of the call
+    uint8_t             Data[TEST_MSGS][4];     // First bytes of each write message
+} MessageCall;
+
+static MessageCall  calls[TEST_CALLS];  // "I2C_RDWR" calls captured
+static uint8_t      callcnt = 0;        // Number of calls (keeps counting past "TEST_CALLS")
+
+static uint8_t      regs[TEST_REGS];    // Registers of the simulated slave
+static uint8_t      reg_ptr = 0;        // Register pointer of the simulated slave
+
+static bool         fail_driver = false;    // Reject all calls (not a NACK)
+static uint32_t     slow_us     = 0;        // Time taken by each call (us)
+static uint32_t     busy_inside  = 0;       // Calls in progress
+static uint32_t     busy_overlap = 0;       // Calls made whilst another was in progress
+
+static int slaveMessages(struct i2c_rdwr_ioctl_data *rdwr);
+
+static int slaveIoctl(int fd, unsigned long request, void *arg) {
+/**************************************************************************************************
+ * Stands in for the i2c-dev driver. Captures each "I2C_RDWR" call, then works through the
+ * messages against the simulated slave - first byte of a write sets the register pointer, further
+ * bytes written into the registers; reads return the registers from the pointer. Pointer
+ * increments after each register. A message to any other address is not acknowledged (EREMOTEIO).
+ * Any call made whilst another is in progress is counted ("busy_overlap").
+ *************************************************************************************************/
+    struct i2c_rdwr_ioctl_data *rdwr = (struct i2c_rdwr_ioctl_data *) arg;
+    int returnval = 0;
+
+    (void) fd;
+
+    if (request != I2C_RDWR)
+        return (0);
+
+    if (__atomic_fetch_add(&busy_inside, 1, __ATOMIC_ACQ_REL) != 0)
+        __atomic_fetch_add(&busy_overlap, 1, __ATOMIC_RELAXED);
+
+    returnval = slaveMessages(rdwr);
+
+    __atomic_fetch_sub(&busy_inside, 1, __ATOMIC_ACQ_REL);
+
+    return (returnval);
+}
+
+static int slaveMessages(struct i2c_rdwr_ioctl_data *rdwr) {
+/**************************************************************************************************
+ * Simulated slave, for a single "I2C_RDWR" call (see ".slaveIoctl")
+ *************************************************************************************************/
+    if (slow_us != 0)
+        usleep(slow_us);
+
+    if (callcnt < TEST_CALLS) {
+        calls[callcnt].Count = (uint8_t) rdwr->nmsgs;
+        for (uint32_t i = 0; (i != rdwr->nmsgs) && (i != TEST_MSGS); i++) {
+            calls[callcnt].Msg[i] = rdwr->msgs[i];
+            memset(calls[callcnt].Data[i], 0, sizeof(calls[callcnt].Data[i]));
+            if ((rdwr->msgs[i].flags & I2C_M_RD) == 0)
+                memcpy(calls[callcnt].Data[i], rdwr->msgs[i].buf,
+                       (rdwr->msgs[i].len < 4) ? rdwr->msgs[i].len : 4);
+        }
+    }
+    __atomic_fetch_add(&callcnt, 1, __ATOMIC_RELEASE);
+
+    if (fail_driver) {
+        errno = EIO;
+        return (-1);
+    }
+
+    for (uint32_t i = 0; i != rdwr->nmsgs; i++) {
+        struct i2c_msg *msg = &(rdwr->msgs[i]);
+
+        if (msg->addr != TEST_ADDR) {
+            errno = EREMOTEIO;
+            return (-1);
+        }
+
+        for (uint16_t k = 0; k != msg->len; k++) {
+            if (msg->flags & I2C_M_RD)
+                msg->buf[k] = regs[reg_ptr++ % TEST_REGS];
+            else if (k == 0)
+                reg_ptr = msg->buf[0];
+            else
+                regs[reg_ptr++ % TEST_REGS] = msg->buf[k];
+        }
+    }
+
+    return ((int) rdwr->nmsgs);
+}
+
+static void resetSlave(void) {
+    callcnt      = 0;
+    fail_driver  = false;
+    busy_overlap = 0;
+    slow_us      = 0;
+    reg_ptr      = 0;
+
+    for (uint8_t i = 0; i != TEST_REGS; i++)
+        regs[i] = (uint8_t) (0x80 + i);
+}
+
+static void checkMsg(uint8_t call, uint8_t i, uint16_t flags, uint16_t len) {
+/**************************************************************************************************
+ * Check message "i" of captured call "call"
+ *************************************************************************************************/
+    const struct i2c_msg *msg = &(calls[call].Msg[i]);
+
+    CHECK(msg->addr     == TEST_ADDR);
+    CHECK(msg->flags    == flags);
+    CHECK(msg->len      == len);
+}
+
+static void testConfig(void) {
+/**************************************************************************************************
+ * Device cannot be opened, then linked function stands in for it
+ *************************************************************************************************/
+    I2CPeriph::Form forms[TEST_FORMS];
+    I2CPeriph       i2c("/nonexistent/i2c-1", forms, TEST_FORMS);
+
+    CHECK(i2c.flt == I2CPeriph::DevFlt::kDriver_Error);
+
+    i2c.linkIoctl(&slaveIoctl);
+    CHECK(i2c.flt == I2CPeriph::DevFlt::kInitialised);
+
+    static I2CBusMngr mngr;
+    CHECK(mngr.addBus("/nonexistent/i2c-1") == I2CMn_NoBus);
+    CHECK(mngr.Flt == I2CBusMngr::DevFlt::kOpen_Error);
+    CHECK(mngr.BusCount == 0);
+    CHECK(mngr.bus(0) == __null);
+}
+
+static void testFraming(void) {
+/**************************************************************************************************
+ * Write (sets pointer, then 2 registers), read (from the pointer) and write then read forms, each
+ * submitted on their own. Then the same via the polling functions.
+ *************************************************************************************************/
+    I2CPeriph::Form forms[TEST_FORMS];
+    I2CPeriph       i2c("/nonexistent/i2c-1", forms, TEST_FORMS);
+
+    uint8_t                     wr[3]   = { 0x02, 0xA5, 0x5A };
+    uint8_t                     rd[2]   = { 0 };
+    uint8_t                     ptr     = 0x03;
+    uint8_t                     wrrd[2] = { 0 };
+    volatile I2CPeriph::DevFlt  flt     = I2CPeriph::DevFlt::kNone;
+    volatile uint16_t           cmp     = 0;
+
+    i2c.linkIoctl(&slaveIoctl);
+    resetSlave();
+
+    // Write
+    i2c.intMasterReq(TEST_DEVADDR, sizeof(wr), wr, I2CPeriph::CommMode::kAutoEnd,
+                     I2CPeriph::Request::kStart_Write, &flt, &cmp);
+    i2c.startInterrupt();
+
+    CHECK( (callcnt == 1) && (calls[0].Count == 1) );
+    checkMsg(0, 0, 0, sizeof(wr));
+    CHECK(calls[0].Msg[0].buf == wr);
+    CHECK( (flt == I2CPeriph::DevFlt::kNone) && (cmp == sizeof(wr)) );
+    CHECK( (regs[2] == 0xA5) && (regs[3] == 0x5A) );
+
+    // Read
+    reg_ptr = 0x02;
+    cmp     = 0;
+    i2c.intMasterReq(TEST_DEVADDR, sizeof(rd), rd, I2CPeriph::CommMode::kAutoEnd,
+                     I2CPeriph::Request::kStart_Read, &flt, &cmp);
+    i2c.startInterrupt();
+
+    CHECK( (callcnt == 2) && (calls[1].Count == 1) );
+    checkMsg(1, 0, I2C_M_RD, sizeof(rd));
+    CHECK(calls[1].Msg[0].buf == rd);
+    CHECK( (flt == I2CPeriph::DevFlt::kNone) && (cmp == sizeof(rd)) );
+    CHECK( (rd[0] == 0xA5) && (rd[1] == 0x5A) );
+
+    // Write then read (repeated START, within a single call)
+    cmp     = 0;
+    i2c.intMasterWriteRead(TEST_DEVADDR, 1, &ptr, sizeof(wrrd), wrrd, &flt, &cmp);
+    i2c.startInterrupt();
+
+    CHECK( (callcnt == 3) && (calls[2].Count == 2) );
+    checkMsg(2, 0, 0, 1);
+    checkMsg(2, 1, I2C_M_RD, sizeof(wrrd));
+    CHECK(calls[2].Data[0][0] == ptr);
+    CHECK(calls[2].Msg[1].buf == wrrd);
+    CHECK( (flt == I2CPeriph::DevFlt::kNone) && (cmp == sizeof(wrrd)) );
+    CHECK( (wrrd[0] == 0x5A) && (wrrd[1] == 0x84) );
+
+    // Polling
+    resetSlave();
+    memset(wrrd, 0, sizeof(wrrd));
+
+    CHECK(i2c.poleMasterTransmit(TEST_DEVADDR, wr, sizeof(wr)) == I2CPeriph::DevFlt::kNone);
+    CHECK(i2c.poleMasterWriteRead(TEST_DEVADDR, &wr[0], 1, wrrd, sizeof(wrrd)) ==
+          I2CPeriph::DevFlt::kNone);
+    CHECK( (callcnt == 2) && (calls[0].Count == 1) && (calls[1].Count == 2) );
+    checkMsg(0, 0, 0, sizeof(wr));
+    checkMsg(1, 0, 0, 1);
+    checkMsg(1, 1, I2C_M_RD, sizeof(wrrd));
+    CHECK( (wrrd[0] == 0xA5) && (wrrd[1] == 0x5A) );
+}
+
+static I2CPeriph            *batch_i2c  = __null;   // Bus to queue batch on
+static uint8_t              batch_wr[2] = { 0x04, 0x11 };
+static uint8_t              batch_rd[1] = { 0 };
+static uint8_t              batch_ptr   = 0x04;
+static uint8_t              batch_wrrd[1] = { 0 };
+static volatile I2CPeriph::DevFlt   batch_flt[3];
+static volatile uint16_t            batch_cmp[3];
+
+static void batchCallback(void *context) {
+/**************************************************************************************************
+ * Completion callback of the first form, queues 3 further forms - which are taken as a single
+ * batch once the first form is closed out
+ *************************************************************************************************/
+    (void) context;
+
+    batch_i2c->intMasterReq(TEST_DEVADDR, sizeof(batch_wr), batch_wr,
+                            I2CPeriph::CommMode::kAutoEnd, I2CPeriph::Request::kStart_Write,
+                            &batch_flt[0], &batch_cmp[0]);
+    batch_i2c->intMasterReq(TEST_DEVADDR, sizeof(batch_rd), batch_rd,
+                            I2CPeriph::CommMode::kAutoEnd, I2CPeriph::Request::kStart_Read,
+                            &batch_flt[1], &batch_cmp[1]);
+    batch_i2c->intMasterWriteRead(TEST_DEVADDR, 1, &batch_ptr, sizeof(batch_wrrd), batch_wrrd,
+                                  &batch_flt[2], &batch_cmp[2]);
+}
+
+static void testBatch(void) {
+/**************************************************************************************************
+ * Write, read and write then read forms within a single call (4 messages, repeated START between
+ * each)
+ *************************************************************************************************/
+    I2CPeriph::Form forms[TEST_FORMS];
+    I2CPeriph       i2c("/nonexistent/i2c-1", forms, TEST_FORMS);
+
+    uint8_t                     first   = 0x00;
+    volatile I2CPeriph::DevFlt  flt     = I2CPeriph::DevFlt::kNone;
+    volatile uint16_t           cmp     = 0;
+
+    i2c.linkIoctl(&slaveIoctl);
+    resetSlave();
+    batch_i2c = &i2c;
+
+    for (uint8_t i = 0; i != 3; i++) {
+        batch_flt[i] = I2CPeriph::DevFlt::kNone;
+        batch_cmp[i] = 0;
+    }
+
+    i2c.intMasterReq(TEST_DEVADDR, 1, &first, I2CPeriph::CommMode::kAutoEnd,
+                     I2CPeriph::Request::kStart_Write, &flt, &cmp, &batchCallback);
+    i2c.startInterrupt();
+
+    CHECK( (callcnt == 2) && (calls[0].Count == 1) && (calls[1].Count == 4) );
+    checkMsg(1, 0, 0,        sizeof(batch_wr));
+    checkMsg(1, 1, I2C_M_RD, sizeof(batch_rd));
+    checkMsg(1, 2, 0,        1);
+    checkMsg(1, 3, I2C_M_RD, sizeof(batch_wrrd));
+
+    CHECK(cmp == 1);
+    CHECK( (batch_cmp[0] == 2) && (batch_cmp[1] == 1) && (batch_cmp[2] == 1) );
+    CHECK( (batch_flt[0] == I2CPeriph::DevFlt::kNone) &&
+           (batch_flt[1] == I2CPeriph::DevFlt::kNone) &&
+           (batch_flt[2] == I2CPeriph::DevFlt::kNone) );
+    CHECK(batch_rd[0]   == 0x85);           // Pointer moved on by the write
+    CHECK(batch_wrrd[0] == 0x11);
+}
+
+static void testFaults(void) {
+/**************************************************************************************************
+ * Address not acknowledged ("kNACK"), and driver rejecting the call ("kDriver_Error")
+ *************************************************************************************************/
+    I2CPeriph::Form forms[TEST_FORMS];
+    I2CPeriph       i2c("/nonexistent/i2c-1", forms, TEST_FORMS);
+
+    uint8_t                     wr[2]   = { 0x01, 0x02 };
+    volatile I2CPeriph::DevFlt  flt     = I2CPeriph::DevFlt::kNone;
+    volatile uint16_t           cmp     = 0;
+
+    i2c.linkIoctl(&slaveIoctl);
+    resetSlave();
+
+    i2c.intMasterReq((TEST_ADDR + 1) << 1, sizeof(wr), wr, I2CPeriph::CommMode::kAutoEnd,
+                     I2CPeriph::Request::kStart_Write, &flt, &cmp);
+    i2c.startInterrupt();
+
+    CHECK(callcnt == 1);
+    CHECK(calls[0].Msg[0].addr == (TEST_ADDR + 1));
+    CHECK( (flt == I2CPeriph::DevFlt::kNACK) && (cmp == 0) );
+    CHECK(i2c.poleDeviceRdy((TEST_ADDR + 1) << 1) == I2CPeriph::DevFlt::kNACK);
+    CHECK(i2c.poleDeviceRdy(TEST_DEVADDR)         == I2CPeriph::DevFlt::kNone);
+
+    fail_driver = true;
+    flt         = I2CPeriph::DevFlt::kNone;
+    i2c.intMasterReq(TEST_DEVADDR, sizeof(wr), wr, I2CPeriph::CommMode::kAutoEnd,
+                     I2CPeriph::Request::kStart_Write, &flt, &cmp);
+    i2c.startInterrupt();
+
+    CHECK( (flt == I2CPeriph::DevFlt::kDriver_Error) && (cmp == 0) );
+    CHECK(i2c.poleMasterTransmit(TEST_DEVADDR, wr, sizeof(wr)) ==
+          I2CPeriph::DevFlt::kDriver_Error);
+}
+
+static I2CPeriph                    *fault_i2c  = __null;   // Bus to queue forms on
+static FormEvent                    fault_event;            // Event of the queued forms
+static uint8_t                      fault_wr[2] = { 0x01, 0x02 };
+static volatile I2CPeriph::DevFlt   fault_flt[2];
+static volatile uint16_t            fault_cmp[2];
+
+static void faultCallback(void *context) {
+/**************************************************************************************************
+ * Completion callback of the first form, queues 2 further forms (bus is still communicating, so
+ * both are queued before either is taken). Source then faults the first of them.
+ *************************************************************************************************/
+    (void) context;
+
+    for (uint8_t i = 0; i != 2; i++)
+        fault_i2c->intMasterReq(TEST_DEVADDR, 1, &fault_wr[i], I2CPeriph::CommMode::kAutoEnd,
+                                I2CPeriph::Request::kStart_Write, &fault_flt[i], &fault_cmp[i],
+                                &FormEvent::formCallback, &fault_event);
+
+    fault_flt[0] = I2CPeriph::DevFlt::kBus_Error;   // Source faults the first form
+}
+
+static uint8_t                      requeue_wr  = 0x07;
+static volatile I2CPeriph::DevFlt   requeue_flt[2];
+static volatile uint16_t            requeue_cmp[2];
+
+static void requeueCallback(void *context) {
+/**************************************************************************************************
+ * Completion callback of the faulted form, requests a new form
+ *************************************************************************************************/
+    (void) context;
+
+    fault_i2c->intMasterReq(TEST_DEVADDR, 1, &requeue_wr, I2CPeriph::CommMode::kAutoEnd,
+                            I2CPeriph::Request::kStart_Write, &requeue_flt[1], &requeue_cmp[1]);
+}
+
+static void requeueFirst(void *context) {
+/**************************************************************************************************
+ * Completion callback of the first form, queues a form (linked to ".requeueCallback") - which the
+ * source then faults
+ *************************************************************************************************/
+    (void) context;
+
+    fault_i2c->intMasterReq(TEST_DEVADDR, 1, &fault_wr[0], I2CPeriph::CommMode::kAutoEnd,
+                            I2CPeriph::Request::kStart_Write, &requeue_flt[0], &requeue_cmp[0],
+                            &requeueCallback);
+    requeue_flt[0] = I2CPeriph::DevFlt::kBus_Error;
+}
+
+static void testFaulted(void) {
+/**************************************************************************************************
+ * Form faulted by the source whilst within the queue, is removed without being transferred. Its
+ * 'FormEvent' is still signalled, along with the form after it (which is transferred).
+ *************************************************************************************************/
+    I2CPeriph::Form forms[TEST_FORMS];
+    I2CPeriph       i2c("/nonexistent/i2c-1", forms, TEST_FORMS);
+
+    uint8_t                     first   = 0x00;
+    volatile I2CPeriph::DevFlt  flt     = I2CPeriph::DevFlt::kNone;
+    volatile uint16_t           cmp     = 0;
+
+    i2c.linkIoctl(&slaveIoctl);
+    resetSlave();
+    fault_i2c = &i2c;
+    fault_event.clear();
+
+    for (uint8_t i = 0; i != 2; i++) {
+        fault_flt[i] = I2CPeriph::DevFlt::kNone;
+        fault_cmp[i] = 0;
+    }
+
+    i2c.intMasterReq(TEST_DEVADDR, 1, &first, I2CPeriph::CommMode::kAutoEnd,
+                     I2CPeriph::Request::kStart_Write, &flt, &cmp, &faultCallback);
+    i2c.startInterrupt();
+
+    CHECK(fault_event.wait(2, 100) == FormEvent::EvntState::kSignalled);
+    CHECK(fault_event.count() == 2);
+    CHECK( (callcnt == 2) && (calls[1].Count == 1) );
+    CHECK(calls[1].Msg[0].buf == &fault_wr[1]);
+    CHECK( (fault_cmp[0] == 0) && (fault_cmp[1] == 1) );
+    CHECK(fault_flt[0] == I2CPeriph::DevFlt::kBus_Error);
+
+    // Completion callback of the faulted form requests a new form
+    resetSlave();
+    for (uint8_t i = 0; i != 2; i++) {
+        requeue_flt[i] = I2CPeriph::DevFlt::kNone;
+        requeue_cmp[i] = 0;
+    }
+    alarm(5);                                       // Deadlock fails, rather than hangs
+
+    i2c.intMasterReq(TEST_DEVADDR, 1, &first, I2CPeriph::CommMode::kAutoEnd,
+                     I2CPeriph::Request::kStart_Write, &flt, &cmp, &requeueFirst);
+    i2c.startInterrupt();
+
+    alarm(0);
+    CHECK( (callcnt == 2) && (calls[1].Msg[0].buf == &requeue_wr) );
+    CHECK( (requeue_cmp[0] == 0) && (requeue_cmp[1] == 1) );
+    CHECK(requeue_flt[1] == I2CPeriph::DevFlt::kNone);
+}
+
+static void testScan(void) {
+/**************************************************************************************************
+ * Scan finds only the simulated slave. Then with each driver call slower than the timeout allows
+ * for a set of probes (queue size), the scan returns "kTimeout" - and once returned, no further
+ * probes are transferred.
+ *************************************************************************************************/
+    I2CPeriph::Form forms[TEST_FORMS];
+    I2CPeriph       i2c("/nonexistent/i2c-1", forms, TEST_FORMS);
+
+    uint8_t         bitmap[I2CPe_ScanBytes];
+    uint8_t         i = 0;
+    uint8_t         taken = 0;
+
+    i2c.linkIoctl(&slaveIoctl);
+    resetSlave();
+
+    CHECK(i2c.poleBusScan(bitmap) == I2CPeriph::DevFlt::kNone);
+    CHECK(callcnt == (uint8_t) (I2CPe_ScanLast - I2CPe_ScanFirst + 1));
+    for (i = 0; i != I2CPe_ScanBytes; i++)
+        CHECK(bitmap[i] == ((i == (TEST_ADDR >> 3)) ? (1 << (TEST_ADDR & 0x07)) : 0));
+
+    resetSlave();
+    slow_us = (I2CPe_ScanTimeout * 1000) / 4;   // Around 5 probes taken before timeout
+    CHECK(i2c.startWorker(0, -1) == I2CPeriph::DevFlt::kNone);
+
+    CHECK(i2c.poleBusScan(bitmap) == I2CPeriph::DevFlt::kTimeout);
+    taken = __atomic_load_n(&callcnt, __ATOMIC_ACQUIRE);
+    CHECK( (taken != 0) && (taken < (TEST_FORMS / 2)) );
+
+    usleep(2 * slow_us);                // Cancelled probes are not transferred
+    CHECK(__atomic_load_n(&callcnt, __ATOMIC_ACQUIRE) == taken);
+    for (i = 0; i != I2CPe_ScanBytes; i++)
+        CHECK(bitmap[i] == 0);
+
+    i2c.stopWorker();
+    CHECK(i2c.flt == I2CPeriph::DevFlt::kTimeout);
+}
+
+static void testWorker(void) {
+/**************************************************************************************************
+ * Write forms submitted by the interrupt emulation thread, whilst polling transfers (write, then
+ * write then read back) are made from this thread. No driver call is to overlap another (register
+ * pointer of the slave would be moved between the polling write and read), and all forms/polling
+ * transfers complete.
+ *************************************************************************************************/
+    I2CPeriph::Form forms[TEST_FORMS];
+    I2CPeriph       i2c("/nonexistent/i2c-1", forms, TEST_FORMS);
+
+    uint8_t                     wr[TEST_FORMS / 2][2];
+    volatile I2CPeriph::DevFlt  flt[TEST_FORMS / 2];
+    volatile uint16_t           cmp[TEST_FORMS / 2];
+    uint8_t                     poll_wr[2] = { (TEST_REGS - 1), 0 };
+    uint8_t                     poll_rd = 0;
+    uint8_t                     poll_ok = 1;
+    uint8_t                     i = 0;
+
+    i2c.linkIoctl(&slaveIoctl);
+    resetSlave();
+    slow_us = 50;
+    CHECK(i2c.startWorker(0, -1) == I2CPeriph::DevFlt::kNone);
+
+    for (i = 0; i != (TEST_FORMS / 2); i++) {
+        wr[i][0] = i;
+        wr[i][1] = (uint8_t) (0x40 + i);
+        flt[i]   = I2CPeriph::DevFlt::kNone;
+        cmp[i]   = 0;
+        i2c.intMasterReq(TEST_DEVADDR, sizeof(wr[i]), wr[i], I2CPeriph::CommMode::kAutoEnd,
+                         I2CPeriph::Request::kStart_Write, &flt[i], &cmp[i]);
+
+        poll_wr[1] = (uint8_t) (0xC0 + i);
+        if ( (i2c.poleMasterTransmit(TEST_DEVADDR, poll_wr, sizeof(poll_wr)) !=
+              I2CPeriph::DevFlt::kNone) ||
+             (i2c.poleMasterWriteRead(TEST_DEVADDR, &poll_wr[0], 1, &poll_rd, 1) !=
+              I2CPeriph::DevFlt::kNone) ||
+             (poll_rd != poll_wr[1]) )
+            poll_ok = 0;
+    }
+
+    for (i = 0; i != (TEST_FORMS / 2); i++) {
+        while ( (__atomic_load_n(&cmp[i], __ATOMIC_ACQUIRE) == 0) &&
+                (flt[i] == I2CPeriph::DevFlt::kNone) ) {};
+    }
+
+    i2c.stopWorker();                               // Returns once the thread has exited
+
+    CHECK(poll_ok == 1);
+    CHECK(__atomic_load_n(&busy_overlap, __ATOMIC_ACQUIRE) == 0);
+    for (i = 0; i != (TEST_FORMS / 2); i++)
+        CHECK( (cmp[i] == sizeof(wr[i])) && (regs[i] == (0x40 + i)) );
+    CHECK(i2c.comm_state == I2CPeriph::CommLock::kFree);
+}
+
+int main(void) {
+    testConfig();
+    testFraming();
+    testBatch();
+    testFaults();
+    testFaulted();
+    testScan();
+    testWorker();
+
+    printf("%d failed checks\n", failcnt);
+
+    return (failcnt);
+}
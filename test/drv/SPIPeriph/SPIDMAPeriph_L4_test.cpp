@@ -0,0 +1,366 @@
+/**************************************************************************************************
+ * @file        SPIDMAPeriph_L4_test.cpp
+ * @author      Thomas
+ * @brief       Host test of the SPI with DMA driver (STM32L4), against a DMA/SPI model
+ **************************************************************************************************
+ @ attention
+
+ << To be Introduced >>
+
+ *************************************************************************************************/
+/**************************************************************************************************
+ * How to use
+ * ----------
+ * Models the Transmit and Receive DMA channels linked to the STM32L4 SPI. Each frame time, the
+ * Transmit DMA takes a frame from memory (size and increment as per its configuration), and the
+ * Receive DMA puts the inverse of the frame into memory. Once the Receive DMA count reaches 0,
+ * its transfer complete interrupt is called. Checks:
+ *      Forms               - 8bit, 16bit, receive only (dummy transmit) and transmit only forms
+ *                            are transferred by the DMAs, with coalescing of forms to the same
+ *                            device (Chip Select changes only at the edge of each group)
+ *      Scatter-gather      - not transferred by DMA, the SPI interrupts are used
+ *      Stream fault        - a Receive DMA error whilst streaming stops the stream within the
+ *                            interrupt, without waiting upon the bus (even if the bus stays busy),
+ *                            and then starts any form requested whilst streaming
+ *
+ * The memory addresses within the DMA registers are 32bit (lower 32bits of the host location), so
+ * the model finds the location within the memory regions it knows of ("modelRegion" - buffers,
+ * and the driver which holds the dummy transmit/receive locations). An address outside of these
+ * fails a check. ".busBusyChk" is provided by this test in place of the driver library (see
+ * "test/run_tests.sh"):
+ *      g++ -std=gnu++11 -fPIC -shared -Dzz__MiSTM32Lx__zz -Iinclude -Iinclude/milibrary
+ *          -Itest/stubs -Itest/stubs/l4 src/drv/SPIPeriph/SPIPeriph.cpp
+ *          src/drv/SPIPeriph/SPIDMAPeriph.cpp src/drv/DMAPeriph/DMAPeriph.cpp
+ *          src/drv/GPIO/DeMux/DeMux.cpp test/stubs/HostStubs.cpp -o libSPIDMAPeriph_L4_test.so
+ *      g++ -std=gnu++11 -Dzz__MiSTM32Lx__zz -Iinclude -Iinclude/milibrary -Itest/stubs
+ *          -Itest/stubs/l4 test/drv/SPIPeriph/SPIDMAPeriph_L4_test.cpp -L.
+ *          -lSPIDMAPeriph_L4_test
+ *
+ * Returns 0 if all checks pass, otherwise the number of failed checks.
+ *************************************************************************************************/
+#include "FileIndex.h"
+#include FilInd_SPIDMAHD
+
+#include "HostStubs.h"
+
+#include <stdio.h>                      // printf
+#include <string.h>                     // memset
+
+static int  failcnt = 0;                // Number of failed checks
+
+#define CHECK(cond)         do { if (!(cond)) { failcnt++;                                      \
+                                 printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); }       \
+                            } while (0)
+
+#define TEST_FORMS          8           // Size of the SPI Request Form queue
+#define TEST_BUFFER         600         // Size of each transmit/receive buffer (bytes)
+#define TEST_TIMEOUT        100000      // Maximum frame times of a transfer
+#define TEST_STREAM         64          // Size of the stream 'GenBuffer' (bytes)
+#define TEST_REGIONS        8           // Number of model memory regions
+
+typedef struct {
+    uint8_t     *Base;                  // Host location of region
+    size_t      Size;                   // Size of region (bytes)
+} MemRegion;
+
+typedef struct {
+    uint32_t    Memory;                 // Memory address latched at start of transfer
+    uint32_t    Count;                  // Count latched at start of transfer
+    uint32_t    Offset;                 // Offset from memory address of next frame
+} ChannelState;
+
+static SPI_TypeDef          regs;       // Modelled SPI registers
+static DMA_Channel_TypeDef  ch_tx, ch_rx, ch_cadence;
+static DMA_TypeDef          dma_tx, dma_rx, dma_cadence;
+static TIM_TypeDef          tim;
+static GPIO_TypeDef         port;
+
+static SPI_HandleTypeDef    hspi;
+static DMA_HandleTypeDef    hdma_tx, hdma_rx, hdma_cadence;
+static TIM_HandleTypeDef    htim;
+
+static uint8_t      txbuff[4][TEST_BUFFER]; // Model memory (within the executable, below 4GB)
+static uint8_t      rxbuff[4][TEST_BUFFER];
+static uint8_t      stream_array[TEST_STREAM];
+static uint8_t      stream_command[2] = { 0x12, 0x34 };
+
+static ChannelState state_tx, state_rx;
+static MemRegion    memory[TEST_REGIONS];   // Model memory regions
+static uint8_t      memcnt;                 // Number of model memory regions
+static uint8_t      scratch[4];             // Location for frames outside of the model memory
+static uint8_t      overrun;            // Frame transmitted with the Receive DMA not ready
+static uint8_t      in_irq;             // Within an interrupt
+static uint32_t     irq_waits;          // Calls to ".busBusyChk" within an interrupt
+
+uint8_t SPIPeriph::busBusyChk(void) {
+/**************************************************************************************************
+ * Returns the busy flag of the model. Captures any check made within an interrupt (returning
+ * not busy, so the test continues)
+ *************************************************************************************************/
+    if (in_irq != 0) {
+        irq_waits++;
+        return (0);
+    }
+
+    return ( ((regs.SR & SPI_SR_BSY) != 0) ? 1 : 0 );
+}
+
+static void modelRegion(void *Base, size_t Size) {
+/**************************************************************************************************
+ * Add a model memory region, which the DMAs can access
+ *************************************************************************************************/
+    if (memcnt != TEST_REGIONS) {
+        memory[memcnt].Base = (uint8_t *) Base;
+        memory[memcnt].Size = Size;
+        memcnt++;
+    }
+}
+
+static uint8_t *modelMemory(uint32_t Address) {
+/**************************************************************************************************
+ * Returns the host location of the 32bit DMA memory "Address" (lower 32bits of the host
+ * location), within the model memory regions. If not within a region, fails a check and returns
+ * a scratch location.
+ *************************************************************************************************/
+    uint32_t base;
+
+    for (uint8_t i = 0; i != memcnt; i++) {
+        base = (uint32_t) (uintptr_t) memory[i].Base;
+        if ((uint32_t) (Address - base) < memory[i].Size)
+            return (memory[i].Base + (Address - base));
+    }
+
+    CHECK(Address == 0);                        // Not within the model memory
+    return (scratch);
+}
+
+static uint8_t *channelFrame(DMA_Channel_TypeDef *channel, ChannelState *state, uint8_t width) {
+/**************************************************************************************************
+ * Returns the memory location of the next frame of "channel", and moves on the count. A new
+ * transfer is detected by a change of memory address, or an increase of the count.
+ *************************************************************************************************/
+    uint8_t *location;
+
+    if ( (channel->CMAR != state->Memory) || (channel->CNDTR > state->Count) )
+        state->Offset = 0;
+
+    location = modelMemory(channel->CMAR + state->Offset);
+
+    if ((channel->CCR & DMA_CCR_MINC) != 0)
+        state->Offset += width;
+
+    channel->CNDTR--;
+    state->Memory   = channel->CMAR;
+    state->Count    = channel->CNDTR;
+
+    return (location);
+}
+
+static void clockFrame(SPIDMAPeriph *spi) {
+/**************************************************************************************************
+ * Clock one frame time. If the Transmit DMA is linked and enabled, a frame is taken from memory
+ * and the inverse put into memory by the Receive DMA - calling the Receive DMA interrupt when its
+ * count reaches 0.
+ *************************************************************************************************/
+    uint8_t     width = ((ch_tx.CCR & DMA_CCR_PSIZE) != 0) ? 2 : 1;
+    uint16_t    frame;
+    uint8_t     *location;
+
+    if ( ((regs.CR2 & SPI_CR2_TXDMAEN) == 0) || ((ch_tx.CCR & DMA_CCR_EN) == 0) ||
+         (ch_tx.CNDTR == 0) )
+        return;
+
+    CHECK(ch_tx.CPAR == (uint32_t) (uintptr_t) &regs.DR);
+    CHECK(((ch_rx.CCR & DMA_CCR_PSIZE) != 0) == (width == 2));
+
+    location = channelFrame(&ch_tx, &state_tx, width);
+    frame = (uint16_t) ~((width == 2) ? *(uint16_t *) location : *location);
+
+    if ( ((regs.CR2 & SPI_CR2_RXDMAEN) == 0) || ((ch_rx.CCR & DMA_CCR_EN) == 0) ||
+         (ch_rx.CNDTR == 0) ) {
+        overrun = 1;
+        return;
+    }
+
+    location = channelFrame(&ch_rx, &state_rx, width);
+    if (width == 2)
+        *(uint16_t *) location = frame;
+    else
+        *location = (uint8_t) frame;
+
+    if (ch_rx.CNDTR == 0) {
+        dma_rx.ISR |= __HAL_DMA_GET_GI_FLAG_INDEX(&hdma_rx) | __HAL_DMA_GET_TC_FLAG_INDEX(&hdma_rx);
+
+        if ((ch_rx.CCR & DMA_IT_TC) != 0) {
+            in_irq = 1;
+            spi->handleDMARxIRQ();
+            in_irq = 0;
+            dma_rx.ISR = 0;                     // Flags cleared by the driver (IFCR)
+        }
+    }
+}
+
+static void resetModel(void) {
+/**************************************************************************************************
+ * Clear the registers of the model, and link the handles
+ *************************************************************************************************/
+    memset(&regs, 0, sizeof(regs));
+    memset(&ch_tx, 0, sizeof(ch_tx));           memset(&dma_tx, 0, sizeof(dma_tx));
+    memset(&ch_rx, 0, sizeof(ch_rx));           memset(&dma_rx, 0, sizeof(dma_rx));
+    memset(&ch_cadence, 0, sizeof(ch_cadence)); memset(&dma_cadence, 0, sizeof(dma_cadence));
+    memset(&tim, 0, sizeof(tim));
+    memset(&state_tx, 0, sizeof(state_tx));
+    memset(&state_rx, 0, sizeof(state_rx));
+
+    hspi.Instance               = &regs;
+    hdma_tx.Instance            = &ch_tx;
+    hdma_tx.DmaBaseAddress      = &dma_tx;
+    hdma_tx.Init.Direction      = DMA_MEMORY_TO_PERIPH;
+    hdma_rx.Instance            = &ch_rx;
+    hdma_rx.DmaBaseAddress      = &dma_rx;
+    hdma_rx.Init.Direction      = DMA_PERIPH_TO_MEMORY;
+    hdma_cadence.Instance       = &ch_cadence;
+    hdma_cadence.DmaBaseAddress = &dma_cadence;
+    hdma_cadence.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    htim.Instance               = &tim;
+
+    overrun     = 0;
+    irq_waits   = 0;
+
+    memcnt      = 0;
+    modelRegion(txbuff, sizeof(txbuff));
+    modelRegion(rxbuff, sizeof(rxbuff));
+    modelRegion(stream_array, sizeof(stream_array));
+    modelRegion(stream_command, sizeof(stream_command));
+
+    for (uint8_t i = 0; i != 4; i++) {
+        for (uint16_t k = 0; k != TEST_BUFFER; k++) {
+            txbuff[i][k] = (uint8_t) ((i * 31) + k);
+            rxbuff[i][k] = 0;
+        }
+    }
+
+    stubGPIOClear();
+}
+
+static void testForms(void) {
+/**************************************************************************************************
+ * Forms are transferred by the DMAs (coalesced where to the same device and data width), and
+ * scatter-gather forms use the SPI interrupts
+ *************************************************************************************************/
+    static SPIPeriph::Form forms[TEST_FORMS];
+    volatile uint16_t   cmplt[5] = { 0, 0, 0, 0, 0 };
+    volatile SPIPeriph::DevFlt flt[5];
+    uint32_t            i;
+
+    resetModel();
+
+    static SPIDMAPeriph spi(&hspi, forms, TEST_FORMS, &hdma_rx, &hdma_tx);
+    modelRegion(&spi, sizeof(spi));             // Dummy transmit/receive locations
+    GPIO cs_a(&port, 0, GPIO::kOutput);
+    GPIO cs_b(&port, 1, GPIO::kOutput);
+
+    for (i = 0; i != 5; i++)
+        flt[i] = SPIPeriph::DevFlt::kNone;
+
+    spi.configCoalesce(SPIPeriph::kCoalesce_On);
+
+    spi.intMasterTransfer(&cs_a, 512, txbuff[0], rxbuff[0], &flt[0], &cmplt[0]);
+    spi.intMasterTransfer(&cs_a, 100, (uint16_t *) txbuff[1], (uint16_t *) rxbuff[1],
+                          &flt[1], &cmplt[1]);  // 16bit, not coalesced with 8bit
+    spi.intMasterTransfer(&cs_a, 50, (uint16_t *) txbuff[2], (uint16_t *) rxbuff[2],
+                          &flt[2], &cmplt[2]);  // Coalesced
+    spi.intMasterTransfer(&cs_b, 300, (uint8_t *) __null, rxbuff[3], &flt[3], &cmplt[3]);
+    spi.intMasterTransfer(&cs_b, 200, txbuff[3], (uint8_t *) __null, &flt[4], &cmplt[4]);
+
+    for (i = 0; (spi.CommState != SPIPeriph::CommLock::kFree) && (i != TEST_TIMEOUT); i++)
+        clockFrame(&spi);
+
+    CHECK(spi.CommState == SPIPeriph::CommLock::kFree);
+    CHECK(overrun == 0);
+    CHECK(cmplt[0] == 512);
+    CHECK(cmplt[1] == 100);
+    CHECK(cmplt[2] == 50);
+    CHECK(cmplt[3] == 300);
+    CHECK(cmplt[4] == 200);
+    for (i = 0; i != 5; i++)
+        CHECK(flt[i] == SPIPeriph::DevFlt::kNone);
+
+    for (i = 0; i != 512; i++)
+        CHECK(rxbuff[0][i] == (uint8_t) ~txbuff[0][i]);
+    for (i = 0; i != 200; i++)
+        CHECK(rxbuff[1][i] == (uint8_t) ~txbuff[1][i]);
+    for (i = 0; i != 100; i++)
+        CHECK(rxbuff[2][i] == (uint8_t) ~txbuff[2][i]);
+    for (i = 0; i != 300; i++)
+        CHECK(rxbuff[3][i] == 0xFF);            // Inverse of the dummy transmit
+
+    CHECK(spi.CoalesceCnt == 2);
+    CHECK(StubGPIOCnt == 6);                    // Select/de-select of each group
+
+    // Scatter-gather form
+    SPIPeriph::Segment          segment = { txbuff[0], 4 };
+    volatile uint16_t           sg_cmplt = 0;
+    volatile SPIPeriph::DevFlt  sg_flt = SPIPeriph::DevFlt::kNone;
+
+    spi.intMasterTransfer(&segment, 1, &segment, 1, &sg_flt, &sg_cmplt);
+
+    CHECK((regs.CR2 & SPI_CR2_TXEIE) != 0);
+    CHECK((regs.CR2 & SPI_CR2_TXDMAEN) == 0);
+}
+
+static void testStreamFault(void) {
+/**************************************************************************************************
+ * A Receive DMA error whilst streaming, with the bus still busy, stops the stream within the
+ * interrupt without waiting upon the bus, then starts the form requested whilst streaming
+ *************************************************************************************************/
+    static SPIPeriph::Form forms[TEST_FORMS];
+    static GenBuffer<uint8_t> stream(stream_array, TEST_STREAM);
+    volatile uint16_t   cmplt = 0;
+    volatile SPIPeriph::DevFlt flt = SPIPeriph::DevFlt::kNone;
+    uint32_t            i;
+
+    resetModel();
+
+    static SPIDMAPeriph spi(&hspi, forms, TEST_FORMS, &hdma_rx, &hdma_tx);
+    modelRegion(&spi, sizeof(spi));             // Dummy transmit/receive locations
+
+    CHECK(spi.startStream(stream_command, 2, SPIPeriph::DataWidth::k8bit, &stream, &htim,
+                          &hdma_cadence) == SPIPeriph::DevFlt::kNone);
+    CHECK((tim.CR1 & TIM_CR1_CEN) != 0);
+
+    spi.intMasterTransfer(16, txbuff[0], rxbuff[0], &flt, &cmplt);  // Queued behind stream
+    CHECK(cmplt == 0);
+
+    regs.SR    |= SPI_SR_BSY;                   // Bus stays busy
+    dma_rx.ISR  = __HAL_DMA_GET_GI_FLAG_INDEX(&hdma_rx) | __HAL_DMA_GET_TE_FLAG_INDEX(&hdma_rx);
+
+    in_irq = 1;
+    spi.handleDMARxIRQ();
+    in_irq = 0;
+    dma_rx.ISR = 0;                             // Flags cleared by the driver (IFCR)
+
+    CHECK(irq_waits == 0);
+    CHECK(spi.Flt == SPIPeriph::DevFlt::kDMA_Rx_Error);
+    CHECK((tim.CR1 & TIM_CR1_CEN) == 0);
+    CHECK((ch_cadence.CCR & DMA_CCR_EN) == 0);
+    CHECK((ch_rx.CCR & DMA_CCR_CIRC) == 0);
+
+    regs.SR &= ~SPI_SR_BSY;
+    for (i = 0; (spi.CommState != SPIPeriph::CommLock::kFree) && (i != TEST_TIMEOUT); i++)
+        clockFrame(&spi);
+
+    CHECK(spi.CommState == SPIPeriph::CommLock::kFree);
+    CHECK(cmplt == 16);
+    CHECK(flt == SPIPeriph::DevFlt::kNone);
+    for (i = 0; i != 16; i++)
+        CHECK(rxbuff[0][i] == (uint8_t) ~txbuff[0][i]);
+}
+
+int main(void) {
+    testForms();
+    testStreamFault();
+
+    printf("%d failed checks\n", failcnt);
+    return (failcnt);
+}
@@ -0,0 +1,275 @@
+/**************************************************************************************************
+ * @file        SPIPeriph_L4_test.cpp
+ * @author      Thomas
+ * @brief       Host test of the SPI driver interrupt transfers (STM32L4), against a FIFO model
+ **************************************************************************************************
+ @ attention
+
+ << To be Introduced >>
+
+ *************************************************************************************************/
+/**************************************************************************************************
+ * How to use
+ * ----------
+ * Models the STM32L4 SPI block - 4 byte TX and RX FIFOs either side of a shift register, with the
+ * status register (TXE, RXNE, OVR, FTLVL, FRLVL) updated as frames are clocked through. RXNE
+ * follows the RX FIFO threshold (1 byte if "FRXTH" set, otherwise 2 bytes). Received data is the
+ * inverse of the transmitted data.
+ * The Data Register accesses of 'SPIPeriph' (".readDR", ".writeDR", ".readDRPacked",
+ * ".writeDRPacked") are provided by this test in place of the driver library, so each access is
+ * applied to the model. Interrupt transfers of 8bit and 16bit frames, for odd/even numbers of
+ * frames, are run with "TEST_LATENCY" frames clocked between each interrupt entry. Checks:
+ *      Data                - received data is the inverse of the transmitted data
+ *      Completion          - the form completes, with all frames and no fault; bus is freed
+ *      FIFOs               - no TX FIFO overflow, RX FIFO underflow or RX overrun (the driver
+ *                            keeps within the FIFO depth, and drains by the FIFO level)
+ *      Threshold           - "FRXTH" set (and data size of 8bit) for 8bit frames, cleared (and
+ *                            data size of 16bit) for 16bit frames
+ *      Packing             - 8bit transfers of more than 1 frame use the packed accesses. Where
+ *                            more than 1 frame is clocked between interrupt entries, long
+ *                            transfers need fewer interrupts than frames
+ *
+ * Built as the driver in a shared library, linked to this test (see "test/run_tests.sh"):
+ *      g++ -std=gnu++11 -fPIC -shared -Dzz__MiSTM32Lx__zz -Iinclude -Iinclude/milibrary
+ *          -Itest/stubs -Itest/stubs/l4 src/drv/SPIPeriph/SPIPeriph.cpp
+ *          src/drv/GPIO/DeMux/DeMux.cpp test/stubs/HostStubs.cpp -o libSPIPeriph_L4_test.so
+ *      g++ -std=gnu++11 -Dzz__MiSTM32Lx__zz -Iinclude -Iinclude/milibrary -Itest/stubs
+ *          -Itest/stubs/l4 test/drv/SPIPeriph/SPIPeriph_L4_test.cpp -L. -lSPIPeriph_L4_test
+ *
+ * Returns 0 if all checks pass, otherwise the number of failed checks.
+ *************************************************************************************************/
+#include "FileIndex.h"
+#include FilInd_SPIPe__HD
+
+#include <stdio.h>                      // printf
+#include <string.h>                     // memset
+
+static int  failcnt = 0;                // Number of failed checks
+
+#define CHECK(cond)         do { if (!(cond)) { failcnt++;                                      \
+                                 printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); }       \
+                            } while (0)
+
+#define TEST_FORMS          8           // Size of the SPI Request Form queue
+#define TEST_BUFFER         256         // Size of the transmit/receive buffers (bytes)
+#define TEST_LATENCY        4           // Maximum frames clocked between interrupt entries
+#define TEST_TIMEOUT        100000      // Maximum interrupt checks of a transfer
+#define TEST_FIFO_FRAMES    64          // Transfers which refill the FIFOs many times
+
+#define MODEL_FIFO          4           // Size of the modelled TX/RX FIFOs (bytes)
+
+static SPI_TypeDef  regs;               // Modelled SPI registers
+
+static uint8_t      txfifo[MODEL_FIFO]; // Modelled TX FIFO
+static uint8_t      txcnt;              // Number of bytes within TX FIFO
+static uint8_t      rxfifo[MODEL_FIFO]; // Modelled RX FIFO
+static uint8_t      rxcnt;              // Number of bytes within RX FIFO
+static uint8_t      shift[2];           // Modelled shift register
+static uint8_t      shiftcnt;           // Number of bytes within shift register
+
+static uint8_t      overrun;            // RX FIFO full when a frame was received
+static uint8_t      txoverflow;         // Write whilst the TX FIFO was full
+static uint8_t      rxunderflow;        // Read whilst the RX FIFO was empty
+static uint32_t     packedcnt;          // Number of packed Data Register accesses
+
+static uint32_t fifoLevel(uint8_t count) {
+/**************************************************************************************************
+ * Returns the FIFO level (quarters) of "count" bytes, as "FTLVL"/"FRLVL"
+ *************************************************************************************************/
+    return ( (count >= 3) ? 3 : count );
+}
+
+static void updateStatus(void) {
+/**************************************************************************************************
+ * Update the status register from the state of the FIFOs
+ *************************************************************************************************/
+    uint32_t status = 0;
+    uint8_t threshold = ((regs.CR2 & SPI_CR2_FRXTH) != 0) ? 1 : 2;
+
+    if (txcnt <= (MODEL_FIFO / 2))
+        status |= SPI_SR_TXE;
+
+    if (rxcnt >= threshold)
+        status |= SPI_SR_RXNE;
+
+    if (overrun != 0)
+        status |= SPI_SR_OVR;
+
+    status |= fifoLevel(txcnt) << SPI_SR_FTLVL_Pos;
+    status |= fifoLevel(rxcnt) << SPI_SR_FRLVL_Pos;
+
+    regs.SR = status;
+}
+
+static void pushTx(uint8_t data) {
+    if (txcnt == MODEL_FIFO)
+        txoverflow = 1;
+    else
+        txfifo[txcnt++] = data;
+}
+
+static uint8_t popRx(void) {
+    uint8_t data;
+
+    if (rxcnt == 0) {
+        rxunderflow = 1;
+        return (0);
+    }
+
+    data = rxfifo[0];
+    memmove(&rxfifo[0], &rxfifo[1], --rxcnt);
+
+    return (data);
+}
+
+static void clockFrame(void) {
+/**************************************************************************************************
+ * Clock one frame time. The frame within the shift register is received (inverted) into the RX
+ * FIFO, and the next frame is taken from the TX FIFO (if a complete frame is present)
+ *************************************************************************************************/
+    uint8_t width = ((regs.CR2 & SPI_CR2_DS) == (15u << SPI_CR2_DS_Pos)) ? 2 : 1;
+
+    for (uint8_t i = 0; i != shiftcnt; i++) {
+        if (rxcnt == MODEL_FIFO)
+            overrun = 1;
+        else
+            rxfifo[rxcnt++] = (uint8_t) ~shift[i];
+    }
+    shiftcnt = 0;
+
+    if (txcnt >= width) {
+        memcpy(shift, txfifo, width);
+        txcnt = (uint8_t) (txcnt - width);
+        memmove(&txfifo[0], &txfifo[width], txcnt);
+        shiftcnt = width;
+    }
+
+    updateStatus();
+}
+
+uint16_t SPIPeriph::readDR(void) {
+    uint16_t data = popRx();
+
+    if (_data_width_ == DataWidth::k16bit)
+        data |= (uint16_t) (popRx() << 8);
+
+    updateStatus();
+    return (data);
+}
+
+void SPIPeriph::writeDR(uint16_t data) {
+    pushTx((uint8_t) data);
+
+    if (_data_width_ == DataWidth::k16bit)
+        pushTx((uint8_t) (data >> 8));
+
+    updateStatus();
+}
+
+uint16_t SPIPeriph::readDRPacked(void) {
+    uint16_t data = popRx();
+
+    data |= (uint16_t) (popRx() << 8);
+    packedcnt++;
+
+    updateStatus();
+    return (data);
+}
+
+void SPIPeriph::writeDRPacked(uint16_t data) {
+    pushTx((uint8_t) data);
+    pushTx((uint8_t) (data >> 8));
+    packedcnt++;
+
+    updateStatus();
+}
+
+static void runTransfer(uint16_t frames, SPIPeriph::DataWidth width, uint8_t latency) {
+/**************************************************************************************************
+ * Run an interrupt transfer of "frames" frames of "width", with "latency" frames clocked between
+ * each interrupt entry
+ *************************************************************************************************/
+    SPI_HandleTypeDef       handle;
+    SPIPeriph::Form         forms[TEST_FORMS];
+    static uint8_t          tx[TEST_BUFFER];
+    static uint8_t          rx[TEST_BUFFER];
+    volatile uint16_t       cmplt = 0;
+    volatile SPIPeriph::DevFlt flt = SPIPeriph::DevFlt::kNone;
+    uint16_t    bytes = (width == SPIPeriph::DataWidth::k16bit) ? (frames * 2) : frames;
+    uint32_t    irqs = 0;
+    uint32_t    i;
+
+    memset(&regs, 0, sizeof(regs));
+    memset(&handle, 0, sizeof(handle));
+    handle.Instance = &regs;
+
+    txcnt = rxcnt = shiftcnt = 0;
+    overrun = txoverflow = rxunderflow = 0;
+    packedcnt = 0;
+
+    for (i = 0; i != TEST_BUFFER; i++) {
+        tx[i] = (uint8_t) ((i * 7) + 3);
+        rx[i] = 0;
+    }
+
+    SPIPeriph spi(&handle, forms, TEST_FORMS);
+    updateStatus();
+
+    if (width == SPIPeriph::DataWidth::k16bit)
+        spi.intMasterTransfer(frames, (uint16_t *) tx, (uint16_t *) rx, &flt, &cmplt);
+    else
+        spi.intMasterTransfer(frames, tx, rx, &flt, &cmplt);
+
+    if (width == SPIPeriph::DataWidth::k16bit) {
+        CHECK((regs.CR2 & SPI_CR2_FRXTH) == 0);
+        CHECK((regs.CR2 & SPI_CR2_DS) == (15u << SPI_CR2_DS_Pos));
+    }
+    else {
+        CHECK((regs.CR2 & SPI_CR2_FRXTH) != 0);
+        CHECK((regs.CR2 & SPI_CR2_DS) == (7u << SPI_CR2_DS_Pos));
+    }
+
+    for (i = 0; (spi.CommState != SPIPeriph::CommLock::kFree) && (i != TEST_TIMEOUT); i++) {
+        for (uint8_t k = 0; k != latency; k++)
+            clockFrame();
+
+        if ( ( ((regs.SR & SPI_SR_TXE)  != 0) && ((regs.CR2 & SPI_CR2_TXEIE)  != 0) ) ||
+             ( ((regs.SR & SPI_SR_RXNE) != 0) && ((regs.CR2 & SPI_CR2_RXNEIE) != 0) ) ) {
+            irqs++;
+            spi.handleIRQ();
+        }
+    }
+
+    printf("width %2u frames %3u latency %u: %3u interrupts, %3u packed\n", (unsigned) width,
+           frames, latency, irqs, packedcnt);
+
+    CHECK(spi.CommState == SPIPeriph::CommLock::kFree);
+    CHECK(cmplt == frames);
+    CHECK(flt == SPIPeriph::DevFlt::kNone);
+    CHECK(overrun == 0);
+    CHECK(txoverflow == 0);
+    CHECK(rxunderflow == 0);
+
+    for (i = 0; i != bytes; i++)
+        CHECK(rx[i] == (uint8_t) ~tx[i]);
+
+    if ( (width == SPIPeriph::DataWidth::k8bit) && (frames > 1) )
+        CHECK(packedcnt != 0);
+
+    if ( (frames >= TEST_FIFO_FRAMES) && (latency > 1) )
+        CHECK(irqs < frames);
+}
+
+int main(void) {
+    static const uint16_t sizes[] = { 1, 2, 3, 5, 64, 127 };
+
+    for (uint8_t latency = 1; latency <= TEST_LATENCY; latency++) {
+        for (uint8_t i = 0; i != (sizeof(sizes) / sizeof(sizes[0])); i++) {
+            runTransfer(sizes[i], SPIPeriph::DataWidth::k8bit,  latency);
+            runTransfer(sizes[i], SPIPeriph::DataWidth::k16bit, latency);
+        }
+    }
+
+    printf("%d failed checks\n", failcnt);
+    return (failcnt);
+}
@@ -0,0 +1,62 @@
+/**************************************************************************************************
+ * @file        SPIPeriph_bench.cpp
+ * @author      Thomas
+ * @brief       Host benchmark of the SPI Peripheral driver (throughput and latency)
+ **************************************************************************************************
+ @ attention
+
+ << To be Introduced >>
+
+ *************************************************************************************************/
+/**************************************************************************************************
+ * How to use
+ * ----------
+ * Runs 'SPIBench' for each mode (polled, interrupt, batched) and transfer size:
+ *      SPIPeriph_bench [device] [iterations]
+ *
+ *      device      - spidev to measure (e.g. "/dev/spidev0.0"). If not provided (or the device
+ *                    cannot be accessed), then the loop back backend is used
+ *      iterations  - number of transfers per mode/size (default "BENCH_ITERATIONS", limited to
+ *                    "SPIBch_MaxIter")
+ *
+ *      g++ -std=gnu++11 -O2 -Dzz__MiRaspbPi__zz -Iinclude -Iinclude/milibrary -Itest/stubs
+ *          test/drv/SPIPeriph/SPIPeriph_bench.cpp src/drv/SPIPeriph/SPIBench.cpp
+ *          src/drv/SPIPeriph/SPIPeriph.cpp src/com/FormEvent/FormEvent.cpp
+ *          src/drv/GPIO/DeMux/DeMux.cpp test/stubs/HostStubs.cpp -pthread
+ *
+ * Writes the CSV of each mode/size to stdout. Only returns non-zero if the CSV cannot be written,
+ * or the interrupt emulation thread cannot be started (transfer faults are counted in the CSV).
+ *************************************************************************************************/
+#include "FileIndex.h"
+#include FilInd_SPIBchHD
+
+#include <stdio.h>                      // printf
+#include <stdlib.h>                     // atoi
+
+#define BENCH_ITERATIONS    10          // Default number of transfers per mode/size
+#define BENCH_SPEED         1000000     // SPI clock speed (Hz), only used by spidev
+
+int main(int argc, char *argv[]) {
+    int         iterations = BENCH_ITERATIONS;
+    SPIBench    *bench;
+    SPIBench::DevFlt    result;
+
+    if (argc > 2)
+        iterations = atoi(argv[2]);
+
+    if ( (iterations <= 0) || (iterations > SPIBch_MaxIter) ) {
+        printf("Iterations needs to be within 1 to %d\n", SPIBch_MaxIter);
+        return (1);
+    }
+
+    // Class contains the 64KB transmit/receive buffers, so is not placed on the stack
+    bench = new SPIBench((argc > 1) ? argv[1] : __null, BENCH_SPEED, SPIPeriph::kMode0);
+
+    result = bench->run(stdout, (uint16_t) iterations);
+    if (result != SPIBench::DevFlt::kNone)
+        fprintf(stderr, "SPIBench fault %d\n", (int) result);
+
+    delete bench;
+
+    return ( (result == SPIBench::DevFlt::kNone) ? 0 : 1 );
+}
@@ -0,0 +1,526 @@
+/**************************************************************************************************
+ * @file        SPIPeriph_test.cpp
+ * @author      Thomas
+ * @brief       Host test of the SPI driver spidev calls (RaspberryPi), against a linked function
+ **************************************************************************************************
+ @ attention
+
+ << To be Introduced >>
+
+ *************************************************************************************************/
+/**************************************************************************************************
+ * How to use
+ * ----------
+ * Constructs 'SPIPeriph' against a spidev device which doesn't exist, then links a function
+ * (".linkIoctl") which stands in for the driver - capturing each call, and looping back the
+ * inverse of the transmitted data. Checks:
+ *      Configuration       - fault if the device cannot be opened, or the configuration is
+ *                            rejected; mode/data size/speed sent through the linked function
+ *      Framing             - "SPI_IOC_MESSAGE" transfers of a batch of forms; length, data width,
+ *                            speed and "cs_change" of each transfer (scatter-gather, software
+ *                            GPIO Chip Select, coalescing, batch limit, driver rejection)
+ *      Faulted forms       - a form faulted whilst queued is not transferred, but its completion
+ *                            callback is still called (signals its 'FormEvent'). The callback can
+ *                            request a new form (queue is not locked during the callback)
+ *      Priority            - forms within unlinked priorities are taken/timed as "kNormal"
+ *      Worker              - polling transfers whilst the interrupt emulation thread is running
+ *                            are not interleaved with its driver calls, forms are not submitted
+ *                            whilst the bus is held (".holdBus"), and ".stopWorker" joins
+ *
+ * Built with the host stubs (see "test/run_tests.sh"):
+ *      g++ -std=gnu++11 -Dzz__MiRaspbPi__zz -Iinclude -Iinclude/milibrary -Itest/stubs
+ *          test/drv/SPIPeriph/SPIPeriph_test.cpp src/drv/SPIPeriph/SPIPeriph.cpp
+ *          src/com/FormEvent/FormEvent.cpp src/drv/GPIO/DeMux/DeMux.cpp test/stubs/HostStubs.cpp
+ *          -pthread
+ *
+ * Returns 0 if all checks pass, otherwise the number of failed checks.
+ *************************************************************************************************/
+#include "FileIndex.h"
+#include FilInd_SPIPe__HD
+#include FilInd_FrmEvtHD
+
+#include "HostStubs.h"
+
+#include <stdio.h>                      // printf
+
+static int  failcnt = 0;                // Number of failed checks
+
+#define CHECK(cond)         do { if (!(cond)) { failcnt++;                                      \
+                                 printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); }       \
+                            } while (0)
+
+#define TEST_SPEED          1000000     // Speed of the bus (Hz)
+#define TEST_CALLS          8           // Number of "SPI_IOC_MESSAGE" calls captured
+#define TEST_FORMS          64          // Size of the SPI Request Form queue
+
+typedef struct {
+    uint8_t                 Count;                  // Number of transfers within call
+    struct spi_ioc_transfer Xfer[SPIPe_MaxBatch];   // Transfers of the call
+    uint16_t                GPIOCnt;                // GPIO changes prior to the call
+} MessageCall;
+
+static MessageCall  calls[TEST_CALLS];  // "SPI_IOC_MESSAGE" calls captured
+static uint8_t      callcnt = 0;        // Number of calls (keeps counting past "TEST_CALLS")
+
+static uint8_t      cfg_mode  = 0xFF;   // Configuration sent to the driver
+static uint8_t      cfg_bits  = 0;      //
+static uint32_t     cfg_speed = 0;      //
+
+static unsigned long fail_request = 0;  // Request to reject (0 = none)
+
+static int shimIoctl(int fd, unsigned long request, void *arg) {
+/**************************************************************************************************
+ * Stands in for the spidev driver. Captures the configuration and each "SPI_IOC_MESSAGE" call,
+ * and loops back the inverse of the transmitted data (0xFF if no transmit data). Rejects
+ * "fail_request" (any "SPI_IOC_MESSAGE" if set to "SPI_IOC_MESSAGE(1)").
+ *************************************************************************************************/
+    struct spi_ioc_transfer *xfer = (struct spi_ioc_transfer *) arg;
+    uint8_t count = 0;
+
+    (void) fd;
+
+    if (request == SPI_IOC_WR_MODE)             cfg_mode  = *(uint8_t *)  arg;
+    if (request == SPI_IOC_WR_BITS_PER_WORD)    cfg_bits  = *(uint8_t *)  arg;
+    if (request == SPI_IOC_WR_MAX_SPEED_HZ)     cfg_speed = *(uint32_t *) arg;
+
+    if (_IOC_TYPE(request) == SPI_IOC_MAGIC && _IOC_NR(request) == 0) {
+        count = _IOC_SIZE(request) / sizeof(struct spi_ioc_transfer);
+
+        if (fail_request == SPI_IOC_MESSAGE(1))
+            return (-1);
+
+        if (callcnt < TEST_CALLS) {
+            calls[callcnt].Count    = count;
+            calls[callcnt].GPIOCnt  = StubGPIOCnt;
+            memcpy(calls[callcnt].Xfer, xfer, count * sizeof(struct spi_ioc_transfer));
+        }
+        callcnt++;
+
+        for (uint8_t i = 0; i != count; i++) {
+            uint8_t *tx = (uint8_t *) xfer[i].tx_buf;
+            uint8_t *rx = (uint8_t *) xfer[i].rx_buf;
+
+            for (uint32_t k = 0; (rx != __null) && (k != xfer[i].len); k++)
+                rx[k] = (tx == __null) ? 0xFF : (uint8_t) ~tx[k];
+        }
+
+        return ((int) count);
+    }
+
+    if ( (fail_request != 0) && (request == fail_request) )
+        return (-1);
+
+    return (0);
+}
+
+static uint32_t     busy_inside  = 0;   // Driver calls in progress (worker test)
+static uint32_t     busy_overlap = 0;   // Driver calls made whilst another was in progress
+
+static int busyIoctl(int fd, unsigned long request, void *arg) {
+/**************************************************************************************************
+ * Stands in for the spidev driver, for the worker test. Each "SPI_IOC_MESSAGE" call takes some
+ * time, and counts any other call made during it. Loops back the transmitted data.
+ *************************************************************************************************/
+    struct spi_ioc_transfer *xfer = (struct spi_ioc_transfer *) arg;
+    uint8_t count = 0;
+
+    (void) fd;
+
+    if ( (_IOC_TYPE(request) != SPI_IOC_MAGIC) || (_IOC_NR(request) != 0) )
+        return (0);
+
+    if (__atomic_fetch_add(&busy_inside, 1, __ATOMIC_ACQ_REL) != 0)
+        __atomic_fetch_add(&busy_overlap, 1, __ATOMIC_RELAXED);
+
+    count = _IOC_SIZE(request) / sizeof(struct spi_ioc_transfer);
+    for (uint8_t i = 0; i != count; i++) {
+        if (xfer[i].rx_buf != 0)
+            memcpy((void *) xfer[i].rx_buf, (void *) xfer[i].tx_buf, xfer[i].len);
+    }
+    usleep(50);
+
+    __atomic_fetch_sub(&busy_inside, 1, __ATOMIC_ACQ_REL);
+
+    return ((int) count);
+}
+
+static void resetShim(void) {
+    callcnt = 0;
+    fail_request = 0;
+    stubGPIOClear();
+}
+
+static void checkXfer(uint8_t call, uint8_t i, uint32_t len, uint8_t bits, uint8_t cs) {
+/**************************************************************************************************
+ * Check transfer "i" of captured call "call"
+ *************************************************************************************************/
+    const struct spi_ioc_transfer *xfer = &(calls[call].Xfer[i]);
+
+    CHECK(xfer->len             == len);
+    CHECK(xfer->bits_per_word   == bits);
+    CHECK(xfer->speed_hz        == TEST_SPEED);
+    CHECK(xfer->cs_change       == cs);
+}
+
+static void testConfig(void) {
+/**************************************************************************************************
+ * Device cannot be opened, then linked function stands in for it (including rejecting the
+ * configuration)
+ *************************************************************************************************/
+    SPIPeriph::Form forms[TEST_FORMS];
+    SPIPeriph       spi("/nonexistent/spidev0.0", TEST_SPEED, SPIPeriph::kMode1, forms, TEST_FORMS);
+
+    CHECK(spi.Flt == SPIPeriph::DevFlt::kDriver_Error);
+
+    fail_request = SPI_IOC_WR_BITS_PER_WORD;
+    spi.linkIoctl(&shimIoctl);
+    CHECK(spi.Flt == SPIPeriph::DevFlt::kDriver_Error);
+
+    resetShim();
+    spi.linkIoctl(&shimIoctl);
+    CHECK(spi.Flt == SPIPeriph::DevFlt::kInitialised);
+    CHECK(cfg_mode  == SPI_MODE_1);
+    CHECK(cfg_bits  == 8);
+    CHECK(cfg_speed == TEST_SPEED);
+}
+
+static void testFraming(void) {
+/**************************************************************************************************
+ * Batch of hardware Chip Select forms (8bit, 16bit and scatter-gather), submitted in a single
+ * call. Chip Select is released between forms, but not within the scatter-gather form, or at the
+ * end of the message. Then a polling transfer.
+ *************************************************************************************************/
+    SPIPeriph::Form forms[TEST_FORMS];
+    SPIPeriph       spi("/nonexistent/spidev0.0", TEST_SPEED, SPIPeriph::kMode0, forms, TEST_FORMS);
+
+    uint8_t         tx8[2][4]   = { { 0x01, 0x02, 0x03, 0x04 }, { 0x10, 0x20, 0x30, 0x40 } };
+    uint8_t         rx8[2][4]   = { { 0 } };
+    uint16_t        tx16[2]     = { 0x1234, 0x5678 };
+    uint16_t        rx16[2]     = { 0 };
+    uint8_t         seg_a[3]    = { 0xA0, 0xA1, 0xA2 };
+    uint8_t         seg_b[2]    = { 0xB0, 0xB1 };
+    uint8_t         seg_rx[5]   = { 0 };
+    SPIPeriph::Segment  txseg[2] = { { seg_a, 3 }, { seg_b, 2 } };
+    SPIPeriph::Segment  rxseg[1] = { { seg_rx, 5 } };
+
+    volatile SPIPeriph::DevFlt  flt[4]  = { SPIPeriph::DevFlt::kNone, SPIPeriph::DevFlt::kNone,
+                                            SPIPeriph::DevFlt::kNone, SPIPeriph::DevFlt::kNone };
+    volatile uint16_t           cmp[4]  = { 0, 0, 0, 0 };
+
+    uint8_t         poll_tx[3]  = { 0x55, 0x66, 0x77 };
+    uint8_t         poll_rx[3]  = { 0 };
+
+    spi.linkIoctl(&shimIoctl);
+    resetShim();
+
+    spi.holdBus();                             // Hold the bus, whilst queued
+    spi.intMasterTransfer(2, tx8[0], rx8[0], &flt[0], &cmp[0]);
+    spi.intMasterTransfer(4, tx8[1], rx8[1], &flt[1], &cmp[1]);
+    spi.intMasterTransfer(2, tx16, rx16, &flt[2], &cmp[2]);
+    spi.intMasterTransfer(txseg, 2, rxseg, 1, &flt[3], &cmp[3]);
+    spi.releaseBus();
+
+    CHECK(callcnt == 1);
+    CHECK(calls[0].Count == 5);
+    checkXfer(0, 0, 2, 8,  1);
+    checkXfer(0, 1, 4, 8,  1);
+    checkXfer(0, 2, 4, 16, 1);
+    checkXfer(0, 3, 3, 8,  0);      // Scatter-gather form, split at transmit segment change
+    checkXfer(0, 4, 2, 8,  0);      // End of message
+
+    CHECK(calls[0].Xfer[3].tx_buf == (unsigned long) seg_a);
+    CHECK(calls[0].Xfer[3].rx_buf == (unsigned long) seg_rx);
+    CHECK(calls[0].Xfer[4].tx_buf == (unsigned long) seg_b);
+    CHECK(calls[0].Xfer[4].rx_buf == (unsigned long) &seg_rx[3]);
+
+    CHECK( (cmp[0] == 2) && (cmp[1] == 4) && (cmp[2] == 2) && (cmp[3] == 5) );
+    CHECK( (flt[0] == SPIPeriph::DevFlt::kNone) && (flt[3] == SPIPeriph::DevFlt::kNone) );
+    CHECK( (rx8[0][0] == 0xFE) && (rx8[0][1] == 0xFD) && (rx8[0][2] == 0x00) );
+    CHECK( (rx8[1][3] == 0xBF) && (rx16[1] == (uint16_t) ~0x5678) );
+    CHECK( (seg_rx[0] == 0x5F) && (seg_rx[3] == 0x4F) && (seg_rx[4] == 0x4E) );
+
+    resetShim();
+    CHECK(spi.poleMasterTransfer(poll_tx, poll_rx, 3) == SPIPeriph::DevFlt::kNone);
+    CHECK( (callcnt == 1) && (calls[0].Count == 1) );
+    checkXfer(0, 0, 3, 8, 0);
+    CHECK( (poll_rx[0] == 0xAA) && (poll_rx[2] == 0x88) );
+}
+
+static void testChipSelect(void) {
+/**************************************************************************************************
+ * Software GPIO Chip Select forms are submitted on their own (GPIO selected either side of the
+ * call), unless coalesced with the previous form to the same GPIO
+ *************************************************************************************************/
+    SPIPeriph::Form forms[TEST_FORMS];
+    SPIPeriph       spi("/nonexistent/spidev0.0", TEST_SPEED, SPIPeriph::kMode0, forms, TEST_FORMS);
+    GPIO            cs(HIGH, 7, OUTPUT);
+
+    uint8_t                     tx[4][2]    = { { 1, 2 }, { 3, 4 }, { 5, 6 }, { 7, 8 } };
+    uint8_t                     rx[4][2]    = { { 0 } };
+    volatile SPIPeriph::DevFlt  flt[4];
+    volatile uint16_t           cmp[4]      = { 0, 0, 0, 0 };
+
+    for (uint8_t i = 0; i != 4; i++)
+        flt[i] = SPIPeriph::DevFlt::kNone;
+
+    spi.linkIoctl(&shimIoctl);
+    resetShim();
+
+    spi.holdBus();
+    spi.intMasterTransfer(2, tx[0], rx[0], &flt[0], &cmp[0]);
+    spi.intMasterTransfer(&cs, 2, tx[1], rx[1], &flt[1], &cmp[1]);
+    spi.intMasterTransfer(2, tx[2], rx[2], &flt[2], &cmp[2]);
+    spi.releaseBus();
+
+    CHECK(callcnt == 3);
+    CHECK( (calls[0].Count == 1) && (calls[1].Count == 1) && (calls[2].Count == 1) );
+    checkXfer(1, 0, 2, 8, 0);
+    CHECK(calls[0].GPIOCnt == 0);
+    CHECK(calls[1].GPIOCnt == 1);                   // GPIO selected prior to its call
+    CHECK(calls[2].GPIOCnt == 2);                   // and deselected after
+    CHECK( (StubGPIOLog[0].Pin == 7) && (StubGPIOLog[0].Value == GPIO::kLow)  );
+    CHECK( (StubGPIOLog[1].Pin == 7) && (StubGPIOLog[1].Value == GPIO::kHigh) );
+    CHECK( (cmp[0] == 2) && (cmp[1] == 2) && (cmp[2] == 2) );
+
+    spi.configCoalesce(SPIPeriph::Coalesce::kCoalesce_On);
+    resetShim();
+
+    spi.holdBus();
+    spi.intMasterTransfer(&cs, 2, tx[0], rx[0], &flt[0], &cmp[0]);
+    spi.intMasterTransfer(&cs, 2, tx[3], rx[3], &flt[3], &cmp[3]);
+    spi.releaseBus();
+
+    CHECK( (callcnt == 1) && (calls[0].Count == 2) );
+    checkXfer(0, 0, 2, 8, 0);                       // Kept selected between coalesced forms
+    checkXfer(0, 1, 2, 8, 0);
+    CHECK( (StubGPIOCnt == 2) && (spi.CoalesceCnt == 1) );
+    CHECK( (cmp[0] == 4) && (cmp[3] == 2) && (rx[3][1] == 0xF7) );
+}
+
+static void testLimits(void) {
+/**************************************************************************************************
+ * More forms than "SPIPe_MaxBatch" are split into further calls. A call rejected by the driver
+ * faults each form within it.
+ *************************************************************************************************/
+    SPIPeriph::Form forms[TEST_FORMS];
+    SPIPeriph       spi("/nonexistent/spidev0.0", TEST_SPEED, SPIPeriph::kMode0, forms, TEST_FORMS);
+
+    uint8_t                     tx[SPIPe_MaxBatch + 2];
+    uint8_t                     rx[SPIPe_MaxBatch + 2];
+    volatile SPIPeriph::DevFlt  flt[SPIPe_MaxBatch + 2];
+    volatile uint16_t           cmp[SPIPe_MaxBatch + 2];
+    uint8_t                     i = 0;
+
+    spi.linkIoctl(&shimIoctl);
+    resetShim();
+
+    spi.holdBus();
+    for (i = 0; i != (SPIPe_MaxBatch + 2); i++) {
+        tx[i]   = i;
+        flt[i]  = SPIPeriph::DevFlt::kNone;
+        cmp[i]  = 0;
+        spi.intMasterTransfer(1, &tx[i], &rx[i], &flt[i], &cmp[i]);
+    }
+    spi.releaseBus();
+
+    CHECK(callcnt == 2);
+    CHECK( (calls[0].Count == SPIPe_MaxBatch) && (calls[1].Count == 2) );
+    checkXfer(0, SPIPe_MaxBatch - 2, 1, 8, 1);
+    checkXfer(0, SPIPe_MaxBatch - 1, 1, 8, 0);
+    CHECK( (cmp[0] == 1) && (cmp[SPIPe_MaxBatch + 1] == 1) );
+    CHECK(rx[SPIPe_MaxBatch + 1] == (uint8_t) ~(SPIPe_MaxBatch + 1));
+
+    resetShim();
+    fail_request = SPI_IOC_MESSAGE(1);
+
+    spi.holdBus();
+    for (i = 0; i != 2; i++) {
+        cmp[i] = 0;
+        spi.intMasterTransfer(1, &tx[i], &rx[i], &flt[i], &cmp[i]);
+    }
+    spi.releaseBus();
+
+    CHECK( (flt[0] == SPIPeriph::DevFlt::kDriver_Error) &&
+           (flt[1] == SPIPeriph::DevFlt::kDriver_Error) );
+    CHECK( (cmp[0] == 0) && (cmp[1] == 0) );
+    CHECK(spi.Flt == SPIPeriph::DevFlt::kDriver_Error);
+}
+
+static SPIPeriph                    *requeue_spi = __null;  // Bus to queue new form on
+static uint8_t                      requeue_tx   = 0x5A;
+static uint8_t                      requeue_rx   = 0;
+static volatile SPIPeriph::DevFlt   requeue_flt  = SPIPeriph::DevFlt::kNone;
+static volatile uint16_t            requeue_cmp  = 0;
+
+static void requeueCallback(void *context) {
+/**************************************************************************************************
+ * Completion callback of a faulted form, requests a new form
+ *************************************************************************************************/
+    (void) context;
+
+    requeue_spi->intMasterTransfer(1, &requeue_tx, &requeue_rx, &requeue_flt, &requeue_cmp);
+}
+
+static void testFaulted(void) {
+/**************************************************************************************************
+ * Form faulted by the source whilst within the queue, is removed without being transferred. Its
+ * 'FormEvent' is still signalled, along with the form after it (which is transferred).
+ *************************************************************************************************/
+    SPIPeriph::Form forms[TEST_FORMS];
+    SPIPeriph       spi("/nonexistent/spidev0.0", TEST_SPEED, SPIPeriph::kMode0, forms, TEST_FORMS);
+    FormEvent       event;
+
+    uint8_t                     tx[2]   = { 1, 2 };
+    uint8_t                     rx[2]   = { 0 };
+    volatile SPIPeriph::DevFlt  flt[2]  = { SPIPeriph::DevFlt::kNone, SPIPeriph::DevFlt::kNone };
+    volatile uint16_t           cmp[2]  = { 0, 0 };
+
+    spi.linkIoctl(&shimIoctl);
+    resetShim();
+    event.clear();
+
+    spi.holdBus();
+    spi.intMasterTransfer(1, &tx[0], &rx[0], &flt[0], &cmp[0], SPIPeriph::FormPriority::kNormal,
+                          &FormEvent::formCallback, &event);
+    spi.intMasterTransfer(1, &tx[1], &rx[1], &flt[1], &cmp[1], SPIPeriph::FormPriority::kNormal,
+                          &FormEvent::formCallback, &event);
+    flt[0] = SPIPeriph::DevFlt::kData_Size;         // Source faults the first form
+    spi.releaseBus();
+
+    CHECK(event.wait(2, 100) == FormEvent::EvntState::kSignalled);
+    CHECK(event.count() == 2);
+    CHECK( (callcnt == 1) && (calls[0].Count == 1) );
+    CHECK(calls[0].Xfer[0].tx_buf == (unsigned long) &tx[1]);
+    CHECK( (cmp[0] == 0) && (cmp[1] == 1) );
+
+    // Completion callback of the faulted form requests a new form
+    resetShim();
+    requeue_spi = &spi;
+    requeue_cmp = 0;
+    flt[0]      = SPIPeriph::DevFlt::kNone;
+    alarm(5);                                       // Deadlock fails, rather than hangs
+
+    spi.holdBus();
+    spi.intMasterTransfer(1, &tx[0], &rx[0], &flt[0], &cmp[0], SPIPeriph::FormPriority::kNormal,
+                          &requeueCallback);
+    flt[0] = SPIPeriph::DevFlt::kData_Size;         // Source faults the form
+    spi.releaseBus();
+
+    alarm(0);
+    CHECK( (callcnt == 1) && (calls[0].Xfer[0].tx_buf == (unsigned long) &requeue_tx) );
+    CHECK( (requeue_flt == SPIPeriph::DevFlt::kNone) && (requeue_cmp == 1) );
+}
+
+static void testPriority(void) {
+/**************************************************************************************************
+ * Without a "kHigh" queue linked, "kNormal" forms (and "kHigh" forms, put into the "kNormal"
+ * queue) are timed as "kNormal". Once linked, "kHigh" forms are taken first and timed as "kHigh".
+ *************************************************************************************************/
+    SPIPeriph::Form forms[TEST_FORMS];
+    SPIPeriph::Form high_forms[4];
+    SPIPeriph       spi("/nonexistent/spidev0.0", TEST_SPEED, SPIPeriph::kMode0, forms, TEST_FORMS);
+
+    uint8_t                     tx[3]   = { 1, 2, 3 };
+    uint8_t                     rx[3]   = { 0 };
+    volatile SPIPeriph::DevFlt  flt[3]  = { SPIPeriph::DevFlt::kNone, SPIPeriph::DevFlt::kNone,
+                                            SPIPeriph::DevFlt::kNone };
+    volatile uint16_t           cmp[3]  = { 0, 0, 0 };
+
+    spi.linkIoctl(&shimIoctl);
+    resetShim();
+
+    spi.holdBus();
+    spi.intMasterTransfer(1, &tx[0], &rx[0], &flt[0], &cmp[0]);
+    spi.intMasterTransfer(1, &tx[1], &rx[1], &flt[1], &cmp[1], SPIPeriph::FormPriority::kHigh);
+    spi.releaseBus();
+
+    CHECK( (cmp[0] == 1) && (cmp[1] == 1) );
+    CHECK(spi.QueueWait[SPIPeriph::FormPriority::kHigh].Count   == 0);
+    CHECK(spi.QueueWait[SPIPeriph::FormPriority::kNormal].Count == 2);
+
+    spi.linkPriorityQueue(SPIPeriph::FormPriority::kHigh, high_forms, 4);
+    spi.resetQueueWait();
+    resetShim();
+
+    spi.holdBus();
+    spi.intMasterTransfer(1, &tx[0], &rx[0], &flt[0], &cmp[0]);
+    spi.intMasterTransfer(1, &tx[2], &rx[2], &flt[2], &cmp[2], SPIPeriph::FormPriority::kHigh);
+    spi.releaseBus();
+
+    CHECK( (callcnt == 1) && (calls[0].Count == 2) );
+    CHECK(calls[0].Xfer[0].tx_buf == (unsigned long) &tx[2]);   // "kHigh" form first
+    CHECK(spi.QueueWait[SPIPeriph::FormPriority::kHigh].Count   == 1);
+    CHECK(spi.QueueWait[SPIPeriph::FormPriority::kNormal].Count == 1);
+}
+
+static void testWorker(void) {
+/**************************************************************************************************
+ * Forms submitted by the interrupt emulation thread, whilst polling transfers are made from this
+ * thread. No driver call is to overlap another, and all forms/transfers complete. A form
+ * requested whilst the bus is held is only submitted once released.
+ *************************************************************************************************/
+    SPIPeriph::Form forms[TEST_FORMS];
+    SPIPeriph       spi("/nonexistent/spidev0.0", TEST_SPEED, SPIPeriph::kMode0, forms, TEST_FORMS);
+
+    uint8_t                     tx[TEST_FORMS / 2][4];
+    uint8_t                     rx[TEST_FORMS / 2][4];
+    volatile SPIPeriph::DevFlt  flt[TEST_FORMS / 2];
+    volatile uint16_t           cmp[TEST_FORMS / 2];
+    volatile uint16_t           held_cmp = 0;
+    uint8_t                     poll_tx[4] = { 1, 2, 3, 4 };
+    uint8_t                     poll_rx[4] = { 0 };
+    uint8_t                     poll_ok = 1;
+    uint8_t                     i = 0;
+
+    spi.linkIoctl(&busyIoctl);
+    CHECK(spi.startWorker(0, -1) == SPIPeriph::DevFlt::kNone);
+
+    for (i = 0; i != (TEST_FORMS / 2); i++) {
+        memset(tx[i], i, sizeof(tx[i]));
+        flt[i] = SPIPeriph::DevFlt::kNone;
+        cmp[i] = 0;
+        spi.intMasterTransfer(4, tx[i], rx[i], &flt[i], &cmp[i]);
+
+        if ( (spi.poleMasterTransfer(poll_tx, poll_rx, 4) != SPIPeriph::DevFlt::kNone) ||
+             (poll_rx[3] != 4) )
+            poll_ok = 0;
+        poll_rx[3] = 0;
+    }
+
+    for (i = 0; i != (TEST_FORMS / 2); i++) {
+        while ( (__atomic_load_n(&cmp[i], __ATOMIC_ACQUIRE) == 0) &&
+                (flt[i] == SPIPeriph::DevFlt::kNone) ) {};
+    }
+
+    spi.holdBus();                                  // Forms queued whilst held, even with the
+    spi.intMasterTransfer(4, tx[0], rx[0], &flt[0], &held_cmp);     // thread running
+    usleep(10000);
+    CHECK(__atomic_load_n(&held_cmp, __ATOMIC_ACQUIRE) == 0);
+    spi.releaseBus();
+
+    while ( (__atomic_load_n(&held_cmp, __ATOMIC_ACQUIRE) == 0) &&
+            (flt[0] == SPIPeriph::DevFlt::kNone) ) {};
+
+    spi.stopWorker();                               // Returns once the thread has exited
+
+    CHECK(poll_ok == 1);
+    CHECK(__atomic_load_n(&busy_overlap, __ATOMIC_ACQUIRE) == 0);
+    for (i = 0; i != (TEST_FORMS / 2); i++)
+        CHECK( (cmp[i] == 4) && (rx[i][3] == i) );
+    CHECK(held_cmp == 4);
+    CHECK(spi.CommState == SPIPeriph::CommLock::kFree);
+}
+
+int main(void) {
+    testConfig();
+    testFraming();
+    testChipSelect();
+    testLimits();
+    testFaulted();
+    testPriority();
+    testWorker();
+
+    printf("%d failed checks\n", failcnt);
+
+    return (failcnt);
+}
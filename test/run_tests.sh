@@ -0,0 +1,104 @@
+#!/bin/sh
+###################################################################################################
+# @file        run_tests.sh
+# @author      Thomas
+# @brief       Builds and runs the host tests/benchmarks of the library
+###################################################################################################
+# How to use
+# ----------
+# Run from the root of the repository:
+#       test/run_tests.sh               - Build and run all tests
+#       test/run_tests.sh LnxCond_test  - Build and run only the named test(s)
+#
+# Each test is built with the host compiler ("CXX", default g++) into "BUILD" (default
+# /tmp/milibrary_test), with the target device and any defines the test requires. Host stubs of
+# the target device libraries are within "test/stubs".
+# Register model tests ("runlib") build the driver sources into a shared library, so the test can
+# provide the functions which access the hardware in place of those within the library.
+# Returns the number of tests which failed (to build, or to run).
+###################################################################################################
+
+CXX=${CXX:-g++}
+BUILD=${BUILD:-/tmp/milibrary_test}
+FLAGS="-std=gnu++11 -Wall -Wextra -Iinclude -Iinclude/milibrary -Itest/stubs -pthread"
+
+failed=0
+
+run() {
+    # run <name> <defines> <sources...>
+    name=$1
+    defines=$2
+    shift 2
+
+    if [ -n "$SELECT" ] && ! echo " $SELECT " | grep -q " $name "; then
+        return
+    fi
+
+    echo "== $name"
+    if ! $CXX $FLAGS $defines "$@" -o "$BUILD/$name"; then
+        echo "== $name: BUILD FAILED"
+        failed=$((failed + 1))
+    elif ! "$BUILD/$name"; then
+        echo "== $name: FAILED"
+        failed=$((failed + 1))
+    fi
+}
+
+runlib() {
+    # runlib <name> <defines> <test source> <library sources...>
+    name=$1
+    defines=$2
+    source=$3
+    shift 3
+
+    if [ -n "$SELECT" ] && ! echo " $SELECT " | grep -q " $name "; then
+        return
+    fi
+
+    echo "== $name"
+    if ! $CXX $FLAGS $defines -fPIC -shared "$@" -o "$BUILD/lib$name.so" ||
+       ! $CXX $FLAGS $defines "$source" -L"$BUILD" -l"$name" -Wl,-rpath,"$BUILD" \
+             -o "$BUILD/$name"; then
+        echo "== $name: BUILD FAILED"
+        failed=$((failed + 1))
+    elif ! "$BUILD/$name"; then
+        echo "== $name: FAILED"
+        failed=$((failed + 1))
+    fi
+}
+
+SELECT="$*"
+mkdir -p "$BUILD"
+
+# LnxCond
+run LnxCond_test    "-Dzz__MiRaspbPi__zz -DLNX_NUM_CORES=2 -DLNX_MAX_IRQS=8" \
+    test/LnxCond/LnxCond_test.cpp src/LnxCond/LnxCond.cpp
+run LnxCond_bench   "-O2 -Dzz__MiRaspbPi__zz" \
+    test/LnxCond/LnxCond_bench.cpp src/LnxCond/LnxCond.cpp
+
+# SPIPeriph
+run SPIPeriph_test  "-Dzz__MiRaspbPi__zz" \
+    test/drv/SPIPeriph/SPIPeriph_test.cpp src/drv/SPIPeriph/SPIPeriph.cpp \
+    src/com/FormEvent/FormEvent.cpp src/drv/GPIO/DeMux/DeMux.cpp test/stubs/HostStubs.cpp
+run SPIPeriph_bench "-O2 -Dzz__MiRaspbPi__zz" \
+    test/drv/SPIPeriph/SPIPeriph_bench.cpp src/drv/SPIPeriph/SPIBench.cpp \
+    src/drv/SPIPeriph/SPIPeriph.cpp src/com/FormEvent/FormEvent.cpp \
+    src/drv/GPIO/DeMux/DeMux.cpp test/stubs/HostStubs.cpp
+runlib SPIPeriph_L4_test "-Dzz__MiSTM32Lx__zz -Itest/stubs/l4" \
+    test/drv/SPIPeriph/SPIPeriph_L4_test.cpp src/drv/SPIPeriph/SPIPeriph.cpp \
+    src/drv/GPIO/DeMux/DeMux.cpp test/stubs/HostStubs.cpp
+runlib SPIDMAPeriph_L4_test "-Dzz__MiSTM32Lx__zz -Itest/stubs/l4" \
+    test/drv/SPIPeriph/SPIDMAPeriph_L4_test.cpp src/drv/SPIPeriph/SPIPeriph.cpp \
+    src/drv/SPIPeriph/SPIDMAPeriph.cpp src/drv/DMAPeriph/DMAPeriph.cpp \
+    src/drv/GPIO/DeMux/DeMux.cpp test/stubs/HostStubs.cpp
+
+# I2CPeriph
+run I2CPeriph_test  "-Dzz__MiRaspbPi__zz" \
+    test/drv/I2CPeriph/I2CPeriph_test.cpp src/drv/I2CPeriph/I2CPeriph.cpp \
+    src/drv/I2CPeriph/I2CBusMngr.cpp src/com/FormEvent/FormEvent.cpp
+runlib I2CPeriph_L4_test "-Dzz__MiSTM32Lx__zz -Itest/stubs/l4" \
+    test/drv/I2CPeriph/I2CPeriph_L4_test.cpp src/drv/I2CPeriph/I2CPeriph.cpp \
+    test/stubs/HostStubs.cpp
+
+echo "== $failed failed"
+exit $failed
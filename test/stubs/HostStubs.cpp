@@ -0,0 +1,104 @@
+/**************************************************************************************************
+ * @file        HostStubs.cpp
+ * @author      Thomas
+ * @brief       Host stand-ins for the GPIO class and STM32 HAL functions, used by the driver tests
+ **************************************************************************************************
+ @ attention
+
+ << To be Introduced >>
+
+ *************************************************************************************************/
+#include "HostStubs.h"
+
+StubGPIOEntry   StubGPIOLog[STUB_GPIO_LOG];
+uint16_t        StubGPIOCnt = 0;
+
+#if defined(zz__MiSTM32Lx__zz)          // If the target device is an STM32Lxx from cubeMX then
+//=================================================================================================
+static DWT_Type         stub_dwt;
+static CoreDebug_Type   stub_coredebug;
+
+DWT_Type        *DWT            = &stub_dwt;
+CoreDebug_Type  *CoreDebug      = &stub_coredebug;
+uint32_t        SystemCoreClock = 80000000;
+uint32_t        StubTick        = 0;
+
+uint32_t HAL_GetTick(void) {
+/**************************************************************************************************
+ * Time moves on by 1ms each call, so any timeout is reached without waiting
+ *************************************************************************************************/
+    return (StubTick++);
+}
+
+uint32_t HAL_RCC_GetPCLK1Freq(void) {
+    return (SystemCoreClock);
+}
+
+uint32_t HAL_RCC_GetPCLK2Freq(void) {
+    return (SystemCoreClock);
+}
+
+GPIO::GPIO(GPIO_TypeDef *PortAddress, uint32_t pinnumber, Dir direction) {
+/**************************************************************************************************
+ * Capture the pin details, no hardware is configured
+ *************************************************************************************************/
+    _pin_number_      = pinnumber;
+    _port_address_    = PortAddress;
+    _pin_direction_   = direction;
+}
+
+#elif defined(zz__MiRaspbPi__zz)        // If the target device is an Raspberry Pi then
+//=================================================================================================
+GPIO::GPIO(_GPIOValue pinvalue, uint32_t pinnumber, _GPIODirec pindirection) {
+/**************************************************************************************************
+ * Capture the pin details, no hardware is configured
+ *************************************************************************************************/
+    _pin_number_      = pinnumber;
+    _pin_direction_   = (pindirection == OUTPUT) ? kOutput : kInput;
+    _pin_value_       = pinvalue;
+}
+
+#endif
+
+void stubGPIOClear(void) {
+/**************************************************************************************************
+ * Empty the log of GPIO changes
+ *************************************************************************************************/
+    StubGPIOCnt = 0;
+}
+
+uint8_t GPIO::toggleOutput() {
+    return ( setValue((getValue() == kLow) ? kHigh : kLow) );
+}
+
+uint8_t GPIO::setValue(State value) {
+/**************************************************************************************************
+ * Capture the change within the log (if space)
+ *************************************************************************************************/
+    if (StubGPIOCnt < STUB_GPIO_LOG) {
+        StubGPIOLog[StubGPIOCnt].Pin    = _pin_number_;
+        StubGPIOLog[StubGPIOCnt].Value  = value;
+    }
+    StubGPIOCnt++;
+
+    return 0;
+}
+
+GPIO::State GPIO::getValue() {
+/**************************************************************************************************
+ * Returns the last value captured for the pin (within the log), otherwise LOW
+ *************************************************************************************************/
+    uint16_t i = (StubGPIOCnt < STUB_GPIO_LOG) ? StubGPIOCnt : STUB_GPIO_LOG;
+
+    while (i != 0) {
+        i--;
+        if (StubGPIOLog[i].Pin == _pin_number_)
+            return (StubGPIOLog[i].Value);
+    }
+
+    return (kLow);
+}
+
+GPIO::~GPIO()
+{
+}
@@ -0,0 +1,49 @@
+/**************************************************************************************************
+ * @file        HostStubs.h
+ * @author      Thomas
+ * @brief       Host stand-ins for the GPIO class and STM32 HAL functions, used by the driver tests
+ **************************************************************************************************
+ @ attention
+
+ << To be Introduced >>
+
+ *************************************************************************************************/
+/**************************************************************************************************
+ * How to use
+ * ----------
+ * Build "HostStubs.cpp" in place of the 'GPIO' source (which needs the wiringPi library).
+ * Each change of a GPIO output (".setValue"/".toggleOutput") is captured within "StubGPIOLog" as
+ * the pin number and new value, upto "STUB_GPIO_LOG" entries ("StubGPIOCnt" keeps counting).
+ * "stubGPIOClear" empties the log.
+ *
+ * For STM32 (register models, HAL header within "test/stubs/l4"), also provides the HAL functions
+ * and core registers used by the drivers. "HAL_GetTick" moves on 1ms each call ("StubTick"), so
+ * any timeout is reached without waiting.
+ *************************************************************************************************/
+#ifndef HOSTSTUBS_H_
+#define HOSTSTUBS_H_
+
+#include "FileIndex.h"
+#include <stdint.h>
+
+#include FilInd_GPIO___HD
+
+#define STUB_GPIO_LOG       64          // Number of GPIO changes captured
+
+typedef struct {
+    uint32_t        Pin;                // Pin number of the GPIO
+    GPIO::State     Value;              // New value of the pin
+} StubGPIOEntry;
+
+extern StubGPIOEntry    StubGPIOLog[STUB_GPIO_LOG];
+extern uint16_t         StubGPIOCnt;
+
+#if defined(zz__MiSTM32Lx__zz)          // If the target device is an STM32Lxx from cubeMX then
+//=================================================================================================
+extern uint32_t         StubTick;
+
+#endif
+
+void stubGPIOClear(void);
+
+#endif /* HOSTSTUBS_H_ */
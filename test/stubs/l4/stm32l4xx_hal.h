@@ -0,0 +1,247 @@
+/**************************************************************************************************
+ * @file        stm32l4xx_hal.h
+ * @author      Thomas
+ * @brief       Host stand-in for the STM32L4 HAL (registers, flags and macros used by the drivers)
+ **************************************************************************************************
+ @ attention
+
+ << To be Introduced >>
+
+ *************************************************************************************************/
+/**************************************************************************************************
+ * How to use
+ * ----------
+ * Placed upon the include path of the STM32L4 host tests (see "test/run_tests.sh"), in place of
+ * the cubeMX HAL. Peripherals are plain structures, so a test provides the register block (and
+ * models the hardware behaviour). Only the registers/bits used by the drivers are defined - the
+ * bit positions match the reference manual. HAL functions are within "HostStubs.cpp".
+ * I2C flag clears are collected within "ICR" (rather than only the last), so a model sees each
+ * clear made between its updates - the model then applies and empties "ICR". Clearing "TXE" sets
+ * it within "ISR" (flushes the Transmit Data Register), as the HAL does.
+ *************************************************************************************************/
+#ifndef STM32L4XX_HAL_H_
+#define STM32L4XX_HAL_H_
+
+#include <stdint.h>
+
+#define __IO                volatile
+
+// Register blocks
+typedef struct {
+    __IO uint32_t   CR1, CR2, SR, DR, CRCPR, RXCRCR, TXCRCR;
+} SPI_TypeDef;
+
+typedef struct {
+    __IO uint32_t   CR1, CR2, OAR1, OAR2, TIMINGR, TIMEOUTR, ISR, ICR, PECR, RXDR, TXDR;
+} I2C_TypeDef;
+
+typedef struct {
+    __IO uint32_t   CR1, CR2, CR3, BRR, GTPR, RTOR, RQR, ISR, ICR, RDR, TDR;
+} USART_TypeDef;
+
+typedef struct {
+    __IO uint32_t   CCR, CNDTR, CPAR, CMAR;
+} DMA_Channel_TypeDef;
+
+typedef struct {
+    __IO uint32_t   ISR, IFCR;
+} DMA_TypeDef;
+
+typedef struct {
+    __IO uint32_t   MODER, OTYPER, OSPEEDR, PUPDR, IDR, ODR, BSRR;
+} GPIO_TypeDef;
+
+typedef struct {
+    __IO uint32_t   CR1, CR2, SMCR, DIER, SR, EGR;
+} TIM_TypeDef;
+
+typedef struct {
+    __IO uint32_t   CTRL, CYCCNT;
+} DWT_Type;
+
+typedef struct {
+    __IO uint32_t   DEMCR;
+} CoreDebug_Type;
+
+// Handles
+typedef struct {
+    SPI_TypeDef             *Instance;
+    struct { uint32_t BaudRatePrescaler; } Init;
+} SPI_HandleTypeDef;
+
+typedef struct {
+    I2C_TypeDef             *Instance;
+} I2C_HandleTypeDef;
+
+typedef struct {
+    USART_TypeDef           *Instance;
+} UART_HandleTypeDef;
+
+typedef struct {
+    TIM_TypeDef             *Instance;
+} TIM_HandleTypeDef;
+
+typedef struct {
+    DMA_Channel_TypeDef     *Instance;
+    DMA_TypeDef             *DmaBaseAddress;
+    uint32_t                ChannelIndex;
+    struct { uint32_t Direction; } Init;
+} DMA_HandleTypeDef;
+
+extern DWT_Type         *DWT;
+extern CoreDebug_Type   *CoreDebug;
+extern uint32_t         SystemCoreClock;
+
+uint32_t HAL_GetTick(void);
+uint32_t HAL_RCC_GetPCLK1Freq(void);
+uint32_t HAL_RCC_GetPCLK2Freq(void);
+
+#define SET_BIT(R, B)                   ((R) |= (B))
+#define CLEAR_BIT(R, B)                 ((R) &= ~(B))
+#define READ_BIT(R, B)                  ((R) & (B))
+#define MODIFY_REG(R, C, S)             ((R) = (((R) & ~(C)) | (S)))
+
+// Core debug
+#define DWT_CTRL_CYCCNTENA_Msk          1u
+#define CoreDebug_DEMCR_TRCENA_Msk      (1u << 24)
+
+// SPI
+#define SPI_CR1_CPHA                    (1u << 0)
+#define SPI_CR1_CPOL                    (1u << 1)
+#define SPI_CR1_MSTR                    (1u << 2)
+#define SPI_CR1_BR_Pos                  3
+#define SPI_CR1_BR                      (7u << 3)
+#define SPI_CR1_SPE                     (1u << 6)
+#define SPI_CR1_LSBFIRST                (1u << 7)
+#define SPI_CR2_RXDMAEN                 (1u << 0)
+#define SPI_CR2_TXDMAEN                 (1u << 1)
+#define SPI_CR2_NSSP                    (1u << 3)
+#define SPI_CR2_ERRIE                   (1u << 5)
+#define SPI_CR2_RXNEIE                  (1u << 6)
+#define SPI_CR2_TXEIE                   (1u << 7)
+#define SPI_CR2_DS_Pos                  8
+#define SPI_CR2_DS                      (0xFu << 8)
+#define SPI_CR2_FRXTH                   (1u << 12)
+#define SPI_CR2_LDMARX                  (1u << 13)
+#define SPI_CR2_LDMATX                  (1u << 14)
+#define SPI_SR_RXNE                     (1u << 0)
+#define SPI_SR_TXE                      (1u << 1)
+#define SPI_SR_MODF                     (1u << 5)
+#define SPI_SR_OVR                      (1u << 6)
+#define SPI_SR_BSY                      (1u << 7)
+#define SPI_SR_FRLVL                    (3u << 9)
+#define SPI_SR_FRLVL_Pos                9
+#define SPI_SR_FTLVL                    (3u << 11)
+#define SPI_SR_FTLVL_Pos                11
+#define SPI_FLAG_RXNE                   SPI_SR_RXNE
+#define SPI_FLAG_TXE                    SPI_SR_TXE
+#define SPI_FLAG_MODF                   SPI_SR_MODF
+#define SPI_FLAG_OVR                    SPI_SR_OVR
+#define SPI_FLAG_BSY                    SPI_SR_BSY
+#define SPI_FLAG_FRLVL                  SPI_SR_FRLVL
+#define SPI_FLAG_FTLVL                  SPI_SR_FTLVL
+#define SPI_IT_TXE                      SPI_CR2_TXEIE
+#define SPI_IT_RXNE                     SPI_CR2_RXNEIE
+#define SPI_IT_ERR                      SPI_CR2_ERRIE
+#define SPI_POLARITY_HIGH               SPI_CR1_CPOL
+#define SPI_PHASE_2EDGE                 SPI_CR1_CPHA
+#define SPI_RXFIFO_THRESHOLD_QF         SPI_CR2_FRXTH
+#define SPI_RXFIFO_THRESHOLD_HF         0u
+#define SPI_FTLVL_EMPTY                 0u
+#define SPI_FTLVL_FULL                  SPI_SR_FTLVL
+#define SPI_FRLVL_EMPTY                 0u
+#define SPI_FRLVL_QUARTER_FULL          (1u << 9)
+#define SPI_FRLVL_HALF_FULL             (2u << 9)
+#define SPI_FRLVL_FULL                  SPI_SR_FRLVL
+#define __HAL_SPI_ENABLE(h)             SET_BIT((h)->Instance->CR1, SPI_CR1_SPE)
+#define __HAL_SPI_DISABLE(h)            CLEAR_BIT((h)->Instance->CR1, SPI_CR1_SPE)
+#define __HAL_SPI_GET_FLAG(h,f)         (((h)->Instance->SR & (f)) == (f))
+#define __HAL_SPI_GET_IT_SOURCE(h,i)    ((((h)->Instance->CR2 & (i)) == (i)) ? 1 : 0)
+#define __HAL_SPI_ENABLE_IT(h,i)        SET_BIT((h)->Instance->CR2, (i))
+#define __HAL_SPI_DISABLE_IT(h,i)       CLEAR_BIT((h)->Instance->CR2, (i))
+#define __HAL_SPI_CLEAR_OVRFLAG(h)      do { (void) (h)->Instance->DR;                             \
+                                             (void) (h)->Instance->SR; } while (0)
+#define __HAL_SPI_CLEAR_MODFFLAG(h)     do { (void) (h)->Instance->SR;                             \
+                                             CLEAR_BIT((h)->Instance->CR1, SPI_CR1_SPE); } while (0)
+
+// I2C
+#define I2C_CR1_TXIE                    (1u << 1)
+#define I2C_CR1_RXIE                    (1u << 2)
+#define I2C_CR1_NACKIE                  (1u << 4)
+#define I2C_CR1_STOPIE                  (1u << 5)
+#define I2C_CR1_TCIE                    (1u << 6)
+#define I2C_CR1_ERRIE                   (1u << 7)
+#define I2C_CR2_SADD                    (0x3FFu)
+#define I2C_CR2_RD_WRN                  (1u << 10)
+#define I2C_CR2_START                   (1u << 13)
+#define I2C_CR2_STOP                    (1u << 14)
+#define I2C_CR2_NACK                    (1u << 15)
+#define I2C_CR2_NBYTES_Pos              16
+#define I2C_CR2_NBYTES                  (0xFFu << 16)
+#define I2C_CR2_RELOAD                  (1u << 24)
+#define I2C_CR2_AUTOEND                 (1u << 25)
+#define I2C_AUTOEND_MODE                I2C_CR2_AUTOEND
+#define I2C_RELOAD_MODE                 I2C_CR2_RELOAD
+#define I2C_SOFTEND_MODE                0u
+#define I2C_FLAG_TXE                    (1u << 0)
+#define I2C_FLAG_TXIS                   (1u << 1)
+#define I2C_FLAG_RXNE                   (1u << 2)
+#define I2C_FLAG_AF                     (1u << 4)
+#define I2C_FLAG_STOPF                  (1u << 5)
+#define I2C_FLAG_TC                     (1u << 6)
+#define I2C_FLAG_TCR                    (1u << 7)
+#define I2C_FLAG_BERR                   (1u << 8)
+#define I2C_FLAG_BUSY                   (1u << 15)
+#define I2C_IT_TXI                      I2C_CR1_TXIE
+#define I2C_IT_RXI                      I2C_CR1_RXIE
+#define I2C_IT_NACKI                    I2C_CR1_NACKIE
+#define I2C_IT_STOPI                    I2C_CR1_STOPIE
+#define I2C_IT_TCI                      I2C_CR1_TCIE
+#define I2C_IT_ERRI                     I2C_CR1_ERRIE
+#define __HAL_I2C_GET_FLAG(h,f)         ((((h)->Instance->ISR) & (f)) == (f))
+#define __HAL_I2C_CLEAR_FLAG(h,f)       (((f) == I2C_FLAG_TXE) ? ((h)->Instance->ISR |= (f))      \
+                                                               : ((h)->Instance->ICR |= (f)))
+#define __HAL_I2C_GET_IT_SOURCE(h,i)    ((((h)->Instance->CR1 & (i)) == (i)) ? 1 : 0)
+#define __HAL_I2C_ENABLE_IT(h,i)        SET_BIT((h)->Instance->CR1, (i))
+#define __HAL_I2C_DISABLE_IT(h,i)       CLEAR_BIT((h)->Instance->CR1, (i))
+
+// DMA
+#define DMA_CCR_EN                      (1u << 0)
+#define DMA_CCR_CIRC                    (1u << 5)
+#define DMA_CCR_MINC                    (1u << 7)
+#define DMA_CCR_PSIZE                   (3u << 8)
+#define DMA_CCR_PSIZE_0                 (1u << 8)
+#define DMA_CCR_MSIZE                   (3u << 10)
+#define DMA_CCR_MSIZE_0                 (1u << 10)
+#define DMA_IT_TC                       (1u << 1)
+#define DMA_IT_HT                       (1u << 2)
+#define DMA_IT_TE                       (1u << 3)
+#define DMA_ISR_GIF1                    1u
+#define DMA_MEMORY_TO_PERIPH            0x10u
+#define DMA_PERIPH_TO_MEMORY            0u
+#define __HAL_DMA_ENABLE(h)             SET_BIT((h)->Instance->CCR, DMA_CCR_EN)
+#define __HAL_DMA_DISABLE(h)            CLEAR_BIT((h)->Instance->CCR, DMA_CCR_EN)
+#define __HAL_DMA_ENABLE_IT(h,i)        SET_BIT((h)->Instance->CCR, (i))
+#define __HAL_DMA_DISABLE_IT(h,i)       CLEAR_BIT((h)->Instance->CCR, (i))
+#define __HAL_DMA_GET_IT_SOURCE(h,i)    ((((h)->Instance->CCR & (i)) == (i)) ? 1 : 0)
+#define __HAL_DMA_GET_COUNTER(h)        ((h)->Instance->CNDTR)
+#define __HAL_DMA_GET_GI_FLAG_INDEX(h)  (1u)
+#define __HAL_DMA_GET_TC_FLAG_INDEX(h)  (2u)
+#define __HAL_DMA_GET_HT_FLAG_INDEX(h)  (4u)
+#define __HAL_DMA_GET_TE_FLAG_INDEX(h)  (8u)
+#define __HAL_DMA_GET_FLAG(h,f)         ((h)->DmaBaseAddress->ISR & (f))
+#define __HAL_DMA_CLEAR_FLAG(h,f)       ((h)->DmaBaseAddress->IFCR = (f))
+
+// UART
+#define USART_CR3_DMAR                  (1u << 6)
+#define USART_CR3_DMAT                  (1u << 7)
+
+// TIM
+#define TIM_DMA_UPDATE                  (1u << 8)
+#define TIM_CR1_CEN                     (1u << 0)
+#define __HAL_TIM_ENABLE_DMA(h,d)       SET_BIT((h)->Instance->DIER, (d))
+#define __HAL_TIM_DISABLE_DMA(h,d)      CLEAR_BIT((h)->Instance->DIER, (d))
+#define __HAL_TIM_ENABLE(h)             SET_BIT((h)->Instance->CR1, TIM_CR1_CEN)
+#define __HAL_TIM_DISABLE(h)            CLEAR_BIT((h)->Instance->CR1, TIM_CR1_CEN)
+
+#endif /* STM32L4XX_HAL_H_ */
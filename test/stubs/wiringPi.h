@@ -0,0 +1,29 @@
+/**************************************************************************************************
+ * @file        wiringPi.h
+ * @author      Thomas
+ * @brief       Host stand-in for the wiringPi library (only what the driver headers need)
+ **************************************************************************************************
+ @ attention
+
+ << To be Introduced >>
+
+ *************************************************************************************************/
+/**************************************************************************************************
+ * How to use
+ * ----------
+ * Placed upon the include path of the host tests (see "test/run_tests.sh"), so the RaspberryPi
+ * headers can be built without the wiringPi library. The 'GPIO' functions are provided by
+ * "HostStubs.cpp" (so no wiringPi functions are needed).
+ *************************************************************************************************/
+#ifndef WIRINGPI_H_
+#define WIRINGPI_H_
+
+typedef int _GPIOValue;
+typedef int _GPIODirec;
+
+#define INPUT               0
+#define OUTPUT              1
+#define LOW                 0
+#define HIGH                1
+
+#endif /* WIRINGPI_H_ */